@@ -9,3 +9,8 @@ PLATFORMSRC += ${CHIBIOS_CONTRIB}/os/hal/ports/GD/GD32VF103/CRC/hal_crc_lld.c \
 endif
 
 PLATFORMINC += ${CHIBIOS_CONTRIB}/os/hal/ports/GD/GD32VF103/CRC
+
+# Required software CRC library, unless already included.
+ifeq ($(CRCLIBSRC),)
+include $(CHIBIOS)/os/hal/lib/crc/crclib.mk
+endif
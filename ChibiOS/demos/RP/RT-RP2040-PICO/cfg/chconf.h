@@ -256,6 +256,19 @@
 #define CH_CFG_USE_MUTEXES_RECURSIVE        FALSE
 #endif
 
+/**
+ * @brief   Mutexes adaptive spin time.
+ * @details In SMP mode a thread locking a mutex owned by a thread running
+ *          on another OS instance spins for up to this number of realtime
+ *          counter cycles before blocking.
+ *
+ * @note    The default is @p 0, spinning disabled.
+ * @note    Requires @p CH_CFG_USE_MUTEXES and @p CH_CFG_SMP_MODE.
+ */
+#if !defined(CH_CFG_MUTEXES_SPIN_TIME)
+#define CH_CFG_MUTEXES_SPIN_TIME            0
+#endif
+
 /**
  * @brief   Conditional Variables APIs.
  * @details If enabled then the conditional variables APIs are included
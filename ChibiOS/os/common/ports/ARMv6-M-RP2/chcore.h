@@ -88,6 +88,11 @@
  */
 #define PORT_CORES_NUMBER               2
 
+/**
+ * @brief   Hint inserted in busy-wait loops polling the other core.
+ */
+#define PORT_SPIN_HINT()                __NOP()
+
 /**
  * @brief   Port-related fields added to the OS instance structure.
  */
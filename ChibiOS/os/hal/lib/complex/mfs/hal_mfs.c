@@ -39,6 +39,7 @@
 #include "hal.h"
 
 #include "hal_mfs.h"
+#include "crclib.h"
 
 /*===========================================================================*/
 /* Driver local definitions.                                                 */
@@ -62,6 +63,28 @@
 #define ALIGNED_SIZEOF(t)                                                   \
   (((sizeof (t) - 1U) | MFS_ALIGN_MASK) + 1U)
 
+/**
+ * @brief   Record identifier reserved to index records.
+ */
+#define MFS_INDEX_ID                        0U
+
+/**
+ * @brief   Index record size aligned.
+ */
+#define ALIGNED_INDEX_SIZE                                                  \
+  ALIGNED_REC_SIZE(sizeof (mfs_index_t))
+
+/**
+ * @brief   Bank space permanently reserved to metadata.
+ */
+#if (MFS_CFG_USE_INDEX == TRUE) || defined(__DOXYGEN__)
+#define ALIGNED_META_SIZE                                                   \
+  (ALIGNED_SIZEOF(mfs_bank_header_t) + ALIGNED_INDEX_SIZE)
+#else
+#define ALIGNED_META_SIZE                                                   \
+  ALIGNED_SIZEOF(mfs_bank_header_t)
+#endif
+
 /**
  * @brief   Combines two values (0..3) in one (0..15).
  */
@@ -85,56 +108,10 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
-static const uint16_t crc16_table[256] = {
-  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
-  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
-  0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
-  0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
-  0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
-  0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
-  0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
-  0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
-  0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
-  0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
-  0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
-  0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
-  0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
-  0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
-  0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
-  0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
-  0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
-  0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
-  0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
-  0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
-  0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
-  0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
-  0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
-  0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
-  0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
-  0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
-  0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
-  0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
-  0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
-  0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
-  0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
-  0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
-};
-
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
-uint16_t crc16(uint16_t crc, const uint8_t *data, size_t n) {
-
-  while (n > 0U) {
-    crc = (crc << 8U) ^ crc16_table[(crc >> 8U) ^ (uint16_t)*data];
-    data++;
-    n--;
-  }
-
-  return crc;
-}
-
 static void mfs_state_reset(MFSDriver *mfsp) {
   unsigned i;
 
@@ -379,8 +356,9 @@ static mfs_error_t mfs_bank_write_header(MFSDriver *mfsp,
   bhdr.fields.magic2    = MFS_BANK_MAGIC_2;
   bhdr.fields.counter   = cnt;
   bhdr.fields.reserved1 = (uint16_t)mfsp->config->erased;
-  bhdr.fields.crc       = crc16(0xFFFFU, bhdr.hdr8,
-                                sizeof (mfs_bank_header_t) - sizeof (uint16_t));
+  bhdr.fields.crc       = crclibCRC16(0xFFFFU, bhdr.hdr8,
+                                      sizeof (mfs_bank_header_t) -
+                                      sizeof (uint16_t));
 
   return mfs_flash_write(mfsp,
                          flashGetSectorOffset(mfsp->config->flashp, sector),
@@ -415,8 +393,8 @@ static mfs_bank_state_t mfs_bank_check_header(MFSDriver *mfsp) {
   }
 
   /* Verifying header CRC.*/
-  crc = crc16(0xFFFFU, mfsp->buffer.bhdr.hdr8,
-              sizeof (mfs_bank_header_t) - sizeof (uint16_t));
+  crc = crclibCRC16(0xFFFFU, mfsp->buffer.bhdr.hdr8,
+                    sizeof (mfs_bank_header_t) - sizeof (uint16_t));
   if (crc != mfsp->buffer.bhdr.fields.crc) {
     return MFS_BANK_GARBAGE;
   }
@@ -424,9 +402,183 @@ static mfs_bank_state_t mfs_bank_check_header(MFSDriver *mfsp) {
   return MFS_BANK_OK;
 }
 
+/**
+ * @brief   Calculates the CRC of a record data.
+ * @note    The data is read in chunks because the buffer is small.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] hdr_offset offset of the record header
+ * @param[in] size      size of the record data
+ * @param[out] crcp     calculated CRC
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_record_get_crc(MFSDriver *mfsp,
+                                      flash_offset_t hdr_offset,
+                                      uint32_t size,
+                                      uint16_t *crcp) {
+  flash_offset_t data = hdr_offset + sizeof (mfs_data_header_t);
+  uint16_t crc = 0xFFFFU;
+
+  while (size > 0U) {
+    uint32_t chunk = size > MFS_CFG_BUFFER_SIZE ? MFS_CFG_BUFFER_SIZE : size;
+
+    /* Reading the data chunk.*/
+    RET_ON_ERROR(mfs_flash_read(mfsp, data, chunk, mfsp->buffer.data8));
+
+    /* CRC on the read data chunk.*/
+    crc = crclibCRC16(crc, &mfsp->buffer.data8[0], chunk);
+
+    /* Next chunk.*/
+    data += chunk;
+    size -= chunk;
+  }
+
+  *crcp = crc;
+
+  return MFS_NO_ERROR;
+}
+
+#if (MFS_CFG_USE_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Writes an index record.
+ * @details The current records descriptors are written as an index
+ *          record, the magic number is written last.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] offset    offset of the index record
+ * @param[in] end_offset offset of the first record not covered by the index
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_index_write(MFSDriver *mfsp,
+                                   flash_offset_t offset,
+                                   flash_offset_t end_offset) {
+  flash_offset_t data = offset + sizeof (mfs_data_header_t);
+  uint16_t crc;
+
+  crc = crclibCRC16(0xFFFFU, (const uint8_t *)&end_offset,
+                    sizeof (flash_offset_t));
+  crc = crclibCRC16(crc, (const uint8_t *)mfsp->descriptors,
+                    sizeof (mfsp->descriptors));
+
+  /* Writing the data header without the magic, it will be written last.*/
+  mfsp->buffer.dhdr.fields.id     = (uint16_t)MFS_INDEX_ID;
+  mfsp->buffer.dhdr.fields.size   = (uint32_t)sizeof (mfs_index_t);
+  mfsp->buffer.dhdr.fields.crc    = crc;
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               offset + (sizeof (uint32_t) * 2U),
+                               sizeof (mfs_data_header_t) - (sizeof (uint32_t) * 2U),
+                               mfsp->buffer.data8 + (sizeof (uint32_t) * 2U)));
+
+  /* Writing the index data.*/
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               data + offsetof(mfs_index_t, end_offset),
+                               sizeof (flash_offset_t),
+                               (const uint8_t *)&end_offset));
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               data + offsetof(mfs_index_t, descriptors),
+                               sizeof (mfsp->descriptors),
+                               (const uint8_t *)mfsp->descriptors));
+
+  /* Finally writing the magic number, it seals the operation.*/
+  mfsp->buffer.dhdr.fields.magic1 = (uint32_t)MFS_HEADER_MAGIC_1;
+  mfsp->buffer.dhdr.fields.magic2 = (uint32_t)MFS_HEADER_MAGIC_2;
+  return mfs_flash_write(mfsp,
+                         offset,
+                         sizeof (uint32_t) * 2U,
+                         mfsp->buffer.data8);
+}
+
+/**
+ * @brief   Searches a bank for the most recent valid index.
+ * @details Only record headers are read, the data of a record is read only
+ *          if it is an index. When a valid index is found the descriptors
+ *          are loaded from it and the records covered by it are skipped.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the bank identifier
+ * @param[out] offsetp  offset of the first record not covered by an index
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_bank_load_index(MFSDriver *mfsp,
+                                       mfs_bank_t bank,
+                                       flash_offset_t *offsetp) {
+  flash_offset_t hdr_offset, start_offset, end_offset;
+
+  /* Boundaries.*/
+  start_offset = mfs_flash_get_bank_offset(mfsp, bank);
+  hdr_offset   = start_offset + (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t);
+  end_offset   = start_offset + mfsp->config->bank_size;
+
+  /* No index by default.*/
+  *offsetp = hdr_offset;
+
+  /* Walking the records headers, the walk stops on the first erased or
+     invalid header, the full scan takes care of it.*/
+  while (hdr_offset < end_offset - ALIGNED_DHDR_SIZE) {
+    mfs_data_header_t dhdr;
+
+    /* Reading the current record header.*/
+    RET_ON_ERROR(mfs_flash_read(mfsp, hdr_offset,
+                                sizeof (mfs_data_header_t),
+                                dhdr.hdr8));
+
+    if ((dhdr.fields.magic1 != MFS_HEADER_MAGIC_1) ||
+        (dhdr.fields.magic2 != MFS_HEADER_MAGIC_2) ||
+        (dhdr.fields.id > (uint32_t)MFS_CFG_MAX_RECORDS) ||
+        (dhdr.fields.size > end_offset - hdr_offset)) {
+      break;
+    }
+
+    /* Index records are validated and loaded, an index failing the checks
+       is skipped like any other record.*/
+    if ((dhdr.fields.id == MFS_INDEX_ID) &&
+        (dhdr.fields.size == (uint32_t)sizeof (mfs_index_t))) {
+      flash_offset_t data = hdr_offset + sizeof (mfs_data_header_t);
+      flash_offset_t next_offset;
+      uint16_t crc;
+
+      RET_ON_ERROR(mfs_record_get_crc(mfsp, hdr_offset,
+                                      dhdr.fields.size, &crc));
+      RET_ON_ERROR(mfs_flash_read(mfsp,
+                                  data + offsetof(mfs_index_t, end_offset),
+                                  sizeof (flash_offset_t),
+                                  (uint8_t *)&next_offset));
+      if ((crc == dhdr.fields.crc) &&
+          (next_offset >= hdr_offset + ALIGNED_INDEX_SIZE) &&
+          (next_offset <= end_offset)) {
+        RET_ON_ERROR(mfs_flash_read(mfsp,
+                                    data + offsetof(mfs_index_t, descriptors),
+                                    sizeof (mfsp->descriptors),
+                                    (uint8_t *)mfsp->descriptors));
+
+        /* Records covered by the index are not examined.*/
+        *offsetp   = next_offset;
+        hdr_offset = next_offset;
+        continue;
+      }
+    }
+
+    /* On the next header.*/
+    hdr_offset = hdr_offset + ALIGNED_REC_SIZE(dhdr.fields.size);
+  }
+
+  return MFS_NO_ERROR;
+}
+#endif /* MFS_CFG_USE_INDEX == TRUE */
+
 /**
  * @brief   Scans blocks searching for records.
- * @note    The block integrity is strongly checked.
+ * @note    The block integrity is strongly checked if the option
+ *          @p MFS_CFG_STRONG_CHECKING is enabled, else the records data is
+ *          only verified on read.
+ * @note    If the option @p MFS_CFG_USE_INDEX is enabled then the scan
+ *          starts after the most recent valid index.
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
  * @param[in] bank      the bank identifier
@@ -449,6 +601,11 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
   hdr_offset   = start_offset + (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t);
   end_offset   = start_offset + mfsp->config->bank_size;
 
+#if MFS_CFG_USE_INDEX == TRUE
+  /* Records covered by an index are not scanned.*/
+  RET_ON_ERROR(mfs_bank_load_index(mfsp, bank, &hdr_offset));
+#endif
+
   /* Scanning records until there is there is not enough space left for an
      header.*/
   while (hdr_offset < end_offset - ALIGNED_DHDR_SIZE) {
@@ -473,40 +630,42 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
     /* It is not erased so checking for integrity.*/
     if ((u.dhdr.fields.magic1 != MFS_HEADER_MAGIC_1) ||
         (u.dhdr.fields.magic2 != MFS_HEADER_MAGIC_2) ||
+#if MFS_CFG_USE_INDEX == FALSE
         (u.dhdr.fields.id < 1U) ||
+#endif
         (u.dhdr.fields.id > (uint32_t)MFS_CFG_MAX_RECORDS) ||
         (u.dhdr.fields.size > end_offset - hdr_offset)) {
       *wflagp = true;
       break;
     }
 
-    /* Finally checking the CRC, we need to perform it in chunks because
-       we have a limited buffer.*/
-    crc = 0xFFFFU;
-    if (u.dhdr.fields.size > 0U) {
-      flash_offset_t data = hdr_offset + sizeof (mfs_data_header_t);
-      uint32_t total = u.dhdr.fields.size;
-
-      while (total > 0U) {
-        uint32_t chunk = total > MFS_CFG_BUFFER_SIZE ? MFS_CFG_BUFFER_SIZE :
-                                                       total;
-
-        /* Reading the data chunk.*/
-        RET_ON_ERROR(mfs_flash_read(mfsp, data, chunk, mfsp->buffer.data8));
-
-        /* CRC on the read data chunk.*/
-        crc = crc16(crc, &mfsp->buffer.data8[0], chunk);
-
-        /* Next chunk.*/
-        data  += chunk;
-        total -= chunk;
-      }
+    /* Finally checking the CRC, without strong checking only erase
+       markers and index records are checked here, data is verified on
+       read.*/
+#if MFS_CFG_STRONG_CHECKING == TRUE
+    RET_ON_ERROR(mfs_record_get_crc(mfsp, hdr_offset,
+                                    u.dhdr.fields.size, &crc));
+#else
+    if ((u.dhdr.fields.id == MFS_INDEX_ID) || (u.dhdr.fields.size == 0U)) {
+      RET_ON_ERROR(mfs_record_get_crc(mfsp, hdr_offset,
+                                      u.dhdr.fields.size, &crc));
+    }
+    else {
+      crc = u.dhdr.fields.crc;
     }
+#endif
     if (crc != u.dhdr.fields.crc) {
       /* If the CRC is invalid then this record is ignored but scanning
          continues because there could be more valid records afterward.*/
       *wflagp = true;
     }
+#if MFS_CFG_USE_INDEX == TRUE
+    else if (u.dhdr.fields.id == MFS_INDEX_ID) {
+      /* An index found here has been rejected by the index search, it is
+         ignored and discarded by the next garbage collection.*/
+      *wflagp = true;
+    }
+#endif
     else {
       /* Zero-sized records are erase markers.*/
       if (u.dhdr.fields.size == 0U) {
@@ -588,6 +747,9 @@ static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
   unsigned i;
   mfs_bank_t sbank, dbank;
   flash_offset_t dest_offset;
+#if MFS_CFG_USE_INDEX == TRUE
+  flash_offset_t index_offset;
+#endif
 
   sbank = mfsp->current_bank;
   if (sbank == MFS_BANK_0) {
@@ -601,6 +763,13 @@ static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
   dest_offset = mfs_flash_get_bank_offset(mfsp, dbank) +
                 ALIGNED_SIZEOF(mfs_bank_header_t);
 
+#if MFS_CFG_USE_INDEX == TRUE
+  /* The index is the first record in the bank, it is written after the
+     data because it contains the new records positions.*/
+  index_offset = dest_offset;
+  dest_offset += ALIGNED_INDEX_SIZE;
+#endif
+
   /* Copying the most recent record instances only.*/
   for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
     uint32_t totsize = ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
@@ -613,6 +782,11 @@ static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
     }
   }
 
+#if MFS_CFG_USE_INDEX == TRUE
+  /* Index covering all the copied records.*/
+  RET_ON_ERROR(mfs_index_write(mfsp, index_offset, dest_offset));
+#endif
+
   /* New current bank.*/
   mfsp->current_bank = dbank;
   mfsp->current_counter += 1U;
@@ -749,12 +923,20 @@ static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
     RET_ON_ERROR(mfs_bank_scan_records(mfsp, bank, &w2));
 
     /* Calculating the effective used size.*/
-    mfsp->used_space = ALIGNED_SIZEOF(mfs_bank_header_t);
+    mfsp->used_space = ALIGNED_META_SIZE;
     for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
       if (mfsp->descriptors[i].offset != 0U) {
         mfsp->used_space += ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
       }
     }
+
+#if MFS_CFG_USE_INDEX == TRUE
+    /* A bank filled without the index reserve cannot hold the index, the
+       space checks would overflow, the partition must be erased.*/
+    if (mfsp->used_space > mfsp->config->bank_size) {
+      return MFS_ERR_OUT_OF_MEM;
+    }
+#endif
   }
 
   /* In case of detected problems then a garbage collection is performed in
@@ -775,6 +957,11 @@ static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
  *                                  completed.
  * @retval MFS_WARN_GC              if the operation triggered a garbage
  *                                  collection.
+ * @retval MFS_ERR_OUT_OF_MEM       if the partition has been written with
+ *                                  @p MFS_CFG_USE_INDEX disabled and the
+ *                                  records do not leave space for the index.
+ *                                  Makes the driver enter the @p MFS_ERROR
+ *                                  state.
  * @retval MFS_ERR_FLASH_FAILURE    if the flash memory is unusable because HW
  *                                  failures. Makes the driver enter the
  *                                  @p MFS_ERROR state.
@@ -793,9 +980,9 @@ mfs_error_t mfs_mount(MFSDriver *mfsp) {
     mfs_error_t err;
 
     err = mfs_try_mount(mfsp);
-    if (err == MFS_ERR_INTERNAL) {
-      /* Special case, do not retry on internal errors but report
-         immediately.*/
+    if ((err == MFS_ERR_INTERNAL) || (err == MFS_ERR_OUT_OF_MEM)) {
+      /* Special case, do not retry on internal errors or on a partition
+         not fitting the index reserve but report immediately.*/
       mfsp->state = MFS_ERROR;
       return err;
     }
@@ -839,6 +1026,11 @@ void mfsObjectInit(MFSDriver *mfsp) {
  *                                  completed.
  * @retval MFS_WARN_GC              if the operation triggered a garbage
  *                                  collection.
+ * @retval MFS_ERR_OUT_OF_MEM       if the partition has been written with
+ *                                  @p MFS_CFG_USE_INDEX disabled and the
+ *                                  records do not leave space for the index.
+ *                                  Makes the driver enter the @p MFS_ERROR
+ *                                  state.
  * @retval MFS_ERR_FLASH_FAILURE    if the flash memory is unusable because HW
  *                                  failures. Makes the driver enter the
  *                                  @p MFS_ERROR state.
@@ -965,7 +1157,7 @@ mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
                               buffer));
 
   /* Checking CRC.*/
-  crc = crc16(0xFFFFU, buffer, *np);
+  crc = crclibCRC16(0xFFFFU, buffer, *np);
   if (crc != mfsp->buffer.dhdr.fields.crc) {
     mfsp->state = MFS_ERROR;
     return MFS_ERR_FLASH_FAILURE;
@@ -1039,7 +1231,7 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
     /* Writing the data header without the magic, it will be written last.*/
     mfsp->buffer.dhdr.fields.id     = (uint16_t)id;
     mfsp->buffer.dhdr.fields.size   = (uint32_t)n;
-    mfsp->buffer.dhdr.fields.crc    = crc16(0xFFFFU, buffer, n);
+    mfsp->buffer.dhdr.fields.crc    = crclibCRC16(0xFFFFU, buffer, n);
     RET_ON_ERROR(mfs_flash_write(mfsp,
                                  mfsp->next_offset + (sizeof (uint32_t) * 2U),
                                  sizeof (mfs_data_header_t) - (sizeof (uint32_t) * 2U),
@@ -1095,7 +1287,7 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
     /* Writing the data header without the magic, it will be written last.*/
     mfsp->buffer.dhdr.fields.id     = (uint16_t)id;
     mfsp->buffer.dhdr.fields.size   = (uint32_t)n;
-    mfsp->buffer.dhdr.fields.crc    = crc16(0xFFFFU, buffer, n);
+    mfsp->buffer.dhdr.fields.crc    = crclibCRC16(0xFFFFU, buffer, n);
     RET_ON_ERROR(mfs_flash_write(mfsp,
                                  mfsp->tr_next_offset + (sizeof (uint32_t) * 2U),
                                  sizeof (mfs_data_header_t) - (sizeof (uint32_t) * 2U),
@@ -1375,6 +1567,9 @@ mfs_error_t mfsStartTransaction(MFSDriver *mfsp, size_t size) {
  */
 mfs_error_t mfsCommitTransaction(MFSDriver *mfsp) {
   mfs_transaction_op_t *top;
+#if MFS_CFG_USE_INDEX == TRUE
+  flash_offset_t free;
+#endif
 
   osalDbgCheck(mfsp != NULL);
 
@@ -1430,6 +1625,19 @@ mfs_error_t mfsCommitTransaction(MFSDriver *mfsp) {
     top++;
   }
 
+#if MFS_CFG_USE_INDEX == TRUE
+  /* Writing an index of the committed state, if there is not enough
+     immediately available space then it is skipped, the next garbage
+     collection writes one anyway.*/
+  free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
+          mfsp->config->bank_size) - mfsp->next_offset;
+  if (ALIGNED_INDEX_SIZE + ALIGNED_DHDR_SIZE <= free) {
+    RET_ON_ERROR(mfs_index_write(mfsp, mfsp->next_offset,
+                                 mfsp->next_offset + ALIGNED_INDEX_SIZE));
+    mfsp->next_offset += ALIGNED_INDEX_SIZE;
+  }
+#endif
+
   /* Returning to ready mode.*/
   mfsp->state = MFS_READY;
 
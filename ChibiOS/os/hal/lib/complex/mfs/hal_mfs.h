@@ -74,11 +74,33 @@
  * @details Strong checking requires reading of the whole written data and
  *          this can be slow, normal checking only checks integrity of
  *          metadata, data errors would be detected on read.
+ * @note    Records covered by a valid index are never re-read on mount,
+ *          this setting only affects records written after the index.
  */
 #if !defined(MFS_CFG_STRONG_CHECKING) || defined(__DOXYGEN__)
 #define MFS_CFG_STRONG_CHECKING             TRUE
 #endif
 
+/**
+ * @brief   Enables the persisted records index.
+ * @details A snapshot of the records descriptors is written in the bank
+ *          on garbage collection and on transaction commit, the mount
+ *          procedure trusts the most recent valid index and only scans
+ *          records written after it.
+ * @note    The space for one index record is permanently reserved in
+ *          each bank.
+ * @note    Banks written with this option enabled cannot be mounted by
+ *          drivers having the option disabled, the index record would be
+ *          considered garbage and removed.
+ * @note    Enabling the option on a partition written without it requires
+ *          the stored records to leave space for the index reserve, else
+ *          @p mfsStart() fails with @p MFS_ERR_OUT_OF_MEM and the flash
+ *          must be erased.
+ */
+#if !defined(MFS_CFG_USE_INDEX) || defined(__DOXYGEN__)
+#define MFS_CFG_USE_INDEX                   FALSE
+#endif
+
 /**
  * @brief   Size of the buffer used for data copying.
  * @note    The buffer size must be a power of two and not smaller than
@@ -277,6 +299,22 @@ typedef struct {
   uint32_t                  size;
 } mfs_record_descriptor_t;
 
+/**
+ * @brief   Type of a records index.
+ * @details This structure is the payload of an index record, it is
+ *          written using the reserved record identifier zero.
+ */
+typedef struct {
+  /**
+   * @brief   Offset of the first record not covered by the index.
+   */
+  flash_offset_t            end_offset;
+  /**
+   * @brief   Snapshot of the records descriptors.
+   */
+  mfs_record_descriptor_t   descriptors[MFS_CFG_MAX_RECORDS];
+} mfs_index_t;
+
 /**
  * @brief   Type of a MFS configuration structure.
  */
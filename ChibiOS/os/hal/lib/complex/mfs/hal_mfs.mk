@@ -7,3 +7,8 @@ MFSINC := $(CHIBIOS)/os/hal/lib/complex/mfs
 # Shared variables
 ALLCSRC += $(MFSSRC)
 ALLINC  += $(MFSINC)
+
+# Required software CRC library, unless already included.
+ifeq ($(CRCLIBSRC),)
+include $(CHIBIOS)/os/hal/lib/crc/crclib.mk
+endif
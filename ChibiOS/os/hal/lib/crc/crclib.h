@@ -0,0 +1,179 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    crclib.h
+ * @brief   Software CRC library header.
+ *
+ * @addtogroup HAL_CRCLIB
+ * @{
+ */
+
+#ifndef CRCLIB_H
+#define CRCLIB_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    CRC check values
+ * @brief   CRC of the ASCII string "123456789".
+ * @{
+ */
+#define CRCLIB_CRC16_CHECK                  0x29B1U
+#define CRCLIB_CRC32_CHECK                  0xCBF43926U
+#define CRCLIB_CRC32C_CHECK                 0xE3069283U
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the CRC16-CCITT algorithm.
+ * @details Polynomial 0x1021, not reflected, it is the CRC used by MFS.
+ */
+#if !defined(CRCLIB_CFG_USE_CRC16) || defined(__DOXYGEN__)
+#define CRCLIB_CFG_USE_CRC16                TRUE
+#endif
+
+/**
+ * @brief   Enables the CRC32 algorithm.
+ * @details Polynomial 0x04C11DB7, reflected, as used by Ethernet and zlib.
+ */
+#if !defined(CRCLIB_CFG_USE_CRC32) || defined(__DOXYGEN__)
+#define CRCLIB_CFG_USE_CRC32                TRUE
+#endif
+
+/**
+ * @brief   Enables the CRC32C algorithm.
+ * @details Polynomial 0x1EDC6F41 (Castagnoli), reflected.
+ */
+#if !defined(CRCLIB_CFG_USE_CRC32C) || defined(__DOXYGEN__)
+#define CRCLIB_CFG_USE_CRC32C               TRUE
+#endif
+
+/**
+ * @brief   Number of lookup tables per algorithm.
+ * @details With one table the data is processed one byte at time, with
+ *          four or eight tables the data is processed in blocks of the
+ *          same size ("slicing-by-N"). Each table takes 256 CRC words of
+ *          flash: 512 bytes for CRC16 and 1kB for CRC32 and CRC32C, so
+ *          8 tables take 8kB for each 32 bits algorithm.
+ * @note    The default is a single table, the same footprint of the
+ *          byte at time implementations replaced by this library.
+ */
+#if !defined(CRCLIB_CFG_SLICES) || defined(__DOXYGEN__)
+#define CRCLIB_CFG_SLICES                   1
+#endif
+
+/**
+ * @brief   Enables the x86 CRC32 instruction for CRC32C.
+ * @note    Only effective when compiling for x86 with SSE4.2 enabled,
+ *          for example on the simulator using @p -msse4.2.
+ */
+#if !defined(CRCLIB_CFG_USE_X86_CRC32) || defined(__DOXYGEN__)
+#define CRCLIB_CFG_USE_X86_CRC32            TRUE
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (CRCLIB_CFG_SLICES != 1) && (CRCLIB_CFG_SLICES != 4) &&                 \
+    (CRCLIB_CFG_SLICES != 8)
+#error "CRCLIB_CFG_SLICES must be 1, 4 or 8"
+#endif
+
+#if (CRCLIB_CFG_USE_X86_CRC32 == TRUE) && defined(__SSE4_2__)
+#define CRCLIB_X86_CRC32                    TRUE
+#else
+#define CRCLIB_X86_CRC32                    FALSE
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Supported algorithms.
+ */
+typedef enum {
+  CRCLIB_CRC16 = 0,
+  CRCLIB_CRC32 = 1,
+  CRCLIB_CRC32C = 2
+} crclib_type_t;
+
+/**
+ * @brief   Type of a streaming CRC context.
+ */
+typedef struct {
+  /**
+   * @brief   Selected algorithm.
+   */
+  crclib_type_t             type;
+  /**
+   * @brief   Running CRC value, before the final XOR.
+   */
+  uint32_t                  crc;
+} crclib_context_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (CRCLIB_CFG_USE_CRC16 == TRUE) || defined(__DOXYGEN__)
+extern const uint16_t crclib_crc16_table[CRCLIB_CFG_SLICES][256];
+#endif
+#if (CRCLIB_CFG_USE_CRC32 == TRUE) || defined(__DOXYGEN__)
+extern const uint32_t crclib_crc32_table[CRCLIB_CFG_SLICES][256];
+#endif
+#if ((CRCLIB_CFG_USE_CRC32C == TRUE) && (CRCLIB_X86_CRC32 == FALSE)) ||     \
+    defined(__DOXYGEN__)
+extern const uint32_t crclib_crc32c_table[CRCLIB_CFG_SLICES][256];
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if (CRCLIB_CFG_USE_CRC16 == TRUE) || defined(__DOXYGEN__)
+  uint16_t crclibCRC16(uint16_t crc, const void *buf, size_t n);
+#endif
+#if (CRCLIB_CFG_USE_CRC32 == TRUE) || defined(__DOXYGEN__)
+  uint32_t crclibCRC32(uint32_t crc, const void *buf, size_t n);
+#endif
+#if (CRCLIB_CFG_USE_CRC32C == TRUE) || defined(__DOXYGEN__)
+  uint32_t crclibCRC32C(uint32_t crc, const void *buf, size_t n);
+#endif
+  void crclibInit(crclib_context_t *ctxp, crclib_type_t type);
+  void crclibUpdate(crclib_context_t *ctxp, const void *buf, size_t n);
+  uint32_t crclibFinal(const crclib_context_t *ctxp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* CRCLIB_H */
+
+/** @} */
@@ -0,0 +1,9 @@
+# List of all the software CRC library files.
+CRCLIBSRC := $(CHIBIOS)/os/hal/lib/crc/crclib.c
+
+# Required include directories
+CRCLIBINC := $(CHIBIOS)/os/hal/lib/crc
+
+# Shared variables
+ALLCSRC += $(CRCLIBSRC)
+ALLINC  += $(CRCLIBINC)
@@ -28,6 +28,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 #include "chprintf.h"
 #include "memstreams.h"
@@ -97,35 +99,198 @@ static char *ftoa(char *p, double num, unsigned long precision) {
 #endif
 
 /**
- * @brief   System formatted output function.
- * @details This function implements a minimal @p vprintf()-like functionality
- *          with output on a @p BaseSequentialStream.
- *          The general parameters format is: %[-][width|*][.precision|*][l|L]p.
- *          The following parameter types (p) are supported:
- *          - <b>x</b> hexadecimal integer.
- *          - <b>X</b> hexadecimal long.
- *          - <b>o</b> octal integer.
- *          - <b>O</b> octal long.
- *          - <b>d</b> decimal signed integer.
- *          - <b>D</b> decimal signed long.
- *          - <b>u</b> decimal unsigned integer.
- *          - <b>U</b> decimal unsigned long.
- *          - <b>c</b> character.
- *          - <b>s</b> string.
- *          .
+ * @brief   Type of an output context.
+ */
+typedef struct {
+  BaseSequentialStream  *chp;
+  int                   n;
+#if CHPRINTF_BUFFER_SIZE > 0
+  size_t                cnt;
+  uint8_t               buf[CHPRINTF_BUFFER_SIZE];
+#endif
+} output_t;
+
+static void out_init(output_t *op, BaseSequentialStream *chp) {
+
+  op->chp = chp;
+  op->n   = 0;
+#if CHPRINTF_BUFFER_SIZE > 0
+  op->cnt = 0U;
+#endif
+}
+
+static void out_flush(output_t *op) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  if (op->cnt > 0U) {
+    (void) streamWrite(op->chp, op->buf, op->cnt);
+    op->cnt = 0U;
+  }
+#else
+  (void)op;
+#endif
+}
+
+static void out_put(output_t *op, char c) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  op->buf[op->cnt++] = (uint8_t)c;
+  if (op->cnt >= (size_t)CHPRINTF_BUFFER_SIZE) {
+    out_flush(op);
+  }
+#else
+  streamPut(op->chp, (uint8_t)c);
+#endif
+  op->n++;
+}
+
+static void out_write(output_t *op, const char *s, size_t size) {
+
+  op->n += (int)size;
+#if CHPRINTF_BUFFER_SIZE > 0
+  /* Runs larger than the buffer are written directly.*/
+  if (size >= (size_t)CHPRINTF_BUFFER_SIZE) {
+    out_flush(op);
+    (void) streamWrite(op->chp, (const uint8_t *)s, size);
+    return;
+  }
+  while (size > 0U) {
+    size_t free = (size_t)CHPRINTF_BUFFER_SIZE - op->cnt;
+
+    if (free > size) {
+      free = size;
+    }
+    memcpy(&op->buf[op->cnt], s, free);
+    op->cnt += free;
+    s       += free;
+    size    -= free;
+    if (op->cnt >= (size_t)CHPRINTF_BUFFER_SIZE) {
+      out_flush(op);
+    }
+  }
+#else
+  while (size > 0U) {
+    streamPut(op->chp, (uint8_t)*s++);
+    size--;
+  }
+#endif
+}
+
+/**
+ * @brief   Parses the next conversion specification.
  *
- * @param[in] chp       pointer to a @p BaseSequentialStream implementing object
  * @param[in] fmt       formatting string
- * @param[in] ap        list of parameters
- * @return              The number of bytes that would have been
- *                      written to @p chp if no stream error occurs
+ * @param[out] sp       pointer to the specification to be filled
+ * @return              The pointer to the rest of the formatting string,
+ *                      @p NULL if the string has been fully parsed, in
+ *                      this case @p sp only contains the final literal.
+ */
+static const char *parse_spec(const char *fmt, chprintf_spec_t *sp) {
+  char c;
+
+  /* Literal text up to the next conversion.*/
+  sp->literal = fmt;
+  while ((*fmt != 0) && (*fmt != '%')) {
+    fmt++;
+  }
+  sp->literal_size = (size_t)(fmt - sp->literal);
+  sp->width        = 0;
+  sp->precision    = 0;
+  sp->flags        = 0U;
+  sp->conv         = 0;
+  if (*fmt++ == 0) {
+    return NULL;
+  }
+
+  /* Alignment mode.*/
+  if (*fmt == '-') {
+    fmt++;
+    sp->flags |= CHPRINTF_FLAG_LEFT;
+  }
+
+  /* Sign mode.*/
+  if (*fmt == '+') {
+    fmt++;
+    sp->flags |= CHPRINTF_FLAG_SIGN;
+  }
+
+  /* Filler mode.*/
+  if (*fmt == '0') {
+    fmt++;
+    sp->flags |= CHPRINTF_FLAG_ZERO;
+  }
+
+  /* Width modifier.*/
+  if (*fmt == '*') {
+    sp->flags |= CHPRINTF_FLAG_WIDTH_ARG;
+    ++fmt;
+    c = *fmt++;
+  }
+  else {
+    while (true) {
+      c = *fmt++;
+      if (c == 0) {
+        return NULL;
+      }
+      if (c >= '0' && c <= '9') {
+        c -= '0';
+        sp->width = sp->width * 10 + c;
+      }
+      else {
+        break;
+      }
+    }
+  }
+
+  /* Precision modifier.*/
+  if (c == '.') {
+    c = *fmt++;
+    if (c == 0) {
+      return NULL;
+    }
+    if (c == '*') {
+      sp->flags |= CHPRINTF_FLAG_PREC_ARG;
+      c = *fmt++;
+    }
+    else {
+      while (c >= '0' && c <= '9') {
+        c -= '0';
+        sp->precision = sp->precision * 10 + c;
+        c = *fmt++;
+        if (c == 0) {
+          return NULL;
+        }
+      }
+    }
+  }
+
+  /* Long modifier.*/
+  if (c == 'l' || c == 'L') {
+    sp->flags |= CHPRINTF_FLAG_LONG;
+    c = *fmt++;
+  }
+  else if ((c >= 'A') && (c <= 'Z')) {
+    sp->flags |= CHPRINTF_FLAG_LONG;
+  }
+  if (c == 0) {
+    return NULL;
+  }
+
+  sp->conv = c;
+  return fmt;
+}
+
+/**
+ * @brief   Formats a parsed conversion specification.
  *
- * @api
+ * @param[in] op        pointer to the output context
+ * @param[in] sp        pointer to the specification
+ * @param[in] app       pointer to the list of parameters
  */
-int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
+static void format_spec(output_t *op, const chprintf_spec_t *sp,
+                        va_list *app) {
   char *p, *s, c, filler;
   int i, precision, width;
-  int n = 0;
   bool is_long, left_align, do_sign;
   long l;
 #if CHPRINTF_USE_FLOAT
@@ -135,209 +300,178 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
   char tmpbuf[MAX_FILLER + 1];
 #endif
 
-  while (true) {
-    c = *fmt++;
-    if (c == 0) {
-      return n;
-    }
-    
-    if (c != '%') {
-      streamPut(chp, (uint8_t)c);
-      n++;
-      continue;
-    }
-    
-    p = tmpbuf;
-    s = tmpbuf;
-
-    /* Alignment mode.*/
-    left_align = false;
-    if (*fmt == '-') {
-      fmt++;
-      left_align = true;
-    }
+  out_write(op, sp->literal, sp->literal_size);
+  if (sp->conv == 0) {
+    return;
+  }
 
-    /* Sign mode.*/
-    do_sign = false;
-    if (*fmt == '+') {
-      fmt++;
-      do_sign = true;
-    }
+  p = tmpbuf;
+  s = tmpbuf;
+  left_align = (sp->flags & CHPRINTF_FLAG_LEFT) != 0U;
+  do_sign    = (sp->flags & CHPRINTF_FLAG_SIGN) != 0U;
+  filler     = (sp->flags & CHPRINTF_FLAG_ZERO) != 0U ? '0' : ' ';
+  is_long    = (sp->flags & CHPRINTF_FLAG_LONG) != 0U;
+  if ((sp->flags & CHPRINTF_FLAG_WIDTH_ARG) != 0U) {
+    width = va_arg(*app, int);
+  }
+  else {
+    width = sp->width;
+  }
+  if ((sp->flags & CHPRINTF_FLAG_PREC_ARG) != 0U) {
+    precision = va_arg(*app, int);
+  }
+  else {
+    precision = sp->precision;
+  }
 
-    /* Filler mode.*/
+  /* Command decoding.*/
+  c = sp->conv;
+  switch (c) {
+  case 'c':
+    filler = ' ';
+    *p++ = va_arg(*app, int);
+    break;
+  case 's':
     filler = ' ';
-    if (*fmt == '0') {
-      fmt++;
-      filler = '0';
+    if ((s = va_arg(*app, char *)) == 0) {
+      s = "(null)";
     }
-    
-    /* Width modifier.*/
-    if ( *fmt == '*') {
-      width = va_arg(ap, int);
-      ++fmt;
-      c = *fmt++;
+    if (precision == 0) {
+      precision = 32767;
+    }
+    for (p = s; *p && (--precision >= 0); p++)
+      ;
+    break;
+  case 'D':
+  case 'd':
+  case 'I':
+  case 'i':
+    if (is_long) {
+      l = va_arg(*app, long);
     }
     else {
-      width = 0;
-      while (true) {
-        c = *fmt++;
-        if (c == 0) {
-          return n;
-        }
-        if (c >= '0' && c <= '9') {
-          c -= '0';
-          width = width * 10 + c;
-        }
-        else {
-          break;
-        }
-      }
+      l = va_arg(*app, int);
     }
-    
-    /* Precision modifier.*/
-    precision = 0;
-    if (c == '.') {
-      c = *fmt++;
-      if (c == 0) {
-        return n;
-      }
-      if (c == '*') {
-        precision = va_arg(ap, int);
-        c = *fmt++;
-      }
-      else {
-        while (c >= '0' && c <= '9') {
-          c -= '0';
-          precision = precision * 10 + c;
-          c = *fmt++;
-          if (c == 0) {
-            return n;
-          }
-        }
-      }
+    if (l < 0) {
+      *p++ = '-';
+      l = -l;
     }
-    
-    /* Long modifier.*/
-    if (c == 'l' || c == 'L') {
-      is_long = true;
-      c = *fmt++;
-      if (c == 0) {
-        return n;
+    else
+      if (do_sign) {
+        *p++ = '+';
       }
+    p = ch_ltoa(p, l, 10);
+    break;
+#if CHPRINTF_USE_FLOAT
+  case 'f':
+    f = (float) va_arg(*app, double);
+    if (f < 0) {
+      *p++ = '-';
+      f = -f;
     }
     else {
-      is_long = (c >= 'A') && (c <= 'Z');
-    }
-
-    /* Command decoding.*/
-    switch (c) {
-    case 'c':
-      filler = ' ';
-      *p++ = va_arg(ap, int);
-      break;
-    case 's':
-      filler = ' ';
-      if ((s = va_arg(ap, char *)) == 0) {
-        s = "(null)";
-      }
-      if (precision == 0) {
-        precision = 32767;
-      }
-      for (p = s; *p && (--precision >= 0); p++)
-        ;
-      break;
-    case 'D':
-    case 'd':
-    case 'I':
-    case 'i':
-      if (is_long) {
-        l = va_arg(ap, long);
-      }
-      else {
-        l = va_arg(ap, int);
-      }
-      if (l < 0) {
-        *p++ = '-';
-        l = -l;
-      }
-      else
-        if (do_sign) {
-          *p++ = '+';
-        }
-      p = ch_ltoa(p, l, 10);
-      break;
-#if CHPRINTF_USE_FLOAT
-    case 'f':
-      f = (float) va_arg(ap, double);
-      if (f < 0) {
-        *p++ = '-';
-        f = -f;
+      if (do_sign) {
+        *p++ = '+';
       }
-      else {
-        if (do_sign) {
-          *p++ = '+';
-        }
-      }
-      p = ftoa(p, f, precision);
-      break;
+    }
+    p = ftoa(p, f, precision);
+    break;
 #endif
-    case 'X':
-    case 'x':
-    case 'P':
-    case 'p':
-      c = 16;
-      goto unsigned_common;
-    case 'U':
-    case 'u':
-      c = 10;
-      goto unsigned_common;
-    case 'O':
-    case 'o':
-      c = 8;
+  case 'X':
+  case 'x':
+  case 'P':
+  case 'p':
+    c = 16;
+    goto unsigned_common;
+  case 'U':
+  case 'u':
+    c = 10;
+    goto unsigned_common;
+  case 'O':
+  case 'o':
+    c = 8;
 unsigned_common:
-      if (is_long) {
-        l = va_arg(ap, unsigned long);
-      }
-      else {
-        l = va_arg(ap, unsigned int);
-      }
-      p = ch_ltoa(p, l, c);
-      break;
-    default:
-      *p++ = c;
-      break;
-    }
-    i = (int)(p - s);
-    if ((width -= i) < 0) {
-      width = 0;
-    }
-    if (left_align == false) {
-      width = -width;
+    if (is_long) {
+      l = va_arg(*app, unsigned long);
     }
-    if (width < 0) {
-      if ((*s == '-' || *s == '+') && filler == '0') {
-        streamPut(chp, (uint8_t)*s++);
-        n++;
-        i--;
-      }
-      do {
-        streamPut(chp, (uint8_t)filler);
-        n++;
-      } while (++width != 0);
+    else {
+      l = va_arg(*app, unsigned int);
     }
-    while (--i >= 0) {
-      streamPut(chp, (uint8_t)*s++);
-      n++;
+    p = ch_ltoa(p, l, c);
+    break;
+  default:
+    *p++ = c;
+    break;
+  }
+  i = (int)(p - s);
+  if ((width -= i) < 0) {
+    width = 0;
+  }
+  if (left_align == false) {
+    width = -width;
+  }
+  if (width < 0) {
+    if ((*s == '-' || *s == '+') && filler == '0') {
+      out_put(op, *s++);
+      i--;
     }
+    do {
+      out_put(op, filler);
+    } while (++width != 0);
+  }
+  out_write(op, s, (size_t)i);
 
-    while (width) {
-      streamPut(chp, (uint8_t)filler);
-      n++;
-      width--;
-    }
+  while (width) {
+    out_put(op, filler);
+    width--;
   }
 }
 
+/**
+ * @brief   System formatted output function.
+ * @details This function implements a minimal @p vprintf()-like functionality
+ *          with output on a @p BaseSequentialStream.
+ *          The general parameters format is: %[-][width|*][.precision|*][l|L]p.
+ *          The following parameter types (p) are supported:
+ *          - <b>x</b> hexadecimal integer.
+ *          - <b>X</b> hexadecimal long.
+ *          - <b>o</b> octal integer.
+ *          - <b>O</b> octal long.
+ *          - <b>d</b> decimal signed integer.
+ *          - <b>D</b> decimal signed long.
+ *          - <b>u</b> decimal unsigned integer.
+ *          - <b>U</b> decimal unsigned long.
+ *          - <b>c</b> character.
+ *          - <b>s</b> string.
+ *          .
+ * @note    The output is buffered on the stack and written to the stream
+ *          in chunks of @p CHPRINTF_BUFFER_SIZE bytes.
+ *
+ * @param[in] chp       pointer to a @p BaseSequentialStream implementing object
+ * @param[in] fmt       formatting string
+ * @param[in] ap        list of parameters
+ * @return              The number of bytes that would have been
+ *                      written to @p chp if no stream error occurs
+ *
+ * @api
+ */
+int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
+  output_t out;
+  chprintf_spec_t spec;
+  va_list aq;
+
+  out_init(&out, chp);
+  va_copy(aq, ap);
+  do {
+    fmt = parse_spec(fmt, &spec);
+    format_spec(&out, &spec, &aq);
+  } while (fmt != NULL);
+  va_end(aq);
+  out_flush(&out);
+
+  return out.n;
+}
+
 /**
  * @brief   System formatted output function.
  * @details This function implements a minimal @p printf() like functionality
@@ -374,6 +508,95 @@ int chprintf(BaseSequentialStream *chp, const char *fmt, ...) {
   return formatted_bytes;
 }
 
+/**
+ * @brief   Parses a format for later use.
+ * @details The formatting string is split in conversion specifications,
+ *          the parsed format can then be used with @p chprintfv() and
+ *          @p chvprintfv() skipping the parsing on each call.
+ * @note    The parsed format refers to the literal text of @p fmt, the
+ *          string must stay valid while the format is in use.
+ *
+ * @param[out] cfp      pointer to the @p chprintf_format_t object
+ * @param[out] specs    array of conversion specifications
+ * @param[in] n         number of elements in @p specs, one element is
+ *                      required for each conversion plus one
+ * @param[in] fmt       formatting string
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the format has been parsed.
+ * @retval HAL_FAILED   if the @p specs array is too small.
+ *
+ * @api
+ */
+bool chprintfparse(chprintf_format_t *cfp, chprintf_spec_t *specs,
+                   size_t n, const char *fmt) {
+  size_t i = 0U;
+
+  do {
+    if (i >= n) {
+      return HAL_FAILED;
+    }
+    fmt = parse_spec(fmt, &specs[i++]);
+  } while (fmt != NULL);
+
+  cfp->specs = specs;
+  cfp->n     = i;
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   System formatted output function using a parsed format.
+ * @details This function is equivalent to @p chvprintf() but the format
+ *          has been previously parsed using @p chprintfparse().
+ *
+ * @param[in] chp       pointer to a @p BaseSequentialStream implementing object
+ * @param[in] cfp       pointer to the parsed format
+ * @param[in] ap        list of parameters
+ * @return              The number of bytes that would have been
+ *                      written to @p chp if no stream error occurs
+ *
+ * @api
+ */
+int chvprintfv(BaseSequentialStream *chp, const chprintf_format_t *cfp,
+               va_list ap) {
+  output_t out;
+  va_list aq;
+  size_t i;
+
+  out_init(&out, chp);
+  va_copy(aq, ap);
+  for (i = 0U; i < cfp->n; i++) {
+    format_spec(&out, &cfp->specs[i], &aq);
+  }
+  va_end(aq);
+  out_flush(&out);
+
+  return out.n;
+}
+
+/**
+ * @brief   System formatted output function using a parsed format.
+ * @details This function is equivalent to @p chprintf() but the format
+ *          has been previously parsed using @p chprintfparse().
+ *
+ * @param[in] chp       pointer to a @p BaseSequentialStream implementing object
+ * @param[in] cfp       pointer to the parsed format
+ * @return              The number of bytes that would have been
+ *                      written to @p chp if no stream error occurs
+ *
+ * @api
+ */
+int chprintfv(BaseSequentialStream *chp, const chprintf_format_t *cfp, ...) {
+  va_list ap;
+  int formatted_bytes;
+
+  va_start(ap, cfp);
+  formatted_bytes = chvprintfv(chp, cfp, ap);
+  va_end(ap);
+
+  return formatted_bytes;
+}
+
 /**
  * @brief   System formatted output function.
  * @details This function implements a minimal @p snprintf()-like functionality.
@@ -34,6 +34,76 @@
 #define CHPRINTF_USE_FLOAT          FALSE
 #endif
 
+/**
+ * @brief   Size of the output buffer.
+ * @details The formatted output is accumulated in a buffer allocated on
+ *          the stack of the calling thread and written to the stream in
+ *          chunks of this size, zero disables the buffer and the output
+ *          is put on the stream one character at time.
+ */
+#if !defined(CHPRINTF_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define CHPRINTF_BUFFER_SIZE        32
+#endif
+
+/**
+ * @name    Conversion specification flags
+ * @{
+ */
+#define CHPRINTF_FLAG_LEFT          1U  /**< @brief Left alignment.        */
+#define CHPRINTF_FLAG_SIGN          2U  /**< @brief Sign always shown.     */
+#define CHPRINTF_FLAG_ZERO          4U  /**< @brief Zero filler.           */
+#define CHPRINTF_FLAG_LONG          8U  /**< @brief Long argument.         */
+#define CHPRINTF_FLAG_WIDTH_ARG     16U /**< @brief Width from arguments.  */
+#define CHPRINTF_FLAG_PREC_ARG      32U /**< @brief Precision from args.   */
+/** @} */
+
+/**
+ * @brief   Type of a parsed conversion specification.
+ * @details Each specification includes the literal text preceding the
+ *          conversion, the last specification of a format has only the
+ *          literal part.
+ */
+typedef struct {
+  /**
+   * @brief   Literal text preceding the conversion.
+   */
+  const char                *literal;
+  /**
+   * @brief   Size of the literal text.
+   */
+  size_t                    literal_size;
+  /**
+   * @brief   Field width.
+   */
+  int                       width;
+  /**
+   * @brief   Precision.
+   */
+  int                       precision;
+  /**
+   * @brief   Specification flags.
+   */
+  uint8_t                   flags;
+  /**
+   * @brief   Conversion character, zero for the final literal.
+   */
+  char                      conv;
+} chprintf_spec_t;
+
+/**
+ * @brief   Type of a parsed format.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the array of specifications.
+   */
+  const chprintf_spec_t     *specs;
+  /**
+   * @brief   Number of used specifications.
+   */
+  size_t                    n;
+} chprintf_format_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -41,6 +111,11 @@ extern "C" {
   int chprintf(BaseSequentialStream *chp, const char *fmt, ...);
   int chsnprintf(char *str, size_t size, const char *fmt, ...);
   int chvsnprintf(char *str, size_t size, const char *fmt, va_list ap);
+  bool chprintfparse(chprintf_format_t *cfp, chprintf_spec_t *specs,
+                     size_t n, const char *fmt);
+  int chvprintfv(BaseSequentialStream *chp, const chprintf_format_t *cfp,
+                 va_list ap);
+  int chprintfv(BaseSequentialStream *chp, const chprintf_format_t *cfp, ...);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,243 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    deflog.c
+ * @brief   Deferred binary log code.
+ *
+ * @addtogroup HAL_DEFERRED_LOG
+ * @details Log records are formed by a format identifier and raw argument
+ *          words, the formatting is performed on the host by the
+ *          @p tools/dlog/dlog2txt.py decoder using the strings in the ELF
+ *          file. Records are posted from any context and drained on a
+ *          @p BaseSequentialStream by a low priority thread.
+ * @{
+ */
+
+#include "hal.h"
+#include "deflog.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Reference for the format identifiers.
+ * @details Format identifiers are offsets from this object, the host
+ *          decoder locates it using the ELF symbols table.
+ */
+const char dlog_anchor[] = "DLOG";
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+static const dlog_word_t sync_word = DLOG_SYNC_WORD;
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static dlog_word_t make_header(size_t n) {
+
+  return (dlog_word_t)DLOG_RECORD_MAGIC | ((dlog_word_t)n << 8) |
+         ((dlog_word_t)osalOsGetSystemTimeX() << 16);
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Deferred log object initialization.
+ *
+ * @param[out] dlp      pointer to the @p DeferredLog object to be
+ *                      initialized
+ * @param[in] buffer    pointer to the records buffer
+ * @param[in] size      size of the buffer in words
+ *
+ * @init
+ */
+void dlogObjectInit(DeferredLog *dlp, dlog_word_t *buffer, size_t size) {
+
+  osalDbgCheck((dlp != NULL) && (buffer != NULL) &&
+               (size >= (size_t)DLOG_CFG_MAX_ARGS + 2U));
+
+  dlp->buffer = buffer;
+  dlp->size   = size;
+  dlp->rdidx  = 0U;
+  dlp->wridx  = 0U;
+  dlp->cnt    = 0U;
+  dlp->lost   = 0U;
+  dlp->thread = NULL;
+}
+
+/**
+ * @brief   Writes a log record.
+ * @details The record is copied in the buffer within a short critical
+ *          zone, if there is not enough space then the record is counted
+ *          as lost. A thread waiting in @p dlogWaitTimeout() is woken.
+ * @note    Use the @p dlogPrintf() and @p dlogPuts() macros rather than
+ *          calling this function directly.
+ *
+ * @param[in] dlp       pointer to the @p DeferredLog object
+ * @param[in] fmt       formatting string, it must be a string constant
+ * @param[in] n         number of arguments
+ * @param[in] args      pointer to the arguments
+ *
+ * @xclass
+ */
+void dlogPost(DeferredLog *dlp, const char *fmt,
+              size_t n, const dlog_word_t *args) {
+  syssts_t sts;
+  size_t i;
+
+  osalDbgCheck((dlp != NULL) && (fmt != NULL) &&
+               (n <= (size_t)DLOG_CFG_MAX_ARGS));
+
+  sts = osalSysGetStatusAndLockX();
+  if (dlp->size - dlp->cnt < n + 2U) {
+    dlp->lost++;
+    osalSysRestoreStatusX(sts);
+    return;
+  }
+  i = dlp->wridx;
+  dlp->buffer[i] = make_header(n);
+  if (++i >= dlp->size) {
+    i = 0U;
+  }
+  dlp->buffer[i] = (dlog_word_t)((uintptr_t)fmt - (uintptr_t)dlog_anchor);
+  if (++i >= dlp->size) {
+    i = 0U;
+  }
+  while (n > 0U) {
+    dlp->buffer[i] = *args++;
+    if (++i >= dlp->size) {
+      i = 0U;
+    }
+    dlp->cnt++;
+    n--;
+  }
+  dlp->wridx = i;
+  dlp->cnt += 2U;
+  osalThreadResumeI(&dlp->thread, MSG_OK);
+  osalSysRestoreStatusX(sts);
+}
+
+/**
+ * @brief   Waits for log records.
+ *
+ * @param[in] dlp       pointer to the @p DeferredLog object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if there are records to be drained.
+ * @retval MSG_TIMEOUT  if the timeout expired.
+ *
+ * @api
+ */
+msg_t dlogWaitTimeout(DeferredLog *dlp, sysinterval_t timeout) {
+  msg_t msg = MSG_OK;
+
+  osalDbgCheck(dlp != NULL);
+
+  osalSysLock();
+  if ((dlp->cnt == 0U) && (dlp->lost == 0U)) {
+    msg = osalThreadSuspendTimeoutS(&dlp->thread, timeout);
+  }
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Drains the log records on a stream.
+ * @details The records in the buffer are written on the stream preceded
+ *          by @p DLOG_SYNC_WORD and followed by a lost records notification
+ *          if records have been lost. Words are written in the target
+ *          endianness.
+ * @note    The function is meant to be called from a low priority thread,
+ *          typically looping on @p dlogWaitTimeout().
+ *
+ * @param[in] dlp       pointer to the @p DeferredLog object
+ * @param[in] chp       pointer to a @p BaseSequentialStream implementation
+ * @return              The number of bytes written.
+ *
+ * @api
+ */
+size_t dlogDrain(DeferredLog *dlp, BaseSequentialStream *chp) {
+  size_t rdidx, cnt, n, total;
+  uint32_t lost;
+
+  osalDbgCheck((dlp != NULL) && (chp != NULL));
+
+  osalSysLock();
+  rdidx = dlp->rdidx;
+  cnt   = dlp->cnt;
+  lost  = dlp->lost;
+  dlp->lost = 0U;
+  osalSysUnlock();
+
+  if ((cnt == 0U) && (lost == 0U)) {
+    return 0U;
+  }
+
+  total = streamWrite(chp, (const uint8_t *)&sync_word, sizeof (dlog_word_t));
+
+  /* Writers only fill the free space, the records between the read index
+     and the counter taken above are stable.*/
+  n = dlp->size - rdidx;
+  if (n > cnt) {
+    n = cnt;
+  }
+  total += streamWrite(chp, (const uint8_t *)&dlp->buffer[rdidx],
+                       n * sizeof (dlog_word_t));
+  if (cnt > n) {
+    total += streamWrite(chp, (const uint8_t *)&dlp->buffer[0],
+                         (cnt - n) * sizeof (dlog_word_t));
+  }
+
+  /* Records are lost when the buffer is full, the notification follows
+     the buffered records.*/
+  if (lost > 0U) {
+    dlog_word_t notification[2];
+
+    notification[0] = make_header((size_t)DLOG_LOST_NARGS);
+    notification[1] = (dlog_word_t)lost;
+    total += streamWrite(chp, (const uint8_t *)notification,
+                         sizeof (notification));
+  }
+
+  osalSysLock();
+  rdidx += cnt;
+  if (rdidx >= dlp->size) {
+    rdidx -= dlp->size;
+  }
+  dlp->rdidx = rdidx;
+  dlp->cnt  -= cnt;
+  osalSysUnlock();
+
+  return total;
+}
+
+/** @} */
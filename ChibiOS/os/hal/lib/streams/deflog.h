@@ -0,0 +1,188 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    deflog.h
+ * @brief   Deferred binary log structures and macros.
+ *
+ * @addtogroup HAL_DEFERRED_LOG
+ * @{
+ */
+
+#ifndef DEFLOG_H
+#define DEFLOG_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Synchronization word, the ASCII string "DLOG" in little endian.
+ * @details It is written in front of each drained block, the host decoder
+ *          uses it to detect the target endianness and to resynchronize.
+ */
+#define DLOG_SYNC_WORD              0x474F4C44U
+
+/**
+ * @brief   Magic value in the low byte of each record header.
+ */
+#define DLOG_RECORD_MAGIC           0xA5U
+
+/**
+ * @brief   Arguments count of the lost records notification.
+ */
+#define DLOG_LOST_NARGS             0xFFU
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of arguments of a log record.
+ */
+#if !defined(DLOG_CFG_MAX_ARGS) || defined(__DOXYGEN__)
+#define DLOG_CFG_MAX_ARGS           8
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (DLOG_CFG_MAX_ARGS < 1) || (DLOG_CFG_MAX_ARGS > 8)
+#error "DLOG_CFG_MAX_ARGS must be within 1 and 8"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a log word.
+ */
+typedef uint32_t dlog_word_t;
+
+/**
+ * @brief   Deferred log object.
+ * @details Records are formed by an header word, the format identifier and
+ *          the arguments words. The header contains @p DLOG_RECORD_MAGIC
+ *          in bits 0..7, the number of arguments in bits 8..15 and the
+ *          low 16 bits of the system time in bits 16..31.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the circular buffer.
+   */
+  dlog_word_t               *buffer;
+  /**
+   * @brief   Size of the buffer in words.
+   */
+  size_t                    size;
+  /**
+   * @brief   Read index.
+   */
+  size_t                    rdidx;
+  /**
+   * @brief   Write index.
+   */
+  size_t                    wridx;
+  /**
+   * @brief   Number of words in the buffer.
+   */
+  size_t                    cnt;
+  /**
+   * @brief   Records lost since the last drain.
+   */
+  uint32_t                  lost;
+  /**
+   * @brief   Thread waiting for records.
+   */
+  thread_reference_t        thread;
+} DeferredLog;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Counts the arguments of a variadic macro, up to 8.
+ */
+#define DLOG_NARGS(...)                                                     \
+  _DLOG_NARGS(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define _DLOG_NARGS(a1, a2, a3, a4, a5, a6, a7, a8, n, ...) n
+
+/**
+ * @brief   Encodes a constant string argument.
+ * @details The string is encoded as an offset in the program image, it must
+ *          be a string constant, the host decoder reads it from the ELF
+ *          file.
+ *
+ * @param[in] s         the string constant
+ * @return              The encoded string.
+ */
+#define DLOG_STR(s)                                                         \
+  ((dlog_word_t)((uintptr_t)(s) - (uintptr_t)dlog_anchor))
+
+/**
+ * @brief   Writes a record with arguments.
+ * @details Arguments are converted to @p dlog_word_t, the conversions of
+ *          @p chprintf() are supported with 32 bits arguments, strings
+ *          must be encoded using @p DLOG_STR().
+ * @note    The format is not parsed on the target, it must be a string
+ *          constant.
+ *
+ * @param[in] dlp       pointer to the @p DeferredLog object
+ * @param[in] fmt       formatting string
+ * @param[in] ...       arguments, from 1 to @p DLOG_CFG_MAX_ARGS
+ *
+ * @xclass
+ */
+#define dlogPrintf(dlp, fmt, ...)                                           \
+  dlogPost(dlp, fmt, DLOG_NARGS(__VA_ARGS__),                               \
+           (const dlog_word_t []){__VA_ARGS__})
+
+/**
+ * @brief   Writes a record without arguments.
+ * @note    The message is not parsed on the target, it must be a string
+ *          constant.
+ *
+ * @param[in] dlp       pointer to the @p DeferredLog object
+ * @param[in] msg       message string
+ *
+ * @xclass
+ */
+#define dlogPuts(dlp, msg) dlogPost(dlp, msg, 0U, NULL)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern const char dlog_anchor[];
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dlogObjectInit(DeferredLog *dlp, dlog_word_t *buffer, size_t size);
+  void dlogPost(DeferredLog *dlp, const char *fmt,
+                size_t n, const dlog_word_t *args);
+  msg_t dlogWaitTimeout(DeferredLog *dlp, sysinterval_t timeout);
+  size_t dlogDrain(DeferredLog *dlp, BaseSequentialStream *chp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEFLOG_H */
+
+/** @} */
@@ -3,7 +3,8 @@ STREAMSSRC = $(CHIBIOS)/os/hal/lib/streams/chprintf.c \
              $(CHIBIOS)/os/hal/lib/streams/chscanf.c \
              $(CHIBIOS)/os/hal/lib/streams/memstreams.c \
              $(CHIBIOS)/os/hal/lib/streams/nullstreams.c \
-             $(CHIBIOS)/os/hal/lib/streams/bufstreams.c
+             $(CHIBIOS)/os/hal/lib/streams/bufstreams.c \
+             $(CHIBIOS)/os/hal/lib/streams/deflog.c
 
 STREAMSINC = $(CHIBIOS)/os/hal/lib/streams
 
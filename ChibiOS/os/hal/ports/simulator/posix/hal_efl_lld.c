@@ -0,0 +1,571 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_efl_lld.c
+ * @brief   Posix simulator Embedded Flash subsystem low level driver source.
+ * @details The flash array follows NOR semantics, erased bytes are 0xFF and
+ *          programming can only clear bits. The contents of a volatile
+ *          array survive @p eflStop(), a file-backed array also survives
+ *          the process.
+ *
+ * @addtogroup HAL_EFL
+ * @{
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "hal.h"
+
+#if (HAL_USE_EFL == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define SIM_EFL_SIZE                        (SIM_EFL_SECTOR_SIZE *          \
+                                             SIM_EFL_SECTORS_COUNT)
+
+#define SIM_EFL_PAGE_MASK                   (SIM_EFL_PAGE_SIZE - 1U)
+
+#define NSEC_PER_USEC                       1000ULL
+#define NSEC_PER_MSEC                       1000000ULL
+#define NSEC_PER_SEC                        1000000000ULL
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   EFL1 driver identifier.
+ */
+EFlashDriver EFLD1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static uint64_t sim_efl_get_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * NSEC_PER_SEC) + (uint64_t)ts.tv_nsec;
+}
+
+static void sim_efl_delay_ns(uint64_t ns) {
+  uint64_t end;
+
+  if (ns == 0U) {
+    return;
+  }
+
+  end = sim_efl_get_ns() + ns;
+  while (sim_efl_get_ns() < end) {
+  }
+}
+
+static uint8_t *sim_efl_map_file(EFlashDriver *eflp, const char *path) {
+  struct stat st;
+  uint8_t *p;
+
+  eflp->fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (eflp->fd == -1) {
+    printf("EFL1: Unable to open %s\n", path);
+    goto abort;
+  }
+
+  if (fstat(eflp->fd, &st) != 0) {
+    printf("EFL1: Unable to access %s\n", path);
+    goto abort;
+  }
+
+  /* Files with unexpected size are reinitialized as an erased array.*/
+  if (st.st_size != (off_t)SIM_EFL_SIZE) {
+    if (ftruncate(eflp->fd, (off_t)SIM_EFL_SIZE) != 0) {
+      printf("EFL1: Unable to resize %s\n", path);
+      goto abort;
+    }
+  }
+
+  p = mmap(NULL, SIM_EFL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED,
+           eflp->fd, 0);
+  if (p == MAP_FAILED) {
+    printf("EFL1: Unable to map %s\n", path);
+    goto abort;
+  }
+
+  if (st.st_size != (off_t)SIM_EFL_SIZE) {
+    memset(p, 0xFF, SIM_EFL_SIZE);
+  }
+
+  return p;
+
+abort:
+  if (eflp->fd != -1)
+    close(eflp->fd);
+  exit(1);
+}
+
+static uint8_t *sim_efl_map_volatile(void) {
+  uint8_t *p;
+
+  p = mmap(NULL, SIM_EFL_SIZE, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) {
+    printf("EFL1: Unable to allocate the flash array\n");
+    exit(1);
+  }
+  memset(p, 0xFF, SIM_EFL_SIZE);
+
+  return p;
+}
+
+static void sim_efl_erase_sectors(EFlashDriver *eflp, flash_sector_t first,
+                                  flash_sector_t n) {
+
+  /* The erase is performed immediately, the array is only reported busy
+     until the simulated erase time is elapsed.*/
+  eflp->erase_end_ns = sim_efl_get_ns() +
+                       ((uint64_t)SIM_EFL_ERASE_TIME_MS * NSEC_PER_MSEC * n);
+  eflp->state = FLASH_ERASE;
+
+  memset(eflp->descriptor.address + (first * SIM_EFL_SECTOR_SIZE),
+         0xFF, n * SIM_EFL_SECTOR_SIZE);
+  while (n > 0U) {
+    eflp->erase_cycles[first]++;
+    first++;
+    n--;
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level Embedded Flash driver initialization.
+ *
+ * @notapi
+ */
+void efl_lld_init(void) {
+
+  /* Driver initialization.*/
+  eflObjectInit(&EFLD1);
+  EFLD1.descriptor.attributes    = FLASH_ATTR_ERASED_IS_ONE |
+                                   FLASH_ATTR_MEMORY_MAPPED;
+  EFLD1.descriptor.page_size     = SIM_EFL_PAGE_SIZE;
+  EFLD1.descriptor.sectors_count = SIM_EFL_SECTORS_COUNT;
+  EFLD1.descriptor.sectors       = NULL;
+  EFLD1.descriptor.sectors_size  = SIM_EFL_SECTOR_SIZE;
+  EFLD1.descriptor.address       = NULL;
+  EFLD1.descriptor.size          = SIM_EFL_SIZE;
+  EFLD1.fd                       = -1;
+  EFLD1.pgm_budget               = 0U;
+  EFLD1.powered_off              = false;
+  efl_lld_reset_counters(&EFLD1);
+}
+
+/**
+ * @brief   Configures and activates the Embedded Flash peripheral.
+ * @details The flash array is allocated on first activation, restarting
+ *          the driver also restores power after a simulated power loss.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ *
+ * @notapi
+ */
+void efl_lld_start(EFlashDriver *eflp) {
+
+  if (eflp->descriptor.address == NULL) {
+    if ((eflp->config != NULL) && (eflp->config->path != NULL)) {
+      eflp->descriptor.address = sim_efl_map_file(eflp, eflp->config->path);
+    }
+    else {
+      eflp->descriptor.address = sim_efl_map_volatile();
+    }
+  }
+
+  eflp->pgm_budget  = 0U;
+  eflp->powered_off = false;
+}
+
+/**
+ * @brief   Deactivates the Embedded Flash peripheral.
+ * @details A file-backed array is synchronized and released, a volatile
+ *          array is retained for the next activation.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ *
+ * @notapi
+ */
+void efl_lld_stop(EFlashDriver *eflp) {
+
+  if (eflp->fd != -1) {
+    (void) msync(eflp->descriptor.address, SIM_EFL_SIZE, MS_SYNC);
+    (void) munmap(eflp->descriptor.address, SIM_EFL_SIZE);
+    close(eflp->fd);
+    eflp->fd = -1;
+    eflp->descriptor.address = NULL;
+  }
+}
+
+/**
+ * @brief   Gets the flash descriptor structure.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @return                          A flash device descriptor.
+ *
+ * @notapi
+ */
+const flash_descriptor_t *efl_lld_get_descriptor(void *instance) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  return &devp->descriptor;
+}
+
+/**
+ * @brief   Read operation.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @param[in] offset                offset within full flash address space
+ * @param[in] n                     number of bytes to be read
+ * @param[out] rp                   pointer to the data buffer
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_HW_FAILURE   if the power has been lost.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_read(void *instance, flash_offset_t offset,
+                           size_t n, uint8_t *rp) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  osalDbgCheck((instance != NULL) && (rp != NULL) && (n > 0U));
+  osalDbgCheck((size_t)offset + n <= (size_t)devp->descriptor.size);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  if (devp->powered_off) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+
+  /* No reading while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* FLASH_READ state while the operation is performed.*/
+  devp->state = FLASH_READ;
+
+  memcpy((void *)rp, (const void *)(devp->descriptor.address + offset), n);
+  devp->read_bytes += (uint64_t)n;
+
+  /* Ready state again.*/
+  devp->state = FLASH_READY;
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Program operation.
+ * @note    Programming can only clear bits, the new content is the AND
+ *          of the old content and the programmed data.
+ * @note    If a power loss is armed and the budget is exhausted then the
+ *          page in progress is not written and the power is lost.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @param[in] offset                offset within full flash address space
+ * @param[in] n                     number of bytes to be programmed
+ * @param[in] pp                    pointer to the data buffer
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_PROGRAM      if the power has been lost during the
+ *                                  operation.
+ * @retval FLASH_ERROR_HW_FAILURE   if the power has been lost.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_program(void *instance, flash_offset_t offset,
+                              size_t n, const uint8_t *pp) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  flash_error_t err = FLASH_NO_ERROR;
+
+  osalDbgCheck((instance != NULL) && (pp != NULL) && (n > 0U));
+  osalDbgCheck((size_t)offset + n <= (size_t)devp->descriptor.size);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  if (devp->powered_off) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+
+  /* No programming while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* FLASH_PGM state while the operation is performed.*/
+  devp->state = FLASH_PGM;
+
+  /* Programming one page at time.*/
+  while (n > 0U) {
+    uint8_t *p = devp->descriptor.address + offset;
+    size_t chunk;
+
+    chunk = SIM_EFL_PAGE_SIZE - (offset & SIM_EFL_PAGE_MASK);
+    if (chunk > n) {
+      chunk = n;
+    }
+
+    /* Simulated power loss before the page is committed.*/
+    if (devp->pgm_budget > 0U) {
+      devp->pgm_budget--;
+      if (devp->pgm_budget == 0U) {
+        devp->powered_off = true;
+        err = FLASH_ERROR_PROGRAM;
+        break;
+      }
+    }
+
+    sim_efl_delay_ns((uint64_t)SIM_EFL_PROGRAM_TIME_US * NSEC_PER_USEC);
+
+    offset += (flash_offset_t)chunk;
+    n      -= chunk;
+    while (chunk > 0U) {
+      *p++ &= *pp++;
+      chunk--;
+    }
+    devp->programmed_pages++;
+  }
+
+  /* Ready state again.*/
+  devp->state = FLASH_READY;
+
+  return err;
+}
+
+/**
+ * @brief   Starts a whole-device erase operation.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_HW_FAILURE   if the power has been lost.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_start_erase_all(void *instance) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  if (devp->powered_off) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+
+  /* No erasing while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  sim_efl_erase_sectors(devp, 0U, SIM_EFL_SECTORS_COUNT);
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Starts an sector erase operation.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @param[in] sector                sector to be erased
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_HW_FAILURE   if the power has been lost.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_start_erase_sector(void *instance,
+                                         flash_sector_t sector) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgCheck(sector < devp->descriptor.sectors_count);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  if (devp->powered_off) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+
+  /* No erasing while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  sim_efl_erase_sectors(devp, sector, 1U);
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Queries the driver for erase operation progress.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @param[out] msec                 recommended time, in milliseconds, that
+ *                                  should be spent before calling this
+ *                                  function again, can be @p NULL
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_HW_FAILURE   if the power has been lost.
+ *
+ * @api
+ */
+flash_error_t efl_lld_query_erase(void *instance, uint32_t *msec) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  uint64_t now;
+
+  if (devp->powered_off) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+
+  /* If there is an erase in progress then the deadline must be checked.*/
+  if (devp->state == FLASH_ERASE) {
+    now = sim_efl_get_ns();
+    if (now < devp->erase_end_ns) {
+      /* Remaining time, rounded up.*/
+      if (msec != NULL) {
+        *msec = (uint32_t)((devp->erase_end_ns - now + NSEC_PER_MSEC - 1U) /
+                           NSEC_PER_MSEC);
+      }
+
+      return FLASH_BUSY_ERASING;
+    }
+
+    /* Back to ready state.*/
+    devp->state = FLASH_READY;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Returns the erase state of a sector.
+ *
+ * @param[in] ip                    pointer to a @p EFlashDriver instance
+ * @param[in] sector                sector to be verified
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if the sector is erased.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_VERIFY       if the verify operation failed.
+ * @retval FLASH_ERROR_HW_FAILURE   if the power has been lost.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_verify_erase(void *instance, flash_sector_t sector) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  flash_error_t err = FLASH_NO_ERROR;
+  const uint8_t *p;
+  unsigned i;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgCheck(sector < devp->descriptor.sectors_count);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  if (devp->powered_off) {
+    return FLASH_ERROR_HW_FAILURE;
+  }
+
+  /* No verifying while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* FLASH_READ state while the operation is performed.*/
+  devp->state = FLASH_READ;
+
+  /* Scanning the sector space.*/
+  p = devp->descriptor.address + (sector * SIM_EFL_SECTOR_SIZE);
+  for (i = 0U; i < SIM_EFL_SECTOR_SIZE; i++) {
+    if (p[i] != 0xFFU) {
+      err = FLASH_ERROR_VERIFY;
+      break;
+    }
+  }
+
+  /* Ready state again.*/
+  devp->state = FLASH_READY;
+
+  return err;
+}
+
+/**
+ * @brief   Arms a simulated power loss.
+ * @details The power is lost when the specified page program operation is
+ *          attempted, that page is not written. All operations then fail
+ *          with @p FLASH_ERROR_HW_FAILURE until the driver is restarted.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ * @param[in] pages     number of the page program operation causing the
+ *                      power loss, starting from one, zero disarms
+ *
+ * @api
+ */
+void efl_lld_set_power_loss(EFlashDriver *eflp, uint32_t pages) {
+
+  osalDbgCheck(eflp != NULL);
+
+  eflp->pgm_budget = pages;
+}
+
+/**
+ * @brief   Resets the wear and traffic counters.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ *
+ * @api
+ */
+void efl_lld_reset_counters(EFlashDriver *eflp) {
+
+  osalDbgCheck(eflp != NULL);
+
+  memset(eflp->erase_cycles, 0, sizeof eflp->erase_cycles);
+  eflp->programmed_pages = 0U;
+  eflp->read_bytes       = 0U;
+}
+
+#endif /* HAL_USE_EFL == TRUE */
+
+/** @} */
@@ -0,0 +1,172 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_efl_lld.h
+ * @brief   Posix simulator Embedded Flash subsystem low level driver header.
+ * @details The simulated flash is a NOR array held in host memory, either
+ *          anonymous or mapped from a file, it can be used for running the
+ *          flash-based libraries on the host.
+ *
+ * @addtogroup HAL_EFL
+ * @{
+ */
+
+#ifndef HAL_EFL_LLD_H
+#define HAL_EFL_LLD_H
+
+#if (HAL_USE_EFL == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Posix simulator EFL configuration options
+ * @{
+ */
+/**
+ * @brief   Size of the simulated flash sectors.
+ */
+#if !defined(SIM_EFL_SECTOR_SIZE) || defined(__DOXYGEN__)
+#define SIM_EFL_SECTOR_SIZE                 4096U
+#endif
+
+/**
+ * @brief   Number of simulated flash sectors.
+ */
+#if !defined(SIM_EFL_SECTORS_COUNT) || defined(__DOXYGEN__)
+#define SIM_EFL_SECTORS_COUNT               8U
+#endif
+
+/**
+ * @brief   Size of the simulated program pages.
+ * @details Program operations are split at page boundaries, latency and
+ *          power loss are accounted per page.
+ */
+#if !defined(SIM_EFL_PAGE_SIZE) || defined(__DOXYGEN__)
+#define SIM_EFL_PAGE_SIZE                   256U
+#endif
+
+/**
+ * @brief   Simulated time required for programming a page.
+ * @note    The time is busy-waited, zero means no delay.
+ */
+#if !defined(SIM_EFL_PROGRAM_TIME_US) || defined(__DOXYGEN__)
+#define SIM_EFL_PROGRAM_TIME_US             0U
+#endif
+
+/**
+ * @brief   Simulated time required for erasing a sector.
+ * @note    The erase is reported as in progress until the time is
+ *          elapsed, zero means immediate completion.
+ */
+#if !defined(SIM_EFL_ERASE_TIME_MS) || defined(__DOXYGEN__)
+#define SIM_EFL_ERASE_TIME_MS               0U
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (SIM_EFL_SECTOR_SIZE % SIM_EFL_PAGE_SIZE) != 0U
+#error "SIM_EFL_SECTOR_SIZE must be a multiple of SIM_EFL_PAGE_SIZE"
+#endif
+
+#if (SIM_EFL_PAGE_SIZE & (SIM_EFL_PAGE_SIZE - 1U)) != 0U
+#error "SIM_EFL_PAGE_SIZE must be a power of two"
+#endif
+
+#if SIM_EFL_SECTORS_COUNT < 1U
+#error "invalid SIM_EFL_SECTORS_COUNT value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the embedded flash driver structure.
+ */
+#define efl_lld_driver_fields                                               \
+  /* Device descriptor, the address points to the host memory.*/           \
+  flash_descriptor_t        descriptor;                                     \
+  /* File descriptor of the backing file or -1.*/                           \
+  int                       fd;                                             \
+  /* Time of completion of the current erase operation.*/                   \
+  uint64_t                  erase_end_ns;                                   \
+  /* Number of erase cycles of each sector.*/                               \
+  uint32_t                  erase_cycles[SIM_EFL_SECTORS_COUNT];            \
+  /* Total number of programmed pages.*/                                    \
+  uint32_t                  programmed_pages;                               \
+  /* Total number of bytes read.*/                                          \
+  uint64_t                  read_bytes;                                     \
+  /* Pages still allowed before a power loss, zero if disabled.*/           \
+  uint32_t                  pgm_budget;                                     \
+  /* Power lost, all operations fail until the driver is restarted.*/       \
+  bool                      powered_off;
+
+/**
+ * @brief   Low level fields of the embedded flash configuration structure.
+ */
+#define efl_lld_config_fields                                               \
+  /* Path of the backing file, the flash is volatile if NULL.*/             \
+  const char                *path
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(__DOXYGEN__)
+extern EFlashDriver EFLD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void efl_lld_init(void);
+  void efl_lld_start(EFlashDriver *eflp);
+  void efl_lld_stop(EFlashDriver *eflp);
+  const flash_descriptor_t *efl_lld_get_descriptor(void *instance);
+  flash_error_t efl_lld_read(void *instance, flash_offset_t offset,
+                             size_t n, uint8_t *rp);
+  flash_error_t efl_lld_program(void *instance, flash_offset_t offset,
+                                size_t n, const uint8_t *pp);
+  flash_error_t efl_lld_start_erase_all(void *instance);
+  flash_error_t efl_lld_start_erase_sector(void *instance,
+                                           flash_sector_t sector);
+  flash_error_t efl_lld_query_erase(void *instance, uint32_t *msec);
+  flash_error_t efl_lld_verify_erase(void *instance, flash_sector_t sector);
+  void efl_lld_set_power_loss(EFlashDriver *eflp, uint32_t pages);
+  void efl_lld_reset_counters(EFlashDriver *eflp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_EFL == TRUE */
+
+#endif /* HAL_EFL_LLD_H */
+
+/** @} */
@@ -24,7 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <sys/time.h>
+#include <sys/select.h>
 
 #include "hal.h"
 
@@ -36,9 +36,6 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
-static struct timeval nextcnt;
-static struct timeval tick = {0UL, 1000000UL / OSAL_ST_FREQUENCY};
-
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -61,15 +58,12 @@ void hal_lld_init(void) {
 #else
   puts("ChibiOS/RT simulator (Linux)\n");
 #endif
-  gettimeofday(&nextcnt, NULL);
-  timeradd(&nextcnt, &tick, &nextcnt);
 }
 
 /**
  * @brief   Interrupt simulation.
  */
 void _sim_check_for_interrupts(void) {
-  struct timeval tv;
   bool int_occurred = false;
 
 #if HAL_USE_SERIAL
@@ -78,19 +72,17 @@ void _sim_check_for_interrupts(void) {
   }
 #endif
 
-  gettimeofday(&tv, NULL);
-  if (timercmp(&tv, &nextcnt, >=)) {
+#if OSAL_ST_MODE != OSAL_ST_MODE_NONE
+  if (st_lld_is_interrupt_pending()) {
     int_occurred = true;
-    timeradd(&nextcnt, &tick, &nextcnt);
 
     CH_IRQ_PROLOGUE();
 
-    chSysLockFromISR();
-    chSysTimerHandlerI();
-    chSysUnlockFromISR();
+    st_lld_serve_interrupt();
 
     CH_IRQ_EPILOGUE();
   }
+#endif
 
   if (int_occurred) {
     __dbg_check_lock();
@@ -100,4 +92,39 @@ void _sim_check_for_interrupts(void) {
   }
 }
 
+/**
+ * @brief   Waits for an interrupt.
+ * @details The host thread is suspended until the next timer event or
+ *          until activity is detected on the simulated serial ports, then
+ *          the pending interrupts are served.
+ */
+void _sim_wait_for_interrupt(void) {
+  fd_set rfds, wfds;
+  struct timeval tv, *tvp = NULL;
+  int nfds = 0;
+
+  FD_ZERO(&rfds);
+  FD_ZERO(&wfds);
+
+#if HAL_USE_SERIAL
+  nfds = sd_lld_get_wait_fds(&rfds, &wfds);
+#endif
+
+#if OSAL_ST_MODE != OSAL_ST_MODE_NONE
+  int64_t ns = st_lld_get_timeout();
+  if (ns != ST_LLD_NO_TIMEOUT) {
+    tv.tv_sec  = (time_t)(ns / 1000000000LL);
+    tv.tv_usec = (suseconds_t)(((ns % 1000000000LL) + 999LL) / 1000LL);
+    tvp = &tv;
+  }
+#endif
+
+  /* Waiting for an fd or the next timer deadline, else just polling.*/
+  if ((nfds > 0) || (tvp != NULL)) {
+    (void) select(nfds, &rfds, &wfds, NULL, tvp);
+  }
+
+  _sim_check_for_interrupts();
+}
+
 /** @} */
@@ -144,6 +144,26 @@ abort:
   exit(1);
 }
 
+static int waitfds(SerialDriver *sdp, fd_set *rfds, fd_set *wfds, int nfds) {
+
+  if (sdp->com_data != -1) {
+    FD_SET(sdp->com_data, rfds);
+    if (!oqIsEmptyI(&sdp->oqueue)) {
+      FD_SET(sdp->com_data, wfds);
+    }
+    if (sdp->com_data >= nfds) {
+      nfds = sdp->com_data + 1;
+    }
+  }
+  else if (sdp->com_listen != -1) {
+    FD_SET(sdp->com_listen, rfds);
+    if (sdp->com_listen >= nfds) {
+      nfds = sdp->com_listen + 1;
+    }
+  }
+  return nfds;
+}
+
 static bool inint(SerialDriver *sdp) {
 
   if (sdp->com_data != -1) {
@@ -293,6 +313,29 @@ bool sd_lld_interrupt_pending(void) {
   return b;
 }
 
+/**
+ * @brief   Collects the sockets able to generate serial events.
+ * @note    Data sockets are added to the write set only if there is
+ *          data waiting to be transmitted.
+ *
+ * @param[out] rfds     set of sockets to be monitored for input
+ * @param[out] wfds     set of sockets to be monitored for output
+ * @return              The highest socket number plus one, zero if there
+ *                      are no sockets to be monitored.
+ */
+int sd_lld_get_wait_fds(fd_set *rfds, fd_set *wfds) {
+  int nfds = 0;
+
+#if USE_SIM_SERIAL1
+  nfds = waitfds(&SD1, rfds, wfds, nfds);
+#endif
+#if USE_SIM_SERIAL2
+  nfds = waitfds(&SD2, rfds, wfds, nfds);
+#endif
+
+  return nfds;
+}
+
 #endif /* HAL_USE_SERIAL */
 
 /** @} */
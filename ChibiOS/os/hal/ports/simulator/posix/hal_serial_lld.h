@@ -132,6 +132,7 @@ extern "C" {
   void sd_lld_start(SerialDriver *sdp, const SerialConfig *config);
   void sd_lld_stop(SerialDriver *sdp);
   bool sd_lld_interrupt_pending(void);
+  int sd_lld_get_wait_fds(fd_set *rfds, fd_set *wfds);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,308 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_st_lld.c
+ * @brief   Posix simulator ST subsystem low level driver source.
+ * @details The simulated timer is a free running counter derived from
+ *          @p CLOCK_MONOTONIC, the periodic tick and the one-shot alarm
+ *          are both compared against it.
+ *
+ * @addtogroup ST
+ * @{
+ */
+
+#include <time.h>
+
+#include "hal.h"
+
+#if (OSAL_ST_MODE != OSAL_ST_MODE_NONE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define NSEC_PER_SEC                        1000000000ULL
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Monotonic time at driver initialization.
+ */
+static struct timespec st_base;
+
+/**
+ * @brief   Next event as an absolute 64 bits ticks count.
+ * @note    In periodic mode this is the next tick, in free running mode it
+ *          is the alarm time.
+ */
+static uint64_t st_next;
+
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Alarm compare value.
+ */
+static systime_t st_alarm;
+
+/**
+ * @brief   Alarm interrupt enabled.
+ */
+static bool st_alarm_enabled;
+
+/**
+ * @brief   Alarm not yet triggered since last programmed.
+ */
+static bool st_alarm_armed;
+#endif
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Nanoseconds elapsed since driver initialization.
+ */
+static uint64_t st_get_elapsed_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)(ts.tv_sec - st_base.tv_sec) * NSEC_PER_SEC) +
+         (uint64_t)ts.tv_nsec - (uint64_t)st_base.tv_nsec;
+}
+
+/**
+ * @brief   Converts nanoseconds to ticks, rounding down.
+ */
+static uint64_t st_ns2ticks(uint64_t ns) {
+
+  return ((ns / NSEC_PER_SEC) * (uint64_t)OSAL_ST_FREQUENCY) +
+         (((ns % NSEC_PER_SEC) * (uint64_t)OSAL_ST_FREQUENCY) / NSEC_PER_SEC);
+}
+
+/**
+ * @brief   Converts ticks to nanoseconds, rounding up.
+ */
+static uint64_t st_ticks2ns(uint64_t ticks) {
+
+  return ((ticks / (uint64_t)OSAL_ST_FREQUENCY) * NSEC_PER_SEC) +
+         ((((ticks % (uint64_t)OSAL_ST_FREQUENCY) * NSEC_PER_SEC) +
+           (uint64_t)OSAL_ST_FREQUENCY - 1ULL) / (uint64_t)OSAL_ST_FREQUENCY);
+}
+
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Arms the alarm on the next match of the compare value.
+ * @note    A compare value already in the past is considered due
+ *          immediately, the host can delay the simulator by more than
+ *          @p CH_CFG_ST_TIMEDELTA ticks and an early alarm is harmless
+ *          while a lost one is not.
+ */
+static void st_arm_alarm(systime_t abstime) {
+  uint64_t now = st_ns2ticks(st_get_elapsed_ns());
+  systime_t delta = (systime_t)(abstime - (systime_t)now);
+
+  if (delta > (systime_t)(((systime_t)-1) / (systime_t)2)) {
+    delta = (systime_t)0;
+  }
+
+  st_alarm = abstime;
+  st_next  = now + (uint64_t)delta;
+  st_alarm_armed = true;
+}
+#endif
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level ST driver initialization.
+ *
+ * @notapi
+ */
+void st_lld_init(void) {
+
+  clock_gettime(CLOCK_MONOTONIC, &st_base);
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+  st_next = 1U;
+#else
+  st_alarm = (systime_t)0;
+  st_alarm_enabled = false;
+  st_alarm_armed = false;
+#endif
+}
+
+/**
+ * @brief   Checks for a pending timer interrupt.
+ *
+ * @return              The interrupt status.
+ * @retval false        if there is no pending interrupt.
+ * @retval true         if the tick or the alarm are due.
+ *
+ * @notapi
+ */
+bool st_lld_is_interrupt_pending(void) {
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  if (!st_alarm_enabled || !st_alarm_armed) {
+    return false;
+  }
+#endif
+
+  return st_ns2ticks(st_get_elapsed_ns()) >= st_next;
+}
+
+/**
+ * @brief   Nanoseconds until the next timer interrupt.
+ * @note    Used by the idle loop in order to sleep the host thread.
+ *
+ * @return              The time to the next interrupt in nanoseconds.
+ * @retval ST_LLD_NO_TIMEOUT if no interrupt is scheduled.
+ *
+ * @notapi
+ */
+int64_t st_lld_get_timeout(void) {
+  uint64_t now, next;
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  if (!st_alarm_enabled || !st_alarm_armed) {
+    return ST_LLD_NO_TIMEOUT;
+  }
+#endif
+
+  now  = st_get_elapsed_ns();
+  next = st_ticks2ns(st_next);
+
+  return next > now ? (int64_t)(next - now) : (int64_t)0;
+}
+
+/**
+ * @brief   Serves the simulated timer interrupt.
+ *
+ * @notapi
+ */
+void st_lld_serve_interrupt(void) {
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+  /* One tick per served interrupt, late ticks are recovered on the
+     following checks.*/
+  st_next++;
+#else
+  /* The compare match fires once, the kernel reprograms the alarm from
+     within the handler if required.*/
+  st_alarm_armed = false;
+#endif
+
+  osalSysLockFromISR();
+  osalOsTimerHandlerI();
+  osalSysUnlockFromISR();
+}
+
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the time counter value.
+ *
+ * @return              The counter value.
+ *
+ * @notapi
+ */
+systime_t st_lld_get_counter(void) {
+
+  return (systime_t)st_ns2ticks(st_get_elapsed_ns());
+}
+
+/**
+ * @brief   Starts the alarm.
+ * @note    Makes sure that no spurious alarms are triggered after
+ *          this call.
+ *
+ * @param[in] abstime   the time to be set for the first alarm
+ *
+ * @notapi
+ */
+void st_lld_start_alarm(systime_t abstime) {
+
+  st_arm_alarm(abstime);
+  st_alarm_enabled = true;
+}
+
+/**
+ * @brief   Stops the alarm interrupt.
+ *
+ * @notapi
+ */
+void st_lld_stop_alarm(void) {
+
+  st_alarm_enabled = false;
+  st_alarm_armed = false;
+}
+
+/**
+ * @brief   Sets the alarm time.
+ *
+ * @param[in] abstime   the time to be set for the next alarm
+ *
+ * @notapi
+ */
+void st_lld_set_alarm(systime_t abstime) {
+
+  st_arm_alarm(abstime);
+}
+
+/**
+ * @brief   Returns the current alarm time.
+ *
+ * @return              The currently set alarm time.
+ *
+ * @notapi
+ */
+systime_t st_lld_get_alarm(void) {
+
+  return st_alarm;
+}
+
+/**
+ * @brief   Determines if the alarm is active.
+ *
+ * @return              The alarm status.
+ * @retval false        if the alarm is not active.
+ * @retval true         is the alarm is active
+ *
+ * @notapi
+ */
+bool st_lld_is_alarm_active(void) {
+
+  return st_alarm_enabled;
+}
+#endif /* OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING */
+
+#endif /* OSAL_ST_MODE != OSAL_ST_MODE_NONE */
+
+/** @} */
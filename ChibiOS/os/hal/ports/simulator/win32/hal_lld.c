@@ -107,4 +107,13 @@ void _sim_check_for_interrupts(void) {
   }
 }
 
+/**
+ * @brief   Waits for an interrupt.
+ * @note    Simply polls the simulated interrupt sources.
+ */
+void _sim_wait_for_interrupt(void) {
+
+  _sim_check_for_interrupts();
+}
+
 /** @} */
@@ -15,7 +15,7 @@
 */
 
 /**
- * @file    hal_st_lld.c
+ * @file    simulator/win32/hal_st_lld.c
  * @brief   PLATFORM ST subsystem low level driver source.
  *
  * @addtogroup ST
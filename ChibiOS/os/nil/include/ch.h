@@ -183,6 +183,18 @@
 #include "chconf.h"
 #include "chlicense.h"
 
+/**
+ * @brief   Waiters and timeouts bitmaps.
+ * @details If enabled then each threads queue keeps a bitmap of its waiting
+ *          threads and the kernel keeps a bitmap of the threads having an
+ *          armed timeout. Dequeue operations and the system tick processing
+ *          do not need to scan the whole threads array.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_WAIT_BITMAPS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_WAIT_BITMAPS             FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -329,7 +341,11 @@
 #error "at least one thread must be defined"
 #endif
 
-#if CH_CFG_MAX_THREADS > 16
+#if (CH_CFG_USE_WAIT_BITMAPS == TRUE) && (CH_CFG_MAX_THREADS > 32)
+#error "CH_CFG_MAX_THREADS cannot exceed 32 with CH_CFG_USE_WAIT_BITMAPS"
+#endif
+
+#if (CH_CFG_USE_WAIT_BITMAPS == FALSE) && (CH_CFG_MAX_THREADS > 16)
 #error "ChibiOS/NIL is not recommended for thread-intensive applications,"  \
        "consider ChibiOS/RT instead"
 #endif
@@ -486,6 +502,19 @@ typedef struct nil_threads_queue threads_queue_t;
 typedef threads_queue_t semaphore_t;
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
+#if (CH_CFG_USE_WAIT_BITMAPS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a threads bitmap, one bit for each thread slot.
+ */
+#if (CH_CFG_MAX_THREADS <= 8) || defined(__DOXYGEN__)
+typedef uint8_t nil_bitmap_t;
+#elif CH_CFG_MAX_THREADS <= 16
+typedef uint16_t nil_bitmap_t;
+#else
+typedef uint32_t nil_bitmap_t;
+#endif
+#endif /* CH_CFG_USE_WAIT_BITMAPS == TRUE */
+
 /* Late inclusion of port core layer.*/
 #include "chcore.h"
 
@@ -494,6 +523,9 @@ typedef threads_queue_t semaphore_t;
  */
 struct nil_threads_queue {
   volatile cnt_t    cnt;        /**< @brief Threads Queue counter.          */
+#if (CH_CFG_USE_WAIT_BITMAPS == TRUE) || defined(__DOXYGEN__)
+  nil_bitmap_t      waiters;    /**< @brief Waiting threads bitmap.         */
+#endif
 };
 
 /**
@@ -577,6 +609,12 @@ struct nil_os_instance {
    */
   systime_t             nexttime;
 #endif
+#if (CH_CFG_USE_WAIT_BITMAPS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Bitmap of the threads having an armed timeout.
+   */
+  nil_bitmap_t          timeouts;
+#endif
 #if (CH_DBG_SYSTEM_STATE_CHECK == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   ISR nesting level.
@@ -961,7 +999,11 @@ struct nil_os_instance {
  *
  * @param[in] name      the name of the threads queue variable
  */
+#if (CH_CFG_USE_WAIT_BITMAPS == TRUE) || defined(__DOXYGEN__)
+#define __THREADS_QUEUE_DATA(name) {(cnt_t)0, (nil_bitmap_t)0}
+#else
 #define __THREADS_QUEUE_DATA(name) {(cnt_t)0}
+#endif
 
 /**
  * @brief   Static threads queue object initializer.
@@ -1223,7 +1265,14 @@ struct nil_os_instance {
  *
  * @init
  */
+#if (CH_CFG_USE_WAIT_BITMAPS == TRUE) || defined(__DOXYGEN__)
+#define chThdQueueObjectInit(tqp) do {                                      \
+  (tqp)->cnt = (cnt_t)0;                                                    \
+  (tqp)->waiters = (nil_bitmap_t)0;                                         \
+} while (false)
+#else
 #define chThdQueueObjectInit(tqp) ((tqp)->cnt = (cnt_t)0)
+#endif
 
 /**
  * @brief   Evaluates to @p true if the specified queue is empty.
@@ -1389,6 +1438,7 @@ extern const thread_descriptor_t nil_thd_configs[];
 extern "C" {
 #endif
   thread_t *nil_find_thread(tstate_t state, void *p);
+  thread_t *nil_find_waiter(threads_queue_t *tqp);
   cnt_t nil_ready_all(void *p, cnt_t cnt, msg_t msg);
   void chSysInit(void);
   void chSysHalt(const char *reason);
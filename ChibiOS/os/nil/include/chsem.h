@@ -63,7 +63,11 @@
  * @param[in] n         the counter initial value, this value must be
  *                      non-negative
  */
+#if (CH_CFG_USE_WAIT_BITMAPS == TRUE) || defined(__DOXYGEN__)
+#define __SEMAPHORE_DATA(name, n) {n, (nil_bitmap_t)0}
+#else
 #define __SEMAPHORE_DATA(name, n) {n}
+#endif
 
 /**
  * @brief   Static semaphore initializer.
@@ -90,7 +94,14 @@
  *
  * @init
  */
+#if (CH_CFG_USE_WAIT_BITMAPS == TRUE) || defined(__DOXYGEN__)
+#define chSemObjectInit(sp, n) do {                                         \
+  (sp)->cnt = (n);                                                          \
+  (sp)->waiters = (nil_bitmap_t)0;                                          \
+} while (false)
+#else
 #define chSemObjectInit(sp, n) ((sp)->cnt = (n))
+#endif
 
 /**
  * @brief   Performs a reset operation on the semaphore.
@@ -31,6 +31,14 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_WAIT_BITMAPS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Bit associated to a thread in the threads bitmaps.
+ */
+#define NIL_THD_BIT(tp)                                                     \
+  ((nil_bitmap_t)((nil_bitmap_t)1U << (unsigned)((tp) - &nil.threads[0])))
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -48,6 +56,114 @@ os_instance_t nil;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_WAIT_BITMAPS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Index of the least significant bit set in a non-empty bitmap.
+ * @note    Lower indexes are higher priority threads.
+ *
+ * @param[in] b         the bitmap to be scanned, must not be zero
+ * @return              The bit index.
+ *
+ * @notapi
+ */
+static inline unsigned nil_bitmap_first(nil_bitmap_t b) {
+#if defined(__GNUC__)
+  return (unsigned)__builtin_ctz((unsigned)b);
+#else
+  unsigned n = 0U;
+
+  while ((b & (nil_bitmap_t)1) == (nil_bitmap_t)0) {
+    b >>= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+#endif /* CH_CFG_USE_WAIT_BITMAPS == TRUE */
+
+/**
+ * @brief   Wakes up a thread whose timeout expired.
+ *
+ * @param[in] tp        pointer to the thread
+ *
+ * @notapi
+ */
+static void nil_timeout_wakeup(thread_t *tp) {
+
+  /* Timeout on thread queues requires a special handling because the
+     counter must be incremented.*/
+  if (NIL_THD_IS_WTQUEUE(tp)) {
+    tp->u1.tqp->cnt++;
+  }
+  else {
+    if (NIL_THD_IS_SUSPENDED(tp)) {
+      *tp->u1.trp = NULL;
+    }
+  }
+  (void) chSchReadyI(tp, MSG_TIMEOUT);
+}
+
+#if (CH_CFG_ST_TIMEDELTA == 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Tick processing of a single thread.
+ *
+ * @param[in] tp        pointer to the thread
+ *
+ * @notapi
+ */
+static void nil_tick_thread(thread_t *tp) {
+
+  /* Is the thread in a wait state with timeout?.*/
+  if (tp->timeout > (sysinterval_t)0) {
+
+    chDbgAssert(!NIL_THD_IS_READY(tp), "is ready");
+
+    /* Did the timer reach zero?*/
+    if (--tp->timeout == (sysinterval_t)0) {
+      nil_timeout_wakeup(tp);
+    }
+  }
+}
+#endif /* CH_CFG_ST_TIMEDELTA == 0 */
+
+#if (CH_CFG_ST_TIMEDELTA > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Alarm processing of a single thread.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] next      nearest timeout found so far, zero if none
+ * @return              The nearest timeout including this thread.
+ *
+ * @notapi
+ */
+static sysinterval_t nil_alarm_thread(thread_t *tp, sysinterval_t next) {
+  sysinterval_t timeout = tp->timeout;
+
+  /* Is the thread in a wait state with timeout?.*/
+  if (timeout > (sysinterval_t)0) {
+
+    chDbgAssert(!NIL_THD_IS_READY(tp), "is ready");
+    chDbgAssert(timeout >= chTimeDiffX(nil.lasttime, nil.nexttime),
+                "skipped one");
+
+    /* The volatile field is updated once, here.*/
+    timeout -= chTimeDiffX(nil.lasttime, nil.nexttime);
+    tp->timeout = timeout;
+
+    if (timeout == (sysinterval_t)0) {
+      nil_timeout_wakeup(tp);
+    }
+    else {
+      if (timeout <= (sysinterval_t)(next - (sysinterval_t)1)) {
+        next = timeout;
+      }
+    }
+  }
+
+  return next;
+}
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+
 /*===========================================================================*/
 /* Module interrupt handlers.                                                */
 /*===========================================================================*/
@@ -80,6 +196,27 @@ thread_t *nil_find_thread(tstate_t state, void *p) {
   return NULL;
 }
 
+/**
+ * @brief   Retrieves the highest priority thread waiting on a threads queue.
+ *
+ * @param[in] tqp       pointer to the threads queue object
+ * @return              The pointer to the found thread.
+ * @retval NULL         if there are no waiting threads.
+ *
+ * @notapi
+ */
+thread_t *nil_find_waiter(threads_queue_t *tqp) {
+
+#if CH_CFG_USE_WAIT_BITMAPS == TRUE
+  if (tqp->waiters == (nil_bitmap_t)0) {
+    return NULL;
+  }
+  return &nil.threads[nil_bitmap_first(tqp->waiters)];
+#else
+  return nil_find_thread(NIL_STATE_WTQUEUE, (void *)tqp);
+#endif
+}
+
 /**
  * @brief   Puts in ready state all thread matching the specified status and
  *          associated object.
@@ -93,7 +230,19 @@ thread_t *nil_find_thread(tstate_t state, void *p) {
  * @notapi
  */
 cnt_t nil_ready_all(void *p, cnt_t cnt, msg_t msg) {
-  thread_t *tp = nil.threads;;
+#if CH_CFG_USE_WAIT_BITMAPS == TRUE
+
+  while (cnt < (cnt_t)0) {
+    thread_t *tp = nil_find_waiter((threads_queue_t *)p);
+
+    chDbgAssert(tp != NULL, "thread not found");
+
+    /* The thread is removed from the waiters bitmap by chSchReadyI().*/
+    cnt++;
+    (void) chSchReadyI(tp, msg);
+  }
+#else
+  thread_t *tp = nil.threads;
 
   while (cnt < (cnt_t)0) {
 
@@ -107,6 +256,7 @@ cnt_t nil_ready_all(void *p, cnt_t cnt, msg_t msg) {
     }
     tp++;
   }
+#endif
 
   return cnt;
 }
@@ -357,84 +507,73 @@ void chSysTimerHandlerI(void) {
   chDbgCheckClassI();
 
 #if CH_CFG_ST_TIMEDELTA == 0
-  thread_t *tp = &nil.threads[0];
   nil.systime++;
-  do {
-    /* Is the thread in a wait state with timeout?.*/
-    if (tp->timeout > (sysinterval_t)0) {
-
-      chDbgAssert(!NIL_THD_IS_READY(tp), "is ready");
-
-      /* Did the timer reach zero?*/
-      if (--tp->timeout == (sysinterval_t)0) {
-        /* Timeout on queues/semaphores requires a special handling because
-           the counter must be incremented.*/
-        /*lint -save -e9013 [15.7] There is no else because it is not needed.*/
-#if CH_CFG_USE_SEMAPHORES == TRUE
-        if (NIL_THD_IS_WTQUEUE(tp)) {
-          tp->u1.semp->cnt++;
-        }
-        else
-#endif
-        if (NIL_THD_IS_SUSPENDED(tp)) {
-          *tp->u1.trp = NULL;
-        }
-        /*lint -restore*/
-        (void) chSchReadyI(tp, MSG_TIMEOUT);
-      }
+#if CH_CFG_USE_WAIT_BITMAPS == TRUE
+  {
+    /* Only threads with an armed timeout are processed, threads readied
+       while the lock is released are skipped because their timeout has
+       been cleared.*/
+    nil_bitmap_t armed = nil.timeouts;
+
+    while (armed != (nil_bitmap_t)0) {
+      nil_tick_thread(&nil.threads[nil_bitmap_first(armed)]);
+      armed &= (nil_bitmap_t)(armed - (nil_bitmap_t)1);
+
+      /* Lock released in order to give a preemption chance on those
+         architectures supporting IRQ preemption.*/
+      chSysUnlockFromISR();
+      chSysLockFromISR();
     }
-    /* Lock released in order to give a preemption chance on those
-       architectures supporting IRQ preemption.*/
-    chSysUnlockFromISR();
-    tp++;
-    chSysLockFromISR();
-  } while (tp < &nil.threads[CH_CFG_MAX_THREADS]);
+  }
+#else
+  {
+    thread_t *tp = &nil.threads[0];
+
+    do {
+      nil_tick_thread(tp);
+
+      /* Lock released in order to give a preemption chance on those
+         architectures supporting IRQ preemption.*/
+      chSysUnlockFromISR();
+      tp++;
+      chSysLockFromISR();
+    } while (tp < &nil.threads[CH_CFG_MAX_THREADS]);
+  }
+#endif
 #else
-  thread_t *tp = &nil.threads[0];
   sysinterval_t next = (sysinterval_t)0;
 
   chDbgAssert(nil.nexttime == port_timer_get_alarm(), "time mismatch");
 
-  do {
-    sysinterval_t timeout = tp->timeout;
-
-    /* Is the thread in a wait state with timeout?.*/
-    if (timeout > (sysinterval_t)0) {
-
-      chDbgAssert(!NIL_THD_IS_READY(tp), "is ready");
-      chDbgAssert(timeout >= chTimeDiffX(nil.lasttime, nil.nexttime),
-                  "skipped one");
-
-      /* The volatile field is updated once, here.*/
-      timeout -= chTimeDiffX(nil.lasttime, nil.nexttime);
-      tp->timeout = timeout;
-
-      if (timeout == (sysinterval_t)0) {
-        /* Timeout on thread queues requires a special handling because the
-           counter must be incremented.*/
-        if (NIL_THD_IS_WTQUEUE(tp)) {
-          tp->u1.tqp->cnt++;
-        }
-        else {
-          if (NIL_THD_IS_SUSPENDED(tp)) {
-            *tp->u1.trp = NULL;
-          }
-        }
-        (void) chSchReadyI(tp, MSG_TIMEOUT);
-      }
-      else {
-        if (timeout <= (sysinterval_t)(next - (sysinterval_t)1)) {
-          next = timeout;
-        }
-      }
+#if CH_CFG_USE_WAIT_BITMAPS == TRUE
+  {
+    nil_bitmap_t armed = nil.timeouts;
+
+    while (armed != (nil_bitmap_t)0) {
+      next = nil_alarm_thread(&nil.threads[nil_bitmap_first(armed)], next);
+      armed &= (nil_bitmap_t)(armed - (nil_bitmap_t)1);
+
+      /* Lock released in order to give a preemption chance on those
+         architectures supporting IRQ preemption.*/
+      chSysUnlockFromISR();
+      chSysLockFromISR();
     }
+  }
+#else
+  {
+    thread_t *tp = &nil.threads[0];
 
-    /* Lock released in order to give a preemption chance on those
-       architectures supporting IRQ preemption.*/
-    chSysUnlockFromISR();
-    tp++;
-    chSysLockFromISR();
-  } while (tp < &nil.threads[CH_CFG_MAX_THREADS]);
+    do {
+      next = nil_alarm_thread(tp, next);
+
+      /* Lock released in order to give a preemption chance on those
+         architectures supporting IRQ preemption.*/
+      chSysUnlockFromISR();
+      tp++;
+      chSysLockFromISR();
+    } while (tp < &nil.threads[CH_CFG_MAX_THREADS]);
+  }
+#endif
 
   nil.lasttime = nil.nexttime;
   if (next > (sysinterval_t)0) {
@@ -585,6 +724,15 @@ thread_t *chSchReadyI(thread_t *tp, msg_t msg) {
   chDbgAssert(!NIL_THD_IS_READY(tp), "already ready");
   chDbgAssert(nil.next <= nil.current, "priority ordering");
 
+#if CH_CFG_USE_WAIT_BITMAPS == TRUE
+  /* Removing the thread from the bitmaps, the queue pointer is about to be
+     overwritten by the message.*/
+  if (NIL_THD_IS_WTQUEUE(tp)) {
+    tp->u1.tqp->waiters &= (nil_bitmap_t)~NIL_THD_BIT(tp);
+  }
+  nil.timeouts &= (nil_bitmap_t)~NIL_THD_BIT(tp);
+#endif
+
   tp->u1.msg = msg;
   tp->state = NIL_STATE_READY;
   tp->timeout = (sysinterval_t)0;
@@ -671,6 +819,15 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
   /* Storing the wait object for the current thread.*/
   otp->state = newstate;
 
+#if CH_CFG_USE_WAIT_BITMAPS == TRUE
+  if (newstate == NIL_STATE_WTQUEUE) {
+    otp->u1.tqp->waiters |= NIL_THD_BIT(otp);
+  }
+  if (timeout != TIME_INFINITE) {
+    nil.timeouts |= NIL_THD_BIT(otp);
+  }
+#endif
+
 #if CH_CFG_ST_TIMEDELTA > 0
   if (timeout != TIME_INFINITE) {
     systime_t abstime;
@@ -1035,7 +1192,7 @@ void chThdDoDequeueNextI(threads_queue_t *tqp, msg_t msg) {
   chDbgAssert(tqp->cnt < (cnt_t)0, "empty queue");
 
   tqp->cnt++;
-  tp = nil_find_thread(NIL_STATE_WTQUEUE, (void *)tqp);
+  tp = nil_find_waiter(tqp);
 
   chDbgAssert(tp != NULL, "thread not found");
 
@@ -156,7 +156,7 @@ void chSemSignalI(semaphore_t *sp) {
   chDbgCheck(sp != NULL);
 
   if (++sp->cnt <= (cnt_t)0) {
-    thread_t *tp = nil_find_thread(NIL_STATE_WTQUEUE, (void *)sp);
+    thread_t *tp = nil_find_waiter(sp);
 
     chDbgAssert(tp != NULL, "thread not found");
 
@@ -58,6 +58,22 @@
 #define CH_CFG_AUTOSTART_THREADS            TRUE
 #endif
 
+/**
+ * @brief   Waiters and timeouts bitmaps.
+ * @details If enabled then each threads queue keeps a bitmap of its waiting
+ *          threads and the kernel keeps a bitmap of the threads having an
+ *          armed timeout, dequeue operations and the system tick processing
+ *          do not need to scan the whole threads array.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Each threads queue and semaphore is enlarged by one bitmap word,
+ *          one byte up to 8 threads.
+ * @note    When enabled @p CH_CFG_MAX_THREADS can be raised up to 32.
+ */
+#if !defined(CH_CFG_USE_WAIT_BITMAPS)
+#define CH_CFG_USE_WAIT_BITMAPS             FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -217,6 +233,21 @@
 #define CH_CFG_USE_HEAP                     TRUE
 #endif
 
+/**
+ * @brief   Segregated fits heap allocator.
+ * @details If enabled then the memory heap allocator uses segregated free
+ *          lists indexed by size class, allocation and release take a
+ *          bounded time regardless of the heap fragmentation. If disabled
+ *          then a first-fit allocator with a single free list is used.
+ *
+ * @note    The default is @p FALSE.
+ * @note    The segregated fits allocator requires a larger heap descriptor
+ *          and one extra header for each memory region.
+ */
+#if !defined(CH_CFG_HEAP_TLSF)
+#define CH_CFG_HEAP_TLSF                    FALSE
+#endif
+
 /**
  * @brief   Memory Pools Allocator APIs.
  * @details If enabled then the memory pools allocator APIs are included
@@ -228,6 +259,20 @@
 #define CH_CFG_USE_MEMPOOLS                 TRUE
 #endif
 
+/**
+ * @brief   Memory Pools magazines APIs.
+ * @details If enabled then the per-thread memory pool magazines are
+ *          included in the kernel. A magazine keeps a small stack of
+ *          objects privately owned by a thread and accesses the underlying
+ *          pool in batches.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MEMPOOLS.
+ */
+#if !defined(CH_CFG_USE_POOL_MAGAZINES)
+#define CH_CFG_USE_POOL_MAGAZINES           FALSE
+#endif
+
 /**
  * @brief  Objects FIFOs APIs.
  * @details If enabled then the objects FIFOs APIs are included
@@ -250,6 +295,17 @@
 #define CH_CFG_USE_PIPES                    TRUE
 #endif
 
+/**
+ * @brief   Rings APIs.
+ * @details If enabled then the single and multiple producers rings APIs
+ *          are included in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_RINGS)
+#define CH_CFG_USE_RINGS                    FALSE
+#endif
+
 /**
  * @brief   Objects Caches APIs.
  * @details If enabled then the objects caches APIs are included
@@ -261,6 +317,18 @@
 #define CH_CFG_USE_OBJ_CACHES               TRUE
 #endif
 
+/**
+ * @brief   Objects Caches segments.
+ * @details Number of segments the hash table and the LRU list of an
+ *          objects cache are split into, each segment has its own LRU
+ *          list. It must be a power of two.
+ *
+ * @note    The default is @p 1.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_SEGMENTS)
+#define CH_CFG_OBJ_CACHES_SEGMENTS          1
+#endif
+
 /**
  * @brief   Delegate threads APIs.
  * @details If enabled then the delegate threads APIs are included
@@ -28,6 +28,15 @@
  *          - <b>Post</b>: A job is posted to the queue, it will be
  *            returned to the pool after execution.
  *          .
+ *          <h2>Jobs Systems</h2>
+ *          A jobs system distributes jobs among a set of worker threads,
+ *          each worker has its own deque of jobs. Workers execute the
+ *          newest job in their own deque and, when it is empty, steal the
+ *          oldest job from the other workers. Jobs posted by a worker are
+ *          queued in its own deque.<br>
+ *          Jobs can be spawned as part of a group, a thread can then join
+ *          the group executing pending jobs until all jobs in the group
+ *          have been completed.
  *
  * @addtogroup oslib_jobs_queues
  * @{
@@ -104,6 +113,94 @@ typedef struct ch_job_descriptor {
   void                      *jobarg;
 } job_descriptor_t;
 
+/**
+ * @brief   Type of a jobs group.
+ */
+typedef struct ch_jobs_group {
+  /**
+   * @brief   Jobs spawned in the group and not yet completed.
+   */
+  cnt_t                     pending;
+  /**
+   * @brief   Thread joining the group.
+   */
+  thread_reference_t        waiter;
+} jobs_group_t;
+
+/**
+ * @brief   Type of a slot in a worker deque.
+ */
+typedef struct ch_job_slot {
+  /**
+   * @brief   Queued job.
+   */
+  job_descriptor_t          *jp;
+  /**
+   * @brief   Group of the job or @p NULL.
+   */
+  jobs_group_t              *grp;
+} job_slot_t;
+
+/**
+ * @brief   Type of a jobs worker.
+ */
+typedef struct ch_jobs_worker {
+  /**
+   * @brief   Worker thread, set on the first dispatch.
+   */
+  thread_t                  *thread;
+  /**
+   * @brief   Deque of the queued jobs.
+   */
+  job_slot_t                *slots;
+  /**
+   * @brief   Index of the oldest job in the deque.
+   */
+  size_t                    top;
+  /**
+   * @brief   Number of jobs in the deque.
+   */
+  size_t                    cnt;
+  /**
+   * @brief   Jobs executed by the worker.
+   */
+  ucnt_t                    executed;
+  /**
+   * @brief   Jobs stolen from other workers.
+   */
+  ucnt_t                    stolen;
+} jobs_worker_t;
+
+/**
+ * @brief   Type of a jobs system.
+ */
+typedef struct ch_jobs_system {
+  /**
+   * @brief   Pool of the free jobs.
+   */
+  guarded_memory_pool_t     free;
+  /**
+   * @brief   Size of each worker deque.
+   */
+  size_t                    jobsn;
+  /**
+   * @brief   Array of the workers.
+   */
+  jobs_worker_t             *workers;
+  /**
+   * @brief   Number of workers.
+   */
+  unsigned                  workersn;
+  /**
+   * @brief   Worker receiving the next job posted by other threads.
+   */
+  unsigned                  next;
+  /**
+   * @brief   Semaphore of the idle workers.
+   */
+  semaphore_t               idle;
+} jobs_system_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -115,7 +212,20 @@ typedef struct ch_job_descriptor {
 #ifdef __cplusplus
 extern "C" {
 #endif
-
+  void chJobSystemObjectInit(jobs_system_t *jsp,
+                             size_t jobsn,
+                             job_descriptor_t *jobsbuf,
+                             unsigned workersn,
+                             jobs_worker_t *workers,
+                             job_slot_t *slotsbuf);
+  void chJobSystemPostI(jobs_system_t *jsp, job_descriptor_t *jp);
+  void chJobSystemPost(jobs_system_t *jsp, job_descriptor_t *jp);
+  void chJobPostLocalS(jobs_system_t *jsp, job_descriptor_t *jp);
+  void chJobPostLocal(jobs_system_t *jsp, job_descriptor_t *jp);
+  msg_t chJobWorkerDispatch(jobs_system_t *jsp, jobs_worker_t *jwp);
+  void chJobSpawn(jobs_system_t *jsp, jobs_group_t *jgp,
+                  job_function_t jobfunc, void *jobarg);
+  void chJobJoin(jobs_system_t *jsp, jobs_group_t *jgp);
 #ifdef __cplusplus
 }
 #endif
@@ -390,6 +500,67 @@ static inline msg_t chJobDispatchTimeout(jobs_queue_t *jqp,
   return msg;
 }
 
+/**
+ * @brief   Allocates a free job object from a jobs system.
+ *
+ * @param[in] jsp       pointer to a @p jobs_system_t structure
+ * @return              The pointer to the allocated job object.
+ *
+ * @api
+ */
+static inline job_descriptor_t *chJobSystemGet(jobs_system_t *jsp) {
+
+  return (job_descriptor_t *)chGuardedPoolAllocTimeout(&jsp->free, TIME_INFINITE);
+}
+
+/**
+ * @brief   Allocates a free job object from a jobs system.
+ *
+ * @param[in] jsp       pointer to a @p jobs_system_t structure
+ * @return              The pointer to the allocated job object.
+ * @retval NULL         if a job object is not immediately available.
+ *
+ * @iclass
+ */
+static inline job_descriptor_t *chJobSystemGetI(jobs_system_t *jsp) {
+
+  return (job_descriptor_t *)chGuardedPoolAllocI(&jsp->free);
+}
+
+/**
+ * @brief   Allocates a free job object from a jobs system.
+ *
+ * @param[in] jsp       pointer to a @p jobs_system_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The pointer to the allocated job object.
+ * @retval NULL         if a job object is not available within the specified
+ *                      timeout.
+ *
+ * @api
+ */
+static inline job_descriptor_t *chJobSystemGetTimeout(jobs_system_t *jsp,
+                                                      sysinterval_t timeout) {
+
+  return (job_descriptor_t *)chGuardedPoolAllocTimeout(&jsp->free, timeout);
+}
+
+/**
+ * @brief   Initializes a jobs group object.
+ *
+ * @param[out] jgp      pointer to a @p jobs_group_t structure
+ *
+ * @init
+ */
+static inline void chJobGroupObjectInit(jobs_group_t *jgp) {
+
+  jgp->pending = (cnt_t)0;
+  jgp->waiter  = NULL;
+}
+
 #endif /* CH_CFG_USE_JOBS == TRUE */
 
 #endif /* CHJOBS_H */
@@ -96,10 +96,22 @@
 #error "CH_CFG_USE_HEAP not defined in chconf.h"
 #endif
 
+/* The segregated fits heap is not present in older configuration files,
+   the first-fit heap is used by default.*/
+#if !defined(CH_CFG_HEAP_TLSF)
+#define CH_CFG_HEAP_TLSF                    FALSE
+#endif
+
 #if !defined(CH_CFG_USE_MEMPOOLS)
 #error "CH_CFG_USE_MEMPOOLS not defined in chconf.h"
 #endif
 
+/* Pool magazines are not present in older configuration files, disabled
+   by default.*/
+#if !defined(CH_CFG_USE_POOL_MAGAZINES)
+#define CH_CFG_USE_POOL_MAGAZINES           FALSE
+#endif
+
 #if !defined(CH_CFG_USE_OBJ_FIFOS)
 #error "CH_CFG_USE_OBJ_FIFOS not defined in chconf.h"
 #endif
@@ -108,10 +120,22 @@
 #error "CH_CFG_USE_PIPES not defined in chconf.h"
 #endif
 
+/* Rings are not present in older configuration files, disabled by
+   default.*/
+#if !defined(CH_CFG_USE_RINGS)
+#define CH_CFG_USE_RINGS                    FALSE
+#endif
+
 #if !defined(CH_CFG_USE_OBJ_CACHES)
 #error "CH_CFG_USE_OBJ_CACHES not defined in chconf.h"
 #endif
 
+/* Objects caches segments are not present in older configuration files,
+   single segment by default.*/
+#if !defined(CH_CFG_OBJ_CACHES_SEGMENTS)
+#define CH_CFG_OBJ_CACHES_SEGMENTS          1
+#endif
+
 #if !defined(CH_CFG_USE_DELEGATES)
 #error "CH_CFG_USE_DELEGATES not defined in chconf.h"
 #endif
@@ -183,6 +207,7 @@
 #undef CH_CFG_USE_MEMPOOLS
 #undef CH_CFG_USE_OBJ_FIFOS
 #undef CH_CFG_USE_PIPES
+#undef CH_CFG_USE_RINGS
 #undef CH_CFG_USE_OBJ_CACHES
 #undef CH_CFG_USE_DELEGATES
 #undef CH_CFG_USE_JOBS
@@ -191,6 +216,7 @@
 #define CH_CFG_USE_MEMPOOLS                 FALSE
 #define CH_CFG_USE_OBJ_FIFOS                FALSE
 #define CH_CFG_USE_PIPES                    FALSE
+#define CH_CFG_USE_RINGS                    FALSE
 #define CH_CFG_USE_OBJ_CACHES               FALSE
 #define CH_CFG_USE_DELEGATES                FALSE
 #define CH_CFG_USE_JOBS                     FALSE
@@ -216,6 +242,12 @@
 /* Module macros.                                                            */
 /*===========================================================================*/
 
+/* Objects tracing is only available in RT, the trace calls in the library
+   code are removed when running on other kernels.*/
+#if !defined(__trace_object) && !defined(__CHIBIOS_RT__)
+#define __trace_object(op, objp, arg)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -232,6 +264,7 @@
 #include "chmempools.h"
 #include "chobjfifos.h"
 #include "chpipes.h"
+#include "chrings.h"
 #include "chobjcaches.h"
 #include "chdelegates.h"
 #include "chjobs.h"
@@ -62,6 +62,46 @@ typedef struct {
   threads_queue_t       qr;             /**< @brief Queued readers.         */
 } mailbox_t;
 
+/**
+ * @brief   Ordering of messages in a priority mailbox.
+ */
+typedef enum {
+  PMB_ORDER_PRIORITY = 0,               /**< @brief Higher keys first.      */
+  PMB_ORDER_DEADLINE = 1                /**< @brief Earlier deadlines first.*/
+} pmb_order_t;
+
+/**
+ * @brief   Priority mailbox entry.
+ */
+typedef struct {
+  msg_t                 msg;            /**< @brief Message.                */
+  systime_t             key;            /**< @brief Priority or absolute
+                                                    deadline.               */
+  ucnt_t                seq;            /**< @brief Posting order, for
+                                                    messages with the same
+                                                    key.                    */
+} pmb_entry_t;
+
+/**
+ * @brief   Structure representing a priority mailbox object.
+ * @details Pending messages are kept in a binary heap laid out in the
+ *          entries buffer, the most urgent message is always at the
+ *          buffer start.
+ */
+typedef struct {
+  pmb_entry_t           *buffer;        /**< @brief Pointer to the entries
+                                                    buffer.                 */
+  size_t                size;           /**< @brief Number of entries in
+                                                    the buffer.             */
+  size_t                cnt;            /**< @brief Messages in queue.      */
+  pmb_order_t           order;          /**< @brief Messages ordering.      */
+  ucnt_t                seq;            /**< @brief Next posting sequence
+                                                    number.                 */
+  bool                  reset;          /**< @brief True in reset state.    */
+  threads_queue_t       qw;             /**< @brief Queued writers.         */
+  threads_queue_t       qr;             /**< @brief Queued readers.         */
+} prio_mailbox_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -117,6 +157,20 @@ extern "C" {
   msg_t chMBFetchTimeout(mailbox_t *mbp, msg_t *msgp, sysinterval_t timeout);
   msg_t chMBFetchTimeoutS(mailbox_t *mbp, msg_t *msgp, sysinterval_t timeout);
   msg_t chMBFetchI(mailbox_t *mbp, msg_t *msgp);
+  void chPMBObjectInit(prio_mailbox_t *pmbp, pmb_entry_t *buf, size_t n,
+                       pmb_order_t order);
+  void chPMBReset(prio_mailbox_t *pmbp);
+  void chPMBResetI(prio_mailbox_t *pmbp);
+  msg_t chPMBPostTimeout(prio_mailbox_t *pmbp, msg_t msg, systime_t key,
+                         sysinterval_t timeout);
+  msg_t chPMBPostTimeoutS(prio_mailbox_t *pmbp, msg_t msg, systime_t key,
+                          sysinterval_t timeout);
+  msg_t chPMBPostI(prio_mailbox_t *pmbp, msg_t msg, systime_t key);
+  msg_t chPMBFetchTimeout(prio_mailbox_t *pmbp, msg_t *msgp,
+                          sysinterval_t timeout);
+  msg_t chPMBFetchTimeoutS(prio_mailbox_t *pmbp, msg_t *msgp,
+                           sysinterval_t timeout);
+  msg_t chPMBFetchI(prio_mailbox_t *pmbp, msg_t *msgp);
 #ifdef __cplusplus
 }
 #endif
@@ -202,6 +256,84 @@ static inline void chMBResumeX(mailbox_t *mbp) {
   mbp->reset = false;
 }
 
+/**
+ * @brief   Returns the priority mailbox buffer size as number of messages.
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t
+ *                      object
+ * @return              The size of the mailbox.
+ *
+ * @iclass
+ */
+static inline size_t chPMBGetSizeI(const prio_mailbox_t *pmbp) {
+
+  return pmbp->size;
+}
+
+/**
+ * @brief   Returns the number of used message slots into a priority
+ *          mailbox.
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t
+ *                      object
+ * @return              The number of queued messages.
+ *
+ * @iclass
+ */
+static inline size_t chPMBGetUsedCountI(const prio_mailbox_t *pmbp) {
+
+  chDbgCheckClassI();
+
+  return pmbp->cnt;
+}
+
+/**
+ * @brief   Returns the number of free message slots into a priority
+ *          mailbox.
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t
+ *                      object
+ * @return              The number of empty message slots.
+ *
+ * @iclass
+ */
+static inline size_t chPMBGetFreeCountI(const prio_mailbox_t *pmbp) {
+
+  chDbgCheckClassI();
+
+  return chPMBGetSizeI(pmbp) - chPMBGetUsedCountI(pmbp);
+}
+
+/**
+ * @brief   Returns the most urgent message without removing it.
+ * @pre     The mailbox must contain at least one message.
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t
+ *                      object
+ * @return              The most urgent message.
+ *
+ * @iclass
+ */
+static inline msg_t chPMBPeekI(const prio_mailbox_t *pmbp) {
+
+  chDbgCheckClassI();
+
+  return pmbp->buffer[0].msg;
+}
+
+/**
+ * @brief   Terminates the reset state.
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t
+ *                      object
+ *
+ * @xclass
+ */
+static inline void chPMBResumeX(prio_mailbox_t *pmbp) {
+
+  pmbp->reset = false;
+}
+
 #endif /* CH_CFG_USE_MAILBOXES == TRUE */
 
 #endif /* CHMBOXES_H */
@@ -38,7 +38,9 @@
  * @brief   Minimum alignment used for heap.
  * @note    Cannot use the sizeof operator in this macro.
  */
-#if (SIZEOF_PTR == 4) || defined(__DOXYGEN__)
+#if (SIZEOF_PTR == 8) || defined(__DOXYGEN__)
+#define CH_HEAP_ALIGNMENT   16U
+#elif (SIZEOF_PTR == 4)
 #define CH_HEAP_ALIGNMENT   8U
 #elif (SIZEOF_PTR == 2)
 #define CH_HEAP_ALIGNMENT   4U
@@ -50,10 +52,33 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Number of first level size classes of the segregated fits
+ *          heap.
+ * @details Each first level class covers a power of two range of block
+ *          sizes and is split in eight second level classes. Blocks larger
+ *          than the highest class are kept in its last list and allocated
+ *          using a first-fit search.
+ * @note    Each class requires eight pointers in each heap descriptor.
+ */
+#if !defined(CH_CFG_HEAP_TLSF_CLASSES) || defined(__DOXYGEN__)
+#define CH_CFG_HEAP_TLSF_CLASSES            12U
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if CH_CFG_HEAP_TLSF == TRUE
+#if (CH_CFG_HEAP_TLSF_CLASSES < 1U) || (CH_CFG_HEAP_TLSF_CLASSES > 31U)
+#error "invalid CH_CFG_HEAP_TLSF_CLASSES value"
+#endif
+
+#if SIZEOF_PTR < 4
+#error "CH_CFG_HEAP_TLSF requires 32 bits or larger pointers"
+#endif
+#endif
+
 #if CH_CFG_USE_MEMCORE == FALSE
 #error "CH_CFG_USE_HEAP requires CH_CFG_USE_MEMCORE"
 #endif
@@ -88,6 +113,13 @@ union heap_header {
     memory_heap_t       *heap;      /**< @brief Block owner heap.           */
     size_t              size;       /**< @brief Size of the area in bytes.  */
   } used;
+#if (CH_CFG_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+  struct {
+    uintptr_t           link;       /**< @brief Next free block or owner
+                                                heap, plus block flags.     */
+    size_t              pages;      /**< @brief Size of the area in pages.  */
+  } tlsf;
+#endif
 };
 
 /**
@@ -96,7 +128,19 @@ union heap_header {
 struct memory_heap {
   memgetfunc2_t         provider;   /**< @brief Memory blocks provider for
                                                 this heap.                  */
+#if (CH_CFG_HEAP_TLSF == FALSE) || defined(__DOXYGEN__)
   heap_header_t         header;     /**< @brief Free blocks list header.    */
+#endif
+#if (CH_CFG_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+  uint32_t              flmap;      /**< @brief Non-empty first level
+                                                classes mask.               */
+  uint32_t              slmap[CH_CFG_HEAP_TLSF_CLASSES];
+                                    /**< @brief Non-empty second level
+                                                classes masks.              */
+  heap_header_t         *lists[CH_CFG_HEAP_TLSF_CLASSES][8];
+                                    /**< @brief Free blocks lists, one for
+                                                each size class.            */
+#endif
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   mutex_t               mtx;        /**< @brief Heap access mutex.          */
 #else
@@ -136,8 +180,7 @@ extern "C" {
 /*===========================================================================*/
 
 /**
- * @brief   Allocates a block of memory from the heap by using the first-fit
- *          algorithm.
+ * @brief   Allocates a block of memory from the heap.
  * @details The allocated block is guaranteed to be properly aligned for a
  *          pointer data type.
  *
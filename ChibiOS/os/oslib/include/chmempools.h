@@ -81,6 +81,31 @@ typedef struct {
 } guarded_memory_pool_t;
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
+#if (CH_CFG_USE_POOL_MAGAZINES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Memory pool magazine descriptor.
+ * @details A magazine is a small stack of objects owned by a single thread
+ *          placed in front of a memory pool, objects are taken from and
+ *          returned to the magazine without locking, the pool is only
+ *          accessed in batches when the magazine is empty or full.
+ */
+typedef struct {
+  memory_pool_t         *pool;          /**< @brief Underlying memory pool. */
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
+  guarded_memory_pool_t *guarded;       /**< @brief Underlying guarded memory
+                                                    pool or @p NULL.        */
+#endif
+  void                  **objects;      /**< @brief Objects stack.          */
+  size_t                size;           /**< @brief Magazine capacity.      */
+  size_t                cnt;            /**< @brief Objects in the
+                                                    magazine.               */
+  ucnt_t                hits;           /**< @brief Operations served by the
+                                                    magazine.               */
+  ucnt_t                misses;         /**< @brief Operations served by the
+                                                    memory pool.            */
+} pool_magazine_t;
+#endif /* CH_CFG_USE_POOL_MAGAZINES == TRUE */
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -165,6 +190,19 @@ extern "C" {
                                   sysinterval_t timeout);
   void chGuardedPoolFree(guarded_memory_pool_t *gmp, void *objp);
 #endif
+#if CH_CFG_USE_POOL_MAGAZINES == TRUE
+  void chPoolMagazineObjectInit(pool_magazine_t *pmp, memory_pool_t *mp,
+                                void **buf, size_t n);
+#if CH_CFG_USE_SEMAPHORES == TRUE
+  void chGuardedPoolMagazineObjectInit(pool_magazine_t *pmp,
+                                       guarded_memory_pool_t *gmp,
+                                       void **buf, size_t n);
+#endif
+  void *chPoolMagazineAllocTimeout(pool_magazine_t *pmp,
+                                   sysinterval_t timeout);
+  void chPoolMagazineFree(pool_magazine_t *pmp, void *objp);
+  void chPoolMagazineFlush(pool_magazine_t *pmp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -378,6 +416,63 @@ static inline void chGuardedPoolAddS(guarded_memory_pool_t *gmp, void *objp) {
 }
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
+#if (CH_CFG_USE_POOL_MAGAZINES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Allocates an object through a magazine.
+ * @details Plain memory pools return @p NULL when empty, guarded memory
+ *          pools wait for an object to become available.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ * @return              The pointer to the allocated object.
+ * @retval NULL         if the pool is empty.
+ *
+ * @api
+ */
+static inline void *chPoolMagazineAlloc(pool_magazine_t *pmp) {
+
+  return chPoolMagazineAllocTimeout(pmp, TIME_INFINITE);
+}
+
+/**
+ * @brief   Returns the number of objects held in a magazine.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ * @return              The number of objects.
+ *
+ * @xclass
+ */
+static inline size_t chPoolMagazineGetCountX(const pool_magazine_t *pmp) {
+
+  return pmp->cnt;
+}
+
+/**
+ * @brief   Returns the number of operations served by a magazine.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ * @return              The number of hits.
+ *
+ * @xclass
+ */
+static inline ucnt_t chPoolMagazineGetHitsX(const pool_magazine_t *pmp) {
+
+  return pmp->hits;
+}
+
+/**
+ * @brief   Returns the number of operations that accessed the memory pool.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ * @return              The number of misses.
+ *
+ * @xclass
+ */
+static inline ucnt_t chPoolMagazineGetMissesX(const pool_magazine_t *pmp) {
+
+  return pmp->misses;
+}
+#endif /* CH_CFG_USE_POOL_MAGAZINES == TRUE */
+
 #endif /* CH_CFG_USE_MEMPOOLS == TRUE */
 
 #endif /* CHMEMPOOLS_H */
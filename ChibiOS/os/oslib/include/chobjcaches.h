@@ -50,10 +50,40 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Number of LRU objects examined when looking for a victim.
+ * @details Eviction and write-back only scan this many objects starting
+ *          from the LRU tail of a segment, this bounds the time spent
+ *          in the critical section.
+ */
+#if !defined(OC_LRU_SCAN_DEPTH) || defined(__DOXYGEN__)
+#define OC_LRU_SCAN_DEPTH                   8U
+#endif
+
+/**
+ * @brief   Consecutive accesses required to detect a sequential scan.
+ */
+#if !defined(OC_SEQ_THRESHOLD) || defined(__DOXYGEN__)
+#define OC_SEQ_THRESHOLD                    2U
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if !defined(CH_CFG_OBJ_CACHES_SEGMENTS)
+#error "CH_CFG_OBJ_CACHES_SEGMENTS not defined"
+#endif
+
+#if (CH_CFG_OBJ_CACHES_SEGMENTS < 1) ||                                     \
+    ((CH_CFG_OBJ_CACHES_SEGMENTS & (CH_CFG_OBJ_CACHES_SEGMENTS - 1)) != 0)
+#error "CH_CFG_OBJ_CACHES_SEGMENTS must be a power of two"
+#endif
+
+#if OC_SEQ_THRESHOLD < 1U
+#error "invalid OC_SEQ_THRESHOLD value"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -78,6 +108,11 @@ typedef struct ch_oc_lru_header oc_lru_header_t;
  */
 typedef struct ch_oc_object oc_object_t;
 
+/**
+ * @brief   Type of a cache segment.
+ */
+typedef struct ch_oc_segment oc_segment_t;
+
 /**
  * @brief   Type of a cache object.
  */
@@ -187,6 +222,54 @@ struct ch_oc_object {
   void                  *dptr;
 };
 
+/**
+ * @brief   Structure representing a cache segment.
+ * @details Each segment owns the hash slots whose index modulo
+ *          @p CH_CFG_OBJ_CACHES_SEGMENTS is equal to the segment index
+ *          and a fixed share of the objects buffers with their own LRU
+ *          list.
+ */
+struct ch_oc_segment {
+  /**
+   * @brief   LRU list header.
+   */
+  oc_lru_header_t       lru;
+  /**
+   * @brief   Semaphore for LRU access.
+   */
+  semaphore_t           lru_sem;
+};
+
+/**
+ * @brief   Cache statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Objects found in cache.
+   */
+  ucnt_t                hits;
+  /**
+   * @brief   Objects not found in cache.
+   */
+  ucnt_t                misses;
+  /**
+   * @brief   Cached objects replaced by other objects.
+   */
+  ucnt_t                evictions;
+  /**
+   * @brief   Evictions that had to write a dirty object.
+   */
+  ucnt_t                dirty_evictions;
+  /**
+   * @brief   Objects read ahead.
+   */
+  ucnt_t                readaheads;
+  /**
+   * @brief   Objects written back by @p chCacheWriteBack().
+   */
+  ucnt_t                writebacks;
+} oc_stats_t;
+
 /**
  * @brief   Structure representing a cache object.
  */
@@ -212,17 +295,13 @@ struct ch_objects_cache {
    */
   void                  *objvp;
   /**
-   * @brief   LRU list header.
+   * @brief   Cache segments.
    */
-  oc_lru_header_t       lru;
+  oc_segment_t          segments[CH_CFG_OBJ_CACHES_SEGMENTS];
   /**
    * @brief   Semaphore for cache access.
    */
   semaphore_t           cache_sem;
-  /**
-   * @brief   Semaphore for LRU access.
-   */
-  semaphore_t           lru_sem;
   /**
    * @brief   Reader functions for cached objects.
    */
@@ -231,6 +310,34 @@ struct ch_objects_cache {
    * @brief   Writer functions for cached objects.
    */
   oc_writef_t           writef;
+  /**
+   * @brief   Read-ahead window size, zero if disabled.
+   */
+  ucnt_t                ra_window;
+  /**
+   * @brief   Group of the last accessed object.
+   */
+  uint32_t              seq_group;
+  /**
+   * @brief   Key of the last accessed object.
+   */
+  uint32_t              seq_key;
+  /**
+   * @brief   Number of consecutive sequential accesses.
+   */
+  ucnt_t                seq_cnt;
+  /**
+   * @brief   Next object to be read ahead.
+   */
+  uint32_t              ra_key;
+  /**
+   * @brief   Objects still to be read ahead.
+   */
+  ucnt_t                ra_cnt;
+  /**
+   * @brief   Cache statistics.
+   */
+  oc_stats_t            stats;
 };
 
 /*===========================================================================*/
@@ -263,6 +370,9 @@ extern "C" {
   bool chCacheWriteObject(objects_cache_t *ocp,
                           oc_object_t *objp,
                           bool async);
+  void chCacheSetReadAhead(objects_cache_t *ocp, ucnt_t n);
+  ucnt_t chCacheWriteBack(objects_cache_t *ocp, ucnt_t n);
+  void chCacheGetStatistics(objects_cache_t *ocp, oc_stats_t *sp);
 #ifdef __cplusplus
 }
 #endif
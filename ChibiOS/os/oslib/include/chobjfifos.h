@@ -258,6 +258,34 @@ static inline void chFifoReturnObject(objects_fifo_t *ofp,
   chGuardedPoolFree(&ofp->free, objp);
 }
 
+#if (CH_CFG_USE_POOL_MAGAZINES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a magazine in front of the objects FIFO free pool.
+ * @details Objects can then be taken with @p chPoolMagazineAllocTimeout()
+ *          and returned with @p chPoolMagazineFree() instead of
+ *          @p chFifoTakeObjectTimeout() and @p chFifoReturnObject().
+ * @note    The magazine is owned by the calling thread. Objects held in
+ *          a magazine are not available to the other threads, this reduces
+ *          the usable FIFO depth. When the pool runs out of objects the
+ *          released objects and the magazine content are returned to the
+ *          pool so a sender waiting for objects is eventually released.
+ *
+ * @param[out] pmp      pointer to a @p pool_magazine_t structure
+ * @param[in] ofp       pointer to a @p objects_fifo_t structure
+ * @param[in] buf       pointer to an array of @p n pointers used as objects
+ *                      stack
+ * @param[in] n         magazine capacity as number of objects
+ *
+ * @init
+ */
+static inline void chFifoMagazineObjectInit(pool_magazine_t *pmp,
+                                            objects_fifo_t *ofp,
+                                            void **buf, size_t n) {
+
+  chGuardedPoolMagazineObjectInit(pmp, &ofp->free, buf, n);
+}
+#endif
+
 /**
  * @brief   Posts an object.
  * @note    By design the object can be always immediately posted.
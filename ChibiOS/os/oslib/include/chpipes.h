@@ -71,6 +71,19 @@ typedef struct {
 #endif
 } pipe_t;
 
+/**
+ * @brief   Structure representing a region of a pipe buffer.
+ * @details Free space and queued data can wrap across the buffer end so
+ *          a region is made of up to two contiguous spans, the second span
+ *          starts at the buffer base and is empty if not needed.
+ */
+typedef struct {
+  uint8_t               *ptr1;          /**< @brief First span pointer.     */
+  size_t                n1;             /**< @brief First span size.        */
+  uint8_t               *ptr2;          /**< @brief Second span pointer.    */
+  size_t                n2;             /**< @brief Second span size.       */
+} pipe_span_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -139,6 +152,12 @@ extern "C" {
                             size_t n, sysinterval_t timeout);
   size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
                            size_t n, sysinterval_t timeout);
+  size_t chPipeAcquireWriteSpan(pipe_t *pp, pipe_span_t *psp,
+                                size_t n, sysinterval_t timeout);
+  void chPipeCommitWrite(pipe_t *pp, size_t n);
+  size_t chPipeAcquireReadSpan(pipe_t *pp, pipe_span_t *psp,
+                               size_t n, sysinterval_t timeout);
+  void chPipeReleaseRead(pipe_t *pp, size_t n);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,244 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    oslib/include/chrings.h
+ * @brief   Rings macros and structures.
+ *
+ * @addtogroup oslib_rings
+ * @{
+ */
+
+#ifndef CHRINGS_H
+#define CHRINGS_H
+
+#if (CH_CFG_USE_RINGS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Padding between the producer and consumer fields of a ring.
+ * @details The producer and consumer indexes are written by different
+ *          threads, the padding keeps them in different cache lines. It
+ *          should be set to the cache line size of the target, zero
+ *          disables the padding.
+ */
+#if !defined(CH_CFG_RINGS_PADDING) || defined(__DOXYGEN__)
+#define CH_CFG_RINGS_PADDING                32U
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Structure representing a single producer ring object.
+ */
+typedef struct {
+  volatile msg_t        *buffer;        /**< @brief Pointer to the ring
+                                                    buffer.                 */
+  size_t                mask;           /**< @brief Ring size minus one.    */
+  volatile size_t       wridx;          /**< @brief Free running write
+                                                    index.                  */
+  thread_reference_t    wtr;            /**< @brief Waiting writer.         */
+#if (CH_CFG_RINGS_PADDING > 0U) || defined(__DOXYGEN__)
+  uint8_t               wrpad[CH_CFG_RINGS_PADDING];
+#endif
+  volatile size_t       rdidx;          /**< @brief Free running read
+                                                    index.                  */
+  thread_reference_t    rtr;            /**< @brief Waiting reader.         */
+#if (CH_CFG_RINGS_PADDING > 0U) || defined(__DOXYGEN__)
+  uint8_t               rdpad[CH_CFG_RINGS_PADDING];
+#endif
+} ring_t;
+
+/**
+ * @brief   Structure representing a multiple producers ring slot.
+ */
+typedef struct {
+  volatile size_t       seq;            /**< @brief Write index plus one
+                                                    of the stored message.  */
+  volatile msg_t        msg;            /**< @brief Stored message.         */
+} ring_slot_t;
+
+/**
+ * @brief   Structure representing a multiple producers ring object.
+ */
+typedef struct {
+  ring_slot_t           *slots;         /**< @brief Pointer to the ring
+                                                    slots array.            */
+  size_t                mask;           /**< @brief Ring size minus one.    */
+  volatile size_t       wridx;          /**< @brief Free running index of
+                                                    the next slot to be
+                                                    reserved.               */
+  volatile cnt_t        wcnt;           /**< @brief Number of waiting
+                                                    writers.                */
+  threads_queue_t       qw;             /**< @brief Queued writers.         */
+#if (CH_CFG_RINGS_PADDING > 0U) || defined(__DOXYGEN__)
+  uint8_t               wrpad[CH_CFG_RINGS_PADDING];
+#endif
+  volatile size_t       rdidx;          /**< @brief Free running read
+                                                    index.                  */
+  thread_reference_t    rtr;            /**< @brief Waiting reader.         */
+#if (CH_CFG_RINGS_PADDING > 0U) || defined(__DOXYGEN__)
+  uint8_t               rdpad[CH_CFG_RINGS_PADDING];
+#endif
+} mpring_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chRingObjectInit(ring_t *rp, msg_t *buf, size_t n);
+  msg_t chRingPostTimeout(ring_t *rp, msg_t msg, sysinterval_t timeout);
+  msg_t chRingPostI(ring_t *rp, msg_t msg);
+  size_t chRingPostManyTimeout(ring_t *rp, const msg_t *msgp,
+                               size_t n, sysinterval_t timeout);
+  msg_t chRingFetchTimeout(ring_t *rp, msg_t *msgp, sysinterval_t timeout);
+  msg_t chRingFetchI(ring_t *rp, msg_t *msgp);
+  size_t chRingFetchManyTimeout(ring_t *rp, msg_t *msgp,
+                                size_t n, sysinterval_t timeout);
+  void chMPRingObjectInit(mpring_t *mrp, ring_slot_t *slots, size_t n);
+  msg_t chMPRingPostTimeout(mpring_t *mrp, msg_t msg, sysinterval_t timeout);
+  msg_t chMPRingPostI(mpring_t *mrp, msg_t msg);
+  size_t chMPRingPostManyTimeout(mpring_t *mrp, const msg_t *msgp,
+                                 size_t n, sysinterval_t timeout);
+  msg_t chMPRingFetchTimeout(mpring_t *mrp, msg_t *msgp,
+                             sysinterval_t timeout);
+  msg_t chMPRingFetchI(mpring_t *mrp, msg_t *msgp);
+  size_t chMPRingFetchManyTimeout(mpring_t *mrp, msg_t *msgp,
+                                  size_t n, sysinterval_t timeout);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the ring size as number of messages.
+ *
+ * @param[in] rp        the pointer to an initialized @p ring_t object
+ * @return              The size of the ring.
+ *
+ * @xclass
+ */
+static inline size_t chRingGetSizeX(const ring_t *rp) {
+
+  return rp->mask + (size_t)1;
+}
+
+/**
+ * @brief   Returns the number of messages in a ring.
+ * @note    The value can be already obsolete when returned if called
+ *          outside the producer or consumer context.
+ *
+ * @param[in] rp        the pointer to an initialized @p ring_t object
+ * @return              The number of queued messages.
+ *
+ * @xclass
+ */
+static inline size_t chRingGetUsedCountX(const ring_t *rp) {
+  size_t rd = rp->rdidx;
+
+  return rp->wridx - rd;
+}
+
+/**
+ * @brief   Returns the number of free message slots in a ring.
+ * @note    The value can be already obsolete when returned if called
+ *          outside the producer or consumer context.
+ *
+ * @param[in] rp        the pointer to an initialized @p ring_t object
+ * @return              The number of empty message slots.
+ *
+ * @xclass
+ */
+static inline size_t chRingGetFreeCountX(const ring_t *rp) {
+
+  return chRingGetSizeX(rp) - chRingGetUsedCountX(rp);
+}
+
+/**
+ * @brief   Returns the ring size as number of messages.
+ *
+ * @param[in] mrp       the pointer to an initialized @p mpring_t object
+ * @return              The size of the ring.
+ *
+ * @xclass
+ */
+static inline size_t chMPRingGetSizeX(const mpring_t *mrp) {
+
+  return mrp->mask + (size_t)1;
+}
+
+/**
+ * @brief   Returns the number of messages in a ring.
+ * @note    Slots reserved by producers but not yet written are counted
+ *          as used.
+ * @note    The value can be already obsolete when returned.
+ *
+ * @param[in] mrp       the pointer to an initialized @p mpring_t object
+ * @return              The number of queued messages.
+ *
+ * @xclass
+ */
+static inline size_t chMPRingGetUsedCountX(const mpring_t *mrp) {
+  size_t rd = mrp->rdidx;
+
+  return mrp->wridx - rd;
+}
+
+/**
+ * @brief   Returns the number of free message slots in a ring.
+ * @note    The value can be already obsolete when returned.
+ *
+ * @param[in] mrp       the pointer to an initialized @p mpring_t object
+ * @return              The number of empty message slots.
+ *
+ * @xclass
+ */
+static inline size_t chMPRingGetFreeCountX(const mpring_t *mrp) {
+
+  return chMPRingGetSizeX(mrp) - chMPRingGetUsedCountX(mrp);
+}
+
+#endif /* CH_CFG_USE_RINGS == TRUE */
+
+#endif /* CHRINGS_H */
+
+/** @} */
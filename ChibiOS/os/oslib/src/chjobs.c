@@ -0,0 +1,478 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    oslib/src/chjobs.c
+ * @brief   Jobs Systems code.
+ * @details Jobs systems.
+ *          <h2>Operation mode</h2>
+ *          A jobs system is a set of worker threads sharing a pool of job
+ *          descriptors, each worker owns a deque of jobs.<br>
+ *          - Jobs posted by a worker are pushed on the bottom of its own
+ *            deque, the owner takes jobs from the bottom so the most
+ *            recently posted job is executed first.
+ *          - Jobs posted by other threads are distributed among workers
+ *            and pushed on the top of the deques, the owner executes them
+ *            in order after its own jobs.
+ *          - Idle workers steal jobs from the top of the other workers
+ *            deques, the oldest jobs are stolen first.
+ *          - Workers with no jobs to execute or steal wait on a semaphore
+ *            signaled when new jobs are posted.
+ *          .
+ *          Each deque has room for all the job descriptors in the pool so
+ *          posting a job never fails.
+ * @pre     In order to use the jobs systems APIs the @p CH_CFG_USE_JOBS
+ *          option must be enabled in @p chconf.h.
+ * @note    Compatible with RT and NIL.
+ *
+ * @addtogroup oslib_jobs_queues
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the worker associated to the current thread.
+ *
+ * @param[in] jsp       pointer to a @p jobs_system_t structure
+ * @return              The pointer to the worker.
+ * @retval NULL         if the current thread is not a worker.
+ *
+ * @notapi
+ */
+static jobs_worker_t *jobs_self_s(jobs_system_t *jsp) {
+  thread_t *tp = chThdGetSelfX();
+  unsigned i;
+
+  for (i = 0U; i < jsp->workersn; i++) {
+    if (jsp->workers[i].thread == tp) {
+      return &jsp->workers[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Pushes a job on a worker deque.
+ * @note    An idle worker, if any, is awakened.
+ *
+ * @param[in] jsp       pointer to a @p jobs_system_t structure
+ * @param[in] jwp       pointer to the caller worker or @p NULL
+ * @param[in] jp        pointer to the job object
+ * @param[in] jgp       pointer to the job group or @p NULL
+ *
+ * @notapi
+ */
+static void jobs_push_s(jobs_system_t *jsp, jobs_worker_t *jwp,
+                        job_descriptor_t *jp, jobs_group_t *jgp) {
+  job_slot_t *slotp;
+
+  if (jwp != NULL) {
+    /* Local job, on the bottom of the caller deque.*/
+    chDbgAssert(jwp->cnt < jsp->jobsn, "deque full");
+
+    slotp = &jwp->slots[(jwp->top + jwp->cnt) % jsp->jobsn];
+  }
+  else {
+    /* Jobs posted by other threads are distributed among workers and
+       queued on top.*/
+    jwp = &jsp->workers[jsp->next];
+    jsp->next = (jsp->next + 1U) % jsp->workersn;
+
+    chDbgAssert(jwp->cnt < jsp->jobsn, "deque full");
+
+    jwp->top = (jwp->top + jsp->jobsn - 1U) % jsp->jobsn;
+    slotp = &jwp->slots[jwp->top];
+  }
+  slotp->jp  = jp;
+  slotp->grp = jgp;
+  jwp->cnt++;
+
+  /* Waking up an idle worker, it will steal the job if the target worker
+     is busy.*/
+  if (chSemGetCounterI(&jsp->idle) < (cnt_t)0) {
+    chSemSignalI(&jsp->idle);
+  }
+}
+
+/**
+ * @brief   Takes a job for execution.
+ * @details The newest job of the caller deque is taken, if the deque is
+ *          empty then the oldest job of another worker is stolen.
+ *
+ * @param[in] jsp       pointer to a @p jobs_system_t structure
+ * @param[in] jwp       pointer to the caller worker or @p NULL
+ * @param[out] slotp    pointer to the slot receiving the job
+ * @param[in] nulls     @p JOB_NULL jobs are taken too if @p true
+ * @return              The operation result.
+ * @retval true         if a job has been taken.
+ * @retval false        if there are no jobs to take.
+ *
+ * @notapi
+ */
+static bool jobs_take_s(jobs_system_t *jsp, jobs_worker_t *jwp,
+                        job_slot_t *slotp, bool nulls) {
+  unsigned i, first;
+
+  /* Own deque first, from the bottom.*/
+  if ((jwp != NULL) && (jwp->cnt > (size_t)0)) {
+    job_slot_t *bp = &jwp->slots[(jwp->top + jwp->cnt - 1U) % jsp->jobsn];
+
+    if (nulls || (bp->jp->jobfunc != NULL)) {
+      *slotp = *bp;
+      jwp->cnt--;
+      return true;
+    }
+  }
+
+  /* Stealing from the top of the other deques, starting from the worker
+     following the caller.*/
+  first = (jwp != NULL) ? (unsigned)(jwp - jsp->workers) + 1U : jsp->next;
+  for (i = 0U; i < jsp->workersn; i++) {
+    jobs_worker_t *vp = &jsp->workers[(first + i) % jsp->workersn];
+
+    if ((vp != jwp) && (vp->cnt > (size_t)0)) {
+      job_slot_t *tp = &vp->slots[vp->top];
+
+      if (nulls || (tp->jp->jobfunc != NULL)) {
+        *slotp = *tp;
+        vp->top = (vp->top + 1U) % jsp->jobsn;
+        vp->cnt--;
+        if (jwp != NULL) {
+          jwp->stolen++;
+        }
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief   Executes a job then returns it to the pool.
+ * @note    If the job belongs to a group and it is the last pending job
+ *          then the joining thread, if any, is resumed.
+ *
+ * @param[in] jsp       pointer to a @p jobs_system_t structure
+ * @param[in] slotp     pointer to the slot of the job
+ *
+ * @notapi
+ */
+static void jobs_execute(jobs_system_t *jsp, const job_slot_t *slotp) {
+  job_descriptor_t *jp = slotp->jp;
+  jobs_group_t *jgp = slotp->grp;
+
+  /* Invoking the job function.*/
+  jp->jobfunc(jp->jobarg);
+
+  chSysLock();
+
+  /* Returning the job descriptor object.*/
+  chGuardedPoolFreeI(&jsp->free, (void *)jp);
+
+  /* Group completion.*/
+  if (jgp != NULL) {
+    jgp->pending--;
+    if (jgp->pending == (cnt_t)0) {
+      chThdResumeI(&jgp->waiter, MSG_OK);
+    }
+  }
+
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a jobs system object.
+ *
+ * @param[out] jsp      pointer to a @p jobs_system_t structure
+ * @param[in] jobsn     number of jobs available
+ * @param[in] jobsbuf   pointer to the buffer of jobs, it must be able
+ *                      to hold @p jobsn @p job_descriptor_t structures
+ * @param[in] workersn  number of workers
+ * @param[in] workers   pointer to an array of @p workersn
+ *                      @p jobs_worker_t structures
+ * @param[in] slotsbuf  pointer to the buffer of deques, it must be able
+ *                      to hold <tt>workersn * jobsn</tt> @p job_slot_t
+ *                      structures
+ *
+ * @init
+ */
+void chJobSystemObjectInit(jobs_system_t *jsp,
+                           size_t jobsn,
+                           job_descriptor_t *jobsbuf,
+                           unsigned workersn,
+                           jobs_worker_t *workers,
+                           job_slot_t *slotsbuf) {
+  unsigned i;
+
+  chDbgCheck((jsp != NULL) && (jobsn > 0U) && (jobsbuf != NULL) &&
+             (workersn > 0U) && (workers != NULL) && (slotsbuf != NULL));
+
+  chGuardedPoolObjectInit(&jsp->free, sizeof (job_descriptor_t));
+  chGuardedPoolLoadArray(&jsp->free, (void *)jobsbuf, jobsn);
+  chSemObjectInit(&jsp->idle, (cnt_t)0);
+  jsp->jobsn    = jobsn;
+  jsp->workers  = workers;
+  jsp->workersn = workersn;
+  jsp->next     = 0U;
+
+  for (i = 0U; i < workersn; i++) {
+    workers[i].thread   = NULL;
+    workers[i].slots    = &slotsbuf[i * jobsn];
+    workers[i].top      = (size_t)0;
+    workers[i].cnt      = (size_t)0;
+    workers[i].executed = (ucnt_t)0;
+    workers[i].stolen   = (ucnt_t)0;
+  }
+}
+
+/**
+ * @brief   Posts a job object to a jobs system.
+ * @details The job is queued in the deque of the next worker in a round
+ *          robin order.
+ * @note    By design the object can be always immediately posted.
+ *
+ * @param[in] jsp       pointer to a @p jobs_system_t structure
+ * @param[in] jp        pointer to the job object to be posted
+ *
+ * @iclass
+ */
+void chJobSystemPostI(jobs_system_t *jsp, job_descriptor_t *jp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((jsp != NULL) && (jp != NULL));
+
+  jobs_push_s(jsp, NULL, jp, NULL);
+}
+
+/**
+ * @brief   Posts a job object to a jobs system.
+ * @details The job is queued in the deque of the next worker in a round
+ *          robin order.
+ * @note    By design the object can be always immediately posted.
+ *
+ * @param[in] jsp       pointer to a @p jobs_system_t structure
+ * @param[in] jp        pointer to the job object to be posted
+ *
+ * @api
+ */
+void chJobSystemPost(jobs_system_t *jsp, job_descriptor_t *jp) {
+
+  chSysLock();
+  chJobSystemPostI(jsp, jp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Posts a job object to the deque of the current worker.
+ * @details If the caller is not a worker of the jobs system then the job
+ *          is posted as by @p chJobSystemPostI().
+ * @note    By design the object can be always immediately posted.
+ *
+ * @param[in] jsp       pointer to a @p jobs_system_t structure
+ * @param[in] jp        pointer to the job object to be posted
+ *
+ * @sclass
+ */
+void chJobPostLocalS(jobs_system_t *jsp, job_descriptor_t *jp) {
+
+  chDbgCheckClassS();
+  chDbgCheck((jsp != NULL) && (jp != NULL));
+
+  jobs_push_s(jsp, jobs_self_s(jsp), jp, NULL);
+  chSchRescheduleS();
+}
+
+/**
+ * @brief   Posts a job object to the deque of the current worker.
+ * @details If the caller is not a worker of the jobs system then the job
+ *          is posted as by @p chJobSystemPost().
+ * @note    By design the object can be always immediately posted.
+ *
+ * @param[in] jsp       pointer to a @p jobs_system_t structure
+ * @param[in] jp        pointer to the job object to be posted
+ *
+ * @api
+ */
+void chJobPostLocal(jobs_system_t *jsp, job_descriptor_t *jp) {
+
+  chSysLock();
+  chJobPostLocalS(jsp, jp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Waits for a job then executes it.
+ * @note    This function must always be called by the same thread for
+ *          a given worker.
+ *
+ * @param[in] jsp       pointer to a @p jobs_system_t structure
+ * @param[in] jwp       pointer to the @p jobs_worker_t structure of the
+ *                      calling thread
+ * @return              The function outcome.
+ * @retval MSG_OK       if a job has been executed.
+ * @retval MSG_JOB_NULL if a @p JOB_NULL has been received.
+ *
+ * @api
+ */
+msg_t chJobWorkerDispatch(jobs_system_t *jsp, jobs_worker_t *jwp) {
+  job_slot_t slot;
+
+  chDbgCheck((jsp != NULL) && (jwp >= jsp->workers) &&
+             (jwp < &jsp->workers[jsp->workersn]));
+
+  chSysLock();
+
+  jwp->thread = chThdGetSelfX();
+
+  /* Waiting for a job, posts always signal idle workers.*/
+  while (!jobs_take_s(jsp, jwp, &slot, true)) {
+    (void) chSemWaitS(&jsp->idle);
+  }
+
+  chSysUnlock();
+
+  if (slot.jp->jobfunc == NULL) {
+
+    /* Returning the job descriptor object.*/
+    chGuardedPoolFree(&jsp->free, (void *)slot.jp);
+
+    return MSG_JOB_NULL;
+  }
+
+  jwp->executed++;
+  jobs_execute(jsp, &slot);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Spawns a job as part of a group.
+ * @details The job is queued in the deque of the current worker, if no
+ *          job objects are available then the job function is called
+ *          directly.
+ *
+ * @param[in] jsp       pointer to a @p jobs_system_t structure
+ * @param[in] jgp       pointer to a @p jobs_group_t structure
+ * @param[in] jobfunc   the job function
+ * @param[in] jobarg    the job function argument
+ *
+ * @api
+ */
+void chJobSpawn(jobs_system_t *jsp, jobs_group_t *jgp,
+                job_function_t jobfunc, void *jobarg) {
+  job_descriptor_t *jp;
+
+  chDbgCheck((jsp != NULL) && (jgp != NULL) && (jobfunc != NULL));
+
+  chSysLock();
+
+  jp = chJobSystemGetI(jsp);
+  if (jp == NULL) {
+    chSysUnlock();
+
+    /* No free jobs, executing it in place.*/
+    jobfunc(jobarg);
+
+    return;
+  }
+
+  jp->jobfunc = jobfunc;
+  jp->jobarg  = jobarg;
+  jgp->pending++;
+  jobs_push_s(jsp, jobs_self_s(jsp), jp, jgp);
+  chSchRescheduleS();
+
+  chSysUnlock();
+}
+
+/**
+ * @brief   Waits for all the jobs of a group to complete.
+ * @details While waiting the calling thread executes pending jobs, it only
+ *          sleeps when there are no jobs left to execute.
+ *
+ * @param[in] jsp       pointer to a @p jobs_system_t structure
+ * @param[in] jgp       pointer to a @p jobs_group_t structure
+ *
+ * @api
+ */
+void chJobJoin(jobs_system_t *jsp, jobs_group_t *jgp) {
+  jobs_worker_t *jwp;
+
+  chDbgCheck((jsp != NULL) && (jgp != NULL));
+
+  chSysLock();
+
+  jwp = jobs_self_s(jsp);
+  while (jgp->pending > (cnt_t)0) {
+    job_slot_t slot;
+
+    /* Helping, null jobs are left to the dispatchers.*/
+    if (jobs_take_s(jsp, jwp, &slot, false)) {
+      chSysUnlock();
+
+      if (jwp != NULL) {
+        jwp->executed++;
+      }
+      jobs_execute(jsp, &slot);
+
+      chSysLock();
+    }
+    else {
+      /* Remaining jobs are being executed by other threads.*/
+      (void) chThdSuspendTimeoutS(&jgp->waiter, TIME_INFINITE);
+    }
+  }
+
+  chSysUnlock();
+}
+
+#endif /* CH_CFG_USE_JOBS == TRUE */
+
+/** @} */
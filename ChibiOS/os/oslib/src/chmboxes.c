@@ -34,6 +34,10 @@
  *          - <b>Reset</b>: The mailbox is emptied and all the stored messages
  *            are lost.
  *          .
+ *          Priority mailboxes are a variant where each message is posted
+ *          with a key, either a priority or an absolute deadline, and
+ *          fetched in key order. Messages with the same key are fetched
+ *          in FIFO order.
  *          A message is a variable of type msg_t that is guaranteed to have
  *          the same size of and be compatible with (data) pointers (anyway an
  *          explicit cast is needed).
@@ -70,6 +74,109 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Compares two priority mailbox entries.
+ * @note    Deadlines and sequence numbers are compared using modular
+ *          arithmetic so pending deadlines must be within half the
+ *          system time range from each other.
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t object
+ * @param[in] ep1       first entry
+ * @param[in] ep2       second entry
+ * @return              The comparison result.
+ * @retval true         if the first entry must be fetched before the second.
+ * @retval false        if the second entry must be fetched before the first.
+ *
+ * @notapi
+ */
+static bool pmb_before(const prio_mailbox_t *pmbp,
+                       const pmb_entry_t *ep1,
+                       const pmb_entry_t *ep2) {
+
+  if (ep1->key != ep2->key) {
+    if (pmbp->order == PMB_ORDER_PRIORITY) {
+      return ep1->key > ep2->key;
+    }
+    return (systime_t)(ep2->key - ep1->key) <
+           (systime_t)((systime_t)-1 / (systime_t)2);
+  }
+
+  return (ucnt_t)(ep2->seq - ep1->seq) <
+         (ucnt_t)((ucnt_t)-1 / (ucnt_t)2);
+}
+
+/**
+ * @brief   Inserts a message in the heap.
+ * @pre     The heap must not be full.
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t object
+ * @param[in] msg       the message to be inserted
+ * @param[in] key       the message key
+ *
+ * @notapi
+ */
+static void pmb_insert(prio_mailbox_t *pmbp, msg_t msg, systime_t key) {
+  pmb_entry_t e;
+  size_t i;
+
+  e.msg = msg;
+  e.key = key;
+  e.seq = pmbp->seq++;
+
+  /* Sift-up, moving parents down until the insertion point is found.*/
+  i = pmbp->cnt++;
+  while (i > (size_t)0) {
+    size_t parent = (i - (size_t)1) / (size_t)2;
+
+    if (!pmb_before(pmbp, &e, &pmbp->buffer[parent])) {
+      break;
+    }
+    pmbp->buffer[i] = pmbp->buffer[parent];
+    i = parent;
+  }
+  pmbp->buffer[i] = e;
+}
+
+/**
+ * @brief   Removes the most urgent message from the heap.
+ * @pre     The heap must not be empty.
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t object
+ * @return              The removed message.
+ *
+ * @notapi
+ */
+static msg_t pmb_remove(prio_mailbox_t *pmbp) {
+  msg_t msg = pmbp->buffer[0].msg;
+  pmb_entry_t *ep;
+  size_t i, n;
+
+  /* Sift-down of the last entry starting from the root.*/
+  n  = --pmbp->cnt;
+  ep = &pmbp->buffer[n];
+  i  = (size_t)0;
+  while (true) {
+    size_t child = (i * (size_t)2) + (size_t)1;
+
+    if (child >= n) {
+      break;
+    }
+    if (((child + (size_t)1) < n) &&
+        pmb_before(pmbp, &pmbp->buffer[child + (size_t)1],
+                   &pmbp->buffer[child])) {
+      child++;
+    }
+    if (!pmb_before(pmbp, &pmbp->buffer[child], ep)) {
+      break;
+    }
+    pmbp->buffer[i] = pmbp->buffer[child];
+    i = child;
+  }
+  pmbp->buffer[i] = *ep;
+
+  return msg;
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -197,6 +304,8 @@ msg_t chMBPostTimeoutS(mailbox_t *mbp, msg_t msg, sysinterval_t timeout) {
   chDbgCheckClassS();
   chDbgCheck(mbp != NULL);
 
+  __trace_object(CH_TRACE_OBJ_MB_POST, mbp, msg);
+
   do {
     /* If the mailbox is in reset state then returns immediately.*/
     if (mbp->reset) {
@@ -245,6 +354,8 @@ msg_t chMBPostI(mailbox_t *mbp, msg_t msg) {
   chDbgCheckClassI();
   chDbgCheck(mbp != NULL);
 
+  __trace_object(CH_TRACE_OBJ_MB_POST, mbp, msg);
+
   /* If the mailbox is in reset state then returns immediately.*/
   if (mbp->reset) {
     return MSG_RESET;
@@ -322,6 +433,8 @@ msg_t chMBPostAheadTimeoutS(mailbox_t *mbp, msg_t msg, sysinterval_t timeout) {
   chDbgCheckClassS();
   chDbgCheck(mbp != NULL);
 
+  __trace_object(CH_TRACE_OBJ_MB_POST, mbp, msg);
+
   do {
     /* If the mailbox is in reset state then returns immediately.*/
     if (mbp->reset) {
@@ -370,6 +483,8 @@ msg_t chMBPostAheadI(mailbox_t *mbp, msg_t msg) {
   chDbgCheckClassI();
   chDbgCheck(mbp != NULL);
 
+  __trace_object(CH_TRACE_OBJ_MB_POST, mbp, msg);
+
   /* If the mailbox is in reset state then returns immediately.*/
   if (mbp->reset) {
     return MSG_RESET;
@@ -447,6 +562,8 @@ msg_t chMBFetchTimeoutS(mailbox_t *mbp, msg_t *msgp, sysinterval_t timeout) {
   chDbgCheckClassS();
   chDbgCheck((mbp != NULL) && (msgp != NULL));
 
+  __trace_object(CH_TRACE_OBJ_MB_FETCH, mbp, (msg_t)chMBGetUsedCountI(mbp));
+
   do {
     /* If the mailbox is in reset state then returns immediately.*/
     if (mbp->reset) {
@@ -495,6 +612,8 @@ msg_t chMBFetchI(mailbox_t *mbp, msg_t *msgp) {
   chDbgCheckClassI();
   chDbgCheck((mbp != NULL) && (msgp != NULL));
 
+  __trace_object(CH_TRACE_OBJ_MB_FETCH, mbp, (msg_t)chMBGetUsedCountI(mbp));
+
   /* If the mailbox is in reset state then returns immediately.*/
   if (mbp->reset) {
     return MSG_RESET;
@@ -517,6 +636,331 @@ msg_t chMBFetchI(mailbox_t *mbp, msg_t *msgp) {
   /* No message, immediate timeout.*/
   return MSG_TIMEOUT;
 }
+
+/**
+ * @brief   Initializes a @p prio_mailbox_t object.
+ *
+ * @param[out] pmbp     the pointer to the @p prio_mailbox_t structure to be
+ *                      initialized
+ * @param[in] buf       pointer to the entries buffer as an array of
+ *                      @p pmb_entry_t
+ * @param[in] n         number of elements in the buffer array
+ * @param[in] order     ordering of messages, @p PMB_ORDER_PRIORITY or
+ *                      @p PMB_ORDER_DEADLINE
+ *
+ * @init
+ */
+void chPMBObjectInit(prio_mailbox_t *pmbp, pmb_entry_t *buf, size_t n,
+                     pmb_order_t order) {
+
+  chDbgCheck((pmbp != NULL) && (buf != NULL) && (n > (size_t)0));
+
+  pmbp->buffer = buf;
+  pmbp->size   = n;
+  pmbp->cnt    = (size_t)0;
+  pmbp->order  = order;
+  pmbp->seq    = (ucnt_t)0;
+  pmbp->reset  = false;
+  chThdQueueObjectInit(&pmbp->qw);
+  chThdQueueObjectInit(&pmbp->qr);
+}
+
+/**
+ * @brief   Resets a @p prio_mailbox_t object.
+ * @details All the waiting threads are resumed with status @p MSG_RESET and
+ *          the queued messages are lost.
+ * @post    The mailbox is in reset state, all operations will fail and
+ *          return @p MSG_RESET until the mailbox is enabled again using
+ *          @p chPMBResumeX().
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t object
+ *
+ * @api
+ */
+void chPMBReset(prio_mailbox_t *pmbp) {
+
+  chSysLock();
+  chPMBResetI(pmbp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Resets a @p prio_mailbox_t object.
+ * @details All the waiting threads are resumed with status @p MSG_RESET and
+ *          the queued messages are lost.
+ * @post    The mailbox is in reset state, all operations will fail and
+ *          return @p MSG_RESET until the mailbox is enabled again using
+ *          @p chPMBResumeX().
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t object
+ *
+ * @iclass
+ */
+void chPMBResetI(prio_mailbox_t *pmbp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(pmbp != NULL);
+
+  pmbp->cnt   = (size_t)0;
+  pmbp->reset = true;
+  chThdDequeueAllI(&pmbp->qw, MSG_RESET);
+  chThdDequeueAllI(&pmbp->qr, MSG_RESET);
+}
+
+/**
+ * @brief   Posts a message into a priority mailbox.
+ * @details The invoking thread waits until a empty slot in the mailbox becomes
+ *          available or the specified time runs out.
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t object
+ * @param[in] msg       the message to be posted on the mailbox
+ * @param[in] key       the message priority or absolute deadline, depending
+ *                      on the mailbox ordering
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_RESET    if the mailbox has been reset.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chPMBPostTimeout(prio_mailbox_t *pmbp, msg_t msg, systime_t key,
+                       sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  chSysLock();
+  rdymsg = chPMBPostTimeoutS(pmbp, msg, key, timeout);
+  chSysUnlock();
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Posts a message into a priority mailbox.
+ * @details The invoking thread waits until a empty slot in the mailbox becomes
+ *          available or the specified time runs out.
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t object
+ * @param[in] msg       the message to be posted on the mailbox
+ * @param[in] key       the message priority or absolute deadline, depending
+ *                      on the mailbox ordering
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_RESET    if the mailbox has been reset.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @sclass
+ */
+msg_t chPMBPostTimeoutS(prio_mailbox_t *pmbp, msg_t msg, systime_t key,
+                        sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  chDbgCheckClassS();
+  chDbgCheck(pmbp != NULL);
+
+  __trace_object(CH_TRACE_OBJ_MB_POST, pmbp, msg);
+
+  do {
+    /* If the mailbox is in reset state then returns immediately.*/
+    if (pmbp->reset) {
+      return MSG_RESET;
+    }
+
+    /* Is there a free message slot in queue? if so then post.*/
+    if (chPMBGetFreeCountI(pmbp) > (size_t)0) {
+      pmb_insert(pmbp, msg, key);
+
+      /* If there is a reader waiting then makes it ready.*/
+      chThdDequeueNextI(&pmbp->qr, MSG_OK);
+      chSchRescheduleS();
+
+      return MSG_OK;
+    }
+
+    /* No space in the queue, waiting for a slot to become available.*/
+    rdymsg = chThdEnqueueTimeoutS(&pmbp->qw, timeout);
+  } while (rdymsg == MSG_OK);
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Posts a message into a priority mailbox.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the queue is full.
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t object
+ * @param[in] msg       the message to be posted on the mailbox
+ * @param[in] key       the message priority or absolute deadline, depending
+ *                      on the mailbox ordering
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_RESET    if the mailbox has been reset.
+ * @retval MSG_TIMEOUT  if the mailbox is full and the message cannot be
+ *                      posted.
+ *
+ * @iclass
+ */
+msg_t chPMBPostI(prio_mailbox_t *pmbp, msg_t msg, systime_t key) {
+
+  chDbgCheckClassI();
+  chDbgCheck(pmbp != NULL);
+
+  __trace_object(CH_TRACE_OBJ_MB_POST, pmbp, msg);
+
+  /* If the mailbox is in reset state then returns immediately.*/
+  if (pmbp->reset) {
+    return MSG_RESET;
+  }
+
+  /* Is there a free message slot in queue? if so then post.*/
+  if (chPMBGetFreeCountI(pmbp) > (size_t)0) {
+    pmb_insert(pmbp, msg, key);
+
+    /* If there is a reader waiting then makes it ready.*/
+    chThdDequeueNextI(&pmbp->qr, MSG_OK);
+
+    return MSG_OK;
+  }
+
+  /* No space, immediate timeout.*/
+  return MSG_TIMEOUT;
+}
+
+/**
+ * @brief   Retrieves the most urgent message from a priority mailbox.
+ * @details The invoking thread waits until a message is posted in the mailbox
+ *          or the specified time runs out.
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t object
+ * @param[out] msgp     pointer to a message variable for the received message
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_RESET    if the mailbox has been reset.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chPMBFetchTimeout(prio_mailbox_t *pmbp, msg_t *msgp,
+                        sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  chSysLock();
+  rdymsg = chPMBFetchTimeoutS(pmbp, msgp, timeout);
+  chSysUnlock();
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Retrieves the most urgent message from a priority mailbox.
+ * @details The invoking thread waits until a message is posted in the mailbox
+ *          or the specified time runs out.
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t object
+ * @param[out] msgp     pointer to a message variable for the received message
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_RESET    if the mailbox has been reset.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @sclass
+ */
+msg_t chPMBFetchTimeoutS(prio_mailbox_t *pmbp, msg_t *msgp,
+                         sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  chDbgCheckClassS();
+  chDbgCheck((pmbp != NULL) && (msgp != NULL));
+
+  __trace_object(CH_TRACE_OBJ_MB_FETCH, pmbp,
+                 (msg_t)chPMBGetUsedCountI(pmbp));
+
+  do {
+    /* If the mailbox is in reset state then returns immediately.*/
+    if (pmbp->reset) {
+      return MSG_RESET;
+    }
+
+    /* Is there a message in queue? if so then fetch.*/
+    if (chPMBGetUsedCountI(pmbp) > (size_t)0) {
+      *msgp = pmb_remove(pmbp);
+
+      /* If there is a writer waiting then makes it ready.*/
+      chThdDequeueNextI(&pmbp->qw, MSG_OK);
+      chSchRescheduleS();
+
+      return MSG_OK;
+    }
+
+    /* No message in the queue, waiting for a message to become available.*/
+    rdymsg = chThdEnqueueTimeoutS(&pmbp->qr, timeout);
+  } while (rdymsg == MSG_OK);
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Retrieves the most urgent message from a priority mailbox.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the queue is empty.
+ *
+ * @param[in] pmbp      the pointer to an initialized @p prio_mailbox_t object
+ * @param[out] msgp     pointer to a message variable for the received message
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_RESET    if the mailbox has been reset.
+ * @retval MSG_TIMEOUT  if the mailbox is empty and a message cannot be
+ *                      fetched.
+ *
+ * @iclass
+ */
+msg_t chPMBFetchI(prio_mailbox_t *pmbp, msg_t *msgp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((pmbp != NULL) && (msgp != NULL));
+
+  __trace_object(CH_TRACE_OBJ_MB_FETCH, pmbp,
+                 (msg_t)chPMBGetUsedCountI(pmbp));
+
+  /* If the mailbox is in reset state then returns immediately.*/
+  if (pmbp->reset) {
+    return MSG_RESET;
+  }
+
+  /* Is there a message in queue? if so then fetch.*/
+  if (chPMBGetUsedCountI(pmbp) > (size_t)0) {
+    *msgp = pmb_remove(pmbp);
+
+    /* If there is a writer waiting then makes it ready.*/
+    chThdDequeueNextI(&pmbp->qw, MSG_OK);
+
+    return MSG_OK;
+  }
+
+  /* No message, immediate timeout.*/
+  return MSG_TIMEOUT;
+}
 #endif /* CH_CFG_USE_MAILBOXES == TRUE */
 
 /** @} */
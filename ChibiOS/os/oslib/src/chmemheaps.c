@@ -29,6 +29,12 @@
  *          library functions. The main difference is that the OS heap APIs
  *          are guaranteed to be thread safe and there is the ability to
  *          return memory blocks aligned to arbitrary powers of two.<br>
+ *          When @p CH_CFG_HEAP_TLSF is enabled the free blocks are kept
+ *          in segregated lists indexed by size class, two bitmaps allow
+ *          to find a suitable list in constant time. Released blocks are
+ *          merged with their physical neighbors using boundary tags so
+ *          both allocation and release take a bounded time regardless of
+ *          the number of fragments.<br>
  * @pre     In order to use the heap APIs the @p CH_CFG_USE_HEAP option must
  *          be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -74,6 +80,47 @@
   ((size_t)((p1) - (p2)))                                                   \
   /*lint -restore*/
 
+#if (CH_CFG_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+/*
+ * Size classes geometry, the first level class zero is linear and contains
+ * blocks smaller than @p H_SL_COUNT pages.
+ */
+#define H_SL_LOG2       3U
+#define H_SL_COUNT      (1U << H_SL_LOG2)
+#define H_FL_COUNT      CH_CFG_HEAP_TLSF_CLASSES
+
+/*
+ * Flags in the link field of a block header. Free blocks keep the next
+ * block in their free list in this field, used blocks keep the owner heap.
+ */
+#define H_FREE          ((uintptr_t)1)
+#define H_PREV_FREE     ((uintptr_t)2)
+#define H_FLAGS         (H_FREE | H_PREV_FREE)
+
+#define H_LINK(hp)      ((hp)->tlsf.link)
+
+#define H_IS_FREE(hp)   ((H_LINK(hp) & H_FREE) != (uintptr_t)0)
+
+#define H_IS_PREV_FREE(hp) ((H_LINK(hp) & H_PREV_FREE) != (uintptr_t)0)
+
+#define H_LNEXT(hp)     ((heap_header_t *)(H_LINK(hp) & ~H_FLAGS))
+
+#define H_OWNER(hp)     ((memory_heap_t *)(H_LINK(hp) & ~H_FLAGS))
+
+/*
+ * Free blocks store the previous block in their free list in the first
+ * word of the area and a pointer to their header in the last word of the
+ * area, the latter allows to find the physically previous block on
+ * release. Blocks having zero pages are not kept in any free list, their
+ * "footer" is the pages field which is zero.
+ */
+#define H_LPREV(hp)     (((heap_header_t **)(void *)H_BLOCK(hp))[0])
+
+#define H_FOOTER(hp)    (((heap_header_t **)(void *)H_LIMIT(hp))[-1])
+
+#define H_PHYS_PREV(hp) (((heap_header_t **)(void *)(hp))[-1])
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -95,6 +142,232 @@ static memory_heap_t default_heap;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Index of the least significant bit set in a non-zero word.
+ *
+ * @param[in] x         the word to be scanned, must not be zero
+ * @return              The bit index.
+ */
+static inline unsigned heap_ctz(uint32_t x) {
+#if defined(__GNUC__)
+  return (unsigned)__builtin_ctz(x);
+#else
+  unsigned n = 0U;
+
+  while ((x & 1U) == 0U) {
+    x >>= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
+/**
+ * @brief   Index of the most significant bit set in a non-zero size.
+ *
+ * @param[in] x         the size to be scanned, must not be zero
+ * @return              The bit index.
+ */
+static inline unsigned heap_fls(size_t x) {
+#if defined(__GNUC__)
+  return ((unsigned)sizeof (unsigned long long) * 8U) - 1U -
+         (unsigned)__builtin_clzll((unsigned long long)x);
+#else
+  unsigned n = 0U;
+
+  while (x > (size_t)1) {
+    x >>= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
+/**
+ * @brief   Returns the size class containing blocks of the specified size.
+ * @note    Sizes beyond the highest class are mapped on its last list.
+ *
+ * @param[in] pages     block size in pages
+ * @param[out] flp      pointer to the first level index
+ * @param[out] slp      pointer to the second level index
+ */
+static void heap_mapping(size_t pages, unsigned *flp, unsigned *slp) {
+
+  if (pages < (size_t)H_SL_COUNT) {
+    *flp = 0U;
+    *slp = (unsigned)pages;
+  }
+  else {
+    unsigned b = heap_fls(pages);
+    unsigned fl = (b - H_SL_LOG2) + 1U;
+
+    if (fl >= H_FL_COUNT) {
+      *flp = H_FL_COUNT - 1U;
+      *slp = H_SL_COUNT - 1U;
+    }
+    else {
+      *flp = fl;
+      *slp = (unsigned)(pages >> (b - H_SL_LOG2)) - H_SL_COUNT;
+    }
+  }
+}
+
+/**
+ * @brief   Inserts a free block in the list of its size class.
+ * @details The physically next block is marked as having a free
+ *          predecessor.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @param[in] hp        pointer to the block header, the block must have
+ *                      at least one page
+ */
+static void heap_insert(memory_heap_t *heapp, heap_header_t *hp) {
+  heap_header_t *np;
+  unsigned fl, sl;
+
+  heap_mapping(H_PAGES(hp), &fl, &sl);
+  np = heapp->lists[fl][sl];
+
+  /* Block is free and its predecessor is not, blocks are always merged.*/
+  H_LINK(hp) = (uintptr_t)np | H_FREE;
+  H_LPREV(hp) = NULL;
+  H_FOOTER(hp) = hp;
+  if (np != NULL) {
+    H_LPREV(np) = hp;
+  }
+  heapp->lists[fl][sl] = hp;
+  heapp->slmap[fl] |= (uint32_t)1U << sl;
+  heapp->flmap |= (uint32_t)1U << fl;
+
+  H_LINK(H_LIMIT(hp)) |= H_PREV_FREE;
+}
+
+/**
+ * @brief   Marks a zero pages block as free.
+ * @details The block is too small to be kept in a free list, it is merged
+ *          when one of its neighbors is released.
+ *
+ * @param[in] hp        pointer to the block header
+ */
+static void heap_orphan(heap_header_t *hp) {
+
+  H_LINK(hp) = H_FREE;
+  H_PAGES(hp) = (size_t)0;
+  H_LINK(H_LIMIT(hp)) |= H_PREV_FREE;
+}
+
+/**
+ * @brief   Removes a free block from the list of its size class.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @param[in] hp        pointer to the block header
+ */
+static void heap_remove(memory_heap_t *heapp, heap_header_t *hp) {
+  heap_header_t *np = H_LNEXT(hp);
+  heap_header_t *pp = H_LPREV(hp);
+
+  if (np != NULL) {
+    H_LPREV(np) = pp;
+  }
+  if (pp != NULL) {
+    H_LINK(pp) = (uintptr_t)np | (H_LINK(pp) & H_FLAGS);
+  }
+  else {
+    unsigned fl, sl;
+
+    heap_mapping(H_PAGES(hp), &fl, &sl);
+    heapp->lists[fl][sl] = np;
+    if (np == NULL) {
+      heapp->slmap[fl] &= ~((uint32_t)1U << sl);
+      if (heapp->slmap[fl] == 0U) {
+        heapp->flmap &= ~((uint32_t)1U << fl);
+      }
+    }
+  }
+}
+
+/**
+ * @brief   Finds a free block of at least the specified size.
+ * @details The size is rounded up to the next class boundary so that any
+ *          block in the found list is large enough, if this fails then the
+ *          first block in the class of the exact size is checked. The last
+ *          class can contain blocks of any size and is searched first-fit.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @param[in] pages     minimum block size in pages
+ * @return              Pointer to the header of a suitable block.
+ * @retval NULL         if a suitable block has not been found.
+ */
+static heap_header_t *heap_find(memory_heap_t *heapp, size_t pages) {
+  heap_header_t *hp;
+  size_t rpages = pages;
+  unsigned fl, sl;
+  uint32_t m;
+
+  if (pages >= (size_t)H_SL_COUNT) {
+    rpages += ((size_t)1 << (heap_fls(pages) - H_SL_LOG2)) - (size_t)1;
+  }
+  heap_mapping(rpages, &fl, &sl);
+
+  m = heapp->slmap[fl] & ((uint32_t)0xFFFFFFFFU << sl);
+  if (m == 0U) {
+    m = heapp->flmap & ((uint32_t)0xFFFFFFFEU << fl);
+    if (m == 0U) {
+      /* No class is guaranteed to fit, trying with the first block of
+         the exact size class.*/
+      heap_mapping(pages, &fl, &sl);
+      hp = heapp->lists[fl][sl];
+      if ((hp != NULL) && (H_PAGES(hp) >= pages)) {
+        return hp;
+      }
+      return NULL;
+    }
+    fl = heap_ctz(m);
+    m = heapp->slmap[fl];
+  }
+  sl = heap_ctz(m);
+
+  hp = heapp->lists[fl][sl];
+  if ((fl == (H_FL_COUNT - 1U)) && (sl == (H_SL_COUNT - 1U))) {
+    while ((hp != NULL) && (H_PAGES(hp) < pages)) {
+      hp = H_LNEXT(hp);
+    }
+  }
+
+  return hp;
+}
+
+/**
+ * @brief   Initializes the free lists of a heap.
+ *
+ * @param[out] heapp    pointer to the heap descriptor
+ */
+static void heap_lists_init(memory_heap_t *heapp) {
+  unsigned fl, sl;
+
+  heapp->flmap = 0U;
+  for (fl = 0U; fl < H_FL_COUNT; fl++) {
+    heapp->slmap[fl] = 0U;
+    for (sl = 0U; sl < H_SL_COUNT; sl++) {
+      heapp->lists[fl][sl] = NULL;
+    }
+  }
+}
+
+/**
+ * @brief   Writes the used header terminating a memory region.
+ * @note    The terminator prevents merging beyond the region end.
+ *
+ * @param[in] hp        pointer to the terminator header
+ */
+static void heap_terminate(heap_header_t *hp) {
+
+  H_LINK(hp) = (uintptr_t)0;
+  H_SIZE(hp) = (size_t)0;
+}
+#endif /* CH_CFG_HEAP_TLSF == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -107,8 +380,12 @@ static memory_heap_t default_heap;
 void __heap_init(void) {
 
   default_heap.provider = chCoreAllocAlignedWithOffset;
+#if CH_CFG_HEAP_TLSF == TRUE
+  heap_lists_init(&default_heap);
+#else
   H_NEXT(&default_heap.header) = NULL;
   H_PAGES(&default_heap.header) = 0;
+#endif
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   chMtxObjectInit(&default_heap.mtx);
 #else
@@ -141,10 +418,21 @@ void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size) {
 
   /* Initializing the heap header.*/
   heapp->provider = NULL;
+#if CH_CFG_HEAP_TLSF == TRUE
+  chDbgAssert(size >= (sizeof (heap_header_t) * 3U), "heap too small");
+
+  /* A single free block followed by the region terminator.*/
+  heap_lists_init(heapp);
+  H_LINK(hp) = (uintptr_t)0;
+  H_PAGES(hp) = (size / CH_HEAP_ALIGNMENT) - 2U;
+  heap_terminate(H_LIMIT(hp));
+  heap_insert(heapp, hp);
+#else
   H_NEXT(&heapp->header) = hp;
   H_PAGES(&heapp->header) = 0;
   H_NEXT(hp) = NULL;
   H_PAGES(hp) = (size - sizeof (heap_header_t)) / CH_HEAP_ALIGNMENT;
+#endif
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   chMtxObjectInit(&heapp->mtx);
 #else
@@ -153,8 +441,7 @@ void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size) {
 }
 
 /**
- * @brief   Allocates a block of memory from the heap by using the first-fit
- *          algorithm.
+ * @brief   Allocates a block of memory from the heap.
  * @details The allocated block is guaranteed to be properly aligned to the
  *          specified alignment.
  *
@@ -170,7 +457,10 @@ void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size) {
  * @api
  */
 void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align) {
-  heap_header_t *qp, *hp, *ahp;
+#if CH_CFG_HEAP_TLSF == FALSE
+  heap_header_t *qp;
+#endif
+  heap_header_t *hp, *ahp;
   size_t pages;
 
   chDbgCheck((size > 0U) && MEM_IS_VALID_ALIGNMENT(align));
@@ -191,6 +481,64 @@ void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align) {
   /* Taking heap mutex/semaphore.*/
   H_LOCK(heapp);
 
+#if CH_CFG_HEAP_TLSF == TRUE
+  /* The searched block has enough space for any alignment offset, an
+     offset of a single page becomes a zero pages free block.*/
+  hp = heap_find(heapp, pages + ((size_t)align / CH_HEAP_ALIGNMENT) - 1U);
+  if (hp != NULL) {
+    size_t rpages;
+
+    heap_remove(heapp, hp);
+
+    /* Pointer aligned to the requested alignment.*/
+    ahp = (heap_header_t *)MEM_ALIGN_NEXT(H_BLOCK(hp), align) - 1U;
+    if (ahp > hp) {
+      /* The block is not properly aligned, the leading part is split
+         and released.*/
+      size_t lpages = NPAGES(ahp, hp);
+
+      H_LINK(ahp) = (uintptr_t)0;
+      H_PAGES(ahp) = H_PAGES(hp) - lpages;
+      if (lpages == 1U) {
+        heap_orphan(hp);
+      }
+      else {
+        H_PAGES(hp) = lpages - 1U;
+        heap_insert(heapp, hp);
+      }
+      hp = ahp;
+    }
+
+    /* The excess part is split and released.*/
+    rpages = H_PAGES(hp) - pages;
+    if (rpages > 0U) {
+      heap_header_t *fp = H_BLOCK(hp) + pages;
+
+      H_LINK(fp) = (uintptr_t)0;
+      if (rpages == 1U) {
+        heap_orphan(fp);
+      }
+      else {
+        H_PAGES(fp) = rpages - 1U;
+        heap_insert(heapp, fp);
+      }
+    }
+    else {
+      H_LINK(H_LIMIT(hp)) &= ~H_PREV_FREE;
+    }
+
+    /* Setting in the block owner heap and size.*/
+    H_LINK(hp) = (uintptr_t)heapp | (H_LINK(hp) & H_PREV_FREE);
+    H_SIZE(hp) = size;
+
+    /* Releasing heap mutex/semaphore.*/
+    H_UNLOCK(heapp);
+
+    /*lint -save -e9087 [11.3] Safe cast.*/
+    return (void *)H_BLOCK(hp);
+    /*lint -restore*/
+  }
+#else
   /* Start of the free blocks list.*/
   qp = &heapp->header;
   while (H_NEXT(qp) != NULL) {
@@ -259,6 +607,7 @@ void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align) {
     /* Next in the free blocks list.*/
     qp = hp;
   }
+#endif
 
   /* Releasing heap mutex/semaphore.*/
   H_UNLOCK(heapp);
@@ -266,6 +615,17 @@ void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align) {
   /* More memory is required, tries to get it from the associated provider
      else fails.*/
   if (heapp->provider != NULL) {
+#if CH_CFG_HEAP_TLSF == TRUE
+    /* The new region contains the block and its terminator.*/
+    ahp = heapp->provider((pages + 1U) * CH_HEAP_ALIGNMENT,
+                          align,
+                          sizeof (heap_header_t));
+    if (ahp != NULL) {
+      hp = ahp - 1U;
+      H_LINK(hp) = (uintptr_t)heapp;
+      H_SIZE(hp) = size;
+      heap_terminate(H_BLOCK(hp) + pages);
+#else
     ahp = heapp->provider(pages * CH_HEAP_ALIGNMENT,
                           align,
                           sizeof (heap_header_t));
@@ -273,6 +633,7 @@ void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align) {
       hp = ahp - 1U;
       H_HEAP(hp) = heapp;
       H_SIZE(hp) = size;
+#endif
 
       /*lint -save -e9087 [11.3] Safe cast.*/
       return (void *)ahp;
@@ -299,6 +660,42 @@ void chHeapFree(void *p) {
   /*lint -save -e9087 [11.3] Safe cast.*/
   hp = (heap_header_t *)p - 1U;
   /*lint -restore*/
+#if CH_CFG_HEAP_TLSF == TRUE
+  heapp = H_OWNER(hp);
+  chDbgAssert(!H_IS_FREE(hp), "not allocated");
+
+  /* Size is converted in number of elementary allocation units.*/
+  H_PAGES(hp) = MEM_ALIGN_NEXT(H_SIZE(hp),
+                               CH_HEAP_ALIGNMENT) / CH_HEAP_ALIGNMENT;
+
+  /* Taking heap mutex/semaphore.*/
+  H_LOCK(heapp);
+
+  /* Merging with the physically next block if free.*/
+  qp = H_LIMIT(hp);
+  if (H_IS_FREE(qp)) {
+    if (H_PAGES(qp) > 0U) {
+      heap_remove(heapp, qp);
+    }
+    H_PAGES(hp) += H_PAGES(qp) + 1U;
+  }
+
+  /* Merging with the physically previous block if free, its address is
+     in its footer.*/
+  if (H_IS_PREV_FREE(hp)) {
+    qp = H_PHYS_PREV(hp);
+    if (qp == NULL) {
+      qp = hp - 1U;
+    }
+    else {
+      heap_remove(heapp, qp);
+    }
+    H_PAGES(qp) += H_PAGES(hp) + 1U;
+    hp = qp;
+  }
+
+  heap_insert(heapp, hp);
+#else
   heapp = H_HEAP(hp);
   qp = &heapp->header;
 
@@ -332,6 +729,7 @@ void chHeapFree(void *p) {
     }
     qp = H_NEXT(qp);
   }
+#endif
 
   /* Releasing heap mutex/semaphore.*/
   H_UNLOCK(heapp);
@@ -366,6 +764,29 @@ size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp) {
   tpages = 0U;
   lpages = 0U;
   n = 0U;
+#if CH_CFG_HEAP_TLSF == TRUE
+  {
+    unsigned fl, sl;
+
+    for (fl = 0U; fl < H_FL_COUNT; fl++) {
+      for (sl = 0U; sl < H_SL_COUNT; sl++) {
+        qp = heapp->lists[fl][sl];
+        while (qp != NULL) {
+          size_t pages = H_PAGES(qp);
+
+          /* Updating counters.*/
+          n++;
+          tpages += pages;
+          if (pages > lpages) {
+            lpages = pages;
+          }
+
+          qp = H_LNEXT(qp);
+        }
+      }
+    }
+  }
+#else
   qp = &heapp->header;
   while (H_NEXT(qp) != NULL) {
     size_t pages = H_PAGES(H_NEXT(qp));
@@ -379,6 +800,7 @@ size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp) {
 
     qp = H_NEXT(qp);
   }
+#endif
 
   /* Writing out fragmented free memory.*/
   if (totalp != NULL) {
@@ -56,6 +56,90 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_POOL_MAGAZINES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of objects moved between a magazine and its pool.
+ * @details Half of the magazine capacity, this leaves room for both
+ *          allocations and releases after each pool access.
+ */
+static size_t magazine_batch(const pool_magazine_t *pmp) {
+
+  return (pmp->size + (size_t)1) / (size_t)2;
+}
+
+/**
+ * @brief   Takes an object from the pool underlying a magazine.
+ * @note    The last free object of a guarded pool is not taken, it is
+ *          left to the other threads using the pool.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ * @return              The pointer to the object.
+ * @retval NULL         if the pool is empty.
+ *
+ * @notapi
+ */
+static void *magazine_get_i(pool_magazine_t *pmp) {
+
+#if CH_CFG_USE_SEMAPHORES == TRUE
+  if (pmp->guarded != NULL) {
+    if (chGuardedPoolGetCounterI(pmp->guarded) <= (cnt_t)1) {
+      return NULL;
+    }
+    return chGuardedPoolAllocI(pmp->guarded);
+  }
+#endif
+
+  return chPoolAllocI(pmp->pool);
+}
+
+/**
+ * @brief   Returns an object to the pool underlying a magazine.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ * @param[in] objp      the pointer to the object to be released
+ *
+ * @notapi
+ */
+static void magazine_put_i(pool_magazine_t *pmp, void *objp) {
+
+#if CH_CFG_USE_SEMAPHORES == TRUE
+  if (pmp->guarded != NULL) {
+    chGuardedPoolFreeI(pmp->guarded, objp);
+    return;
+  }
+#endif
+
+  chPoolFreeI(pmp->pool, objp);
+}
+
+/**
+ * @brief   Checks if the pool underlying a magazine ran out of objects.
+ * @details Only guarded pools can run out, threads could be waiting on
+ *          the pool semaphore for the objects held in the magazine.
+ * @note    The counter is read without locking, a stale value can only
+ *          delay the return of the objects to the next release.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ * @return              The pool state.
+ * @retval false        if the pool has free objects or is not guarded.
+ * @retval true         if the pool has no free objects.
+ *
+ * @notapi
+ */
+static bool magazine_is_starved(pool_magazine_t *pmp) {
+
+#if CH_CFG_USE_SEMAPHORES == TRUE
+  if (pmp->guarded != NULL) {
+    return *(volatile cnt_t *)&pmp->guarded->sem.cnt <= (cnt_t)0;
+  }
+#else
+  (void)pmp;
+#endif
+
+  return false;
+}
+#endif /* CH_CFG_USE_POOL_MAGAZINES == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -331,6 +415,215 @@ void chGuardedPoolFree(guarded_memory_pool_t *gmp, void *objp) {
 }
 #endif
 
+#if (CH_CFG_USE_POOL_MAGAZINES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a magazine in front of a memory pool.
+ * @note    A magazine must only be used by the thread owning it, different
+ *          threads can have their own magazines on the same pool.
+ *
+ * @param[out] pmp      pointer to a @p pool_magazine_t structure
+ * @param[in] mp        pointer to the underlying @p memory_pool_t structure
+ * @param[in] buf       pointer to an array of @p n pointers used as objects
+ *                      stack
+ * @param[in] n         magazine capacity as number of objects
+ *
+ * @init
+ */
+void chPoolMagazineObjectInit(pool_magazine_t *pmp, memory_pool_t *mp,
+                              void **buf, size_t n) {
+
+  chDbgCheck((pmp != NULL) && (mp != NULL) && (buf != NULL) && (n > 0U));
+
+  pmp->pool    = mp;
+#if CH_CFG_USE_SEMAPHORES == TRUE
+  pmp->guarded = NULL;
+#endif
+  pmp->objects = buf;
+  pmp->size    = n;
+  pmp->cnt     = (size_t)0;
+  pmp->hits    = (ucnt_t)0;
+  pmp->misses  = (ucnt_t)0;
+}
+
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a magazine in front of a guarded memory pool.
+ * @note    A magazine must only be used by the thread owning it, different
+ *          threads can have their own magazines on the same pool.
+ * @note    Objects held in the magazine are not counted by the pool
+ *          semaphore, other threads could wait for objects held in a
+ *          magazine, use @p chPoolMagazineFlush() in order to return them.
+ *          The objects are also returned by @p chPoolMagazineFree() when
+ *          the pool runs out of objects.
+ *
+ * @param[out] pmp      pointer to a @p pool_magazine_t structure
+ * @param[in] gmp       pointer to the underlying @p guarded_memory_pool_t
+ *                      structure
+ * @param[in] buf       pointer to an array of @p n pointers used as objects
+ *                      stack
+ * @param[in] n         magazine capacity as number of objects
+ *
+ * @init
+ */
+void chGuardedPoolMagazineObjectInit(pool_magazine_t *pmp,
+                                     guarded_memory_pool_t *gmp,
+                                     void **buf, size_t n) {
+
+  chDbgCheck(gmp != NULL);
+
+  chPoolMagazineObjectInit(pmp, &gmp->pool, buf, n);
+  pmp->guarded = gmp;
+}
+#endif /* CH_CFG_USE_SEMAPHORES == TRUE */
+
+/**
+ * @brief   Allocates an object through a magazine.
+ * @details If the magazine is not empty then an object is taken from it
+ *          without locking, else the magazine is refilled from the pool
+ *          with up to half its capacity under a single critical section.
+ *          The refill does not take the last free object of a guarded
+ *          pool.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      only used with guarded memory pools, the following
+ *                      special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The pointer to the allocated object.
+ * @retval NULL         if the pool is empty or the operation timed out.
+ *
+ * @api
+ */
+void *chPoolMagazineAllocTimeout(pool_magazine_t *pmp,
+                                 sysinterval_t timeout) {
+  size_t batch;
+  void *objp;
+
+  chDbgCheck(pmp != NULL);
+
+  if (pmp->cnt > (size_t)0) {
+    pmp->hits++;
+    pmp->cnt--;
+    return pmp->objects[pmp->cnt];
+  }
+
+  pmp->misses++;
+  batch = magazine_batch(pmp);
+
+  chSysLock();
+#if CH_CFG_USE_SEMAPHORES == TRUE
+  if (pmp->guarded != NULL) {
+    objp = chGuardedPoolAllocTimeoutS(pmp->guarded, timeout);
+  }
+  else {
+    objp = chPoolAllocI(pmp->pool);
+  }
+#else
+  (void)timeout;
+  objp = chPoolAllocI(pmp->pool);
+#endif
+  if (objp != NULL) {
+    /* Refilling with the objects readily available, the returned object
+       is not part of the batch.*/
+    while (pmp->cnt < batch - (size_t)1) {
+      void *p = magazine_get_i(pmp);
+      if (p == NULL) {
+        break;
+      }
+      pmp->objects[pmp->cnt] = p;
+      pmp->cnt++;
+    }
+  }
+  chSysUnlock();
+
+  return objp;
+}
+
+/**
+ * @brief   Releases an object through a magazine.
+ * @details If the magazine is not full then the object is pushed on it
+ *          without locking, else the oldest half of the magazine is
+ *          returned to the pool under a single critical section.
+ * @note    If the underlying guarded pool has no free objects then the
+ *          object and all the objects held in the magazine are returned
+ *          to the pool, so threads waiting on the pool are not starved
+ *          by the magazine.
+ * @pre     The freed object must be of the right size for the underlying
+ *          memory pool.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ * @param[in] objp      the pointer to the object to be released
+ *
+ * @api
+ */
+void chPoolMagazineFree(pool_magazine_t *pmp, void *objp) {
+  size_t i, batch;
+
+  chDbgCheck((pmp != NULL) && (objp != NULL));
+
+  if (magazine_is_starved(pmp)) {
+    pmp->misses++;
+    chSysLock();
+    magazine_put_i(pmp, objp);
+    while (pmp->cnt > (size_t)0) {
+      pmp->cnt--;
+      magazine_put_i(pmp, pmp->objects[pmp->cnt]);
+    }
+    chSchRescheduleS();
+    chSysUnlock();
+    return;
+  }
+
+  if (pmp->cnt < pmp->size) {
+    pmp->hits++;
+    pmp->objects[pmp->cnt] = objp;
+    pmp->cnt++;
+    return;
+  }
+
+  pmp->misses++;
+  batch = magazine_batch(pmp);
+
+  /* The oldest objects are at the bottom of the stack, the most recently
+     used ones are kept because more likely to be still in cache.*/
+  chSysLock();
+  for (i = (size_t)0; i < batch; i++) {
+    magazine_put_i(pmp, pmp->objects[i]);
+  }
+  chSchRescheduleS();
+  chSysUnlock();
+
+  for (i = batch; i < pmp->cnt; i++) {
+    pmp->objects[i - batch] = pmp->objects[i];
+  }
+  pmp->cnt -= batch;
+  pmp->objects[pmp->cnt] = objp;
+  pmp->cnt++;
+}
+
+/**
+ * @brief   Returns all the objects held in a magazine to the pool.
+ *
+ * @param[in] pmp       pointer to a @p pool_magazine_t structure
+ *
+ * @api
+ */
+void chPoolMagazineFlush(pool_magazine_t *pmp) {
+
+  chDbgCheck(pmp != NULL);
+
+  chSysLock();
+  while (pmp->cnt > (size_t)0) {
+    pmp->cnt--;
+    magazine_put_i(pmp, pmp->objects[pmp->cnt]);
+  }
+  chSchRescheduleS();
+  chSysUnlock();
+}
+#endif /* CH_CFG_USE_POOL_MAGAZINES == TRUE */
+
 #endif /* CH_CFG_USE_MEMPOOLS == TRUE */
 
 /** @} */
@@ -43,6 +43,22 @@
  *          - <b>Release Object</b>: Releases an object to the cache handling
  *            the media update, if required.
  *          .
+ *          <h2>Segments</h2>
+ *          The hash table and the objects buffers are split in
+ *          @p CH_CFG_OBJ_CACHES_SEGMENTS segments, each one with its own
+ *          LRU list. An object is always cached in the segment owning its
+ *          hash slot so critical sections only touch the lists of a single
+ *          segment.<br>
+ *          <h2>Read-ahead</h2>
+ *          When enabled using @p chCacheSetReadAhead(), accesses to
+ *          consecutive keys of the same group are detected and the
+ *          following objects are read asynchronously, objects accessed
+ *          sequentially are queued on the LRU tail on release so that
+ *          scans do not flush the rest of the cache.<br>
+ *          <h2>Write-back</h2>
+ *          Eviction prefers objects not marked as @p OC_FLAG_LAZYWRITE,
+ *          dirty objects near the LRU tail can be written in background
+ *          by calling @p chCacheWriteBack() from a low priority thread.
  * @pre     In order to use the pipes APIs the @p CH_CFG_USE_OBJ_CACHES
  *          option must be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -81,20 +97,25 @@
   (objp)->hash_next->hash_prev = (objp)->hash_prev;                         \
 }
 
+/* Segment owning an object.*/
+#define OC_SEGMENT(ocp, group, key)                                         \
+  (&(ocp)->segments[OC_HASH_FUNCTION(ocp, group, key) &                     \
+                    ((unsigned)CH_CFG_OBJ_CACHES_SEGMENTS - 1U)])
+
 /* Insertion on LRU list head (newer objects).*/
-#define LRU_INSERT_HEAD(ocp, objp) {                                        \
-  (objp)->lru_next = (ocp)->lru.lru_next;                                   \
-  (objp)->lru_prev = (oc_object_t *)&(ocp)->lru;                            \
-  (ocp)->lru.lru_next->lru_prev = (objp);                                   \
-  (ocp)->lru.lru_next = (objp);                                             \
+#define LRU_INSERT_HEAD(sgp, objp) {                                        \
+  (objp)->lru_next = (sgp)->lru.lru_next;                                   \
+  (objp)->lru_prev = (oc_object_t *)&(sgp)->lru;                            \
+  (sgp)->lru.lru_next->lru_prev = (objp);                                   \
+  (sgp)->lru.lru_next = (objp);                                             \
 }
 
-/* Insertion on LRU list head (newer objects).*/
-#define LRU_INSERT_TAIL(ocp, objp) {                                        \
-  (objp)->lru_prev = (ocp)->lru.lru_prev;                                   \
-  (objp)->lru_next = (oc_object_t *)&(ocp)->lru;                            \
-  (ocp)->lru.lru_prev->lru_next = (objp);                                   \
-  (ocp)->lru.lru_prev = (objp);                                             \
+/* Insertion on LRU list tail (older objects).*/
+#define LRU_INSERT_TAIL(sgp, objp) {                                        \
+  (objp)->lru_prev = (sgp)->lru.lru_prev;                                   \
+  (objp)->lru_next = (oc_object_t *)&(sgp)->lru;                            \
+  (sgp)->lru.lru_prev->lru_next = (objp);                                   \
+  (sgp)->lru.lru_prev = (objp);                                             \
 }
 
 /* Removal of an object from the LRU list.*/
@@ -155,51 +176,110 @@ static oc_object_t *hash_get_s(objects_cache_t *ocp,
 }
 
 /**
- * @brief   Gets the least recently used object buffer from the LRU list.
+ * @brief   Searches the LRU tail of a segment for an object.
  *
- * @param[out] ocp      pointer to the @p objects_cache_t structure to be
- * @return              The pointer to the retrieved object.
+ * @param[in] sgp       pointer to the @p oc_segment_t structure
+ * @param[in] dirty     searches for a dirty object if @p true, for a clean
+ *                      object if @p false
+ * @return              The pointer to the found object.
+ * @retval NULL         if no object has been found within
+ *                      @p OC_LRU_SCAN_DEPTH objects from the tail.
  *
  * @notapi
  */
-static oc_object_t *lru_get_last_s(objects_cache_t *ocp) {
-  oc_object_t *objp;
+static oc_object_t *lru_find_s(oc_segment_t *sgp, bool dirty) {
+  oc_object_t *objp = sgp->lru.lru_prev;
+  unsigned n = OC_LRU_SCAN_DEPTH;
 
-  while (true) {
-    /* Waiting for an object buffer to become available in the LRU.*/
-    (void) chSemWaitS(&ocp->lru_sem);
+  while ((objp != (oc_object_t *)&sgp->lru) && (n > 0U)) {
+    if (((objp->obj_flags & OC_FLAG_LAZYWRITE) != 0U) == dirty) {
+      return objp;
+    }
+    objp = objp->lru_prev;
+    n--;
+  }
 
-    /* Now an object buffer is in the LRU for sure, taking it from the
-       LRU tail.*/
-    objp = ocp->lru.lru_prev;
+  return NULL;
+}
 
-    chDbgAssert((objp->obj_flags & OC_FLAG_INLRU) == OC_FLAG_INLRU,
-                "not in LRU");
-    chDbgAssert(chSemGetCounterI(&objp->obj_sem) == (cnt_t)1,
-                "semaphore counter not 1");
+/**
+ * @brief   Takes ownership of an object in the LRU list.
+ * @note    The LRU semaphore of the segment must have already been taken.
+ *
+ * @param[in] objp      pointer to the @p oc_object_t structure
+ *
+ * @notapi
+ */
+static void lru_take_s(oc_object_t *objp) {
 
-    LRU_REMOVE(objp);
-    objp->obj_flags &= ~OC_FLAG_INLRU;
+  chDbgAssert((objp->obj_flags & OC_FLAG_INLRU) == OC_FLAG_INLRU,
+              "not in LRU");
+  chDbgAssert(chSemGetCounterI(&objp->obj_sem) == (cnt_t)1,
+              "semaphore counter not 1");
 
-    /* Getting the object semaphore, we know there is no wait so
-       using the "fast" variant.*/
-    chSemFastWaitI(&objp->obj_sem);
+  LRU_REMOVE(objp);
+  objp->obj_flags &= ~OC_FLAG_INLRU;
 
-    /* If it is a buffer not needing (lazy) write then it can be used
-       right away.*/
-    if ((objp->obj_flags & OC_FLAG_LAZYWRITE) == 0U) {
+  /* Getting the object semaphore, we know there is no wait so
+     using the "fast" variant.*/
+  chSemFastWaitI(&objp->obj_sem);
+}
 
-      /* Removing from hash table if required.*/
-      if ((objp->obj_flags & OC_FLAG_INHASH) != 0U) {
-        HASH_REMOVE(objp);
-      }
+/**
+ * @brief   Recycles a clean object taken from the LRU list.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] objp      pointer to the @p oc_object_t structure
+ *
+ * @notapi
+ */
+static void lru_recycle_s(objects_cache_t *ocp, oc_object_t *objp) {
+
+  lru_take_s(objp);
+
+  /* Removing from hash table if required.*/
+  if ((objp->obj_flags & OC_FLAG_INHASH) != 0U) {
+    HASH_REMOVE(objp);
+    ocp->stats.evictions++;
+  }
+
+  /* Removing all flags, it is "new" now.*/
+  objp->obj_flags = 0U;
+}
+
+/**
+ * @brief   Gets the least recently used object buffer from the LRU list.
+ * @details Clean objects near the LRU tail are preferred, dirty objects
+ *          are only written if there are no clean objects within
+ *          @p OC_LRU_SCAN_DEPTH objects from the tail.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] sgp       pointer to the @p oc_segment_t structure
+ * @return              The pointer to the retrieved object.
+ *
+ * @notapi
+ */
+static oc_object_t *lru_get_last_s(objects_cache_t *ocp, oc_segment_t *sgp) {
+  oc_object_t *objp;
+
+  while (true) {
+    /* Waiting for an object buffer to become available in the LRU.*/
+    (void) chSemWaitS(&sgp->lru_sem);
 
-      /* Removing all flags, it is "new" now.*/
-      objp->obj_flags = 0U;
+    /* Now an object buffer is in the LRU for sure, taking the oldest
+       buffer not needing (lazy) write, it can be used right away.*/
+    objp = lru_find_s(sgp, false);
+    if (objp != NULL) {
+      lru_recycle_s(ocp, objp);
 
       return objp;
     }
 
+    /* Only dirty buffers near the LRU tail, taking the last one.*/
+    objp = sgp->lru.lru_prev;
+    lru_take_s(objp);
+    ocp->stats.dirty_evictions++;
+
     /* Out of critical section.*/
     chSysUnlock();
 
@@ -214,6 +294,115 @@ static oc_object_t *lru_get_last_s(objects_cache_t *ocp) {
   }
 }
 
+/**
+ * @brief   Updates the sequential access detector.
+ * @details If the access is part of a sequential scan then the read-ahead
+ *          window is moved forward and the object is marked with
+ *          @p OC_FLAG_FORGET.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] objp      pointer to the accessed object, owned by the caller
+ *
+ * @notapi
+ */
+static void seq_detect_s(objects_cache_t *ocp, oc_object_t *objp) {
+  uint32_t group = objp->obj_group;
+  uint32_t key   = objp->obj_key;
+  uint32_t last;
+
+  if (ocp->ra_window == (ucnt_t)0) {
+    return;
+  }
+
+  if ((group == ocp->seq_group) && (key == ocp->seq_key + 1U)) {
+    if (ocp->seq_cnt < (ucnt_t)OC_SEQ_THRESHOLD) {
+      ocp->seq_cnt++;
+    }
+  }
+  else {
+    ocp->seq_cnt   = (ucnt_t)0;
+    ocp->seq_group = group;
+  }
+  ocp->seq_key = key;
+
+  if (ocp->seq_cnt < (ucnt_t)OC_SEQ_THRESHOLD) {
+    return;
+  }
+
+  /* Sequential scan, the window is restarted if it is not ahead of the
+     current key, else it is extended.*/
+  last = key + (uint32_t)ocp->ra_window;
+  if ((ocp->ra_key <= key) || (ocp->ra_key > last + 1U)) {
+    ocp->ra_key = key + 1U;
+  }
+  ocp->ra_cnt = (ucnt_t)(last + 1U - ocp->ra_key);
+
+  /* Scanned objects are not likely to be reused.*/
+  objp->obj_flags |= OC_FLAG_FORGET;
+}
+
+/**
+ * @brief   Issues the pending read-ahead operations.
+ * @details Objects are only read ahead if clean buffers are immediately
+ *          available in their segment, this function never waits.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ *
+ * @notapi
+ */
+static void cache_readahead(objects_cache_t *ocp) {
+
+  while (true) {
+    oc_segment_t *sgp;
+    oc_object_t *objp;
+    uint32_t group, key;
+
+    chSysLock();
+
+    if (ocp->ra_cnt == (ucnt_t)0) {
+      break;
+    }
+
+    group = ocp->seq_group;
+    key   = ocp->ra_key;
+    ocp->ra_key++;
+    ocp->ra_cnt--;
+
+    /* Already cached.*/
+    if (hash_get_s(ocp, group, key) != NULL) {
+      chSysUnlock();
+      continue;
+    }
+
+    /* Free buffers in the segment, the window is dropped if none.*/
+    sgp  = OC_SEGMENT(ocp, group, key);
+    objp = NULL;
+    if (chSemGetCounterI(&sgp->lru_sem) > (cnt_t)0) {
+      objp = lru_find_s(sgp, false);
+    }
+    if (objp == NULL) {
+      ocp->ra_cnt = (ucnt_t)0;
+      break;
+    }
+    chSemFastWaitI(&sgp->lru_sem);
+    lru_recycle_s(ocp, objp);
+
+    /* Naming this object and publishing it in the hash table.*/
+    objp->obj_group = group;
+    objp->obj_key   = key;
+    objp->obj_flags = OC_FLAG_INHASH | OC_FLAG_NOTSYNC;
+    HASH_INSERT(ocp, objp, group, key);
+    ocp->stats.readaheads++;
+
+    chSysUnlock();
+
+    /* The reader releases the object once it has been read.*/
+    (void) ocp->readf(ocp, objp, true);
+  }
+
+  chSysUnlock();
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -246,24 +435,48 @@ void chCacheObjectInit(objects_cache_t *ocp,
                        oc_readf_t readf,
                        oc_writef_t writef) {
 
+  ucnt_t i;
+
   chDbgCheck((ocp != NULL) && (hashp != NULL) && (objvp != NULL) &&
              ((hashn & (hashn - (ucnt_t)1)) == (ucnt_t)0) &&
-             (objn > (ucnt_t)0) && (hashn >= objn) &&
+             (objn >= (ucnt_t)CH_CFG_OBJ_CACHES_SEGMENTS) &&
+             (hashn >= objn) &&
              (objsz >= sizeof (oc_object_t)) &&
              ((objsz & (PORT_NATURAL_ALIGN - 1U)) == 0U));
 
   chSemObjectInit(&ocp->cache_sem, (cnt_t)1);
-  chSemObjectInit(&ocp->lru_sem, (cnt_t)objn);
   ocp->hashn            = hashn;
   ocp->hashp            = hashp;
   ocp->objn             = objn;
   ocp->objvp            = objvp;
   ocp->readf            = readf;
   ocp->writef           = writef;
-  ocp->lru.hash_next    = NULL;
-  ocp->lru.hash_prev    = NULL;
-  ocp->lru.lru_next     = (oc_object_t *)&ocp->lru;
-  ocp->lru.lru_prev     = (oc_object_t *)&ocp->lru;
+  ocp->ra_window        = (ucnt_t)0;
+  ocp->seq_group        = 0U;
+  ocp->seq_key          = 0U;
+  ocp->seq_cnt          = (ucnt_t)0;
+  ocp->ra_key           = 0U;
+  ocp->ra_cnt           = (ucnt_t)0;
+  ocp->stats.hits            = (ucnt_t)0;
+  ocp->stats.misses          = (ucnt_t)0;
+  ocp->stats.evictions       = (ucnt_t)0;
+  ocp->stats.dirty_evictions = (ucnt_t)0;
+  ocp->stats.readaheads      = (ucnt_t)0;
+  ocp->stats.writebacks      = (ucnt_t)0;
+
+  /* Segments initialization, objects are distributed evenly.*/
+  for (i = (ucnt_t)0; i < (ucnt_t)CH_CFG_OBJ_CACHES_SEGMENTS; i++) {
+    oc_segment_t *sgp = &ocp->segments[i];
+
+    chSemObjectInit(&sgp->lru_sem,
+                    (cnt_t)((objn + (ucnt_t)CH_CFG_OBJ_CACHES_SEGMENTS -
+                             i - (ucnt_t)1) /
+                            (ucnt_t)CH_CFG_OBJ_CACHES_SEGMENTS));
+    sgp->lru.hash_next  = NULL;
+    sgp->lru.hash_prev  = NULL;
+    sgp->lru.lru_next   = (oc_object_t *)&sgp->lru;
+    sgp->lru.lru_prev   = (oc_object_t *)&sgp->lru;
+  }
 
   /* Hash headers initialization.*/
   do {
@@ -273,18 +486,21 @@ void chCacheObjectInit(objects_cache_t *ocp,
   } while (hashp < &ocp->hashp[ocp->hashn]);
 
   /* Object headers initialization.*/
+  i = (ucnt_t)0;
   do {
     oc_object_t *objp = (oc_object_t *)objvp;
+    oc_segment_t *sgp = &ocp->segments[i &
+                          ((ucnt_t)CH_CFG_OBJ_CACHES_SEGMENTS - (ucnt_t)1)];
 
     chSemObjectInit(&objp->obj_sem, (cnt_t)1);
-    LRU_INSERT_HEAD(ocp, objp);
+    LRU_INSERT_HEAD(sgp, objp);
     objp->obj_group = 0U;
     objp->obj_key   = 0U;
     objp->obj_flags = OC_FLAG_INLRU;
     objp->dptr      = NULL;
     objvp = (void *)((uint8_t *)objvp + objsz);
-    objn--;
-  } while (objn > (ucnt_t)0);
+    i++;
+  } while (i < objn);
 }
 
 /**
@@ -304,6 +520,7 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
                               uint32_t group,
                               uint32_t key) {
   oc_object_t *objp;
+  bool readahead;
 
   /* Critical section enter, the hash check operation is fast.*/
   chSysLock();
@@ -315,21 +532,15 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
     chDbgAssert((objp->obj_flags & OC_FLAG_INHASH) == OC_FLAG_INHASH,
                 "not in hash");
 
+    ocp->stats.hits++;
+
     /* Cache hit, checking if the buffer is owned by some
        other thread.*/
     if (chSemGetCounterI(&objp->obj_sem) > (cnt_t)0) {
-      /* Not owned case, it is in the LRU list.*/
-
-      chDbgAssert((objp->obj_flags & OC_FLAG_INLRU) == OC_FLAG_INLRU,
-                  "not in LRU");
-
-      /* Removing the object from LRU, now it is "owned".*/
-      LRU_REMOVE(objp);
-      objp->obj_flags &= ~OC_FLAG_INLRU;
-
-      /* Getting the object semaphore, we know there is no wait so
-         using the "fast" variant.*/
-      chSemFastWaitI(&objp->obj_sem);
+      /* Not owned case, it is in the LRU list, removing the object from
+         LRU, now it is "owned".*/
+      chSemFastWaitI(&OC_SEGMENT(ocp, group, key)->lru_sem);
+      lru_take_s(objp);
     }
     else {
       /* Owned case, some other thread is playing with this object, we
@@ -342,8 +553,11 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
     }
   }
   else {
-    /* Cache miss, getting an object buffer from the LRU list.*/
-    objp = lru_get_last_s(ocp);
+    ocp->stats.misses++;
+
+    /* Cache miss, getting an object buffer from the LRU list of the
+       segment owning the object.*/
+    objp = lru_get_last_s(ocp, OC_SEGMENT(ocp, group, key));
 
     /* Naming this object and publishing it in the hash table.*/
     objp->obj_group = group;
@@ -352,9 +566,19 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
     HASH_INSERT(ocp, objp, group, key);
   }
 
+  /* Sequential accesses detection, on a miss the read-ahead is started
+     by chCacheReadObject() after the object itself has been read.*/
+  seq_detect_s(ocp, objp);
+  readahead = (ocp->ra_cnt > (ucnt_t)0) &&
+              ((objp->obj_flags & OC_FLAG_NOTSYNC) == 0U);
+
   /* Out of critical section and returning the object.*/
   chSysUnlock();
 
+  if (readahead) {
+    cache_readahead(ocp);
+  }
+
   return objp;
 }
 
@@ -377,6 +601,7 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
  */
 void chCacheReleaseObjectI(objects_cache_t *ocp,
                            oc_object_t *objp) {
+  oc_segment_t *sgp;
 
   /* Checking initial conditions of the object to be released.*/
   chDbgAssert((objp->obj_flags & (OC_FLAG_INLRU |
@@ -397,11 +622,14 @@ void chCacheReleaseObjectI(objects_cache_t *ocp,
     return;
   }
 
+  /* Segment owning the object.*/
+  sgp = OC_SEGMENT(ocp, objp->obj_group, objp->obj_key);
+
   /* If the object specifies OC_FLAG_NOTSYNC then it must be invalidated
      and removed from the hash table.*/
   if ((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U) {
     HASH_REMOVE(objp);
-    LRU_INSERT_TAIL(ocp, objp);
+    LRU_INSERT_TAIL(sgp, objp);
     objp->obj_group = 0U;
     objp->obj_key   = 0U;
     objp->obj_flags = OC_FLAG_INLRU;
@@ -410,18 +638,18 @@ void chCacheReleaseObjectI(objects_cache_t *ocp,
     /* LRU insertion point depends on the OC_FLAG_FORGET flag.*/
     if ((objp->obj_flags & OC_FLAG_FORGET) == 0U) {
       /* Placing it on head.*/
-      LRU_INSERT_HEAD(ocp, objp);
+      LRU_INSERT_HEAD(sgp, objp);
     }
     else {
       /* Low priority data, placing it on tail.*/
-      LRU_INSERT_TAIL(ocp, objp);
+      LRU_INSERT_TAIL(sgp, objp);
     }
     objp->obj_flags &= OC_FLAG_INHASH | OC_FLAG_LAZYWRITE;
     objp->obj_flags |= OC_FLAG_INLRU;
   }
 
   /* Increasing the LRU counter semaphore.*/
-  chSemSignalI(&ocp->lru_sem);
+  chSemSignalI(&sgp->lru_sem);
 
   /* Releasing the object, we know there are no threads waiting so
      using the "fast" signal variant.*/
@@ -448,13 +676,21 @@ void chCacheReleaseObjectI(objects_cache_t *ocp,
 bool chCacheReadObject(objects_cache_t *ocp,
                        oc_object_t *objp,
                        bool async) {
+  bool result;
 
   /* Marking it as OC_FLAG_NOTSYNC because the read operation is going
      to corrupt it in case of failure. It is responsibility of the read
      implementation to clear it if the operation succeeds.*/
   objp->obj_flags |= OC_FLAG_NOTSYNC;
 
-  return ocp->readf(ocp, objp, async);
+  result = ocp->readf(ocp, objp, async);
+
+  /* Pending read-ahead, if any, is issued after the requested object.*/
+  if (ocp->ra_window > (ucnt_t)0) {
+    cache_readahead(ocp);
+  }
+
+  return result;
 }
 
 /**
@@ -485,6 +721,108 @@ bool chCacheWriteObject(objects_cache_t *ocp,
   return ocp->writef(ocp, objp, async);
 }
 
+/**
+ * @brief   Sets the read-ahead window of a cache.
+ * @details When a sequential access pattern is detected the cache reads
+ *          asynchronously up to @p n objects following the last accessed
+ *          one, objects accessed sequentially are also released on the
+ *          LRU tail in order to not flush the rest of the cache.
+ * @note    Read-ahead requires a reader function able to operate
+ *          asynchronously, the read operation is invoked from the context
+ *          of the thread accessing the cache.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] n         number of objects to be read ahead, zero disables
+ *                      the read-ahead
+ *
+ * @api
+ */
+void chCacheSetReadAhead(objects_cache_t *ocp, ucnt_t n) {
+
+  chDbgCheck(ocp != NULL);
+
+  chSysLock();
+  ocp->ra_window = n;
+  ocp->seq_cnt   = (ucnt_t)0;
+  ocp->ra_cnt    = (ucnt_t)0;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Writes back dirty objects.
+ * @details Objects marked as @p OC_FLAG_LAZYWRITE near the LRU tails are
+ *          written asynchronously and returned to the LRU tails, this way
+ *          eviction finds clean objects and does not need to write. This
+ *          function is meant to be called periodically from a low priority
+ *          thread.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] n         maximum number of objects to be written
+ * @return              The number of objects written.
+ *
+ * @api
+ */
+ucnt_t chCacheWriteBack(objects_cache_t *ocp, ucnt_t n) {
+  ucnt_t written = (ucnt_t)0;
+
+  chDbgCheck(ocp != NULL);
+
+  while (written < n) {
+    oc_segment_t *sgp;
+    oc_object_t *objp = NULL;
+
+    chSysLock();
+
+    /* Searching for a dirty object in the segments, one object is
+       written for each critical section.*/
+    for (sgp = &ocp->segments[0];
+         sgp < &ocp->segments[CH_CFG_OBJ_CACHES_SEGMENTS];
+         sgp++) {
+      objp = lru_find_s(sgp, true);
+      if (objp != NULL) {
+        break;
+      }
+    }
+
+    if (objp == NULL) {
+      chSysUnlock();
+      break;
+    }
+
+    chSemFastWaitI(&sgp->lru_sem);
+    lru_take_s(objp);
+    ocp->stats.writebacks++;
+
+    chSysUnlock();
+
+    /* Invoking the writer asynchronously, it will release the buffer once
+       it is written, the object is still valid and goes back in the LRU.*/
+    objp->obj_flags = OC_FLAG_INHASH;
+    (void) ocp->writef(ocp, objp, true);
+    written++;
+  }
+
+  return written;
+}
+
+/**
+ * @brief   Returns the cache statistics.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[out] sp       pointer to the @p oc_stats_t structure receiving
+ *                      the statistics
+ *
+ * @api
+ */
+void chCacheGetStatistics(objects_cache_t *ocp, oc_stats_t *sp) {
+
+  chDbgCheck((ocp != NULL) && (sp != NULL));
+
+  chSysLock();
+  *sp = ocp->stats;
+  chSysUnlock();
+}
+
 #endif /* CH_CFG_USE_OBJ_CACHES == TRUE */
 
 /** @} */
@@ -29,6 +29,10 @@
  *          - <b>Reset</b>: The pipe is emptied and all the stored data
  *            is lost.
  *          .
+ *          Data can also be exchanged without copies by loaning regions
+ *          of the pipe buffer, a writer acquires a write span, fills it
+ *          and commits it, a reader acquires a read span, consumes it and
+ *          releases it.
  * @pre     In order to use the pipes APIs the @p CH_CFG_USE_PIPES
  *          option must be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -190,6 +194,63 @@ static size_t pipe_read(pipe_t *pp, uint8_t *bp, size_t n) {
   return n;
 }
 
+/**
+ * @brief   Describes a buffer region starting at a given pointer.
+ * @details The region is split in two spans if it crosses the buffer end.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] p         pointer to the start of the region
+ * @param[in] n         size of the region
+ * @param[out] psp      pointer to the @p pipe_span_t structure to be filled
+ *
+ * @notapi
+ */
+static void pipe_get_span(pipe_t *pp, uint8_t *p, size_t n,
+                          pipe_span_t *psp) {
+  size_t s1;
+
+  /* Number of bytes before buffer limit.*/
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  s1 = (size_t)(pp->top - p);
+  /*lint -restore*/
+
+  psp->ptr1 = p;
+  if (n <= s1) {
+    psp->n1   = n;
+    psp->ptr2 = NULL;
+    psp->n2   = (size_t)0;
+  }
+  else {
+    psp->n1   = s1;
+    psp->ptr2 = pp->buffer;
+    psp->n2   = n - s1;
+  }
+}
+
+/**
+ * @brief   Advances a buffer pointer wrapping at the buffer end.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] p         the pointer to be advanced
+ * @param[in] n         number of bytes, not greater than the buffer size
+ * @return              The advanced pointer.
+ *
+ * @notapi
+ */
+static uint8_t *pipe_advance(pipe_t *pp, uint8_t *p, size_t n) {
+  size_t s1;
+
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  s1 = (size_t)(pp->top - p);
+  /*lint -restore*/
+
+  if (n < s1) {
+    return p + n;
+  }
+
+  return pp->buffer + (n - s1);
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -383,6 +444,200 @@ size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
   return max - n;
 }
 
+/**
+ * @brief   Loans the pipe free space to the caller.
+ * @details The function waits for at least @p n free bytes then describes
+ *          the whole free space of the pipe into @p psp, the caller can
+ *          write data directly in the described spans and then makes it
+ *          available to readers using @p chPipeCommitWrite().
+ * @note    The write side of the pipe is locked until the loan is
+ *          terminated by @p chPipeCommitWrite(), which must be invoked by
+ *          the same thread. Other writers are blocked meanwhile, readers
+ *          are not affected.
+ * @note    The pipe must not be reset and resumed while a span is on loan.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[out] psp      pointer to a @p pipe_span_t structure receiving the
+ *                      loaned spans
+ * @param[in] n         the minimum number of free bytes to wait for, the
+ *                      value 0 is reserved and the value must not be
+ *                      greater than the pipe size
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The total size of the loaned spans.
+ * @retval 0            if a timeout occurred or the pipe went in reset
+ *                      state, in this case there is no loan and
+ *                      @p chPipeCommitWrite() must not be invoked.
+ *
+ * @api
+ */
+size_t chPipeAcquireWriteSpan(pipe_t *pp, pipe_span_t *psp,
+                              size_t n, sysinterval_t timeout) {
+  size_t avail;
+
+  chDbgCheck((pp != NULL) && (psp != NULL) &&
+             (n > 0U) && (n <= chPipeGetSize(pp)));
+
+  /* If the pipe is in reset state then returns immediately.*/
+  if (pp->reset) {
+    return (size_t)0;
+  }
+
+  PW_LOCK(pp);
+
+  /* The free space can only grow while this side is locked so a snapshot
+     of the counter is enough. The check is done under kernel lock in order
+     to not miss a wakeup from the other side.*/
+  chSysLock();
+  while ((avail = chPipeGetFreeCount(pp)) < n) {
+    if (pp->reset ||
+        (chThdSuspendTimeoutS(&pp->wtr, timeout) != MSG_OK)) {
+      chSysUnlock();
+      PW_UNLOCK(pp);
+      return (size_t)0;
+    }
+  }
+  chSysUnlock();
+
+  pipe_get_span(pp, pp->wrptr, avail, psp);
+
+  return avail;
+}
+
+/**
+ * @brief   Terminates a write loan.
+ * @details The first @p n bytes of the loaned spans are queued in the
+ *          pipe and the reader, if waiting, is resumed.
+ * @note    If the pipe went in reset state during the loan then the data
+ *          is discarded.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the number of bytes written in the spans, zero
+ *                      cancels the loan
+ *
+ * @api
+ */
+void chPipeCommitWrite(pipe_t *pp, size_t n) {
+
+  chDbgCheck(pp != NULL);
+
+  PC_LOCK(pp);
+  if (!pp->reset) {
+    chDbgAssert(n <= chPipeGetFreeCount(pp), "out of loan");
+
+    pp->cnt  += n;
+    pp->wrptr = pipe_advance(pp, pp->wrptr, n);
+  }
+  PC_UNLOCK(pp);
+
+  /* Resuming the reader, if present.*/
+  if (n > 0U) {
+    chThdResume(&pp->rtr, MSG_OK);
+  }
+
+  PW_UNLOCK(pp);
+}
+
+/**
+ * @brief   Loans the pipe queued data to the caller.
+ * @details The function waits for at least @p n queued bytes then
+ *          describes all the data queued in the pipe into @p psp, the
+ *          caller can consume data directly from the described spans and
+ *          then returns the space to writers using @p chPipeReleaseRead().
+ * @note    The read side of the pipe is locked until the loan is
+ *          terminated by @p chPipeReleaseRead(), which must be invoked by
+ *          the same thread. Other readers are blocked meanwhile, writers
+ *          are not affected.
+ * @note    The pipe must not be reset and resumed while a span is on loan.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[out] psp      pointer to a @p pipe_span_t structure receiving the
+ *                      loaned spans
+ * @param[in] n         the minimum number of queued bytes to wait for, the
+ *                      value 0 is reserved and the value must not be
+ *                      greater than the pipe size
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The total size of the loaned spans.
+ * @retval 0            if a timeout occurred or the pipe went in reset
+ *                      state, in this case there is no loan and
+ *                      @p chPipeReleaseRead() must not be invoked.
+ *
+ * @api
+ */
+size_t chPipeAcquireReadSpan(pipe_t *pp, pipe_span_t *psp,
+                             size_t n, sysinterval_t timeout) {
+  size_t avail;
+
+  chDbgCheck((pp != NULL) && (psp != NULL) &&
+             (n > 0U) && (n <= chPipeGetSize(pp)));
+
+  /* If the pipe is in reset state then returns immediately.*/
+  if (pp->reset) {
+    return (size_t)0;
+  }
+
+  PR_LOCK(pp);
+
+  /* The queued data can only grow while this side is locked so a snapshot
+     of the counter is enough. The check is done under kernel lock in order
+     to not miss a wakeup from the other side.*/
+  chSysLock();
+  while ((avail = chPipeGetUsedCount(pp)) < n) {
+    if (pp->reset ||
+        (chThdSuspendTimeoutS(&pp->rtr, timeout) != MSG_OK)) {
+      chSysUnlock();
+      PR_UNLOCK(pp);
+      return (size_t)0;
+    }
+  }
+  chSysUnlock();
+
+  pipe_get_span(pp, pp->rdptr, avail, psp);
+
+  return avail;
+}
+
+/**
+ * @brief   Terminates a read loan.
+ * @details The first @p n bytes of the loaned spans are removed from the
+ *          pipe and the writer, if waiting, is resumed.
+ * @note    If the pipe went in reset state during the loan then nothing
+ *          is removed.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the number of bytes consumed from the spans, zero
+ *                      cancels the loan
+ *
+ * @api
+ */
+void chPipeReleaseRead(pipe_t *pp, size_t n) {
+
+  chDbgCheck(pp != NULL);
+
+  PC_LOCK(pp);
+  if (!pp->reset) {
+    chDbgAssert(n <= chPipeGetUsedCount(pp), "out of loan");
+
+    pp->cnt  -= n;
+    pp->rdptr = pipe_advance(pp, pp->rdptr, n);
+  }
+  PC_UNLOCK(pp);
+
+  /* Resuming the writer, if present.*/
+  if (n > 0U) {
+    chThdResume(&pp->wtr, MSG_OK);
+  }
+
+  PR_UNLOCK(pp);
+}
+
 #endif /* CH_CFG_USE_PIPES == TRUE */
 
 /** @} */
@@ -0,0 +1,870 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    oslib/src/chrings.c
+ * @brief   Rings code.
+ * @details Messages rings.
+ *          <h2>Operation mode</h2>
+ *          A ring is an asynchronous communication mechanism similar to
+ *          a mailbox, messages are posted and fetched in FIFO order.<br>
+ *          Differently from mailboxes the ring indexes are updated
+ *          outside the kernel critical zone, the kernel is only entered
+ *          when a thread has to wait for the ring or another thread is
+ *          waiting and has to be resumed.<br>
+ *          Two kinds of ring are available:
+ *          - <b>ring_t</b>: a single producer and single consumer ring,
+ *            posting and fetching messages are wait-free operations.
+ *          - <b>mpring_t</b>: a multiple producers and single consumer
+ *            ring, producers reserve slots using a compare and swap
+ *            operation then write their messages concurrently.
+ *          .
+ *          The batch APIs transfer multiple messages with a single index
+ *          update and at most one wakeup.
+ * @pre     In order to use the rings APIs the @p CH_CFG_USE_RINGS
+ *          option must be enabled in @p chconf.h.
+ * @note    Rings are meant for communication between threads and ISRs
+ *          running on the same core.
+ * @note    Ring sizes must be powers of two.
+ * @note    Compatible with RT and NIL.
+ *
+ * @addtogroup oslib_rings
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_RINGS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Checks for a thread waiting on a reference.
+ * @note    The reference is read outside the critical zone, it can be set
+ *          concurrently by the other side of the ring.
+ */
+#define ring_is_waiting(trp)    (*(thread_t * volatile *)(trp) != NULL)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Resumes the thread waiting on a reference, if any.
+ *
+ * @param[in] trp       pointer to the thread reference
+ */
+static void ring_wakeup(thread_reference_t *trp) {
+
+  if (ring_is_waiting(trp)) {
+    chSysLock();
+    chThdResumeS(trp, MSG_OK);
+    chSysUnlock();
+  }
+}
+
+/**
+ * @brief   Waits for at least one free slot in a ring.
+ *
+ * @param[in] rp        the pointer to an initialized @p ring_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The operation status.
+ * @retval MSG_OK       if there is a free slot.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ */
+static msg_t ring_wait_space(ring_t *rp, sysinterval_t timeout) {
+  msg_t msg = MSG_OK;
+
+  chSysLock();
+  while ((rp->wridx - rp->rdidx) > rp->mask) {
+    msg = chThdSuspendTimeoutS(&rp->wtr, timeout);
+    if (msg != MSG_OK) {
+      break;
+    }
+  }
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Waits for at least one message in a ring.
+ *
+ * @param[in] rp        the pointer to an initialized @p ring_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The operation status.
+ * @retval MSG_OK       if there is a message.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ */
+static msg_t ring_wait_data(ring_t *rp, sysinterval_t timeout) {
+  msg_t msg = MSG_OK;
+
+  chSysLock();
+  while (rp->wridx == rp->rdidx) {
+    msg = chThdSuspendTimeoutS(&rp->rtr, timeout);
+    if (msg != MSG_OK) {
+      break;
+    }
+  }
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Moves the write index of a multiple producers ring.
+ * @details The index is moved only if it still has the expected value.
+ * @note    A compare and swap instruction is used if available, else the
+ *          operation is performed in a short critical zone.
+ *
+ * @param[in] mrp       the pointer to an initialized @p mpring_t object
+ * @param[in] wr        the expected write index
+ * @param[in] n         number of slots to be reserved
+ * @return              The operation status.
+ * @retval false        if the index has been moved by another producer.
+ * @retval true         if the slots have been reserved.
+ */
+static bool mpring_reserve(mpring_t *mrp, size_t wr, size_t n) {
+#if (defined(__GNUC__) && defined(__GCC_ATOMIC_POINTER_LOCK_FREE) &&        \
+     (__GCC_ATOMIC_POINTER_LOCK_FREE == 2)) || defined(__DOXYGEN__)
+
+  return __atomic_compare_exchange_n(&mrp->wridx, &wr, wr + n, false,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+#else
+  syssts_t sts;
+  bool result = false;
+
+  sts = chSysGetStatusAndLockX();
+  if (mrp->wridx == wr) {
+    mrp->wridx = wr + n;
+    result = true;
+  }
+  chSysRestoreStatusX(sts);
+
+  return result;
+#endif
+}
+
+/**
+ * @brief   Reserves slots in a multiple producers ring.
+ * @details At least one slot and up to @p *np slots are reserved, the
+ *          caller waits if the ring is full.
+ *
+ * @param[in] mrp       the pointer to an initialized @p mpring_t object
+ * @param[out] wrp      pointer to the index of the first reserved slot
+ * @param[in,out] np    pointer to the number of slots to be reserved, the
+ *                      number of reserved slots is returned
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The operation status.
+ * @retval MSG_OK       if the slots have been reserved.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ */
+static msg_t mpring_reserve_wait(mpring_t *mrp, size_t *wrp, size_t *np,
+                                 sysinterval_t timeout) {
+
+  while (true) {
+    /* The read index is sampled first, it can only move forward so the
+       free space is never overestimated.*/
+    size_t rd = mrp->rdidx;
+    size_t wr = mrp->wridx;
+    size_t used = wr - rd;
+
+    if (used <= mrp->mask) {
+      size_t n = (mrp->mask + (size_t)1) - used;
+
+      if (n > *np) {
+        n = *np;
+      }
+      if (mpring_reserve(mrp, wr, n)) {
+        *wrp = wr;
+        *np  = n;
+        return MSG_OK;
+      }
+    }
+    else {
+      msg_t msg = MSG_OK;
+
+      /* Checking again in the critical zone, the consumer could have freed
+         slots in the meanwhile.*/
+      chSysLock();
+      if ((mrp->wridx - mrp->rdidx) > mrp->mask) {
+        mrp->wcnt++;
+        msg = chThdEnqueueTimeoutS(&mrp->qw, timeout);
+        mrp->wcnt--;
+      }
+      chSysUnlock();
+
+      if (msg != MSG_OK) {
+        return msg;
+      }
+    }
+  }
+}
+
+/**
+ * @brief   Writes messages into reserved slots and makes them visible.
+ *
+ * @param[in] mrp       the pointer to an initialized @p mpring_t object
+ * @param[in] wr        index of the first reserved slot
+ * @param[in] msgp      pointer to the messages to be written
+ * @param[in] n         number of messages
+ */
+static void mpring_commit(mpring_t *mrp, size_t wr,
+                          const msg_t *msgp, size_t n) {
+
+  while (n > (size_t)0) {
+    ring_slot_t *sp = &mrp->slots[wr & mrp->mask];
+
+    sp->msg = *msgp++;
+    sp->seq = wr + (size_t)1;
+    wr++;
+    n--;
+  }
+}
+
+/**
+ * @brief   Waits for the next message in a multiple producers ring.
+ *
+ * @param[in] mrp       the pointer to an initialized @p mpring_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The operation status.
+ * @retval MSG_OK       if there is a message.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ */
+static msg_t mpring_wait_data(mpring_t *mrp, sysinterval_t timeout) {
+  size_t rd = mrp->rdidx;
+  ring_slot_t *sp = &mrp->slots[rd & mrp->mask];
+  msg_t msg = MSG_OK;
+
+  chSysLock();
+  while (sp->seq != (rd + (size_t)1)) {
+    msg = chThdSuspendTimeoutS(&mrp->rtr, timeout);
+    if (msg != MSG_OK) {
+      break;
+    }
+  }
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Frees slots in a multiple producers ring.
+ * @details The read index is moved forward and up to @p n waiting writers
+ *          are resumed.
+ *
+ * @param[in] mrp       the pointer to an initialized @p mpring_t object
+ * @param[in] rd        the new read index
+ * @param[in] n         number of freed slots
+ */
+static void mpring_release(mpring_t *mrp, size_t rd, size_t n) {
+
+  mrp->rdidx = rd;
+
+  if (mrp->wcnt > (cnt_t)0) {
+    chSysLock();
+    while ((n > (size_t)0) && (mrp->wcnt > (cnt_t)0)) {
+      chThdDequeueNextI(&mrp->qw, MSG_OK);
+      n--;
+    }
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a @p ring_t object.
+ *
+ * @param[out] rp       the pointer to the @p ring_t structure to be
+ *                      initialized
+ * @param[in] buf       pointer to the messages buffer as an array of
+ *                      @p msg_t
+ * @param[in] n         number of elements in the buffer array, must be a
+ *                      power of two
+ *
+ * @init
+ */
+void chRingObjectInit(ring_t *rp, msg_t *buf, size_t n) {
+
+  chDbgCheck((rp != NULL) && (buf != NULL) &&
+             (n > (size_t)0) && ((n & (n - (size_t)1)) == (size_t)0));
+
+  rp->buffer = buf;
+  rp->mask   = n - (size_t)1;
+  rp->wridx  = (size_t)0;
+  rp->wtr    = NULL;
+  rp->rdidx  = (size_t)0;
+  rp->rtr    = NULL;
+}
+
+/**
+ * @brief   Posts a message into a ring.
+ * @details The invoking thread waits until a free slot is available or
+ *          the specified time runs out.
+ * @note    Only a single producer is allowed.
+ *
+ * @param[in] rp        the pointer to an initialized @p ring_t object
+ * @param[in] msg       the message to be posted on the ring
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chRingPostTimeout(ring_t *rp, msg_t msg, sysinterval_t timeout) {
+  size_t wr;
+
+  chDbgCheck(rp != NULL);
+
+  /* Waiting only if the ring is full.*/
+  wr = rp->wridx;
+  if ((wr - rp->rdidx) > rp->mask) {
+    msg_t rdymsg = ring_wait_space(rp, timeout);
+    if (rdymsg != MSG_OK) {
+      return rdymsg;
+    }
+  }
+
+  /* The message is written then made visible to the reader.*/
+  rp->buffer[wr & rp->mask] = msg;
+  rp->wridx = wr + (size_t)1;
+  ring_wakeup(&rp->rtr);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Posts a message into a ring.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the ring is full.
+ * @note    Only a single producer is allowed.
+ *
+ * @param[in] rp        the pointer to an initialized @p ring_t object
+ * @param[in] msg       the message to be posted on the ring
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_TIMEOUT  if the ring is full and the message cannot be
+ *                      posted.
+ *
+ * @iclass
+ */
+msg_t chRingPostI(ring_t *rp, msg_t msg) {
+  size_t wr;
+
+  chDbgCheckClassI();
+  chDbgCheck(rp != NULL);
+
+  wr = rp->wridx;
+  if ((wr - rp->rdidx) > rp->mask) {
+    return MSG_TIMEOUT;
+  }
+
+  rp->buffer[wr & rp->mask] = msg;
+  rp->wridx = wr + (size_t)1;
+  chThdResumeI(&rp->rtr, MSG_OK);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Posts multiple messages into a ring.
+ * @details The messages are written in the free slots, the invoking thread
+ *          waits if the ring becomes full before all the messages are
+ *          posted. The reader is resumed at most once for each group of
+ *          messages written together.
+ * @note    Only a single producer is allowed.
+ *
+ * @param[in] rp        the pointer to an initialized @p ring_t object
+ * @param[in] msgp      pointer to the messages to be posted
+ * @param[in] n         number of messages to be posted
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of posted messages, it is lower than
+ *                      @p n if the operation timed out.
+ *
+ * @api
+ */
+size_t chRingPostManyTimeout(ring_t *rp, const msg_t *msgp,
+                             size_t n, sysinterval_t timeout) {
+  size_t max = n;
+
+  chDbgCheck((rp != NULL) && (msgp != NULL));
+
+  while (n > (size_t)0) {
+    size_t wr = rp->wridx;
+    size_t done = (rp->mask + (size_t)1) - (wr - rp->rdidx);
+    size_t i;
+
+    if (done == (size_t)0) {
+      if (ring_wait_space(rp, timeout) != MSG_OK) {
+        break;
+      }
+      continue;
+    }
+
+    if (done > n) {
+      done = n;
+    }
+
+    /* All the messages in the free space are written then made visible
+       to the reader at once.*/
+    for (i = (size_t)0; i < done; i++) {
+      rp->buffer[(wr + i) & rp->mask] = *msgp++;
+    }
+    rp->wridx = wr + done;
+    ring_wakeup(&rp->rtr);
+
+    n -= done;
+  }
+
+  return max - n;
+}
+
+/**
+ * @brief   Retrieves a message from a ring.
+ * @details The invoking thread waits until a message is posted or the
+ *          specified time runs out.
+ * @note    Only a single consumer is allowed.
+ *
+ * @param[in] rp        the pointer to an initialized @p ring_t object
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chRingFetchTimeout(ring_t *rp, msg_t *msgp, sysinterval_t timeout) {
+  size_t rd;
+
+  chDbgCheck((rp != NULL) && (msgp != NULL));
+
+  /* Waiting only if the ring is empty.*/
+  rd = rp->rdidx;
+  if (rp->wridx == rd) {
+    msg_t rdymsg = ring_wait_data(rp, timeout);
+    if (rdymsg != MSG_OK) {
+      return rdymsg;
+    }
+  }
+
+  /* The message is read then its slot is made available to the writer.*/
+  *msgp = rp->buffer[rd & rp->mask];
+  rp->rdidx = rd + (size_t)1;
+  ring_wakeup(&rp->wtr);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Retrieves a message from a ring.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the ring is empty.
+ * @note    Only a single consumer is allowed.
+ *
+ * @param[in] rp        the pointer to an initialized @p ring_t object
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_TIMEOUT  if the ring is empty and a message cannot be
+ *                      fetched.
+ *
+ * @iclass
+ */
+msg_t chRingFetchI(ring_t *rp, msg_t *msgp) {
+  size_t rd;
+
+  chDbgCheckClassI();
+  chDbgCheck((rp != NULL) && (msgp != NULL));
+
+  rd = rp->rdidx;
+  if (rp->wridx == rd) {
+    return MSG_TIMEOUT;
+  }
+
+  *msgp = rp->buffer[rd & rp->mask];
+  rp->rdidx = rd + (size_t)1;
+  chThdResumeI(&rp->wtr, MSG_OK);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Retrieves multiple messages from a ring.
+ * @details The invoking thread waits until at least one message is posted
+ *          or the specified time runs out, then up to @p n messages are
+ *          fetched. The writer is resumed at most once.
+ * @note    Only a single consumer is allowed.
+ *
+ * @param[in] rp        the pointer to an initialized @p ring_t object
+ * @param[out] msgp     pointer to an array of messages for the received
+ *                      messages
+ * @param[in] n         maximum number of messages to be fetched
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of fetched messages, zero if the
+ *                      operation timed out.
+ *
+ * @api
+ */
+size_t chRingFetchManyTimeout(ring_t *rp, msg_t *msgp,
+                              size_t n, sysinterval_t timeout) {
+  size_t rd, done, i;
+
+  chDbgCheck((rp != NULL) && (msgp != NULL) && (n > (size_t)0));
+
+  /* Waiting only if the ring is empty.*/
+  rd = rp->rdidx;
+  if (rp->wridx == rd) {
+    if (ring_wait_data(rp, timeout) != MSG_OK) {
+      return (size_t)0;
+    }
+  }
+
+  done = rp->wridx - rd;
+  if (done > n) {
+    done = n;
+  }
+
+  /* All the available messages are read then their slots are made
+     available to the writer at once.*/
+  for (i = (size_t)0; i < done; i++) {
+    *msgp++ = rp->buffer[(rd + i) & rp->mask];
+  }
+  rp->rdidx = rd + done;
+  ring_wakeup(&rp->wtr);
+
+  return done;
+}
+
+/**
+ * @brief   Initializes a @p mpring_t object.
+ *
+ * @param[out] mrp      the pointer to the @p mpring_t structure to be
+ *                      initialized
+ * @param[in] slots     pointer to the slots buffer as an array of
+ *                      @p ring_slot_t
+ * @param[in] n         number of elements in the slots array, must be a
+ *                      power of two
+ *
+ * @init
+ */
+void chMPRingObjectInit(mpring_t *mrp, ring_slot_t *slots, size_t n) {
+  size_t i;
+
+  chDbgCheck((mrp != NULL) && (slots != NULL) &&
+             (n > (size_t)0) && ((n & (n - (size_t)1)) == (size_t)0));
+
+  /* A slot contains a message when its sequence is the read index plus
+     one, the initial sequence marks all slots as empty.*/
+  for (i = (size_t)0; i < n; i++) {
+    slots[i].seq = i;
+  }
+
+  mrp->slots = slots;
+  mrp->mask  = n - (size_t)1;
+  mrp->wridx = (size_t)0;
+  mrp->wcnt  = (cnt_t)0;
+  chThdQueueObjectInit(&mrp->qw);
+  mrp->rdidx = (size_t)0;
+  mrp->rtr   = NULL;
+}
+
+/**
+ * @brief   Posts a message into a multiple producers ring.
+ * @details The invoking thread waits until a free slot is available or
+ *          the specified time runs out.
+ *
+ * @param[in] mrp       the pointer to an initialized @p mpring_t object
+ * @param[in] msg       the message to be posted on the ring
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chMPRingPostTimeout(mpring_t *mrp, msg_t msg, sysinterval_t timeout) {
+  size_t wr, n = (size_t)1;
+  msg_t rdymsg;
+
+  chDbgCheck(mrp != NULL);
+
+  rdymsg = mpring_reserve_wait(mrp, &wr, &n, timeout);
+  if (rdymsg != MSG_OK) {
+    return rdymsg;
+  }
+
+  mpring_commit(mrp, wr, &msg, (size_t)1);
+  ring_wakeup(&mrp->rtr);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Posts a message into a multiple producers ring.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the ring is full.
+ *
+ * @param[in] mrp       the pointer to an initialized @p mpring_t object
+ * @param[in] msg       the message to be posted on the ring
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_TIMEOUT  if the ring is full and the message cannot be
+ *                      posted.
+ *
+ * @iclass
+ */
+msg_t chMPRingPostI(mpring_t *mrp, msg_t msg) {
+  size_t wr;
+
+  chDbgCheckClassI();
+  chDbgCheck(mrp != NULL);
+
+  /* Within the critical zone no other producer can run.*/
+  wr = mrp->wridx;
+  if ((wr - mrp->rdidx) > mrp->mask) {
+    return MSG_TIMEOUT;
+  }
+  mrp->wridx = wr + (size_t)1;
+
+  mpring_commit(mrp, wr, &msg, (size_t)1);
+  chThdResumeI(&mrp->rtr, MSG_OK);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Posts multiple messages into a multiple producers ring.
+ * @details Groups of consecutive slots are reserved and written, the
+ *          invoking thread waits if the ring becomes full before all the
+ *          messages are posted. The reader is resumed at most once for
+ *          each group.
+ * @note    Messages posted in a single group are never interleaved with
+ *          messages from other producers.
+ *
+ * @param[in] mrp       the pointer to an initialized @p mpring_t object
+ * @param[in] msgp      pointer to the messages to be posted
+ * @param[in] n         number of messages to be posted
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of posted messages, it is lower than
+ *                      @p n if the operation timed out.
+ *
+ * @api
+ */
+size_t chMPRingPostManyTimeout(mpring_t *mrp, const msg_t *msgp,
+                               size_t n, sysinterval_t timeout) {
+  size_t max = n;
+
+  chDbgCheck((mrp != NULL) && (msgp != NULL));
+
+  while (n > (size_t)0) {
+    size_t wr, done = n;
+
+    if (mpring_reserve_wait(mrp, &wr, &done, timeout) != MSG_OK) {
+      break;
+    }
+
+    mpring_commit(mrp, wr, msgp, done);
+    ring_wakeup(&mrp->rtr);
+
+    msgp += done;
+    n    -= done;
+  }
+
+  return max - n;
+}
+
+/**
+ * @brief   Retrieves a message from a multiple producers ring.
+ * @details The invoking thread waits until a message is posted or the
+ *          specified time runs out.
+ * @note    Only a single consumer is allowed.
+ *
+ * @param[in] mrp       the pointer to an initialized @p mpring_t object
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chMPRingFetchTimeout(mpring_t *mrp, msg_t *msgp,
+                           sysinterval_t timeout) {
+  size_t rd;
+  ring_slot_t *sp;
+
+  chDbgCheck((mrp != NULL) && (msgp != NULL));
+
+  /* Waiting only if the next slot has not been written yet.*/
+  rd = mrp->rdidx;
+  sp = &mrp->slots[rd & mrp->mask];
+  if (sp->seq != (rd + (size_t)1)) {
+    msg_t rdymsg = mpring_wait_data(mrp, timeout);
+    if (rdymsg != MSG_OK) {
+      return rdymsg;
+    }
+  }
+
+  *msgp = sp->msg;
+  mpring_release(mrp, rd + (size_t)1, (size_t)1);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Retrieves a message from a multiple producers ring.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the ring is empty.
+ * @note    Only a single consumer is allowed.
+ *
+ * @param[in] mrp       the pointer to an initialized @p mpring_t object
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_TIMEOUT  if the ring is empty and a message cannot be
+ *                      fetched.
+ *
+ * @iclass
+ */
+msg_t chMPRingFetchI(mpring_t *mrp, msg_t *msgp) {
+  size_t rd;
+  ring_slot_t *sp;
+
+  chDbgCheckClassI();
+  chDbgCheck((mrp != NULL) && (msgp != NULL));
+
+  rd = mrp->rdidx;
+  sp = &mrp->slots[rd & mrp->mask];
+  if (sp->seq != (rd + (size_t)1)) {
+    return MSG_TIMEOUT;
+  }
+
+  *msgp = sp->msg;
+  mrp->rdidx = rd + (size_t)1;
+  if (mrp->wcnt > (cnt_t)0) {
+    chThdDequeueNextI(&mrp->qw, MSG_OK);
+  }
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Retrieves multiple messages from a multiple producers ring.
+ * @details The invoking thread waits until at least one message is posted
+ *          or the specified time runs out, then up to @p n consecutive
+ *          messages are fetched. The fetch stops on the first slot not
+ *          yet written by its producer.
+ * @note    Only a single consumer is allowed.
+ *
+ * @param[in] mrp       the pointer to an initialized @p mpring_t object
+ * @param[out] msgp     pointer to an array of messages for the received
+ *                      messages
+ * @param[in] n         maximum number of messages to be fetched
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of fetched messages, zero if the
+ *                      operation timed out.
+ *
+ * @api
+ */
+size_t chMPRingFetchManyTimeout(mpring_t *mrp, msg_t *msgp,
+                                size_t n, sysinterval_t timeout) {
+  size_t rd, done;
+
+  chDbgCheck((mrp != NULL) && (msgp != NULL) && (n > (size_t)0));
+
+  /* Waiting only if the next slot has not been written yet.*/
+  rd = mrp->rdidx;
+  if (mrp->slots[rd & mrp->mask].seq != (rd + (size_t)1)) {
+    if (mpring_wait_data(mrp, timeout) != MSG_OK) {
+      return (size_t)0;
+    }
+  }
+
+  /* Reading all the consecutive written slots.*/
+  done = (size_t)0;
+  do {
+    *msgp++ = mrp->slots[(rd + done) & mrp->mask].msg;
+    done++;
+  } while ((done < n) &&
+           (mrp->slots[(rd + done) & mrp->mask].seq == (rd + done + (size_t)1)));
+
+  mpring_release(mrp, rd + done, done);
+
+  return done;
+}
+
+#endif /* CH_CFG_USE_RINGS == TRUE */
+
+/** @} */
@@ -46,6 +46,19 @@
 #if !defined(CH_DBG_STACK_FILL_VALUE) || defined(__DOXYGEN__)
 #define CH_DBG_STACK_FILL_VALUE             0x55
 #endif
+
+/**
+ * @brief   Debug option, stack high-water-mark tracking.
+ * @details If enabled then the stack pointer of the thread being switched
+ *          out is sampled on each context switch and the lowest value is
+ *          kept in the @p thread_t structure. Unlike stack filling this
+ *          has no cost at thread creation and is suitable for production
+ *          builds.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_DBG_STACK_WATERMARK) || defined(__DOXYGEN__)
+#define CH_DBG_STACK_WATERMARK              FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -100,6 +113,12 @@ typedef struct ch_system_debug {
 #define chDbgCheckClassS()
 #endif
 
+/* When the stack watermark feature is disabled then the sampling is
+   replaced by an empty macro.*/
+#if CH_DBG_STACK_WATERMARK == FALSE
+#define __dbg_stack_watermark(otp)
+#endif
+
 /**
  * @name    Macro Functions
  * @{
@@ -151,6 +170,28 @@ typedef struct ch_system_debug {
   }                                                                         \
 } while (false)
 #endif /* !defined(chDbgAssert) */
+
+/**
+ * @brief   Samples the stack pointer of a thread being switched out.
+ * @details The address of a local variable approximates the current stack
+ *          pointer, the context frame about to be pushed by
+ *          @p port_switch() is accounted for.
+ * @note    Not a user function, it is invoked from @p chSysSwitch().
+ *
+ * @param[in] otp       the thread to be switched out
+ *
+ * @notapi
+ */
+#if (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
+#define __dbg_stack_watermark(otp) do {                                     \
+  uint8_t __sp;                                                             \
+  uint8_t *__p = (uint8_t *)((uintptr_t)&__sp -                             \
+                             sizeof (struct port_intctx));                  \
+  if (__p < (otp)->stkmin) {                                                \
+    (otp)->stkmin = __p;                                                    \
+  }                                                                         \
+} while (false)
+#endif
 /** @} */
 
 /*===========================================================================*/
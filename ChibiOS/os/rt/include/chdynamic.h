@@ -61,6 +61,70 @@
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a threads pool.
+ */
+typedef struct ch_thread_pool thread_pool_t;
+
+/**
+ * @brief   Structure representing a threads pool slot.
+ * @note    Slots are allocated by the application and handed to the pool
+ *          on initialization, each slot can host one pooled thread.
+ */
+typedef struct ch_thread_pool_slot {
+  /**
+   * @brief   Link in the pool free or parked lists.
+   */
+  ch_queue_t            queue;
+  /**
+   * @brief   Parked thread or @p NULL.
+   */
+  thread_reference_t    tr;
+  /**
+   * @brief   Owner pool.
+   */
+  thread_pool_t         *pool;
+  /**
+   * @brief   Function to be executed by the thread.
+   */
+  tfunc_t               pf;
+  /**
+   * @brief   Argument of the function.
+   */
+  void                  *arg;
+} thread_pool_slot_t;
+
+/**
+ * @brief   Structure representing a threads pool.
+ * @details Threads are created from the heap on demand, when the thread
+ *          function returns the thread is parked with its working area
+ *          and reused by the next start operation.
+ */
+struct ch_thread_pool {
+  /**
+   * @brief   Heap for working areas or @p NULL for the default heap.
+   */
+  memory_heap_t         *heapp;
+  /**
+   * @brief   Size of working areas.
+   */
+  size_t                size;
+  /**
+   * @brief   Name of pooled threads.
+   */
+  const char            *name;
+  /**
+   * @brief   Slots not yet hosting a thread.
+   */
+  ch_queue_t            free;
+  /**
+   * @brief   Slots hosting a parked thread.
+   */
+  ch_queue_t            parked;
+};
+#endif /* CH_CFG_USE_HEAP == TRUE */
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -79,6 +143,12 @@ extern "C" {
   thread_t *chThdCreateFromHeap(memory_heap_t *heapp, size_t size,
                                 const char *name, tprio_t prio,
                                 tfunc_t pf, void *arg);
+  void chThdPoolObjectInit(thread_pool_t *tpp, memory_heap_t *heapp,
+                           size_t size, const char *name,
+                           thread_pool_slot_t *slots, size_t n);
+  thread_t *chThdPoolStart(thread_pool_t *tpp, tprio_t prio,
+                           tfunc_t pf, void *arg);
+  void chThdPoolDispose(thread_pool_t *tpp);
 #endif
 #if CH_CFG_USE_MEMPOOLS == TRUE
   thread_t *chThdCreateFromMemoryPool(memory_pool_t *mp, const char *name,
@@ -41,10 +41,39 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Indexed event sources APIs.
+ * @details If enabled then the indexed event sources APIs are included
+ *          in the kernel.
+ */
+#if !defined(CH_CFG_USE_EVENTS_INDEXED) || defined(__DOXYGEN__)
+#define CH_CFG_USE_EVENTS_INDEXED           FALSE
+#endif
+
+/**
+ * @brief   Number of flags groups in an indexed event source.
+ * @details The flags are split in groups of consecutive bits, each group
+ *          has its own listeners list. Listeners interested in flags of a
+ *          single group are only visited by broadcasts carrying flags of
+ *          that group.
+ * @note    Must be a power of two not greater than the number of bits of
+ *          the @p eventflags_t type.
+ */
+#if !defined(CH_CFG_EVENTS_INDEX_SIZE) || defined(__DOXYGEN__)
+#define CH_CFG_EVENTS_INDEX_SIZE            8
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if CH_CFG_USE_EVENTS_INDEXED == TRUE
+#if (CH_CFG_EVENTS_INDEX_SIZE < 1) || (CH_CFG_EVENTS_INDEX_SIZE > 32) ||    \
+    ((CH_CFG_EVENTS_INDEX_SIZE & (CH_CFG_EVENTS_INDEX_SIZE - 1)) != 0)
+#error "invalid CH_CFG_EVENTS_INDEX_SIZE value"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -77,6 +106,23 @@ typedef struct event_source {
                                                     Source.                 */
 } event_source_t;
 
+#if (CH_CFG_USE_EVENTS_INDEXED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Indexed Event Source structure.
+ * @details Listeners are grouped by their flags filter, a broadcast only
+ *          visits the lists whose flags group overlaps the broadcasted
+ *          flags plus the list of the listeners whose filter spans more
+ *          than one group.
+ */
+typedef struct indexed_event_source {
+  event_listener_t      *lists[CH_CFG_EVENTS_INDEX_SIZE + 1];
+                                        /**< @brief Listeners lists, one
+                                                    for each flags group
+                                                    plus a final one for
+                                                    wide filters.           */
+} indexed_event_source_t;
+#endif
+
 /**
  * @brief   Event Handler callback function.
  */
@@ -138,6 +184,28 @@ extern "C" {
   void chEvtSignalI(thread_t *tp, eventmask_t events);
   void chEvtBroadcastFlags(event_source_t *esp, eventflags_t flags);
   void chEvtBroadcastFlagsI(event_source_t *esp, eventflags_t flags);
+  void chEvtBroadcastFlagsMany(event_source_t *const esps[],
+                               const eventflags_t flags[], size_t n);
+  void chEvtBroadcastFlagsManyI(event_source_t *const esps[],
+                                const eventflags_t flags[], size_t n);
+#if CH_CFG_USE_EVENTS_INDEXED == TRUE
+  void chEvtIndexedObjectInit(indexed_event_source_t *iesp);
+  void chEvtIndexedRegisterMaskWithFlagsI(indexed_event_source_t *iesp,
+                                          event_listener_t *elp,
+                                          eventmask_t events,
+                                          eventflags_t wflags);
+  void chEvtIndexedRegisterMaskWithFlags(indexed_event_source_t *iesp,
+                                         event_listener_t *elp,
+                                         eventmask_t events,
+                                         eventflags_t wflags);
+  void chEvtIndexedUnregister(indexed_event_source_t *iesp,
+                              event_listener_t *elp);
+  bool chEvtIndexedIsListeningI(indexed_event_source_t *iesp);
+  void chEvtIndexedBroadcastFlags(indexed_event_source_t *iesp,
+                                  eventflags_t flags);
+  void chEvtIndexedBroadcastFlagsI(indexed_event_source_t *iesp,
+                                   eventflags_t flags);
+#endif
   void chEvtDispatch(const evhandler_t *handlers, eventmask_t events);
 #if (CH_CFG_OPTIMIZE_SPEED == TRUE) || (CH_CFG_USE_EVENTS_TIMEOUT == FALSE)
   eventmask_t chEvtWaitOne(eventmask_t events);
@@ -38,10 +38,31 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Mutexes adaptive spin time.
+ * @details In SMP mode a thread trying to lock a mutex owned by a thread
+ *          running on another OS instance spins for up to this number of
+ *          realtime counter cycles before blocking.
+ * @note    Zero disables spinning, the setting is ignored if
+ *          @p CH_CFG_SMP_MODE is @p FALSE.
+ */
+#if !defined(CH_CFG_MUTEXES_SPIN_TIME) || defined(__DOXYGEN__)
+#define CH_CFG_MUTEXES_SPIN_TIME            0
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if CH_CFG_MUTEXES_SPIN_TIME < 0
+#error "invalid CH_CFG_MUTEXES_SPIN_TIME value"
+#endif
+
+#if (CH_CFG_SMP_MODE == TRUE) && (CH_CFG_MUTEXES_SPIN_TIME > 0) &&          \
+    (PORT_SUPPORTS_RT == FALSE)
+#error "CH_CFG_MUTEXES_SPIN_TIME requires PORT_SUPPORTS_RT"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -36,10 +36,64 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Bitmap-indexed ready list.
+ * @details If enabled then the ready list keeps track of the last thread of
+ *          each priority level and of the priority levels in use, threads
+ *          insertion in the ready list is performed in constant time.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_READY_BITMAP) || defined(__DOXYGEN__)
+#define CH_CFG_USE_READY_BITMAP             FALSE
+#endif
+
+/**
+ * @brief   Virtual timers wheel.
+ * @details If enabled then the armed virtual timers are kept in a
+ *          hierarchical timer wheel instead of a single delta list, arming
+ *          and resetting a timer is performed in constant time regardless
+ *          of the number of armed timers.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_TIMERS_WHEEL) || defined(__DOXYGEN__)
+#define CH_CFG_USE_TIMERS_WHEEL             FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_READY_BITMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of priority levels tracked by the ready list bitmap.
+ */
+#define CH_READY_BITMAP_LEVELS              256U
+
+/**
+ * @brief   Number of 32 bits words in the ready list bitmap.
+ */
+#define CH_READY_BITMAP_WORDS               (CH_READY_BITMAP_LEVELS / 32U)
+#endif
+
+#if (CH_CFG_USE_TIMERS_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of system time bits covered by each wheel level.
+ */
+#define CH_VT_WHEEL_BITS                    5U
+
+/**
+ * @brief   Number of slots in each wheel level.
+ */
+#define CH_VT_WHEEL_SLOTS                   (1U << CH_VT_WHEEL_BITS)
+
+/**
+ * @brief   Number of wheel levels required to cover the system time range.
+ */
+#define CH_VT_WHEEL_LEVELS                  ((CH_CFG_ST_RESOLUTION +        \
+                                              CH_VT_WHEEL_BITS - 1U) /      \
+                                             CH_VT_WHEEL_BITS)
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -75,6 +129,9 @@ typedef void (*vtfunc_t)(virtual_timer_t *vtp, void *p);
 struct ch_virtual_timer {
   /**
    * @brief   Delta list element.
+   * @note    When @p CH_CFG_USE_TIMERS_WHEEL is enabled the element links
+   *          the timer in a wheel slot and its @p delta field holds the
+   *          absolute timer deadline.
    */
   ch_delta_list_t               dlist;
   /**
@@ -98,10 +155,24 @@ struct ch_virtual_timer {
  *          timer is often used in the code.
  */
 typedef struct ch_virtual_timers_list {
+#if (CH_CFG_USE_TIMERS_WHEEL == FALSE) || defined(__DOXYGEN__)
   /**
    * @brief   Delta list header.
    */
   ch_delta_list_t               dlist;
+#endif
+#if (CH_CFG_USE_TIMERS_WHEEL == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Wheel slots headers.
+   * @note    Slots in level @p n have a granularity of
+   *          <tt>CH_VT_WHEEL_SLOTS ^ n</tt> ticks.
+   */
+  ch_delta_list_t               slots[CH_VT_WHEEL_LEVELS][CH_VT_WHEEL_SLOTS];
+  /**
+   * @brief   Non-empty slots of each wheel level.
+   */
+  uint32_t                      used[CH_VT_WHEEL_LEVELS];
+#endif
 #if (CH_CFG_ST_TIMEDELTA == 0) || defined(__DOXYGEN__)
   /**
    * @brief   System Time counter.
@@ -192,13 +263,21 @@ struct ch_thread {
   const char                    *name;
 #endif
 #if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE) ||  \
-    defined(__DOXYGEN__)
+    (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   Working area base address.
    * @note    This pointer is used for stack overflow checks and for
    *          dynamic threading.
    */
   stkalign_t                    *wabase;
+#endif
+#if (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Lowest stack pointer observed at context switch.
+   * @note    This is a sampled value, stack usage peaks happening between
+   *          two context switches are not seen.
+   */
+  uint8_t                       *stkmin;
 #endif
   /**
    * @brief   Current thread state.
@@ -355,6 +434,22 @@ typedef struct ch_ready_list {
    * @brief     The currently running thread.
    */
   thread_t                      *current;
+#if (CH_CFG_USE_READY_BITMAP == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief     Words of @p levels having at least a bit set.
+   */
+  uint32_t                      summary;
+  /**
+   * @brief     Priority levels having threads in the ready list.
+   */
+  uint32_t                      levels[CH_READY_BITMAP_WORDS];
+  /**
+   * @brief     Last thread of each priority level in the ready list.
+   * @note      Only entries with the corresponding bit set in @p levels
+   *            are meaningful.
+   */
+  ch_priority_queue_t           *tails[CH_READY_BITMAP_LEVELS];
+#endif
 } ready_list_t;
 
 /**
@@ -366,7 +461,7 @@ typedef struct ch_os_instance_config {
    */
   const char                    *name;
 #if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE) ||  \
-    defined(__DOXYGEN__)
+    (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   Lower limit of the main function thread stack.
    */
@@ -130,6 +130,10 @@
 #error "invalid PORT_CORES_NUMBER value"
 #endif
 
+#if !defined(PORT_SPIN_HINT)
+#define PORT_SPIN_HINT()
+#endif
+
 #if PORT_CORES_NUMBER == 1
 #if CH_CFG_SMP_MODE != FALSE
 #error "this port does not support SMP"
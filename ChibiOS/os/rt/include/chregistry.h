@@ -68,7 +68,8 @@ typedef struct {
   uint8_t   off_refs;               /**< @brief Offset of @p refs field.    */
   uint8_t   off_preempt;            /**< @brief Offset of @p ticks field.   */
   uint8_t   off_time;               /**< @brief Offset of @p time field.    */
-  uint8_t   off_reserved[4];
+  uint8_t   off_stkmin;             /**< @brief Offset of @p stkmin field.  */
+  uint8_t   off_reserved[3];
   uint8_t   intctxsize;             /**< @brief Size of a @p port_intctx.   */
   uint8_t   intervalsize;           /**< @brief Size of a @p sysinterval_t. */
   uint8_t   instancesnum;           /**< @brief Number of instances.        */
@@ -212,6 +213,32 @@ static inline void chRegSetThreadNameX(thread_t *tp, const char *name) {
 #endif
 }
 
+#if (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the stack space never used by the specified thread.
+ * @details The returned value is the distance between the lowest stack
+ *          pointer observed at context switch and the working area base,
+ *          it can be used for sizing working areas in production builds.
+ * @note    The value is sampled, it is an upper bound of the real unused
+ *          stack space, a safety margin should be considered.
+ * @note    For threads whose stack boundaries are not known zero is
+ *          returned.
+ *
+ * @param[in] tp        pointer to the thread
+ * @return              Unused stack space in bytes.
+ *
+ * @xclass
+ */
+static inline size_t chRegGetThreadStackUnusedX(thread_t *tp) {
+
+  if (tp->wabase == NULL) {
+    return (size_t)0;
+  }
+
+  return (size_t)(tp->stkmin - (uint8_t *)tp->wabase);
+}
+#endif
+
 #endif /* CHREGISTRY_H */
 
 /** @} */
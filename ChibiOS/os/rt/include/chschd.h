@@ -148,7 +148,9 @@ extern "C" {
 #endif
   void chSchObjectInit(os_instance_t *oip,
                        const os_instance_config_t *oicp);
+  thread_t *ch_sch_rlist_remove(thread_t *tp, tprio_t prio);
   thread_t *chSchReadyI(thread_t *tp);
+  void chSchReadyBatchI(ch_queue_t *qp, tstate_t state, msg_t msg);
   void chSchGoSleepS(tstate_t newstate);
   msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout);
   void chSchWakeupS(thread_t *ntp, msg_t msg);
@@ -56,6 +56,12 @@
 typedef struct {
   ucnt_t                n_irq;      /**< @brief Number of IRQs.             */
   ucnt_t                n_ctxswc;   /**< @brief Number of context switches. */
+  ucnt_t                n_vtalarm;  /**< @brief Number of virtual timers
+                                                alarm settings.             */
+  ucnt_t                n_vttick;   /**< @brief Number of virtual timers
+                                                ticks or alarm events.      */
+  ucnt_t                n_vtfire;   /**< @brief Number of triggered virtual
+                                                timers.                     */
   time_measurement_t    m_crit_thd; /**< @brief Measurement of threads
                                                 critical zones duration.    */
   time_measurement_t    m_crit_isr; /**< @brief Measurement of ISRs critical
@@ -76,6 +82,9 @@ extern "C" {
   void __stats_init(void);
   void __stats_increase_irq(void);
   void __stats_ctxswc(thread_t *ntp, thread_t *otp);
+  void __stats_vt_alarm(void);
+  void __stats_vt_tick(void);
+  void __stats_vt_fire(void);
   void __stats_start_measure_crit_thd(void);
   void __stats_stop_measure_crit_thd(void);
   void __stats_start_measure_crit_isr(void);
@@ -98,8 +107,11 @@ extern "C" {
  */
 static inline void __stats_object_init(kernel_stats_t *ksp) {
 
-  ksp->n_irq    = (ucnt_t)0;
-  ksp->n_ctxswc = (ucnt_t)0;
+  ksp->n_irq     = (ucnt_t)0;
+  ksp->n_ctxswc  = (ucnt_t)0;
+  ksp->n_vtalarm = (ucnt_t)0;
+  ksp->n_vttick  = (ucnt_t)0;
+  ksp->n_vtfire  = (ucnt_t)0;
   chTMObjectInit(&ksp->m_crit_thd);
   chTMObjectInit(&ksp->m_crit_isr);
 }
@@ -109,6 +121,9 @@ static inline void __stats_object_init(kernel_stats_t *ksp) {
 /* Stub functions for when the statistics module is disabled. */
 #define __stats_increase_irq()
 #define __stats_ctxswc(old, new)
+#define __stats_vt_alarm()
+#define __stats_vt_tick()
+#define __stats_vt_fire()
 #define __stats_start_measure_crit_thd()
 #define __stats_stop_measure_crit_thd()
 #define __stats_start_measure_crit_isr()
@@ -307,6 +307,7 @@
   __trace_switch(ntp, otp);                                                 \
   __stats_ctxswc(ntp, otp);                                                 \
   CH_CFG_CONTEXT_SWITCH_HOOK(ntp, otp);                                     \
+  __dbg_stack_watermark(otp);                                               \
   port_switch(ntp, otp);                                                    \
 }
 
@@ -374,7 +374,7 @@ static inline systime_t chThdGetTicksX(thread_t *tp) {
 #endif
 
 #if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE) ||  \
-    defined(__DOXYGEN__)
+    (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Returns the working area base of the specified thread.
  *
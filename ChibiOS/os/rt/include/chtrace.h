@@ -43,6 +43,32 @@
 #define CH_TRACE_TYPE_ISR_LEAVE             4U
 #define CH_TRACE_TYPE_HALT                  5U
 #define CH_TRACE_TYPE_USER                  6U
+#define CH_TRACE_TYPE_OBJECT                7U
+/** @} */
+
+/**
+ * @name    Binary trace only record types
+ * @{
+ */
+#define CH_TRACE_TYPE_SYNC                  8U
+#define CH_TRACE_TYPE_LOST                  9U
+#define CH_TRACE_TYPE_NAME                  10U
+/** @} */
+
+/**
+ * @name    Objects operations
+ * @note    The operation is stored in the @p state field of object records.
+ * @{
+ */
+#define CH_TRACE_OBJ_SEM_WAIT               0U
+#define CH_TRACE_OBJ_SEM_SIGNAL             1U
+#define CH_TRACE_OBJ_MTX_LOCK               2U
+#define CH_TRACE_OBJ_MTX_UNLOCK             3U
+#define CH_TRACE_OBJ_MB_POST                4U
+#define CH_TRACE_OBJ_MB_FETCH               5U
+#define CH_TRACE_OBJ_VT_SET                 6U
+#define CH_TRACE_OBJ_VT_RESET               7U
+#define CH_TRACE_OBJ_VT_FIRE                8U
 /** @} */
 
 /**
@@ -56,6 +82,14 @@
 #define CH_DBG_TRACE_MASK_ISR               4U
 #define CH_DBG_TRACE_MASK_HALT              8U
 #define CH_DBG_TRACE_MASK_USER              16U
+#define CH_DBG_TRACE_MASK_SEM               256U
+#define CH_DBG_TRACE_MASK_MTX               512U
+#define CH_DBG_TRACE_MASK_MB                1024U
+#define CH_DBG_TRACE_MASK_VT                2048U
+#define CH_DBG_TRACE_MASK_OBJECTS           (CH_DBG_TRACE_MASK_SEM |        \
+                                             CH_DBG_TRACE_MASK_MTX |        \
+                                             CH_DBG_TRACE_MASK_MB |         \
+                                             CH_DBG_TRACE_MASK_VT)
 #define CH_DBG_TRACE_MASK_SLOW              (CH_DBG_TRACE_MASK_READY |      \
                                              CH_DBG_TRACE_MASK_SWITCH |     \
                                              CH_DBG_TRACE_MASK_HALT |       \
@@ -90,12 +124,40 @@
 #if !defined(CH_DBG_TRACE_BUFFER_SIZE) || defined(__DOXYGEN__)
 #define CH_DBG_TRACE_BUFFER_SIZE            128
 #endif
+
+/**
+ * @brief   Binary trace buffer.
+ * @details If enabled then trace records are encoded in a compact binary
+ *          format into a bytes buffer that can be drained incrementally
+ *          using @p chTraceReadI(), timestamps are realtime counter deltas.
+ *          If disabled then the records are kept in a circular buffer of
+ *          @p trace_event_t structures.
+ */
+#if !defined(CH_DBG_TRACE_BINARY) || defined(__DOXYGEN__)
+#define CH_DBG_TRACE_BINARY                 FALSE
+#endif
+
+/**
+ * @brief   Binary trace buffer size in bytes.
+ * @note    Must be a power of two.
+ */
+#if !defined(CH_DBG_TRACE_BINARY_SIZE) || defined(__DOXYGEN__)
+#define CH_DBG_TRACE_BINARY_SIZE            1024
+#endif
 /** @} */
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_DBG_TRACE_BINARY_SIZE & (CH_DBG_TRACE_BINARY_SIZE - 1)) != 0
+#error "CH_DBG_TRACE_BINARY_SIZE must be a power of two"
+#endif
+
+#if (CH_DBG_TRACE_BINARY == TRUE) && (CH_DBG_TRACE_BINARY_SIZE < 64)
+#error "CH_DBG_TRACE_BINARY_SIZE too small"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -182,6 +244,19 @@ typedef struct {
        */
       void                  *up2;
     } user;
+    /**
+     * @brief   Structure representing an object operation.
+     */
+    struct {
+      /**
+       * @brief   Object pointer.
+       */
+      void                  *objp;
+      /**
+       * @brief   Operation argument.
+       */
+      msg_t                 arg;
+    } obj;
   } u;
 } trace_event_t;
 /*lint -restore*/
@@ -202,10 +277,45 @@ typedef struct {
    * @brief   Pointer to the buffer front.
    */
   trace_event_t         *ptr;
+#if (CH_DBG_TRACE_BINARY == FALSE) || defined(__DOXYGEN__)
   /**
    * @brief   Ring buffer.
    */
   trace_event_t         buffer[CH_DBG_TRACE_BUFFER_SIZE];
+#else
+  /**
+   * @brief   Record being written, encoded into the bytes buffer.
+   */
+  trace_event_t         record;
+  /**
+   * @brief   Free running write index.
+   */
+  size_t                wridx;
+  /**
+   * @brief   Free running read index.
+   */
+  size_t                rdidx;
+  /**
+   * @brief   Realtime counter value of the last encoded record.
+   */
+  uint32_t              laststamp;
+  /**
+   * @brief   Last encoded pointer value.
+   */
+  uintptr_t             lastptr;
+  /**
+   * @brief   Records lost because the buffer was full.
+   */
+  uint32_t              lost;
+  /**
+   * @brief   A synchronization record is required before the next record.
+   */
+  bool                  sync;
+  /**
+   * @brief   Bytes buffer.
+   */
+  uint8_t               bytes[CH_DBG_TRACE_BINARY_SIZE];
+#endif
 } trace_buffer_t;
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 
@@ -240,6 +350,15 @@ typedef struct {
 #endif
 #endif /* CH_DBG_TRACE_MASK == CH_DBG_TRACE_MASK_DISABLED */
 
+/* Objects records are removed at compile time if no objects class is
+   enabled, the calls are placed in the hot paths of the kernel.*/
+#if (CH_DBG_TRACE_MASK == CH_DBG_TRACE_MASK_DISABLED) ||                    \
+    ((CH_DBG_TRACE_MASK & CH_DBG_TRACE_MASK_OBJECTS) == 0U)
+#if !defined(__trace_object)
+#define __trace_object(op, objp, arg)
+#endif
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -254,12 +373,22 @@ extern "C" {
   void __trace_isr_enter(const char *isr);
   void __trace_isr_leave(const char *isr);
   void __trace_halt(const char *reason);
+#if ((CH_DBG_TRACE_MASK & CH_DBG_TRACE_MASK_OBJECTS) != 0U) ||              \
+    defined(__DOXYGEN__)
+  void __trace_object(unsigned op, void *objp, msg_t arg);
+#endif
   void chTraceWriteI(void *up1, void *up2);
   void chTraceWrite(void *up1, void *up2);
   void chTraceSuspendI(uint16_t mask);
   void chTraceSuspend(uint16_t mask);
   void chTraceIResume(uint16_t mask);
   void chTraceResume(uint16_t mask);
+#if (CH_DBG_TRACE_BINARY == TRUE) || defined(__DOXYGEN__)
+  void chTraceWriteNameI(const void *objp, const char *name);
+  void chTraceSyncI(void);
+  size_t chTraceReadI(uint8_t *bp, size_t n);
+  size_t chTraceRead(uint8_t *bp, size_t n);
+#endif
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 #ifdef __cplusplus
 }
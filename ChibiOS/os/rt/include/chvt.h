@@ -53,6 +53,12 @@
 #error "CH_DBG_THREADS_PROFILING not supported in tickless mode"
 #endif
 
+#if (CH_CFG_USE_TIMERS_WHEEL == TRUE) &&                                    \
+    (CH_CFG_INTERVALS_SIZE != CH_CFG_ST_RESOLUTION)
+#error "CH_CFG_USE_TIMERS_WHEEL requires CH_CFG_INTERVALS_SIZE to be "      \
+       "equal to CH_CFG_ST_RESOLUTION"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -73,10 +79,15 @@ extern "C" {
 #endif
   void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
                   vtfunc_t vtfunc, void *par);
+  void chVTDoSetWithSlackI(virtual_timer_t *vtp, sysinterval_t delay,
+                           sysinterval_t slack, vtfunc_t vtfunc, void *par);
   void chVTDoSetContinuousI(virtual_timer_t *vtp, sysinterval_t delay,
                             vtfunc_t vtfunc, void *par);
   void chVTDoResetI(virtual_timer_t *vtp);
   sysinterval_t chVTGetRemainingIntervalI(virtual_timer_t *vtp);
+#if CH_CFG_USE_TIMERS_WHEEL == TRUE
+  bool chVTGetTimersStateI(sysinterval_t *timep);
+#endif
   void chVTDoTickI(void);
 #if CH_CFG_USE_TIMESTAMP == TRUE
   systimestamp_t chVTGetTimeStampI(void);
@@ -213,6 +224,7 @@ static inline bool chVTIsSystemTimeWithin(systime_t start, systime_t end) {
  *
  * @iclass
  */
+#if (CH_CFG_USE_TIMERS_WHEEL == FALSE) || defined(__DOXYGEN__)
 static inline bool chVTGetTimersStateI(sysinterval_t *timep) {
   virtual_timers_list_t *vtlp = &currcore->vtlist;
   ch_delta_list_t *dlp = &vtlp->dlist;
@@ -234,6 +246,7 @@ static inline bool chVTGetTimersStateI(sysinterval_t *timep) {
 
   return true;
 }
+#endif /* CH_CFG_USE_TIMERS_WHEEL == FALSE */
 
 /**
  * @brief   Returns @p true if the specified timer is armed.
@@ -508,7 +521,20 @@ static inline void chVTResetTimeStamp(void) {
  */
 static inline void __vt_object_init(virtual_timers_list_t *vtlp) {
 
+#if CH_CFG_USE_TIMERS_WHEEL == FALSE
   ch_dlist_init(&vtlp->dlist);
+#else
+  {
+    unsigned i, j;
+
+    for (i = 0U; i < CH_VT_WHEEL_LEVELS; i++) {
+      for (j = 0U; j < CH_VT_WHEEL_SLOTS; j++) {
+        ch_dlist_init(&vtlp->slots[i][j]);
+      }
+      vtlp->used[i] = 0U;
+    }
+  }
+#endif
 #if CH_CFG_ST_TIMEDELTA == 0
   vtlp->systime = (systime_t)0;
 #else /* CH_CFG_ST_TIMEDELTA > 0 */
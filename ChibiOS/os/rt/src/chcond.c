@@ -154,9 +154,7 @@ void chCondBroadcastI(condition_variable_t *cp) {
   /* Empties the condition variable queue and inserts all the threads into the
      ready list in FIFO order. The wakeup message is set to @p MSG_RESET in
      order to make a chCondBroadcast() detectable from a chCondSignal().*/
-  while (ch_queue_notempty(&cp->queue)) {
-    chSchReadyI(threadref(ch_queue_fifo_remove(&cp->queue)))->u.rdymsg = MSG_RESET;
-  }
+  chSchReadyBatchI(&cp->queue, CH_STATE_WTCOND, MSG_RESET);
 }
 
 /**
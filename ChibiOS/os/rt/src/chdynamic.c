@@ -50,6 +50,30 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Pooled threads main function.
+ * @details The slot function is executed then the thread parks itself
+ *          waiting to be re-armed, the thread terminates if the wakeup
+ *          message is not @p MSG_OK.
+ *
+ * @param[in] p         pointer to the thread slot
+ */
+static THD_FUNCTION(__thd_pool_worker, p) {
+  thread_pool_slot_t *sp = (thread_pool_slot_t *)p;
+  msg_t msg;
+
+  do {
+    sp->pf(sp->arg);
+
+    chSysLock();
+    ch_queue_insert(&sp->pool->parked, &sp->queue);
+    msg = chThdSuspendS(&sp->tr);
+    chSysUnlock();
+  } while (msg == MSG_OK);
+}
+#endif /* CH_CFG_USE_HEAP == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -105,6 +129,148 @@ thread_t *chThdCreateFromHeap(memory_heap_t *heapp, size_t size,
 
   return tp;
 }
+
+/**
+ * @brief   Initializes a threads pool.
+ * @pre     The configuration options @p CH_CFG_USE_DYNAMIC and
+ *          @p CH_CFG_USE_HEAP must be enabled in order to use this function.
+ *
+ * @param[out] tpp      pointer to the @p thread_pool_t object
+ * @param[in] heapp     heap from which allocate the working areas or
+ *                      @p NULL for the default heap
+ * @param[in] size      size of the working areas to be allocated
+ * @param[in] name      name of pooled threads
+ * @param[in] slots     pointer to an array of @p thread_pool_slot_t
+ * @param[in] n         number of slots, it is the maximum number of threads
+ *                      in the pool
+ *
+ * @init
+ */
+void chThdPoolObjectInit(thread_pool_t *tpp, memory_heap_t *heapp,
+                         size_t size, const char *name,
+                         thread_pool_slot_t *slots, size_t n) {
+
+  chDbgCheck((tpp != NULL) && (slots != NULL) && (n > (size_t)0));
+
+  tpp->heapp = heapp;
+  tpp->size  = size;
+  tpp->name  = name;
+  ch_queue_init(&tpp->free);
+  ch_queue_init(&tpp->parked);
+  while (n > (size_t)0) {
+    slots->tr   = NULL;
+    slots->pool = tpp;
+    ch_queue_insert(&tpp->free, &slots->queue);
+    slots++;
+    n--;
+  }
+}
+
+/**
+ * @brief   Starts a function on a pooled thread.
+ * @details The most recently parked thread is re-armed with the new
+ *          function, the allocator and the registry are not involved.
+ *          If there are no parked threads then a new one is created from
+ *          the heap using a free slot.
+ * @note    The function must return in order to give its thread back to
+ *          the pool, calling @p chThdExit() loses the slot.
+ * @note    Pooled threads never terminate so @p chThdWait() cannot be
+ *          used on them.
+ *
+ * @param[in] tpp       pointer to the @p thread_pool_t object
+ * @param[in] prio      the priority level for the function execution
+ * @param[in] pf        the function to be executed
+ * @param[in] arg       an argument passed to the function. It can be
+ *                      @p NULL.
+ * @return              The pointer to the @p thread_t executing the
+ *                      function.
+ * @retval NULL         if all slots are busy or the memory cannot be
+ *                      allocated.
+ *
+ * @api
+ */
+thread_t *chThdPoolStart(thread_pool_t *tpp, tprio_t prio,
+                         tfunc_t pf, void *arg) {
+  thread_pool_slot_t *sp;
+  thread_t *tp;
+
+  chDbgCheck((tpp != NULL) && (prio <= HIGHPRIO) && (pf != NULL));
+
+  chSysLock();
+
+  if (ch_queue_notempty(&tpp->parked)) {
+    /* Re-arming the most recently parked thread, its stack is more likely
+       to be still cached.*/
+    sp = (thread_pool_slot_t *)ch_queue_lifo_remove(&tpp->parked);
+    sp->pf  = pf;
+    sp->arg = arg;
+    tp = sp->tr;
+    tp->hdr.pqueue.prio = prio;
+#if CH_CFG_USE_MUTEXES == TRUE
+    tp->realprio = prio;
+#endif
+    chThdResumeS(&sp->tr, MSG_OK);
+    chSysUnlock();
+
+    return tp;
+  }
+
+  if (ch_queue_isempty(&tpp->free)) {
+    chSysUnlock();
+
+    return NULL;
+  }
+  sp = (thread_pool_slot_t *)ch_queue_fifo_remove(&tpp->free);
+
+  chSysUnlock();
+
+  /* Creating a new thread for the slot.*/
+  sp->pf  = pf;
+  sp->arg = arg;
+  tp = chThdCreateFromHeap(tpp->heapp, tpp->size, tpp->name, prio,
+                           __thd_pool_worker, (void *)sp);
+  if (tp == NULL) {
+    chSysLock();
+    ch_queue_insert(&tpp->free, &sp->queue);
+    chSysUnlock();
+  }
+
+  return tp;
+}
+
+/**
+ * @brief   Terminates the threads of a pool.
+ * @details Parked threads are terminated and their working areas returned
+ *          to the heap, the pool can be reused afterward.
+ * @pre     All pooled threads must be parked.
+ *
+ * @param[in] tpp       pointer to the @p thread_pool_t object
+ *
+ * @api
+ */
+void chThdPoolDispose(thread_pool_t *tpp) {
+
+  chDbgCheck(tpp != NULL);
+
+  chSysLock();
+  while (ch_queue_notempty(&tpp->parked)) {
+    thread_pool_slot_t *sp;
+    thread_t *tp;
+
+    sp = (thread_pool_slot_t *)ch_queue_fifo_remove(&tpp->parked);
+    tp = sp->tr;
+    chThdResumeS(&sp->tr, MSG_RESET);
+    chSysUnlock();
+
+    /* Releasing the reference acquired on creation, the memory is
+       returned to the heap.*/
+    (void) chThdWait(tp);
+
+    chSysLock();
+    ch_queue_insert(&tpp->free, &sp->queue);
+  }
+  chSysUnlock();
+}
 #endif /* CH_CFG_USE_HEAP == TRUE */
 
 #if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
@@ -65,6 +65,19 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_EVENTS_INDEXED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of bits in a flags group of an indexed event source.
+ */
+#define EVT_GROUP_BITS                                                      \
+  ((sizeof (eventflags_t) * 8U) / (size_t)CH_CFG_EVENTS_INDEX_SIZE)
+
+/**
+ * @brief   Index of the wide filters list.
+ */
+#define EVT_WIDE_LIST                   ((unsigned)CH_CFG_EVENTS_INDEX_SIZE)
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -81,6 +94,65 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_EVENTS_INDEXED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the mask of a flags group.
+ *
+ * @param[in] i         the flags group index
+ * @return              The flags mask of the group.
+ *
+ * @notapi
+ */
+static inline eventflags_t evt_group_mask(unsigned i) {
+
+  return (eventflags_t)(((eventflags_t)-1 >>
+                         ((sizeof (eventflags_t) * 8U) - EVT_GROUP_BITS)) <<
+                        ((size_t)i * EVT_GROUP_BITS));
+}
+
+/**
+ * @brief   Returns the index of the list a listener belongs to.
+ *
+ * @param[in] wflags    the flags filter of the listener
+ * @return              The index of the list.
+ *
+ * @notapi
+ */
+static unsigned evt_list_index(eventflags_t wflags) {
+  unsigned i;
+
+  for (i = 0U; i < EVT_WIDE_LIST; i++) {
+    eventflags_t mask = evt_group_mask(i);
+
+    if ((wflags & mask) != (eventflags_t)0) {
+      return (wflags & ~mask) == (eventflags_t)0 ? i : EVT_WIDE_LIST;
+    }
+  }
+
+  return EVT_WIDE_LIST;
+}
+
+/**
+ * @brief   Signals the interested listeners of a list.
+ *
+ * @param[in] elp       the first listener of the list or @p NULL
+ * @param[in] flags     the flags set to be added to the listener flags mask
+ *
+ * @notapi
+ */
+static void evt_broadcast_list(event_listener_t *elp, eventflags_t flags) {
+
+  while (elp != NULL) {
+    if ((flags == (eventflags_t)0) ||
+        ((flags & elp->wflags) != (eventflags_t)0)) {
+      elp->flags |= flags;
+      chEvtSignalI(elp->listener, elp->events);
+    }
+    elp = elp->next;
+  }
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -385,6 +457,235 @@ void chEvtBroadcastFlags(event_source_t *esp, eventflags_t flags) {
   chSysUnlock();
 }
 
+/**
+ * @brief   Signals the Event Listeners of several Event Sources.
+ * @details Each Event Source is broadcasted with its own flags set as
+ *          done by @p chEvtBroadcastFlagsI().
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] esps      array of pointers to @p event_source_t structures
+ * @param[in] flags     array of flags sets, one for each Event Source
+ * @param[in] n         number of Event Sources
+ *
+ * @iclass
+ */
+void chEvtBroadcastFlagsManyI(event_source_t *const esps[],
+                              const eventflags_t flags[], size_t n) {
+  size_t i;
+
+  chDbgCheckClassI();
+  chDbgCheck((esps != NULL) && (flags != NULL));
+
+  for (i = 0U; i < n; i++) {
+    chEvtBroadcastFlagsI(esps[i], flags[i]);
+  }
+}
+
+/**
+ * @brief   Signals the Event Listeners of several Event Sources.
+ * @details All the Event Sources are broadcasted within a single critical
+ *          zone, the reschedule is performed once at the end.
+ *
+ * @param[in] esps      array of pointers to @p event_source_t structures
+ * @param[in] flags     array of flags sets, one for each Event Source
+ * @param[in] n         number of Event Sources
+ *
+ * @api
+ */
+void chEvtBroadcastFlagsMany(event_source_t *const esps[],
+                             const eventflags_t flags[], size_t n) {
+
+  chSysLock();
+  chEvtBroadcastFlagsManyI(esps, flags, n);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+#if (CH_CFG_USE_EVENTS_INDEXED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes an Indexed Event Source.
+ * @note    This function can be invoked before the kernel is initialized
+ *          because it just prepares a @p indexed_event_source_t structure.
+ *
+ * @param[out] iesp     pointer to the @p indexed_event_source_t structure
+ *
+ * @init
+ */
+void chEvtIndexedObjectInit(indexed_event_source_t *iesp) {
+  unsigned i;
+
+  chDbgCheck(iesp != NULL);
+  chDbgAssert(EVT_GROUP_BITS > 0U, "index size too large");
+
+  for (i = 0U; i <= EVT_WIDE_LIST; i++) {
+    iesp->lists[i] = NULL;
+  }
+}
+
+/**
+ * @brief   Registers an Event Listener on an Indexed Event Source.
+ * @details The listener is inserted in the list of the flags group
+ *          containing all the bits of @p wflags, listeners whose filter
+ *          spans more than one group are visited by all broadcasts.
+ *
+ * @param[in] iesp      pointer to the @p indexed_event_source_t structure
+ * @param[in] elp       pointer to the @p event_listener_t structure
+ * @param[in] events    events to be ORed to the thread when
+ *                      the event source is broadcasted
+ * @param[in] wflags    mask of flags the listening thread is interested in
+ *
+ * @iclass
+ */
+void chEvtIndexedRegisterMaskWithFlagsI(indexed_event_source_t *iesp,
+                                        event_listener_t *elp,
+                                        eventmask_t events,
+                                        eventflags_t wflags) {
+  unsigned i;
+
+  chDbgCheckClassI();
+  chDbgCheck((iesp != NULL) && (elp != NULL));
+
+  i = evt_list_index(wflags);
+  elp->next      = iesp->lists[i];
+  iesp->lists[i] = elp;
+  elp->listener  = chThdGetSelfX();
+  elp->events    = events;
+  elp->flags     = (eventflags_t)0;
+  elp->wflags    = wflags;
+}
+
+/**
+ * @brief   Registers an Event Listener on an Indexed Event Source.
+ * @details The listener is inserted in the list of the flags group
+ *          containing all the bits of @p wflags, listeners whose filter
+ *          spans more than one group are visited by all broadcasts.
+ *
+ * @param[in] iesp      pointer to the @p indexed_event_source_t structure
+ * @param[in] elp       pointer to the @p event_listener_t structure
+ * @param[in] events    events to be ORed to the thread when
+ *                      the event source is broadcasted
+ * @param[in] wflags    mask of flags the listening thread is interested in
+ *
+ * @api
+ */
+void chEvtIndexedRegisterMaskWithFlags(indexed_event_source_t *iesp,
+                                       event_listener_t *elp,
+                                       eventmask_t events,
+                                       eventflags_t wflags) {
+
+  chSysLock();
+  chEvtIndexedRegisterMaskWithFlagsI(iesp, elp, events, wflags);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Unregisters an Event Listener from its Indexed Event Source.
+ * @note    If the event listener is not registered on the specified event
+ *          source then the function does nothing.
+ *
+ * @param[in] iesp      pointer to the @p indexed_event_source_t structure
+ * @param[in] elp       pointer to the @p event_listener_t structure
+ *
+ * @api
+ */
+void chEvtIndexedUnregister(indexed_event_source_t *iesp,
+                            event_listener_t *elp) {
+  event_listener_t **pp;
+
+  chDbgCheck((iesp != NULL) && (elp != NULL));
+
+  chSysLock();
+  pp = &iesp->lists[evt_list_index(elp->wflags)];
+  while (*pp != NULL) {
+    if (*pp == elp) {
+      *pp = elp->next;
+      break;
+    }
+    pp = &(*pp)->next;
+  }
+  chSysUnlock();
+}
+
+/**
+ * @brief   Verifies if there is at least one @p event_listener_t registered.
+ *
+ * @param[in] iesp      pointer to the @p indexed_event_source_t structure
+ * @return              The event source status.
+ *
+ * @iclass
+ */
+bool chEvtIndexedIsListeningI(indexed_event_source_t *iesp) {
+  unsigned i;
+
+  chDbgCheckClassI();
+  chDbgCheck(iesp != NULL);
+
+  for (i = 0U; i <= EVT_WIDE_LIST; i++) {
+    if (iesp->lists[i] != NULL) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief   Signals the interested Event Listeners of an Indexed Event
+ *          Source.
+ * @details Only the lists of the flags groups overlapping @p flags and the
+ *          list of the wide filters are visited. A zero @p flags signals
+ *          all listeners.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] iesp      pointer to the @p indexed_event_source_t structure
+ * @param[in] flags     the flags set to be added to the listener flags mask
+ *
+ * @iclass
+ */
+void chEvtIndexedBroadcastFlagsI(indexed_event_source_t *iesp,
+                                 eventflags_t flags) {
+  unsigned i;
+
+  chDbgCheckClassI();
+  chDbgCheck(iesp != NULL);
+
+  for (i = 0U; i < EVT_WIDE_LIST; i++) {
+    if ((flags == (eventflags_t)0) ||
+        ((flags & evt_group_mask(i)) != (eventflags_t)0)) {
+      evt_broadcast_list(iesp->lists[i], flags);
+    }
+  }
+  evt_broadcast_list(iesp->lists[EVT_WIDE_LIST], flags);
+}
+
+/**
+ * @brief   Signals the interested Event Listeners of an Indexed Event
+ *          Source.
+ * @details Only the lists of the flags groups overlapping @p flags and the
+ *          list of the wide filters are visited. A zero @p flags signals
+ *          all listeners.
+ *
+ * @param[in] iesp      pointer to the @p indexed_event_source_t structure
+ * @param[in] flags     the flags set to be added to the listener flags mask
+ *
+ * @api
+ */
+void chEvtIndexedBroadcastFlags(indexed_event_source_t *iesp,
+                                eventflags_t flags) {
+
+  chSysLock();
+  chEvtIndexedBroadcastFlagsI(iesp, flags);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+#endif /* CH_CFG_USE_EVENTS_INDEXED == TRUE */
+
 /**
  * @brief   Invokes the event handlers associated to an event flags mask.
  *
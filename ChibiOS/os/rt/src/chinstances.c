@@ -110,6 +110,16 @@ void chInstanceObjectInit(os_instance_t *oip,
 
   /* Ready list initialization.*/
   ch_pqueue_init(&oip->rlist.pqueue);
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  {
+    unsigned i;
+
+    oip->rlist.summary = 0U;
+    for (i = 0U; i < CH_READY_BITMAP_WORDS; i++) {
+      oip->rlist.levels[i] = 0U;
+    }
+  }
+#endif
 
 #if (CH_CFG_USE_REGISTRY == TRUE) && (CH_CFG_SMP_MODE == FALSE)
   /* Registry initialization when SMP mode is disabled.*/
@@ -152,10 +162,17 @@ void chInstanceObjectInit(os_instance_t *oip,
                                          "idle", IDLEPRIO);
 #endif
 
-#if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE)
+#if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE) ||  \
+    (CH_DBG_STACK_WATERMARK == TRUE)
   oip->rlist.current->wabase = oicp->mainthread_base;
 #endif
 
+#if CH_DBG_STACK_WATERMARK == TRUE
+  /* If the main stack boundaries are not known then the watermark is
+     never updated.*/
+  oip->rlist.current->stkmin = (uint8_t *)oicp->mainthread_end;
+#endif
+
   /* Setting up the caller as current thread.*/
   oip->rlist.current->state = CH_STATE_CURRENT;
 
@@ -89,6 +89,46 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if ((CH_CFG_SMP_MODE == TRUE) && (CH_CFG_MUTEXES_SPIN_TIME > 0)) ||        \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Spins while the mutex owner is running on another OS instance.
+ * @details The kernel lock is released for the whole spin so that the owner
+ *          is able to unlock the mutex, the owner is polled without lock.
+ *          Spinning ends when the mutex is released, when the owner stops
+ *          running or when @p CH_CFG_MUTEXES_SPIN_TIME cycles have elapsed.
+ *          The caller rechecks the mutex state under lock.
+ * @note    The owner fields may change while being polled, they are only
+ *          used to decide when to stop spinning.
+ *
+ * @param[in] mp        pointer to the @p mutex_t structure
+ *
+ * @notapi
+ */
+static void mtx_spin(mutex_t *mp) {
+  thread_t *tp = mp->owner;
+  rtcnt_t start, end;
+
+  /* Spinning only makes sense if the owner is running on another
+     instance.*/
+  if ((tp == NULL) || (tp->owner == currcore) ||
+      (tp->state != CH_STATE_CURRENT)) {
+    return;
+  }
+
+  chSysUnlock();
+  start = chSysGetRealtimeCounterX();
+  end   = start + (rtcnt_t)CH_CFG_MUTEXES_SPIN_TIME;
+  do {
+    PORT_SPIN_HINT();
+    tp = *(thread_t * volatile *)&mp->owner;
+  } while ((tp != NULL) &&
+           (*(volatile tstate_t *)&tp->state == CH_STATE_CURRENT) &&
+           chSysIsCounterWithinX(chSysGetRealtimeCounterX(), start, end));
+  chSysLock();
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -115,6 +155,9 @@ void chMtxObjectInit(mutex_t *mp) {
  * @brief   Locks the specified mutex.
  * @post    The mutex is locked and inserted in the per-thread stack of owned
  *          mutexes.
+ * @note    In SMP mode, if @p CH_CFG_MUTEXES_SPIN_TIME is not zero, the
+ *          function spins while the owner is running on another OS instance
+ *          before blocking.
  *
  * @param[in] mp        pointer to the @p mutex_t structure
  *
@@ -123,6 +166,9 @@ void chMtxObjectInit(mutex_t *mp) {
 void chMtxLock(mutex_t *mp) {
 
   chSysLock();
+#if (CH_CFG_SMP_MODE == TRUE) && (CH_CFG_MUTEXES_SPIN_TIME > 0)
+  mtx_spin(mp);
+#endif
   chMtxLockS(mp);
   chSysUnlock();
 }
@@ -142,6 +188,8 @@ void chMtxLockS(mutex_t *mp) {
   chDbgCheckClassS();
   chDbgCheck(mp != NULL);
 
+  __trace_object(CH_TRACE_OBJ_MTX_LOCK, mp, (msg_t)(mp->owner != NULL));
+
   /* Is the mutex already locked? */
   if (mp->owner != NULL) {
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
@@ -163,6 +211,8 @@ void chMtxLockS(mutex_t *mp) {
       /* Does the running thread have higher priority than the mutex
          owning thread? */
       while (tp->hdr.pqueue.prio < currtp->hdr.pqueue.prio) {
+        tprio_t oldprio = tp->hdr.pqueue.prio;
+
         /* Make priority of thread tp match the running thread's priority.*/
         tp->hdr.pqueue.prio = currtp->hdr.pqueue.prio;
 
@@ -201,7 +251,7 @@ void chMtxLockS(mutex_t *mp) {
           tp->state = CH_STATE_CURRENT;
 #endif
           /* Re-enqueues tp with its new priority on the ready list.*/
-          (void) chSchReadyI(threadref(ch_queue_dequeue(&tp->hdr.queue)));
+          (void) chSchReadyI(ch_sch_rlist_remove(tp, oldprio));
           break;
         default:
           /* Nothing to do for other states.*/
@@ -287,6 +337,8 @@ bool chMtxTryLockS(mutex_t *mp) {
   chDbgCheckClassS();
   chDbgCheck(mp != NULL);
 
+  __trace_object(CH_TRACE_OBJ_MTX_LOCK, mp, (msg_t)(mp->owner != NULL));
+
   if (mp->owner != NULL) {
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
 
@@ -331,6 +383,8 @@ void chMtxUnlock(mutex_t *mp) {
 
   chSysLock();
 
+  __trace_object(CH_TRACE_OBJ_MTX_UNLOCK, mp, (msg_t)0);
+
   chDbgAssert(currtp->mtxlist != NULL, "owned mutexes list empty");
   chDbgAssert(currtp->mtxlist->owner == currtp, "ownership failure");
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
@@ -417,6 +471,8 @@ void chMtxUnlockS(mutex_t *mp) {
   chDbgCheckClassS();
   chDbgCheck(mp != NULL);
 
+  __trace_object(CH_TRACE_OBJ_MTX_UNLOCK, mp, (msg_t)0);
+
   chDbgAssert(currtp->mtxlist != NULL, "owned mutexes list empty");
   chDbgAssert(currtp->mtxlist->owner == currtp, "ownership failure");
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
@@ -91,7 +91,8 @@ ROMCONST chdebug_t ch_debug = {
   .off_newer                = (uint8_t)__CH_OFFSETOF(thread_t, rqueue.next),
   .off_older                = (uint8_t)__CH_OFFSETOF(thread_t, rqueue.prev),
   .off_name                 = (uint8_t)__CH_OFFSETOF(thread_t, name),
-#if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE)
+#if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE) ||  \
+    (CH_DBG_STACK_WATERMARK == TRUE)
   .off_stklimit             = (uint8_t)__CH_OFFSETOF(thread_t, wabase),
 #else
   .off_stklimit             = (uint8_t)0,
@@ -113,7 +114,12 @@ ROMCONST chdebug_t ch_debug = {
 #else
   .off_time                 = (uint8_t)0,
 #endif
-  .off_reserved             = {(uint8_t)0, (uint8_t)0, (uint8_t)0, (uint8_t)0},
+#if CH_DBG_STACK_WATERMARK == TRUE
+  .off_stkmin               = (uint8_t)__CH_OFFSETOF(thread_t, stkmin),
+#else
+  .off_stkmin               = (uint8_t)0,
+#endif
+  .off_reserved             = {(uint8_t)0, (uint8_t)0, (uint8_t)0},
   .instancesnum             = (uint8_t)PORT_CORES_NUMBER,
   .off_sys_state            = (uint8_t)__CH_OFFSETOF(ch_system_t, state),
   .off_sys_instances        = (uint8_t)__CH_OFFSETOF(ch_system_t, instances[0]),
@@ -270,7 +276,7 @@ thread_t *chRegFindThreadByPointer(thread_t *tp) {
 }
 
 #if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE) ||  \
-    defined(__DOXYGEN__)
+    (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Confirms that a working area is being used by some active thread.
  * @note    The reference counter of the found thread is increased by one so
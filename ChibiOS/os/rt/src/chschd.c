@@ -48,6 +48,189 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_READY_BITMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Index of the least significant bit set in a non-zero word.
+ *
+ * @param[in] x         the word to be scanned, must not be zero
+ * @return              The bit index.
+ *
+ * @notapi
+ */
+static inline unsigned __sch_ctz(uint32_t x) {
+#if defined(__GNUC__)
+  return (unsigned)__builtin_ctz(x);
+#else
+  unsigned n = 0U;
+
+  while ((x & 1U) == 0U) {
+    x >>= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
+/**
+ * @brief   Marks a priority level as present in the ready list.
+ *
+ * @param[in] rlp       pointer to the ready list
+ * @param[in] prio      the priority level
+ *
+ * @notapi
+ */
+static inline void __sch_bitmap_set(ready_list_t *rlp, tprio_t prio) {
+
+  rlp->levels[prio >> 5] |= (uint32_t)1U << (prio & 31U);
+  rlp->summary           |= (uint32_t)1U << (prio >> 5);
+}
+
+/**
+ * @brief   Marks a priority level as no more present in the ready list.
+ *
+ * @param[in] rlp       pointer to the ready list
+ * @param[in] prio      the priority level
+ *
+ * @notapi
+ */
+static inline void __sch_bitmap_clear(ready_list_t *rlp, tprio_t prio) {
+
+  rlp->levels[prio >> 5] &= ~((uint32_t)1U << (prio & 31U));
+  if (rlp->levels[prio >> 5] == 0U) {
+    rlp->summary &= ~((uint32_t)1U << (prio >> 5));
+  }
+}
+
+/**
+ * @brief   Returns the element after which a thread must be inserted.
+ * @details The returned element is the last thread of the lowest priority
+ *          level greater or equal than @p prio, or the list header if
+ *          there are no threads at those levels.
+ *
+ * @param[in] rlp       pointer to the ready list
+ * @param[in] prio      the lowest priority level to be considered
+ * @return              The insertion point.
+ *
+ * @notapi
+ */
+static inline ch_priority_queue_t *__sch_rlist_find(ready_list_t *rlp,
+                                                    tprio_t prio) {
+  uint32_t w, m;
+
+  if (prio >= CH_READY_BITMAP_LEVELS) {
+    return &rlp->pqueue;
+  }
+
+  /* Searching first in the word containing the priority level.*/
+  w = prio >> 5;
+  m = rlp->levels[w] & ((uint32_t)0xFFFFFFFFU << (prio & 31U));
+  if (m == 0U) {
+    /* Then in the following non-empty words, if any.*/
+    m = rlp->summary & ~(((uint32_t)2U << w) - 1U);
+    if (m == 0U) {
+      return &rlp->pqueue;
+    }
+    w = __sch_ctz(m);
+    m = rlp->levels[w];
+  }
+
+  return rlp->tails[(w << 5) + __sch_ctz(m)];
+}
+
+/**
+ * @brief   Inserts an element after another one in the ready list.
+ *
+ * @param[in] pqp       the element after which the insertion is done
+ * @param[in] p         the pointer to the element to be inserted
+ *
+ * @notapi
+ */
+static inline void __sch_rlist_insert_after(ch_priority_queue_t *pqp,
+                                            ch_priority_queue_t *p) {
+
+  p->prev       = pqp;
+  p->next       = pqp->next;
+  p->next->prev = p;
+  pqp->next     = p;
+}
+#endif /* CH_CFG_USE_READY_BITMAP == TRUE */
+
+/**
+ * @brief   Inserts a thread in the ready list behind its peers.
+ *
+ * @param[in] rlp       pointer to the ready list
+ * @param[in] tp        the thread to be inserted
+ * @return              The thread pointer.
+ *
+ * @notapi
+ */
+static inline thread_t *__sch_rlist_insert_behind(ready_list_t *rlp,
+                                                  thread_t *tp) {
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  tprio_t prio = tp->hdr.pqueue.prio;
+
+  /* Behind the last thread having priority greater or equal.*/
+  __sch_rlist_insert_after(__sch_rlist_find(rlp, prio), &tp->hdr.pqueue);
+  rlp->tails[prio] = &tp->hdr.pqueue;
+  __sch_bitmap_set(rlp, prio);
+
+  return tp;
+#else
+  return threadref(ch_pqueue_insert_behind(&rlp->pqueue, &tp->hdr.pqueue));
+#endif
+}
+
+/**
+ * @brief   Inserts a thread in the ready list ahead of its peers.
+ *
+ * @param[in] rlp       pointer to the ready list
+ * @param[in] tp        the thread to be inserted
+ * @return              The thread pointer.
+ *
+ * @notapi
+ */
+static inline thread_t *__sch_rlist_insert_ahead(ready_list_t *rlp,
+                                                 thread_t *tp) {
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  tprio_t prio = tp->hdr.pqueue.prio;
+
+  /* Behind the last thread having priority strictly greater.*/
+  __sch_rlist_insert_after(__sch_rlist_find(rlp, prio + (tprio_t)1),
+                           &tp->hdr.pqueue);
+  if ((rlp->levels[prio >> 5] & ((uint32_t)1U << (prio & 31U))) == 0U) {
+    rlp->tails[prio] = &tp->hdr.pqueue;
+    __sch_bitmap_set(rlp, prio);
+  }
+
+  return tp;
+#else
+  return threadref(ch_pqueue_insert_ahead(&rlp->pqueue, &tp->hdr.pqueue));
+#endif
+}
+
+/**
+ * @brief   Removes the highest priority thread from the ready list.
+ *
+ * @param[in] rlp       pointer to the ready list
+ * @return              The removed thread pointer.
+ *
+ * @notapi
+ */
+static inline thread_t *__sch_rlist_remove_highest(ready_list_t *rlp) {
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  ch_priority_queue_t *p = ch_pqueue_remove_highest(&rlp->pqueue);
+
+  /* The first thread of a level is also its last only if alone.*/
+  if (rlp->tails[p->prio] == p) {
+    __sch_bitmap_clear(rlp, p->prio);
+  }
+
+  return threadref(p);
+#else
+  return threadref(ch_pqueue_remove_highest(&rlp->pqueue));
+#endif
+}
+
 /**
  * @brief   Inserts a thread in the Ready List placing it behind its peers.
  * @details The thread is positioned behind all threads with higher or equal
@@ -77,8 +260,7 @@ static thread_t *__sch_ready_behind(thread_t *tp) {
   tp->state = CH_STATE_READY;
 
   /* Insertion in the priority queue.*/
-  return threadref(ch_pqueue_insert_behind(&tp->owner->rlist.pqueue,
-                                           &tp->hdr.pqueue));
+  return __sch_rlist_insert_behind(&tp->owner->rlist, tp);
 }
 
 /**
@@ -110,8 +292,7 @@ static thread_t *__sch_ready_ahead(thread_t *tp) {
   tp->state = CH_STATE_READY;
 
   /* Insertion in the priority queue.*/
-  return threadref(ch_pqueue_insert_ahead(&tp->owner->rlist.pqueue,
-                                          &tp->hdr.pqueue));
+  return __sch_rlist_insert_ahead(&tp->owner->rlist, tp);
 }
 
 /**
@@ -130,7 +311,7 @@ static void __sch_reschedule_behind(void) {
   thread_t *ntp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  ntp = threadref(ch_pqueue_remove_highest(&oip->rlist.pqueue));
+  ntp = __sch_rlist_remove_highest(&oip->rlist);
   ntp->state = CH_STATE_CURRENT;
   __instance_set_currthread(oip, ntp);
 
@@ -166,7 +347,7 @@ static void __sch_reschedule_ahead(void) {
   thread_t *ntp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  ntp = threadref(ch_pqueue_remove_highest(&oip->rlist.pqueue));
+  ntp = __sch_rlist_remove_highest(&oip->rlist);
   ntp->state = CH_STATE_CURRENT;
   __instance_set_currthread(oip, ntp);
 
@@ -236,6 +417,38 @@ static void __sch_wakeup(virtual_timer_t *vtp, void *p) {
 /* Module exported functions.                                                */
 /*===========================================================================*/
 
+/**
+ * @brief   Removes a thread from the ready list.
+ * @note    The priority is passed explicitly because the caller could have
+ *          already modified the thread priority field.
+ *
+ * @param[in] tp        the thread to be removed from the ready list
+ * @param[in] prio      the priority the thread has been inserted with
+ * @return              The removed thread pointer.
+ *
+ * @notapi
+ */
+thread_t *ch_sch_rlist_remove(thread_t *tp, tprio_t prio) {
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  ready_list_t *rlp = &tp->owner->rlist;
+
+  if (rlp->tails[prio] == &tp->hdr.pqueue) {
+    /* The previous thread becomes the last of the level, if any.*/
+    if ((tp->hdr.pqueue.prev != &rlp->pqueue) &&
+        (tp->hdr.pqueue.prev->prio == prio)) {
+      rlp->tails[prio] = tp->hdr.pqueue.prev;
+    }
+    else {
+      __sch_bitmap_clear(rlp, prio);
+    }
+  }
+#else
+  (void)prio;
+#endif
+
+  return threadref(ch_queue_dequeue(&tp->hdr.queue));
+}
+
 #if (CH_CFG_OPTIMIZE_SPEED == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   Inserts a thread into a priority ordered queue.
@@ -293,6 +506,71 @@ thread_t *chSchReadyI(thread_t *tp) {
   return __sch_ready_behind(tp);
 }
 
+/**
+ * @brief   Inserts a batch of threads in the Ready List.
+ * @details All the threads in the specified queue are made ready in queue
+ *          order, each one is positioned behind all threads with higher or
+ *          equal priority exactly as @p chSchReadyI() would do. The ready
+ *          list scan is resumed from the previous insertion point as long
+ *          as the priorities are non-increasing so a priority-sorted batch,
+ *          or a batch of threads having the same priority, is merged in a
+ *          single pass.
+ * @post    The queue is left empty.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] qp        pointer to the queue of threads to be made ready
+ * @param[in] state     the state all the threads in the queue are expected
+ *                      to be in, checked by assertion
+ * @param[in] msg       the wakeup message for all the threads
+ *
+ * @iclass
+ */
+void chSchReadyBatchI(ch_queue_t *qp, tstate_t state, msg_t msg) {
+#if CH_CFG_USE_READY_BITMAP == FALSE
+  ready_list_t *rlp = NULL;
+  ch_priority_queue_t *pqp = NULL;
+#endif
+
+  chDbgCheckClassI();
+  chDbgCheck(qp != NULL);
+
+  while (ch_queue_notempty(qp)) {
+    thread_t *tp = threadref(ch_queue_fifo_remove(qp));
+
+    chDbgAssert(tp->state == state, "invalid state");
+
+    tp->u.rdymsg = msg;
+
+#if CH_CFG_SMP_MODE == TRUE
+    if (tp->owner != currcore) {
+      chSysNotifyInstance(tp->owner);
+    }
+#endif
+
+    /* Tracing the event.*/
+    __trace_ready(tp, tp->u.rdymsg);
+
+    /* The thread is marked ready.*/
+    tp->state = CH_STATE_READY;
+
+#if CH_CFG_USE_READY_BITMAP == TRUE
+    /* Insertion is already constant time using the levels tails.*/
+    (void) __sch_rlist_insert_behind(&tp->owner->rlist, tp);
+#else
+    /* Restarting from the list header only if the priority is greater than
+       the previous one or the thread belongs to another ready list.*/
+    if ((rlp != &tp->owner->rlist) || (pqp->prio < tp->hdr.pqueue.prio)) {
+      rlp = &tp->owner->rlist;
+      pqp = &rlp->pqueue;
+    }
+    pqp = ch_pqueue_insert_behind(pqp, &tp->hdr.pqueue);
+#endif
+  }
+}
+
 /**
  * @brief   Puts the current thread to sleep into the specified state.
  * @details The thread goes into a sleeping state. The possible
@@ -322,7 +600,7 @@ void chSchGoSleepS(tstate_t newstate) {
 #endif
 
   /* Next thread in ready list becomes current.*/
-  ntp = threadref(ch_pqueue_remove_highest(&oip->rlist.pqueue));
+  ntp = __sch_rlist_remove_highest(&oip->rlist);
   ntp->state = CH_STATE_CURRENT;
   __instance_set_currthread(oip, ntp);
 
@@ -520,7 +798,7 @@ void chSchDoPreemption(void) {
   thread_t *ntp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  ntp = threadref(ch_pqueue_remove_highest(&oip->rlist.pqueue));
+  ntp = __sch_rlist_remove_highest(&oip->rlist);
   ntp->state = CH_STATE_CURRENT;
   __instance_set_currthread(oip, ntp);
 
@@ -630,7 +908,7 @@ thread_t *chSchSelectFirst(void) {
   thread_t *ntp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  ntp = threadref(ch_pqueue_remove_highest(&oip->rlist.pqueue));
+  ntp = __sch_rlist_remove_highest(&oip->rlist);
   ntp->state = CH_STATE_CURRENT;
   __instance_set_currthread(oip, ntp);
 
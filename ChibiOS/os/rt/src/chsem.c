@@ -195,6 +195,7 @@ msg_t chSemWaitS(semaphore_t *sp) {
   chDbgAssert(((sp->cnt >= (cnt_t)0) && ch_queue_isempty(&sp->queue)) ||
               ((sp->cnt < (cnt_t)0) && ch_queue_notempty(&sp->queue)),
               "inconsistent semaphore");
+  __trace_object(CH_TRACE_OBJ_SEM_WAIT, sp, (msg_t)sp->cnt);
 
   if (--sp->cnt < (cnt_t)0) {
     thread_t *currtp = chThdGetSelfX();
@@ -263,6 +264,7 @@ msg_t chSemWaitTimeoutS(semaphore_t *sp, sysinterval_t timeout) {
   chDbgAssert(((sp->cnt >= (cnt_t)0) && ch_queue_isempty(&sp->queue)) ||
               ((sp->cnt < (cnt_t)0) && ch_queue_notempty(&sp->queue)),
               "inconsistent semaphore");
+  __trace_object(CH_TRACE_OBJ_SEM_WAIT, sp, (msg_t)sp->cnt);
 
   if (--sp->cnt < (cnt_t)0) {
     if (unlikely(TIME_IMMEDIATE == timeout)) {
@@ -295,6 +297,7 @@ void chSemSignal(semaphore_t *sp) {
   chDbgAssert(((sp->cnt >= (cnt_t)0) && ch_queue_isempty(&sp->queue)) ||
               ((sp->cnt < (cnt_t)0) && ch_queue_notempty(&sp->queue)),
               "inconsistent semaphore");
+  __trace_object(CH_TRACE_OBJ_SEM_SIGNAL, sp, (msg_t)sp->cnt);
   if (++sp->cnt <= (cnt_t)0) {
     chSchWakeupS(threadref(ch_queue_fifo_remove(&sp->queue)), MSG_OK);
   }
@@ -319,6 +322,7 @@ void chSemSignalI(semaphore_t *sp) {
   chDbgAssert(((sp->cnt >= (cnt_t)0) && ch_queue_isempty(&sp->queue)) ||
               ((sp->cnt < (cnt_t)0) && ch_queue_notempty(&sp->queue)),
               "inconsistent semaphore");
+  __trace_object(CH_TRACE_OBJ_SEM_SIGNAL, sp, (msg_t)sp->cnt);
 
   if (++sp->cnt <= (cnt_t)0) {
     /* Note, it is done this way in order to allow a tail call on
@@ -350,12 +354,24 @@ void chSemAddCounterI(semaphore_t *sp, cnt_t n) {
               ((sp->cnt < (cnt_t)0) && ch_queue_notempty(&sp->queue)),
               "inconsistent semaphore");
 
-  while (n > (cnt_t)0) {
-    if (++sp->cnt <= (cnt_t)0) {
-      chSchReadyI(threadref(ch_queue_fifo_remove(&sp->queue)))->u.rdymsg = MSG_OK;
+  if (sp->cnt < (cnt_t)0) {
+    if (sp->cnt + n >= (cnt_t)0) {
+      /* All the waiting threads are released at once.*/
+      chSchReadyBatchI(&sp->queue, CH_STATE_WTSEM, MSG_OK);
+    }
+    else {
+      ch_queue_t batch;
+      cnt_t i;
+
+      /* The first n waiting threads are moved in a local batch.*/
+      ch_queue_init(&batch);
+      for (i = (cnt_t)0; i < n; i++) {
+        ch_queue_insert(&batch, ch_queue_fifo_remove(&sp->queue));
+      }
+      chSchReadyBatchI(&batch, CH_STATE_WTSEM, MSG_OK);
     }
-    n--;
   }
+  sp->cnt += n;
 }
 
 /**
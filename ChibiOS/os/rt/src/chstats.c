@@ -76,6 +76,30 @@ void __stats_ctxswc(thread_t *ntp, thread_t *otp) {
   chTMChainMeasurementToX(&otp->stats, &ntp->stats);
 }
 
+/**
+ * @brief   Increases the virtual timers alarm settings counter.
+ */
+void __stats_vt_alarm(void) {
+
+  currcore->kernel_stats.n_vtalarm++;
+}
+
+/**
+ * @brief   Increases the virtual timers ticks counter.
+ */
+void __stats_vt_tick(void) {
+
+  currcore->kernel_stats.n_vttick++;
+}
+
+/**
+ * @brief   Increases the triggered virtual timers counter.
+ */
+void __stats_vt_fire(void) {
+
+  currcore->kernel_stats.n_vtfire++;
+}
+
 /**
  * @brief   Starts the measurement of a thread critical zone.
  */
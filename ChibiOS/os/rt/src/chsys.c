@@ -306,10 +306,82 @@ bool chSysIntegrityCheckI(unsigned testmask) {
     if (n != (cnt_t)0) {
       return true;
     }
+
+#if CH_CFG_USE_READY_BITMAP == TRUE
+    /* The last thread of each priority level must be the one recorded in
+       the index and all the priority levels must be marked.*/
+    pqp = oip->rlist.pqueue.next;
+    while (pqp != &oip->rlist.pqueue) {
+      if (pqp->next->prio != pqp->prio) {
+        if ((oip->rlist.tails[pqp->prio] != pqp) ||
+            ((oip->rlist.levels[pqp->prio >> 5] &
+              ((uint32_t)1U << (pqp->prio & 31U))) == 0U)) {
+          return true;
+        }
+        n++;
+      }
+      pqp = pqp->next;
+    }
+
+    /* No other priority levels must be marked.*/
+    {
+      unsigned i;
+
+      for (i = 0U; i < CH_READY_BITMAP_WORDS; i++) {
+        uint32_t w = oip->rlist.levels[i];
+
+        if (((oip->rlist.summary >> i) & 1U) != (w != 0U ? 1U : 0U)) {
+          return true;
+        }
+        while (w != 0U) {
+          w &= w - 1U;
+          n--;
+        }
+      }
+    }
+    if (n != (cnt_t)0) {
+      return true;
+    }
+#endif
   }
 
   /* Timers list integrity check.*/
   if ((testmask & CH_INTEGRITY_VTLIST) != 0U) {
+#if CH_CFG_USE_TIMERS_WHEEL == TRUE
+    unsigned i, j;
+
+    for (i = 0U; i < CH_VT_WHEEL_LEVELS; i++) {
+      for (j = 0U; j < CH_VT_WHEEL_SLOTS; j++) {
+        ch_delta_list_t *dlhp = &oip->vtlist.slots[i][j];
+        ch_delta_list_t *dlp;
+
+        /* Scanning the slot forward.*/
+        n = (cnt_t)0;
+        dlp = dlhp->next;
+        while (dlp != dlhp) {
+          n++;
+          dlp = dlp->next;
+        }
+
+        /* The slot must be marked as used only if not empty.*/
+        if (((oip->vtlist.used[i] >> j) & 1U) != (n > (cnt_t)0 ? 1U : 0U)) {
+          return true;
+        }
+
+        /* Scanning the slot backward.*/
+        dlp = dlhp->prev;
+        while (dlp != dlhp) {
+          n--;
+          dlp = dlp->prev;
+        }
+
+        /* The number of elements must match.*/
+        if (n != (cnt_t)0) {
+          return true;
+        }
+      }
+    }
+#else
     ch_delta_list_t *dlp;
 
     /* Scanning the timers list forward.*/
@@ -331,6 +403,7 @@ bool chSysIntegrityCheckI(unsigned testmask) {
     if (n != (cnt_t)0) {
       return true;
     }
+#endif
   }
 
 #if CH_CFG_USE_REGISTRY == TRUE
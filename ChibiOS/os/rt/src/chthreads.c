@@ -185,11 +185,17 @@ thread_t *chThdCreateSuspendedI(const thread_descriptor_t *tdp) {
   tp = threadref(((uint8_t *)tdp->wend -
                  MEM_ALIGN_NEXT(sizeof (thread_t), PORT_STACK_ALIGN)));
 
-#if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE)
+#if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE) ||  \
+    (CH_DBG_STACK_WATERMARK == TRUE)
   /* Stack boundary.*/
   tp->wabase = tdp->wbase;
 #endif
 
+#if CH_DBG_STACK_WATERMARK == TRUE
+  /* The stack is initially empty, its top is the thread structure.*/
+  tp->stkmin = (uint8_t *)tp;
+#endif
+
   /* Setting up the port-dependent part of the working area.*/
   PORT_SETUP_CONTEXT(tp, tdp->wbase, tp, tdp->funcp, tdp->arg);
 
@@ -289,7 +295,8 @@ thread_t *chThdCreate(const thread_descriptor_t *tdp) {
   thread_t *tp;
 
 #if (CH_CFG_USE_REGISTRY == TRUE) &&                                        \
-    ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE))
+    ((CH_DBG_ENABLE_STACK_CHECK == TRUE) ||                                 \
+     (CH_CFG_USE_DYNAMIC == TRUE) || (CH_DBG_STACK_WATERMARK == TRUE))
   chDbgAssert(chRegFindThreadByWorkingArea(tdp->wbase) == NULL,
               "working area in use");
 #endif
@@ -337,7 +344,8 @@ thread_t *chThdCreateStatic(void *wsp, size_t size,
              (prio <= HIGHPRIO) && (pf != NULL));
 
 #if (CH_CFG_USE_REGISTRY == TRUE) &&                                        \
-    ((CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE))
+    ((CH_DBG_ENABLE_STACK_CHECK == TRUE) ||                                 \
+     (CH_CFG_USE_DYNAMIC == TRUE) || (CH_DBG_STACK_WATERMARK == TRUE))
   chDbgAssert(chRegFindThreadByWorkingArea(wsp) == NULL,
               "working area in use");
 #endif
@@ -354,11 +362,17 @@ thread_t *chThdCreateStatic(void *wsp, size_t size,
   tp = threadref(((uint8_t *)wsp + size -
                  MEM_ALIGN_NEXT(sizeof (thread_t), PORT_STACK_ALIGN)));
 
-#if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE)
+#if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE) ||  \
+    (CH_DBG_STACK_WATERMARK == TRUE)
   /* Stack boundary.*/
   tp->wabase = (stkalign_t *)wsp;
 #endif
 
+#if CH_DBG_STACK_WATERMARK == TRUE
+  /* The stack is initially empty, its top is the thread structure.*/
+  tp->stkmin = (uint8_t *)tp;
+#endif
+
   /* Setting up the port-dependent part of the working area.*/
   PORT_SETUP_CONTEXT(tp, wsp, tp, pf, arg);
 
@@ -905,9 +919,7 @@ void chThdDequeueNextI(threads_queue_t *tqp, msg_t msg) {
  */
 void chThdDequeueAllI(threads_queue_t *tqp, msg_t msg) {
 
-  while (ch_queue_notempty(&tqp->queue)) {
-    chThdDoDequeueNextI(tqp, msg);
-  }
+  chSchReadyBatchI(&tqp->queue, CH_STATE_QUEUED, msg);
 }
 
 /** @} */
@@ -32,6 +32,17 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   Maximum size of an encoded binary record.
+ * @note    Strings are truncated in order to fit.
+ */
+#define TRACE_MAX_RECORD                    48U
+
+/**
+ * @brief   Binary buffer index mask.
+ */
+#define TRACE_MASK                          ((size_t)CH_DBG_TRACE_BINARY_SIZE - 1U)
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -48,9 +59,194 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if ((CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED) &&                   \
+     (CH_DBG_TRACE_BINARY == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @brief   Encodes an unsigned 32 bits value as a variable length integer.
+ */
+static uint8_t *trace_put_u32(uint8_t *p, uint32_t x) {
+
+  while (x >= 0x80U) {
+    *p++ = (uint8_t)(x | 0x80U);
+    x >>= 7;
+  }
+  *p++ = (uint8_t)x;
+
+  return p;
+}
+
+/**
+ * @brief   Encodes a signed 32 bits value as a zig-zag variable length
+ *          integer.
+ */
+static uint8_t *trace_put_s32(uint8_t *p, int32_t x) {
+
+  return trace_put_u32(p, ((uint32_t)x << 1) ^ (uint32_t)(x >> 31));
+}
+
+/**
+ * @brief   Encodes a pointer as a zig-zag variable length difference from
+ *          the previous encoded pointer.
+ * @note    Pointers to the same memory area are encoded in a few bytes.
+ */
+static uint8_t *trace_put_ptr(uint8_t *p, uintptr_t *lastp, const void *ptr) {
+  uintptr_t x, d = (uintptr_t)ptr - *lastp;
+
+  *lastp = (uintptr_t)ptr;
+  x = (d << 1) ^ (((d >> ((sizeof (uintptr_t) * 8U) - 1U)) != 0U) ?
+                  ~(uintptr_t)0 : (uintptr_t)0);
+  while (x >= 0x80U) {
+    *p++ = (uint8_t)(x | 0x80U);
+    x >>= 7;
+  }
+  *p++ = (uint8_t)x;
+
+  return p;
+}
+
+/**
+ * @brief   Encodes a string, it is truncated to the available space.
+ */
+static uint8_t *trace_put_str(uint8_t *p, const uint8_t *end, const char *str) {
+
+  if (str != NULL) {
+    while ((p < end) && (*str != '\0')) {
+      *p++ = (uint8_t)*str++;
+    }
+  }
+
+  return p;
+}
+
+/**
+ * @brief   Copies an encoded record into the bytes buffer.
+ * @note    The caller checked that there is enough space.
+ */
+static void trace_commit(trace_buffer_t *tbp, const uint8_t *rec, size_t n) {
+
+  while (n > 0U) {
+    tbp->bytes[tbp->wridx & TRACE_MASK] = *rec++;
+    tbp->wridx++;
+    n--;
+  }
+}
+
+/**
+ * @brief   Returns the time stamp of binary records.
+ */
+static uint32_t trace_stamp(void) {
+
+#if PORT_SUPPORTS_RT == TRUE
+  return (uint32_t)chSysGetRealtimeCounterX();
+#else
+  return (uint32_t)chVTGetSystemTimeX();
+#endif
+}
+
+/**
+ * @brief   Encodes the current record into the bytes buffer.
+ * @details Records are formed by a type byte, a length byte for the rest
+ *          of the record, the realtime counter delta from the previous
+ *          record and the type-specific payload. If the buffer is full
+ *          then the record is dropped and counted, a lost record is
+ *          inserted as soon there is space again.
+ *
+ * @notapi
+ */
+static void trace_encode(trace_buffer_t *tbp, unsigned type, uint32_t now) {
+  uint8_t sync[TRACE_MAX_RECORD], lost[8], rec[TRACE_MAX_RECORD];
+  uint8_t *p, *end = &rec[TRACE_MAX_RECORD];
+  size_t syncn = 0U, lostn = 0U, recn, space;
+  uintptr_t lastptr = tbp->lastptr;
+  uint32_t laststamp = tbp->laststamp;
+  trace_event_t *tep = &tbp->record;
+
+  /* Synchronization record, absolute values from which the following
+     records deltas are computed. The pointers size allows the decoder
+     to wrap the pointer deltas as the encoder does.*/
+  if (tbp->sync) {
+    sync[0] = (uint8_t)CH_TRACE_TYPE_SYNC;
+    p = trace_put_u32(&sync[2], now);
+    p = trace_put_u32(p, (uint32_t)tep->time);
+    *p++ = (uint8_t)sizeof (uintptr_t);
+    lastptr = (uintptr_t)0;
+    p = trace_put_ptr(p, &lastptr, chThdGetSelfX());
+    syncn = (size_t)(p - sync);
+    sync[1] = (uint8_t)(syncn - 2U);
+    laststamp = now;
+  }
+
+  /* Lost records notification.*/
+  if (tbp->lost > 0U) {
+    lost[0] = (uint8_t)CH_TRACE_TYPE_LOST;
+    p = trace_put_u32(&lost[2], tbp->lost);
+    lostn = (size_t)(p - lost);
+    lost[1] = (uint8_t)(lostn - 2U);
+  }
+
+  /* The record itself.*/
+  rec[0] = (uint8_t)type;
+  p = trace_put_u32(&rec[2], now - laststamp);
+  switch (type) {
+  case CH_TRACE_TYPE_READY:
+    *p++ = (uint8_t)tep->state;
+    p = trace_put_ptr(p, &lastptr, tep->u.rdy.tp);
+    p = trace_put_s32(p, (int32_t)tep->u.rdy.msg);
+    break;
+  case CH_TRACE_TYPE_SWITCH:
+    *p++ = (uint8_t)tep->state;
+    p = trace_put_ptr(p, &lastptr, tep->u.sw.ntp);
+    p = trace_put_ptr(p, &lastptr, tep->u.sw.wtobjp);
+    break;
+  case CH_TRACE_TYPE_ISR_ENTER:
+  case CH_TRACE_TYPE_ISR_LEAVE:
+    p = trace_put_ptr(p, &lastptr, tep->u.isr.name);
+    break;
+  case CH_TRACE_TYPE_HALT:
+    p = trace_put_str(p, end, tep->u.halt.reason);
+    break;
+  case CH_TRACE_TYPE_USER:
+    p = trace_put_ptr(p, &lastptr, tep->u.user.up1);
+    p = trace_put_ptr(p, &lastptr, tep->u.user.up2);
+    break;
+  case CH_TRACE_TYPE_OBJECT:
+    *p++ = (uint8_t)tep->state;
+    p = trace_put_ptr(p, &lastptr, tep->u.obj.objp);
+    p = trace_put_s32(p, (int32_t)tep->u.obj.arg);
+    break;
+  case CH_TRACE_TYPE_NAME:
+    /* The named pointer is in the second user parameter, the string in
+       the first.*/
+    p = trace_put_ptr(p, &lastptr, tep->u.user.up2);
+    p = trace_put_str(p, end, (const char *)tep->u.user.up1);
+    break;
+  default:
+    break;
+  }
+  recn = (size_t)(p - rec);
+  rec[1] = (uint8_t)(recn - 2U);
+
+  space = (size_t)CH_DBG_TRACE_BINARY_SIZE - (tbp->wridx - tbp->rdidx);
+  if (syncn + lostn + recn > space) {
+    tbp->lost++;
+    return;
+  }
+
+  trace_commit(tbp, sync, syncn);
+  trace_commit(tbp, lost, lostn);
+  trace_commit(tbp, rec, recn);
+  tbp->sync      = false;
+  tbp->lost      = 0U;
+  tbp->laststamp = now;
+  tbp->lastptr   = lastptr;
+}
+#endif
+
 #if (CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED) || defined(__DOXYGEN__)
 /**
  * @brief   Writes a time stamp and increases the trace buffer pointer.
+ * @note    In binary mode the record is encoded into the bytes buffer
+ *          instead.
  *
  * @notapi
  */
@@ -66,9 +262,13 @@ NOINLINE static void trace_next(os_instance_t *oip) {
   /* Trace hook, useful in order to interface debug tools.*/
   CH_CFG_TRACE_HOOK(oip->trace_buffer.ptr);
 
+#if CH_DBG_TRACE_BINARY == TRUE
+  trace_encode(&oip->trace_buffer, oip->trace_buffer.ptr->type, trace_stamp());
+#else
   if (++oip->trace_buffer.ptr >= &oip->trace_buffer.buffer[CH_DBG_TRACE_BUFFER_SIZE]) {
     oip->trace_buffer.ptr = &oip->trace_buffer.buffer[0];
   }
+#endif
 }
 #endif
 
@@ -86,6 +286,7 @@ NOINLINE static void trace_next(os_instance_t *oip) {
  * @notapi
  */
 void __trace_object_init(trace_buffer_t *tbp) {
+#if CH_DBG_TRACE_BINARY == FALSE
   unsigned i;
 
   tbp->suspended = (uint16_t)~CH_DBG_TRACE_MASK;
@@ -94,6 +295,19 @@ void __trace_object_init(trace_buffer_t *tbp) {
   for (i = 0U; i < (unsigned)CH_DBG_TRACE_BUFFER_SIZE; i++) {
     tbp->buffer[i].type = CH_TRACE_TYPE_UNUSED;
   }
+#else
+  /* There is no records buffer in binary mode, the size is zero.*/
+  tbp->suspended   = (uint16_t)~CH_DBG_TRACE_MASK;
+  tbp->size        = 0U;
+  tbp->ptr         = &tbp->record;
+  tbp->record.type = CH_TRACE_TYPE_UNUSED;
+  tbp->wridx       = (size_t)0;
+  tbp->rdidx       = (size_t)0;
+  tbp->laststamp   = 0U;
+  tbp->lastptr     = (uintptr_t)0;
+  tbp->lost        = 0U;
+  tbp->sync        = true;
+#endif
 }
 
 /**
@@ -194,6 +408,36 @@ void __trace_halt(const char *reason) {
   }
 }
 
+#if ((CH_DBG_TRACE_MASK & CH_DBG_TRACE_MASK_OBJECTS) != 0U) ||              \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Inserts in the circular debug trace buffer an object record.
+ *
+ * @param[in] op        the object operation
+ * @param[in] objp      pointer to the object
+ * @param[in] arg       operation-dependent argument
+ *
+ * @notapi
+ */
+void __trace_object(unsigned op, void *objp, msg_t arg) {
+  static const uint16_t masks[] = {
+    CH_DBG_TRACE_MASK_SEM, CH_DBG_TRACE_MASK_SEM,
+    CH_DBG_TRACE_MASK_MTX, CH_DBG_TRACE_MASK_MTX,
+    CH_DBG_TRACE_MASK_MB,  CH_DBG_TRACE_MASK_MB,
+    CH_DBG_TRACE_MASK_VT,  CH_DBG_TRACE_MASK_VT,  CH_DBG_TRACE_MASK_VT
+  };
+  os_instance_t *oip = currcore;
+
+  if ((oip->trace_buffer.suspended & masks[op]) == 0U) {
+    oip->trace_buffer.ptr->type       = CH_TRACE_TYPE_OBJECT;
+    oip->trace_buffer.ptr->state      = (uint8_t)op;
+    oip->trace_buffer.ptr->u.obj.objp = objp;
+    oip->trace_buffer.ptr->u.obj.arg  = arg;
+    trace_next(oip);
+  }
+}
+#endif
+
 /**
  * @brief   Adds an user trace record to the trace buffer.
  *
@@ -286,6 +530,105 @@ void chTraceResume(uint16_t mask) {
   chTraceResumeI(mask);
   chSysUnlock();
 }
+
+#if (CH_DBG_TRACE_BINARY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Adds a name record to the binary trace buffer.
+ * @details Name records associate a name to a thread or object pointer,
+ *          they are used by host tools in order to label the trace.
+ * @note    The name is truncated if too long.
+ *
+ * @param[in] objp      pointer to the named thread or object
+ * @param[in] name      the name
+ *
+ * @iclass
+ */
+void chTraceWriteNameI(const void *objp, const char *name) {
+  os_instance_t *oip = currcore;
+
+  chDbgCheckClassI();
+
+  /* Name records only exist in binary form, the trace hook is not
+     invoked.*/
+  if ((oip->trace_buffer.suspended & CH_DBG_TRACE_MASK_USER) == 0U) {
+    oip->trace_buffer.ptr->time       = chVTGetSystemTimeX();
+    oip->trace_buffer.ptr->u.user.up1 = (void *)name;
+    oip->trace_buffer.ptr->u.user.up2 = (void *)objp;
+    trace_encode(&oip->trace_buffer, CH_TRACE_TYPE_NAME, trace_stamp());
+  }
+}
+
+/**
+ * @brief   Requires a synchronization record before the next record.
+ * @details The synchronization record contains absolute values, a reader
+ *          starting from it is able to decode all the following records.
+ *          It should be invoked when a new reader attaches to the trace.
+ *
+ * @iclass
+ */
+void chTraceSyncI(void) {
+
+  chDbgCheckClassI();
+
+  currcore->trace_buffer.sync = true;
+}
+
+/**
+ * @brief   Reads encoded records from the binary trace buffer.
+ * @details Only whole records are returned, the space is freed for new
+ *          records.
+ *
+ * @param[out] bp       pointer to the destination buffer
+ * @param[in] n         size of the destination buffer
+ * @return              The number of bytes read.
+ *
+ * @iclass
+ */
+size_t chTraceReadI(uint8_t *bp, size_t n) {
+  trace_buffer_t *tbp = &currcore->trace_buffer;
+  size_t cnt = (size_t)0;
+
+  chDbgCheckClassI();
+  chDbgCheck(bp != NULL);
+
+  while (tbp->rdidx != tbp->wridx) {
+    size_t recn = (size_t)tbp->bytes[(tbp->rdidx + 1U) & TRACE_MASK] + 2U;
+
+    if (recn > n - cnt) {
+      break;
+    }
+    while (recn > 0U) {
+      bp[cnt++] = tbp->bytes[tbp->rdidx & TRACE_MASK];
+      tbp->rdidx++;
+      recn--;
+    }
+  }
+
+  return cnt;
+}
+
+/**
+ * @brief   Reads encoded records from the binary trace buffer.
+ * @details Only whole records are returned, the space is freed for new
+ *          records.
+ *
+ * @param[out] bp       pointer to the destination buffer
+ * @param[in] n         size of the destination buffer, it should be at
+ *                      least 48 bytes in order to always fit a record
+ * @return              The number of bytes read.
+ *
+ * @api
+ */
+size_t chTraceRead(uint8_t *bp, size_t n) {
+  size_t cnt;
+
+  chSysLock();
+  cnt = chTraceReadI(bp, n);
+  chSysUnlock();
+
+  return cnt;
+}
+#endif /* CH_DBG_TRACE_BINARY == TRUE */
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 
 /** @} */
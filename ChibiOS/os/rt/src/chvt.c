@@ -32,6 +32,35 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_TIMERS_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Mask of a slot index within a wheel level.
+ */
+#define VT_WHEEL_MASK           (CH_VT_WHEEL_SLOTS - 1U)
+
+/**
+ * @brief   Position of the system time bits indexing the last wheel level.
+ */
+#define VT_WHEEL_TOP_SHIFT      ((CH_VT_WHEEL_LEVELS - 1U) * CH_VT_WHEEL_BITS)
+
+/**
+ * @brief   Number of slots actually used in the last wheel level.
+ */
+#define VT_WHEEL_TOP_SLOTS      (1U << (CH_CFG_ST_RESOLUTION -              \
+                                        VT_WHEEL_TOP_SHIFT))
+
+/**
+ * @brief   Current wheel time.
+ * @details All the timers in the wheel have their deadline after this
+ *          time, it is the system time of the last processed wheel event.
+ */
+#if (CH_CFG_ST_TIMEDELTA == 0) || defined(__DOXYGEN__)
+#define vt_wheel_time(vtlp)     ((vtlp)->systime)
+#else
+#define vt_wheel_time(vtlp)     ((vtlp)->lasttime)
+#endif
+#endif /* CH_CFG_USE_TIMERS_WHEEL == TRUE */
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -48,6 +77,280 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_TIMERS_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Index of the least significant bit set in a non-zero word.
+ *
+ * @param[in] x         the word to be scanned, must not be zero
+ * @return              The bit index.
+ */
+static inline unsigned vt_ctz(uint32_t x) {
+#if defined(__GNUC__)
+  return (unsigned)__builtin_ctz(x);
+#else
+  unsigned n = 0U;
+
+  while ((x & 1U) == 0U) {
+    x >>= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
+/**
+ * @brief   Links a timer in the wheel.
+ * @details The timer is placed in the level of the most significant group
+ *          of bits differing between its deadline and the current wheel
+ *          time, the slot is selected by the deadline bits in that group.
+ *          The timer is moved to a lower level when the wheel time reaches
+ *          the beginning of its slot.
+ * @note    The timer deadline must be already stored in the @p delta field
+ *          and must not be before the current wheel time.
+ *
+ * @param[in] vtlp      pointer to the virtual timers list
+ * @param[in] vtp       the timer to be linked
+ */
+static void vt_wheel_link(virtual_timers_list_t *vtlp, virtual_timer_t *vtp) {
+  systime_t now = vt_wheel_time(vtlp);
+  systime_t deadline = (systime_t)vtp->dlist.delta;
+  systime_t x = deadline ^ now;
+  unsigned level = 0U, slot;
+
+  if ((deadline < now) && ((x >> VT_WHEEL_TOP_SHIFT) == (systime_t)0)) {
+    /* The deadline is so far that the system time wraps around and
+       reaches again the current slot of the last level, the timer is
+       parked in the slot preceding it and is linked again when the
+       wheel time reaches that slot.*/
+    level = CH_VT_WHEEL_LEVELS - 1U;
+    slot  = ((unsigned)(now >> VT_WHEEL_TOP_SHIFT) + VT_WHEEL_TOP_SLOTS -
+             1U) & (VT_WHEEL_TOP_SLOTS - 1U);
+  }
+  else {
+    while (x >= (systime_t)CH_VT_WHEEL_SLOTS) {
+      x >>= CH_VT_WHEEL_BITS;
+      level++;
+    }
+    slot = (unsigned)(deadline >> (level * CH_VT_WHEEL_BITS)) &
+           VT_WHEEL_MASK;
+  }
+
+  ch_dlist_insert_after(&vtlp->slots[level][slot], &vtp->dlist,
+                        vtp->dlist.delta);
+  vtlp->used[level] |= (uint32_t)1U << slot;
+}
+
+/**
+ * @brief   Checks if the wheel is empty.
+ *
+ * @param[in] vtlp      pointer to the virtual timers list
+ * @return              The wheel state.
+ * @retval false        if there is at least one timer in the wheel.
+ * @retval true         if the wheel is empty.
+ */
+static bool vt_wheel_isempty(virtual_timers_list_t *vtlp) {
+  unsigned level;
+
+  for (level = 0U; level < CH_VT_WHEEL_LEVELS; level++) {
+    if (vtlp->used[level] != 0U) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief   Unlinks a timer from the wheel, marking it as not armed.
+ *
+ * @param[in] vtlp      pointer to the virtual timers list
+ * @param[in] vtp       the timer to be unlinked
+ * @return              The wheel state after removal.
+ * @retval false        if there are other timers in the wheel.
+ * @retval true         if the wheel became empty.
+ */
+static bool vt_wheel_unlink(virtual_timers_list_t *vtlp,
+                            virtual_timer_t *vtp) {
+  ch_delta_list_t *dlp = vtp->dlist.prev;
+  unsigned n;
+
+  (void) ch_dlist_dequeue(&vtp->dlist);
+  vtp->dlist.next = NULL;
+
+  /* The slot is still in use if the previous element is a timer or a
+     slot header not pointing to itself.*/
+  if (dlp->next != dlp) {
+    return false;
+  }
+
+  /* Slot became empty, the previous element is its header.*/
+  n = (unsigned)(dlp - &vtlp->slots[0][0]);
+  vtlp->used[n / CH_VT_WHEEL_SLOTS] &= ~((uint32_t)1U <<
+                                         (n % CH_VT_WHEEL_SLOTS));
+
+  return vt_wheel_isempty(vtlp);
+}
+
+/**
+ * @brief   Interval between the current wheel time and the next event.
+ * @details The next event is the deadline of the earliest timer in the
+ *          lowest level or the beginning of the earliest non-empty slot in
+ *          the upper levels, whichever comes first.
+ *
+ * @param[in] vtlp      pointer to the virtual timers list
+ * @param[out] deltap   pointer to the interval to the next event
+ * @return              The wheel state.
+ * @retval false        if the wheel is empty.
+ * @retval true         if there is at least one timer in the wheel.
+ */
+static bool vt_wheel_next(virtual_timers_list_t *vtlp, sysinterval_t *deltap) {
+  systime_t now = vt_wheel_time(vtlp);
+  sysinterval_t delta = (sysinterval_t)0;
+  bool found = false;
+  unsigned level;
+
+  for (level = 0U; level < CH_VT_WHEEL_LEVELS; level++) {
+    unsigned shift = level * CH_VT_WHEEL_BITS;
+    unsigned curr = (unsigned)(now >> shift) & VT_WHEEL_MASK;
+    uint32_t used = vtlp->used[level];
+    uint32_t m;
+    unsigned dist;
+    sysinterval_t d;
+
+    if (used == 0U) {
+      continue;
+    }
+
+    /* Slots after the current one, timers in the last level can also be
+       in slots before it after the wheel time wraps around.*/
+    m = used & ~(((uint32_t)2U << curr) - 1U);
+    if (m != 0U) {
+      dist = vt_ctz(m) - curr;
+    }
+    else if (level == (CH_VT_WHEEL_LEVELS - 1U)) {
+      dist = (vt_ctz(used) + VT_WHEEL_TOP_SLOTS) - curr;
+    }
+    else {
+      chDbgAssert(false, "slot in the past");
+      continue;
+    }
+
+    /* Time from now to the beginning of the found slot.*/
+    d = ((sysinterval_t)dist << shift) -
+        (sysinterval_t)(now & (((systime_t)1 << shift) - (systime_t)1));
+    if (!found || (d < delta)) {
+      delta = d;
+      found = true;
+    }
+  }
+
+  *deltap = delta;
+
+  return found;
+}
+
+/**
+ * @brief   Moves timers from the upper levels to the lower ones.
+ * @details The timers in the slots beginning at the current wheel time are
+ *          linked again in the wheel, ending in lower levels. Levels are
+ *          processed from the highest because timers can fall from a level
+ *          to a slot of the level below that needs processing too.
+ *
+ * @param[in] vtlp      pointer to the virtual timers list
+ */
+static void vt_wheel_cascade(virtual_timers_list_t *vtlp) {
+  systime_t now = vt_wheel_time(vtlp);
+  unsigned level = 1U;
+
+  /* Finding the highest level whose current slot begins now.*/
+  while ((level < CH_VT_WHEEL_LEVELS) &&
+         ((now & (((systime_t)1 << (level * CH_VT_WHEEL_BITS)) -
+                  (systime_t)1)) == (systime_t)0)) {
+    level++;
+  }
+
+  while (--level > 0U) {
+    unsigned slot = (unsigned)(now >> (level * CH_VT_WHEEL_BITS)) &
+                    VT_WHEEL_MASK;
+    ch_delta_list_t *dlhp = &vtlp->slots[level][slot];
+
+    /* Timers are taken from the tail and linked at the head of their new
+       slot, this preserves their relative order.*/
+    while (dlhp->prev != dlhp) {
+      virtual_timer_t *vtp = (virtual_timer_t *)dlhp->prev;
+
+      (void) ch_dlist_dequeue(&vtp->dlist);
+      vt_wheel_link(vtlp, vtp);
+    }
+    vtlp->used[level] &= ~((uint32_t)1U << slot);
+  }
+}
+
+/**
+ * @brief   Moves a deadline forward within its slack window.
+ * @details The deadline is moved on the most aligned system time within
+ *          the window, timers having overlapping windows tend to be moved
+ *          on the same time and are triggered by the same alarm.
+ *
+ * @param[in] deadline  the timer deadline
+ * @param[in] slack     the allowed delay after the deadline
+ * @return              The new deadline.
+ */
+static systime_t vt_wheel_coalesce(systime_t deadline, sysinterval_t slack) {
+  systime_t last = chTimeAddX(deadline, slack);
+  systime_t mask;
+  unsigned i;
+
+  /* The window contains the wrap-around point, it is the most aligned
+     time of all.*/
+  if ((deadline == (systime_t)0) || (last < deadline)) {
+    return (systime_t)0;
+  }
+
+  /* Bits below the most significant bit differing between the last time
+     before the window and the end of the window.*/
+  mask = (systime_t)(deadline - (systime_t)1) ^ last;
+  for (i = 1U; i < CH_CFG_ST_RESOLUTION; i <<= 1) {
+    mask |= mask >> i;
+  }
+
+  return last & ~(mask >> 1);
+}
+#endif /* CH_CFG_USE_TIMERS_WHEEL == TRUE */
+
+#if (CH_CFG_USE_TIMERS_WHEEL == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Moves a delta forward within its slack window.
+ * @details The first armed timer expiring at or after the specified delta
+ *          is searched, if it expires within the slack window then its delta
+ *          is returned and the two timers are triggered together.
+ *
+ * @param[in] vtlp      pointer to the virtual timers list
+ * @param[in] delta     the timer delta from the list base time
+ * @param[in] slack     the allowed delay after the deadline
+ * @return              The new delta.
+ */
+static sysinterval_t vt_coalesce(virtual_timers_list_t *vtlp,
+                                 sysinterval_t delta,
+                                 sysinterval_t slack) {
+  ch_delta_list_t *dlp = vtlp->dlist.next;
+  sysinterval_t d = (sysinterval_t)0;
+
+  while (dlp != &vtlp->dlist) {
+    d += dlp->delta;
+    if (d >= delta) {
+      if ((d - delta) <= slack) {
+        return d;
+      }
+      break;
+    }
+    dlp = dlp->next;
+  }
+
+  return delta;
+}
+#endif /* CH_CFG_USE_TIMERS_WHEEL == FALSE */
+
 #if (CH_CFG_ST_TIMEDELTA > 0) || defined(__DOXYGEN__)
 /**
  * @brief   Alarm time setup.
@@ -84,6 +387,7 @@ static void vt_set_alarm(systime_t now, sysinterval_t delay) {
 
     /* Setting up the alarm on the next deadline.*/
     port_timer_set_alarm(chTimeAddX(now, delay));
+    __stats_vt_alarm();
 
     /* Check on current time, we need to detect the error condition where
        current time skipped past the calculated deadline.
@@ -129,7 +433,13 @@ static void vt_insert_first(virtual_timers_list_t *vtlp,
   /* The delta list is empty, the current time becomes the new
      delta list base time, the timer is inserted.*/
   vtlp->lasttime = now;
+#if CH_CFG_USE_TIMERS_WHEEL == FALSE
   ch_dlist_insert_after(&vtlp->dlist, &vtp->dlist, delay);
+#else
+  vtp->dlist.delta = (sysinterval_t)chTimeAddX(now, delay > (sysinterval_t)0 ?
+                                                    delay : (sysinterval_t)1);
+  vt_wheel_link(vtlp, vtp);
+#endif
 
   /* Initial delta is what is configured statically.*/
   currdelta = (sysinterval_t)CH_CFG_ST_TIMEDELTA;
@@ -152,6 +462,7 @@ static void vt_insert_first(virtual_timers_list_t *vtlp,
   /* Being the first element inserted in the list the alarm timer
      is started.*/
   port_timer_start_alarm(chTimeAddX(vtlp->lasttime, delay));
+  __stats_vt_alarm();
 
   /* Deadline skip detection and correction loop.*/
   while (true) {
@@ -171,8 +482,13 @@ static void vt_insert_first(virtual_timers_list_t *vtlp,
     /* Trying again with a more relaxed minimum delta.*/
     currdelta += (sysinterval_t)1;
 
+    /* Current time becomes the new "base" time.*/
+    now = newnow;
+    delay = currdelta;
+
     /* Setting up the alarm on the next deadline.*/
-    port_timer_set_alarm(chTimeAddX(now, currdelta));
+    port_timer_set_alarm(chTimeAddX(now, delay));
+    __stats_vt_alarm();
   }
 
 #if !defined(CH_VT_RFCU_DISABLED)
@@ -187,12 +503,178 @@ static void vt_insert_first(virtual_timers_list_t *vtlp,
 }
 #endif /* CH_CFG_ST_TIMEDELTA > 0 */
 
+#if (CH_CFG_USE_TIMERS_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Enqueues a virtual timer in the timers wheel.
+ */
+static void vt_enqueue(virtual_timers_list_t *vtlp,
+                       virtual_timer_t *vtp,
+                       sysinterval_t delay,
+                       sysinterval_t slack) {
+
+#if CH_CFG_ST_TIMEDELTA > 0
+  {
+    sysinterval_t nowdelta, delta, next;
+    systime_t now = chVTGetSystemTimeX();
+
+    /* Special case where the timers wheel is empty.*/
+    if (!vt_wheel_next(vtlp, &next)) {
+
+      if (slack > (sysinterval_t)0) {
+        delay = chTimeDiffX(now, vt_wheel_coalesce(chTimeAddX(now, delay),
+                                                   slack));
+      }
+
+      vt_insert_first(vtlp, vtp, now, delay);
+
+      return;
+    }
+
+    /* Delay as delta from 'lasttime'. Note, it can overflow and the value
+       becomes lower than 'deltanow'.*/
+    nowdelta = chTimeDiffX(vtlp->lasttime, now);
+    delta    = nowdelta + delay;
+
+    /* Scenario where a very large delay exceeded the numeric range, the
+       delta is shortened to make it fit the numeric range, the timer
+       will be triggered "deltanow" cycles earlier.*/
+    if (delta < nowdelta) {
+      delta = delay;
+    }
+
+    /* The deadline is moved within the slack window in order to share
+       the alarm with other timers.*/
+    if (slack > (sysinterval_t)0) {
+      sysinterval_t d;
+
+      d = chTimeDiffX(vtlp->lasttime,
+                      vt_wheel_coalesce(chTimeAddX(vtlp->lasttime, delta),
+                                        slack));
+      delay += d - delta;
+      delta  = d;
+    }
+
+    /* Checking if this timer would come before the next wheel event, this
+       requires changing the current alarm setting.*/
+    if (delta < next) {
+
+      vt_set_alarm(now, delay);
+    }
+
+    vtp->dlist.delta = (sysinterval_t)chTimeAddX(vtlp->lasttime, delta);
+  }
+#else /* CH_CFG_ST_TIMEDELTA == 0 */
+
+  /* Deadline is the specified delay after the current time.*/
+  vtp->dlist.delta = (sysinterval_t)chTimeAddX(vtlp->systime, delay);
+  if (slack > (sysinterval_t)0) {
+    vtp->dlist.delta = (sysinterval_t)vt_wheel_coalesce(
+                           (systime_t)vtp->dlist.delta, slack);
+  }
+#endif /* CH_CFG_ST_TIMEDELTA == 0 */
+
+  vt_wheel_link(vtlp, vtp);
+}
+
+/**
+ * @brief   Triggers the timers having the current wheel time as deadline.
+ * @note    The processing stops if a callback changes the wheel time, this
+ *          happens when a timer is armed while the wheel is empty.
+ */
+static void vt_wheel_fire(virtual_timers_list_t *vtlp) {
+  systime_t now = vt_wheel_time(vtlp);
+  ch_delta_list_t *dlhp = &vtlp->slots[0][(unsigned)now & VT_WHEEL_MASK];
+
+  while ((dlhp->next != dlhp) && (vt_wheel_time(vtlp) == now)) {
+    virtual_timer_t *vtp = (virtual_timer_t *)dlhp->next;
+
+    /* Removing the timer from the wheel, if the wheel becomes empty then
+       the alarm is disabled.*/
+    if (vt_wheel_unlink(vtlp, vtp)) {
+#if CH_CFG_ST_TIMEDELTA > 0
+      port_timer_stop_alarm();
+#endif
+    }
+
+    /* The callback is invoked outside the kernel critical section, it
+       is re-entered on the callback return.*/
+    __stats_vt_fire();
+    __trace_object(CH_TRACE_OBJ_VT_FIRE, vtp, (msg_t)0);
+    chSysUnlockFromISR();
+
+    vtp->func(vtp, vtp->par);
+
+    chSysLockFromISR();
+
+    /* If a reload is defined the timer needs to be restarted.*/
+    if (unlikely(vtp->reload > (sysinterval_t)0)) {
+#if CH_CFG_ST_TIMEDELTA == 0
+      vtp->dlist.delta = (sysinterval_t)chTimeAddX(now, vtp->reload);
+#else /* CH_CFG_ST_TIMEDELTA > 0 */
+      sysinterval_t delta, delay, nowdelta;
+      systime_t newnow;
+
+      /* Refreshing the now delta after spending time in the callback for
+         a more accurate detection of too fast reloads.*/
+      newnow = chVTGetSystemTimeX();
+      nowdelta = chTimeDiffX(now, newnow);
+
+#if !defined(CH_VT_RFCU_DISABLED)
+      /* Checking if the required reload is feasible.*/
+      if (nowdelta > vtp->reload) {
+        /* System time is already past the deadline, logging the fault and
+           proceeding with a minimum delay.*/
+
+        chDbgAssert(false, "skipped deadline");
+        chRFCUCollectFaultsI(CH_RFCU_VT_SKIPPED_DEADLINE);
+
+        delay = (sysinterval_t)0;
+      }
+      else {
+        /* Enqueuing the timer again using the calculated delta.*/
+        delay = vtp->reload - nowdelta;
+      }
+#else
+      /* Assertions as fallback.*/
+      chDbgAssert(nowdelta <= vtp->reload, "skipped deadline");
+
+      /* Enqueuing the timer again using the calculated delta.*/
+      delay = vtp->reload - nowdelta;
+#endif
+
+      /* Special case where the timers wheel is empty.*/
+      if (vt_wheel_isempty(vtlp)) {
+
+        vt_insert_first(vtlp, vtp, newnow, delay);
+
+        continue;
+      }
+
+      /* Deadline as delta from the current wheel time, it must be after
+         the wheel time or the timer would wait for a whole wheel turn.*/
+      delta = nowdelta + delay;
+      if (delta < nowdelta) {
+        delta = delay;
+      }
+      if (delta == (sysinterval_t)0) {
+        delta = (sysinterval_t)1;
+      }
+      vtp->dlist.delta = (sysinterval_t)chTimeAddX(now, delta);
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+
+      vt_wheel_link(vtlp, vtp);
+    }
+  }
+}
+
+#else /* CH_CFG_USE_TIMERS_WHEEL == FALSE */
 /**
  * @brief   Enqueues a virtual timer in a virtual timers list.
  */
 static void vt_enqueue(virtual_timers_list_t *vtlp,
                        virtual_timer_t *vtp,
-                       sysinterval_t delay) {
+                       sysinterval_t delay,
+                       sysinterval_t slack) {
   sysinterval_t delta;
 
 #if CH_CFG_ST_TIMEDELTA > 0
@@ -220,6 +702,15 @@ static void vt_enqueue(virtual_timers_list_t *vtlp,
       delta = delay;
     }
 
+    /* The deadline is moved on the deadline of another timer if it falls
+       within the slack window, the two timers share the alarm.*/
+    if (slack > (sysinterval_t)0) {
+      sysinterval_t d = vt_coalesce(vtlp, delta, slack);
+
+      delay += d - delta;
+      delta  = d;
+    }
+
     /* Checking if this timer would become the first in the delta list, this
        requires changing the current alarm setting.*/
     if (delta < vtlp->dlist.next->delta) {
@@ -231,10 +722,14 @@ static void vt_enqueue(virtual_timers_list_t *vtlp,
 
   /* Delta is initially equal to the specified delay.*/
   delta = delay;
+  if (slack > (sysinterval_t)0) {
+    delta = vt_coalesce(vtlp, delta, slack);
+  }
 #endif /* CH_CFG_ST_TIMEDELTA == 0 */
 
   ch_dlist_insert(&vtlp->dlist, &vtp->dlist, delta);
 }
+#endif /* CH_CFG_USE_TIMERS_WHEEL == FALSE */
 
 /*===========================================================================*/
 /* Module exported functions.                                                */
@@ -269,13 +764,63 @@ void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
   chDbgCheckClassI();
   chDbgCheck((vtp != NULL) && (vtfunc != NULL) && (delay != TIME_IMMEDIATE));
 
+  __trace_object(CH_TRACE_OBJ_VT_SET, vtp, (msg_t)delay);
+
   /* Timer initialization.*/
   vtp->par     = par;
   vtp->func    = vtfunc;
   vtp->reload  = (sysinterval_t)0;
 
   /* Inserting the timer in the delta list.*/
-  vt_enqueue(vtlp, vtp, delay);
+  vt_enqueue(vtlp, vtp, delay, (sysinterval_t)0);
+}
+
+/**
+ * @brief   Enables a one-shot virtual timer with a tolerance.
+ * @details The timer is enabled and programmed to trigger after the delay
+ *          specified as parameter, the trigger can be postponed by up to
+ *          @p slack ticks in order to share the alarm with other timers.
+ * @pre     The timer must not be already armed before calling this function.
+ * @note    The callback function is invoked from interrupt context.
+ * @note    When the timers list is used the deadline is moved on the
+ *          deadline of the first timer already armed within the slack
+ *          window, if any. When the timers wheel is used the deadline is
+ *          moved on the most aligned system time within the slack window.
+ *
+ * @param[out] vtp      the @p virtual_timer_t structure pointer
+ * @param[in] delay     the number of ticks before the operation timeouts, the
+ *                      special values are handled as follow:
+ *                      - @a TIME_INFINITE is allowed but interpreted as a
+ *                        normal time specification.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ *                      .
+ * @param[in] slack     the maximum number of ticks the trigger can be
+ *                      postponed, the sum of @p delay and @p slack must not
+ *                      exceed the system time range
+ * @param[in] vtfunc    the timer callback function. After invoking the
+ *                      callback the timer is disabled and the structure can
+ *                      be disposed or reused.
+ * @param[in] par       a parameter that will be passed to the callback
+ *                      function
+ *
+ * @iclass
+ */
+void chVTDoSetWithSlackI(virtual_timer_t *vtp, sysinterval_t delay,
+                         sysinterval_t slack, vtfunc_t vtfunc, void *par) {
+  virtual_timers_list_t *vtlp = &currcore->vtlist;
+
+  chDbgCheckClassI();
+  chDbgCheck((vtp != NULL) && (vtfunc != NULL) && (delay != TIME_IMMEDIATE));
+
+  __trace_object(CH_TRACE_OBJ_VT_SET, vtp, (msg_t)delay);
+
+  /* Timer initialization.*/
+  vtp->par     = par;
+  vtp->func    = vtfunc;
+  vtp->reload  = (sysinterval_t)0;
+
+  /* Inserting the timer in the delta list.*/
+  vt_enqueue(vtlp, vtp, delay, slack);
 }
 
 /**
@@ -307,13 +852,15 @@ void chVTDoSetContinuousI(virtual_timer_t *vtp, sysinterval_t delay,
   chDbgCheckClassI();
   chDbgCheck((vtp != NULL) && (vtfunc != NULL) && (delay != TIME_IMMEDIATE));
 
+  __trace_object(CH_TRACE_OBJ_VT_SET, vtp, (msg_t)delay);
+
   /* Timer initialization.*/
   vtp->par     = par;
   vtp->func    = vtfunc;
   vtp->reload  = delay;
 
   /* Inserting the timer in the delta list.*/
-  vt_enqueue(vtlp, vtp, delay);
+  vt_enqueue(vtlp, vtp, delay, (sysinterval_t)0);
 }
 
 /**
@@ -329,9 +876,21 @@ void chVTDoResetI(virtual_timer_t *vtp) {
 
   chDbgCheckClassI();
   chDbgCheck(vtp != NULL);
+
+  __trace_object(CH_TRACE_OBJ_VT_RESET, vtp, (msg_t)0);
   chDbgAssert(chVTIsArmedI(vtp), "timer not armed");
 
-#if CH_CFG_ST_TIMEDELTA == 0
+#if CH_CFG_USE_TIMERS_WHEEL == TRUE
+
+  /* Removing the timer from the wheel, if the wheel becomes empty then
+     the alarm is stopped. Note that the alarm is not moved if the timer
+     was the next to expire, a spurious alarm will just reprogram it.*/
+  if (vt_wheel_unlink(vtlp, vtp)) {
+#if CH_CFG_ST_TIMEDELTA > 0
+    port_timer_stop_alarm();
+#endif
+  }
+#elif CH_CFG_ST_TIMEDELTA == 0
 
   /* The delta of the timer is added to the next timer.*/
   vtp->dlist.next->delta += vtp->dlist.delta;
@@ -412,6 +971,27 @@ void chVTDoResetI(virtual_timer_t *vtp) {
  */
 sysinterval_t chVTGetRemainingIntervalI(virtual_timer_t *vtp) {
   virtual_timers_list_t *vtlp = &currcore->vtlist;
+#if CH_CFG_USE_TIMERS_WHEEL == TRUE
+  sysinterval_t delta;
+
+  chDbgCheckClassI();
+  chDbgAssert(chVTIsArmedI(vtp), "timer not armed");
+
+  /* Distance of the deadline from the current wheel time.*/
+  delta = chTimeDiffX(vt_wheel_time(vtlp), (systime_t)vtp->dlist.delta);
+#if CH_CFG_ST_TIMEDELTA > 0
+  {
+    systime_t now = chVTGetSystemTimeX();
+    sysinterval_t nowdelta = chTimeDiffX(vtlp->lasttime, now);
+    if (nowdelta > delta) {
+      return (sysinterval_t)0;
+    }
+    return delta - nowdelta;
+  }
+#else
+  return delta;
+#endif
+#else /* CH_CFG_USE_TIMERS_WHEEL == FALSE */
   sysinterval_t delta;
   ch_delta_list_t *dlp;
 
@@ -439,7 +1019,49 @@ sysinterval_t chVTGetRemainingIntervalI(virtual_timer_t *vtp) {
   chDbgAssert(false, "timer not in list");
 
   return (sysinterval_t)-1;
+#endif /* CH_CFG_USE_TIMERS_WHEEL == FALSE */
+}
+
+#if (CH_CFG_USE_TIMERS_WHEEL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the time interval until the next timer event.
+ * @note    The return value is not perfectly accurate and can report values
+ *          in excess of @p CH_CFG_ST_TIMEDELTA ticks.
+ * @note    The next event can be the transfer of timers between wheel
+ *          levels rather than a timer deadline, the returned interval is
+ *          never longer than the time to the next deadline.
+ *
+ * @param[out] timep    pointer to a variable that will contain the time
+ *                      interval until the next timer elapses. This pointer
+ *                      can be @p NULL if the information is not required.
+ * @return              The time, in ticks, until next time event.
+ * @retval false        if the timers list is empty.
+ * @retval true         if the timers list contains at least one timer.
+ *
+ * @iclass
+ */
+bool chVTGetTimersStateI(sysinterval_t *timep) {
+  virtual_timers_list_t *vtlp = &currcore->vtlist;
+  sysinterval_t delta;
+
+  chDbgCheckClassI();
+
+  if (!vt_wheel_next(vtlp, &delta)) {
+    return false;
+  }
+
+  if (timep != NULL) {
+#if CH_CFG_ST_TIMEDELTA == 0
+    *timep = delta;
+#else
+    *timep = (delta + (sysinterval_t)CH_CFG_ST_TIMEDELTA) -
+             chTimeDiffX(vtlp->lasttime, chVTGetSystemTimeX());
+#endif
+  }
+
+  return true;
 }
+#endif /* CH_CFG_USE_TIMERS_WHEEL == TRUE */
 
 /**
  * @brief   Virtual timers ticker.
@@ -455,8 +1077,51 @@ void chVTDoTickI(void) {
 
   chDbgCheckClassI();
 
+  __stats_vt_tick();
+
+#if CH_CFG_USE_TIMERS_WHEEL == TRUE
 #if CH_CFG_ST_TIMEDELTA == 0
   vtlp->systime++;
+
+  /* Timers falling in the current slot are moved down then triggered.*/
+  vt_wheel_cascade(vtlp);
+  vt_wheel_fire(vtlp);
+#else /* CH_CFG_ST_TIMEDELTA > 0 */
+  sysinterval_t delta, nowdelta;
+  systime_t now;
+
+  /* Moving the wheel time from event to event until current time is
+     reached, each event cascades the upper levels and triggers the timers
+     in the current slot of the lowest level.*/
+  while (true) {
+
+    /* If the wheel is empty, nothing else to do, the alarm has been
+       already stopped.*/
+    if (!vt_wheel_next(vtlp, &delta)) {
+      return;
+    }
+
+    /* Delta between current time and last event time.*/
+    now = chVTGetSystemTimeX();
+    nowdelta = chTimeDiffX(vtlp->lasttime, now);
+
+    /* Loop break condition.*/
+    if (nowdelta < delta) {
+      break;
+    }
+
+    /* Wheel time is moved to the next event.*/
+    vtlp->lasttime = chTimeAddX(vtlp->lasttime, delta);
+
+    vt_wheel_cascade(vtlp);
+    vt_wheel_fire(vtlp);
+  }
+
+  /* Update alarm time to next event.*/
+  vt_set_alarm(now, delta - nowdelta);
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+#elif CH_CFG_ST_TIMEDELTA == 0
+  vtlp->systime++;
   if (ch_dlist_notempty(&vtlp->dlist)) {
     /* The list is not empty, processing elements on top.*/
     --vtlp->dlist.next->delta;
@@ -470,6 +1135,8 @@ void chVTDoTickI(void) {
       (void) ch_dlist_dequeue(&vtp->dlist);
       vtp->dlist.next = NULL;
 
+      __stats_vt_fire();
+      __trace_object(CH_TRACE_OBJ_VT_FIRE, vtp, (msg_t)0);
       chSysUnlockFromISR();
       vtp->func(vtp, vtp->par);
       chSysLockFromISR();
@@ -521,6 +1188,8 @@ void chVTDoTickI(void) {
     /* The callback is invoked outside the kernel critical section, it
        is re-entered on the callback return. Note that "lasttime" can be
        modified within the callback if some timer function is called.*/
+    __stats_vt_fire();
+    __trace_object(CH_TRACE_OBJ_VT_FIRE, vtp, (msg_t)0);
     chSysUnlockFromISR();
 
     vtp->func(vtp, vtp->par);
@@ -160,6 +160,35 @@
 #define CH_CFG_OPTIMIZE_SPEED               TRUE
 #endif
 
+/**
+ * @brief   Bitmap-indexed ready list.
+ * @details If enabled then the ready list keeps an index of the priority
+ *          levels in use, threads are inserted in the ready list in constant
+ *          time regardless of the number of ready threads.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires about 1kB of RAM on 32 bits architectures.
+ */
+#if !defined(CH_CFG_USE_READY_BITMAP)
+#define CH_CFG_USE_READY_BITMAP             FALSE
+#endif
+
+/**
+ * @brief   Virtual timers wheel.
+ * @details If enabled then the armed virtual timers are kept in a
+ *          hierarchical timer wheel instead of a delta list, arming and
+ *          resetting a timer takes constant time regardless of the number
+ *          of armed timers.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_INTERVALS_SIZE equal to
+ *          @p CH_CFG_ST_RESOLUTION.
+ * @note    Requires about 2.7kB of RAM with a 32 bits system time.
+ */
+#if !defined(CH_CFG_USE_TIMERS_WHEEL)
+#define CH_CFG_USE_TIMERS_WHEEL             FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -256,6 +285,19 @@
 #define CH_CFG_USE_MUTEXES_RECURSIVE        FALSE
 #endif
 
+/**
+ * @brief   Mutexes adaptive spin time.
+ * @details In SMP mode a thread locking a mutex owned by a thread running
+ *          on another OS instance spins for up to this number of realtime
+ *          counter cycles before blocking.
+ *
+ * @note    The default is @p 0, spinning disabled.
+ * @note    Requires @p CH_CFG_USE_MUTEXES and @p CH_CFG_SMP_MODE.
+ */
+#if !defined(CH_CFG_MUTEXES_SPIN_TIME)
+#define CH_CFG_MUTEXES_SPIN_TIME            0
+#endif
+
 /**
  * @brief   Conditional Variables APIs.
  * @details If enabled then the conditional variables APIs are included
@@ -302,6 +344,29 @@
 #define CH_CFG_USE_EVENTS_TIMEOUT           TRUE
 #endif
 
+/**
+ * @brief   Indexed Events Sources APIs.
+ * @details If enabled then the indexed event sources APIs are included in
+ *          the kernel, listeners are grouped by flags filter so broadcasts
+ *          only visit the interested ones.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_EVENTS.
+ */
+#if !defined(CH_CFG_USE_EVENTS_INDEXED)
+#define CH_CFG_USE_EVENTS_INDEXED           FALSE
+#endif
+
+/**
+ * @brief   Number of flags groups in indexed event sources.
+ *
+ * @note    The default is @p 8.
+ * @note    Requires @p CH_CFG_USE_EVENTS_INDEXED.
+ */
+#if !defined(CH_CFG_EVENTS_INDEX_SIZE)
+#define CH_CFG_EVENTS_INDEX_SIZE            8
+#endif
+
 /**
  * @brief   Synchronous Messages APIs.
  * @details If enabled then the synchronous messages APIs are included
@@ -400,6 +465,21 @@
 #define CH_CFG_USE_HEAP                     TRUE
 #endif
 
+/**
+ * @brief   Segregated fits heap allocator.
+ * @details If enabled then the memory heap allocator uses segregated free
+ *          lists indexed by size class, allocation and release take a
+ *          bounded time regardless of the heap fragmentation. If disabled
+ *          then a first-fit allocator with a single free list is used.
+ *
+ * @note    The default is @p FALSE.
+ * @note    The segregated fits allocator requires a larger heap descriptor
+ *          and one extra header for each memory region.
+ */
+#if !defined(CH_CFG_HEAP_TLSF)
+#define CH_CFG_HEAP_TLSF                    FALSE
+#endif
+
 /**
  * @brief   Memory Pools Allocator APIs.
  * @details If enabled then the memory pools allocator APIs are included
@@ -411,6 +491,20 @@
 #define CH_CFG_USE_MEMPOOLS                 TRUE
 #endif
 
+/**
+ * @brief   Memory Pools magazines APIs.
+ * @details If enabled then the per-thread memory pool magazines are
+ *          included in the kernel. A magazine keeps a small stack of
+ *          objects privately owned by a thread and accesses the underlying
+ *          pool in batches.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MEMPOOLS.
+ */
+#if !defined(CH_CFG_USE_POOL_MAGAZINES)
+#define CH_CFG_USE_POOL_MAGAZINES           FALSE
+#endif
+
 /**
  * @brief   Objects FIFOs APIs.
  * @details If enabled then the objects FIFOs APIs are included
@@ -433,6 +527,17 @@
 #define CH_CFG_USE_PIPES                    TRUE
 #endif
 
+/**
+ * @brief   Rings APIs.
+ * @details If enabled then the single and multiple producers rings APIs
+ *          are included in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_RINGS)
+#define CH_CFG_USE_RINGS                    FALSE
+#endif
+
 /**
  * @brief   Objects Caches APIs.
  * @details If enabled then the objects caches APIs are included
@@ -444,6 +549,18 @@
 #define CH_CFG_USE_OBJ_CACHES               TRUE
 #endif
 
+/**
+ * @brief   Objects Caches segments.
+ * @details Number of segments the hash table and the LRU list of an
+ *          objects cache are split into, each segment has its own LRU
+ *          list. It must be a power of two.
+ *
+ * @note    The default is @p 1.
+ */
+#if !defined(CH_CFG_OBJ_CACHES_SEGMENTS)
+#define CH_CFG_OBJ_CACHES_SEGMENTS          1
+#endif
+
 /**
  * @brief   Delegate threads APIs.
  * @details If enabled then the delegate threads APIs are included
@@ -608,6 +725,27 @@
 #define CH_DBG_TRACE_BUFFER_SIZE            128
 #endif
 
+/**
+ * @brief   Binary trace buffer.
+ * @details If enabled then the trace records are encoded in a compact
+ *          binary format with realtime counter delta time stamps, the
+ *          buffer can be drained while the system is running using
+ *          @p chTraceRead().
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_DBG_TRACE_BINARY)
+#define CH_DBG_TRACE_BINARY                 FALSE
+#endif
+
+/**
+ * @brief   Binary trace buffer size in bytes.
+ * @note    Must be a power of two.
+ */
+#if !defined(CH_DBG_TRACE_BINARY_SIZE)
+#define CH_DBG_TRACE_BINARY_SIZE            1024
+#endif
+
 /**
  * @brief   Debug option, stack checks.
  * @details If enabled then a runtime stack check is performed.
@@ -647,6 +785,19 @@
 #define CH_DBG_THREADS_PROFILING            FALSE
 #endif
 
+/**
+ * @brief   Debug option, stack high-water-mark tracking.
+ * @details If enabled then the stack pointer of the thread being switched
+ *          out is sampled on each context switch and the lowest value is
+ *          kept in the @p thread_t structure, see
+ *          @p chRegGetThreadStackUnusedX().
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_DBG_STACK_WATERMARK)
+#define CH_DBG_STACK_WATERMARK              FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
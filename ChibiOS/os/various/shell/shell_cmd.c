@@ -164,7 +164,8 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
 #else
     core_id = 0U;
 #endif
-#if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE)
+#if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE) ||  \
+    (CH_DBG_STACK_WATERMARK == TRUE)
     uint32_t stklimit = (uint32_t)tp->wabase;
 #else
     uint32_t stklimit = 0U;
@@ -0,0 +1,104 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    tracestream.c
+ * @brief   Binary trace streaming code.
+ *
+ * @addtogroup trace_stream
+ * @{
+ */
+
+#include "hal.h"
+#include "tracestream.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Starts a trace streaming session.
+ * @details A synchronization record is requested and, if the registry is
+ *          enabled, the names of the existing threads are recorded. The
+ *          records already in the buffer can not be decoded and are
+ *          skipped by the host decoder.
+ */
+void trsStart(void) {
+#if CH_CFG_USE_REGISTRY == TRUE
+  thread_t *tp;
+#endif
+
+  chSysLock();
+  chTraceSyncI();
+  chSysUnlock();
+
+#if CH_CFG_USE_REGISTRY == TRUE
+  tp = chRegFirstThread();
+  while (tp != NULL) {
+    chSysLock();
+    chTraceWriteNameI(tp, chRegGetThreadNameX(tp));
+    chSysUnlock();
+    tp = chRegNextThread(tp);
+  }
+#endif
+}
+
+/**
+ * @brief   Drains the trace buffer on a stream.
+ * @details The records in the buffer are written on the stream, the
+ *          function is meant to be called periodically from a low priority
+ *          thread.
+ * @note    At most one buffer worth of data is written by each call, the
+ *          stream itself could generate new records while writing.
+ *
+ * @param[in] chp       pointer to a @p BaseSequentialStream implementation
+ * @return              The number of bytes written.
+ */
+size_t trsDrain(BaseSequentialStream *chp) {
+  uint8_t buf[TRACE_STREAM_CHUNK_SIZE];
+  size_t n, total = (size_t)0;
+
+  do {
+    n = chTraceRead(buf, sizeof (buf));
+    if (n > (size_t)0) {
+      total += streamWrite(chp, buf, n);
+    }
+  } while ((n > (size_t)0) && (total < (size_t)CH_DBG_TRACE_BINARY_SIZE));
+
+  return total;
+}
+
+/** @} */
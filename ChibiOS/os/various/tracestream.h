@@ -0,0 +1,87 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    tracestream.h
+ * @brief   Binary trace streaming macros and structures.
+ *
+ * @addtogroup trace_stream
+ * @{
+ */
+
+#ifndef TRACESTREAM_H
+#define TRACESTREAM_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the intermediate buffer used while draining.
+ * @note    Must be at least 48 bytes in order to fit any record.
+ */
+#if !defined(TRACE_STREAM_CHUNK_SIZE) || defined(__DOXYGEN__)
+#define TRACE_STREAM_CHUNK_SIZE             64
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*
+ * Module dependencies check.
+ */
+#if (CH_DBG_TRACE_MASK == CH_DBG_TRACE_MASK_DISABLED) ||                    \
+    (CH_DBG_TRACE_BINARY == FALSE)
+#error "Trace streaming requires CH_DBG_TRACE_MASK and CH_DBG_TRACE_BINARY"
+#endif
+
+#if TRACE_STREAM_CHUNK_SIZE < 48
+#error "TRACE_STREAM_CHUNK_SIZE too small"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void trsStart(void);
+  size_t trsDrain(BaseSequentialStream *chp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* TRACESTREAM_H */
+
+/** @} */
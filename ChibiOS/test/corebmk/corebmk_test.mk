@@ -1,7 +1,15 @@
 # List of all the core benchmarks test files.
 TESTSRC += ${CHIBIOS}/test/corebmk/source/test/ffbench_mod.c \
+           ${CHIBIOS}/test/corebmk/source/test/histogram_mod.c \
            ${CHIBIOS}/test/corebmk/source/test/corebmk_test_root.c \
-           ${CHIBIOS}/test/corebmk/source/test/corebmk_test_sequence_001.c
+           ${CHIBIOS}/test/corebmk/source/test/corebmk_test_sequence_001.c \
+           ${CHIBIOS}/test/corebmk/source/test/corebmk_test_sequence_002.c \
+           ${CHIBIOS}/test/corebmk/source/test/corebmk_test_sequence_003.c \
+           ${CHIBIOS}/test/corebmk/source/test/corebmk_test_sequence_004.c \
+           ${CHIBIOS}/test/corebmk/source/test/corebmk_test_sequence_005.c \
+           ${CHIBIOS}/test/corebmk/source/test/corebmk_test_sequence_006.c \
+           ${CHIBIOS}/test/corebmk/source/test/corebmk_test_sequence_007.c \
+           ${CHIBIOS}/test/corebmk/source/test/corebmk_test_sequence_008.c
 
 # Required include directories
 TESTINC += ${CHIBIOS}/test/corebmk/source/test
@@ -29,6 +29,13 @@
  *
  * <h2>Test Sequences</h2>
  * - @subpage corebmk_test_sequence_001
+ * - @subpage corebmk_test_sequence_002
+ * - @subpage corebmk_test_sequence_003
+ * - @subpage corebmk_test_sequence_004
+ * - @subpage corebmk_test_sequence_005
+ * - @subpage corebmk_test_sequence_006
+ * - @subpage corebmk_test_sequence_007
+ * - @subpage corebmk_test_sequence_008
  * .
  */
 
@@ -53,6 +60,24 @@ const testsequence_t * const corebmk_test_suite_array[] = {
 #if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
   &corebmk_test_sequence_001,
 #endif
+#if ((PORT_SUPPORTS_RT == TRUE) && (CH_CFG_USE_WAITEXIT == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)) || defined(__DOXYGEN__)
+  &corebmk_test_sequence_002,
+#endif
+#if (CH_CFG_USE_PIPES == TRUE) || defined(__DOXYGEN__)
+  &corebmk_test_sequence_003,
+#endif
+#if (CH_CFG_USE_OBJ_CACHES == TRUE) || defined(__DOXYGEN__)
+  &corebmk_test_sequence_004,
+#endif
+#if (CH_CFG_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+  &corebmk_test_sequence_005,
+#endif
+#if ((CH_CFG_USE_DYNAMIC == TRUE) && (CH_CFG_USE_HEAP == TRUE)) ||          \
+    defined(__DOXYGEN__)
+  &corebmk_test_sequence_006,
+#endif
+  &corebmk_test_sequence_007,
+  &corebmk_test_sequence_008,
   NULL
 };
 
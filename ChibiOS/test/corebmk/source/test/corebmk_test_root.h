@@ -32,6 +32,13 @@
 #include "ch_test.h"
 
 #include "corebmk_test_sequence_001.h"
+#include "corebmk_test_sequence_002.h"
+#include "corebmk_test_sequence_003.h"
+#include "corebmk_test_sequence_004.h"
+#include "corebmk_test_sequence_005.h"
+#include "corebmk_test_sequence_006.h"
+#include "corebmk_test_sequence_007.h"
+#include "corebmk_test_sequence_008.h"
 
 #if !defined(__DOXYGEN__)
 
@@ -0,0 +1,974 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+/*
+    This module is based on the work of John Walker (April of 1989) and
+    merely adapted to work in ChibiOS. The author has not specified
+    additional license terms so this is released using the most permissive
+    license used in ChibiOS. The license covers the changes only, not the
+    original work.
+ */
+
+#include "hal.h"
+#include "corebmk_test_root.h"
+
+/**
+ * @file    corebmk_test_sequence_002.c
+ * @brief   Test Sequence 002 code.
+ *
+ * @page corebmk_test_sequence_002 [2] Kernel latency
+ *
+ * File: @ref corebmk_test_sequence_002.c
+ *
+ * <h2>Description</h2>
+ * This sequence measures the distribution of the most common kernel
+ * latencies, each benchmark prints a log2 histogram of the samples with
+ * percentiles as a JSON object on a single line. Samples are realtime
+ * counter cycles.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (PORT_SUPPORTS_RT == TRUE) && (CH_CFG_USE_WAITEXIT == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage corebmk_test_002_001
+ * - @subpage corebmk_test_002_002
+ * - @subpage corebmk_test_002_003
+ * - @subpage corebmk_test_002_004
+ * - @subpage corebmk_test_002_005
+ * - @subpage corebmk_test_002_006
+ * - @subpage corebmk_test_002_007
+ * - @subpage corebmk_test_002_008
+ * - @subpage corebmk_test_002_009
+ * .
+ */
+
+#if ((PORT_SUPPORTS_RT == TRUE) && (CH_CFG_USE_WAITEXIT == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include "ch.h"
+
+#include "histogram_mod.h"
+
+#define LAT_SAMPLES         1000    /* Samples of threads benchmarks.       */
+#define LAT_TIMER_SAMPLES   200     /* Samples of timers benchmarks.        */
+#define LAT_STACK_SIZE      256     /* Helper thread stack size.            */
+#define LAT_BARRIER_THREADS 64      /* Threads released by a broadcast.     */
+#define LAT_MB_DEPTH        16      /* Bulk mailbox depth.                  */
+#define LAT_MSG_STOP        ((msg_t)LAT_MB_DEPTH)
+#define LAT_MSG_URGENT(i)   ((msg_t)-1 - (msg_t)(i))
+#define LAT_URGENT_FIFO     0U
+#define LAT_URGENT_AHEAD    1U
+#define LAT_URGENT_PRIO     2U
+
+static THD_WORKING_AREA(wa_lat, LAT_STACK_SIZE);
+static THD_WORKING_AREA(wa_bar[LAT_BARRIER_THREADS], LAT_STACK_SIZE);
+static thread_t *lat_bar_tps[LAT_BARRIER_THREADS];
+static threads_queue_t lat_tq;
+static thread_t *lat_tp;
+static histogram_t lat_hist;
+static volatile rtcnt_t lat_t0;
+static thread_reference_t lat_tr;
+static semaphore_t lat_sem;
+static virtual_timer_t lat_vt;
+static volatile unsigned lat_cnt;
+static rtcnt_t lat_stamps[LAT_TIMER_SAMPLES + 1];
+#if CH_CFG_USE_MUTEXES == TRUE
+static mutex_t lat_mtx;
+#endif
+#if CH_CFG_USE_MAILBOXES == TRUE
+static mailbox_t lat_mb1, lat_mb2;
+static msg_t lat_mb1_buf[1], lat_mb2_buf[1];
+static mailbox_t lat_mbb;
+static msg_t lat_mbb_buf[LAT_MB_DEPTH];
+static prio_mailbox_t lat_pmb;
+static pmb_entry_t lat_pmb_buf[LAT_MB_DEPTH];
+#endif
+
+static uint32_t lat_elapsed(void) {
+
+  return (uint32_t)(chSysGetRealtimeCounterX() - lat_t0);
+}
+
+static void lat_start(tfunc_t pf) {
+
+  lat_tp = chThdCreateStatic(wa_lat, sizeof (wa_lat),
+                             chThdGetPriorityX() + 1, pf, NULL);
+}
+
+static THD_FUNCTION(lat_wakeup_thread, arg) {
+  unsigned i;
+
+  (void)arg;
+
+  for (i = 0; i < LAT_SAMPLES; i++) {
+    chSysLock();
+    (void) chThdSuspendS(&lat_tr);
+    chSysUnlock();
+    hist_add(&lat_hist, lat_elapsed());
+  }
+}
+
+static THD_FUNCTION(lat_sem_thread, arg) {
+  unsigned i;
+
+  (void)arg;
+
+  for (i = 0; i < LAT_SAMPLES; i++) {
+    chSemWait(&lat_sem);
+    hist_add(&lat_hist, lat_elapsed());
+  }
+}
+
+#if CH_CFG_USE_MUTEXES == TRUE
+static THD_FUNCTION(lat_mtx_thread, arg) {
+  unsigned i;
+
+  (void)arg;
+
+  for (i = 0; i < LAT_SAMPLES; i++) {
+    chSemWait(&lat_sem);
+    chMtxLock(&lat_mtx);
+    hist_add(&lat_hist, lat_elapsed());
+    chMtxUnlock(&lat_mtx);
+  }
+}
+#endif
+
+#if CH_CFG_USE_MAILBOXES == TRUE
+static THD_FUNCTION(lat_mb_thread, arg) {
+  unsigned i;
+  msg_t msg;
+
+  (void)arg;
+
+  for (i = 0; i < LAT_SAMPLES; i++) {
+    (void) chMBFetchTimeout(&lat_mb1, &msg, TIME_INFINITE);
+    (void) chMBPostTimeout(&lat_mb2, msg, TIME_INFINITE);
+  }
+}
+#endif
+
+#if CH_CFG_USE_MAILBOXES == TRUE
+static void lat_mb_post(unsigned mode, msg_t msg, bool urgent) {
+
+  if (mode == LAT_URGENT_PRIO) {
+    (void) chPMBPostTimeout(&lat_pmb, msg, urgent ? 1U : 0U, TIME_INFINITE);
+  }
+  else if ((mode == LAT_URGENT_AHEAD) && urgent) {
+    (void) chMBPostAheadTimeout(&lat_mbb, msg, TIME_INFINITE);
+  }
+  else {
+    (void) chMBPostTimeout(&lat_mbb, msg, TIME_INFINITE);
+  }
+}
+
+static THD_FUNCTION(lat_mb_consumer_thread, arg) {
+  volatile unsigned work;
+  msg_t msg;
+
+  do {
+    if (arg != NULL) {
+      (void) chPMBFetchTimeout(&lat_pmb, &msg, TIME_INFINITE);
+    }
+    else {
+      (void) chMBFetchTimeout(&lat_mbb, &msg, TIME_INFINITE);
+    }
+    if (msg < (msg_t)0) {
+      /* Urgent messages carry the index of their posting time stamp.*/
+      hist_add(&lat_hist, (uint32_t)(chSysGetRealtimeCounterX() -
+                                     lat_stamps[(msg_t)-1 - msg]));
+    }
+    else {
+      /* Simulated processing of bulk messages.*/
+      for (work = 0U; work < 64U; work++) {
+      }
+    }
+  } while (msg != LAT_MSG_STOP);
+}
+
+static void lat_urgent_run(unsigned mode) {
+  unsigned i, j;
+
+  chMBObjectInit(&lat_mbb, lat_mbb_buf, LAT_MB_DEPTH);
+  chPMBObjectInit(&lat_pmb, lat_pmb_buf, LAT_MB_DEPTH, PMB_ORDER_PRIORITY);
+  lat_tp = chThdCreateStatic(wa_lat, sizeof (wa_lat),
+                             chThdGetPriorityX() - 1,
+                             lat_mb_consumer_thread,
+                             mode == LAT_URGENT_PRIO ? (void *)&lat_pmb : NULL);
+
+  /* Each burst fills the mailbox then an urgent message is posted.*/
+  for (i = 0; i < LAT_TIMER_SAMPLES; i++) {
+    for (j = 0; j < LAT_MB_DEPTH; j++) {
+      lat_mb_post(mode, (msg_t)j, false);
+    }
+    lat_stamps[i] = chSysGetRealtimeCounterX();
+    lat_mb_post(mode, LAT_MSG_URGENT(i), true);
+  }
+  lat_mb_post(mode, LAT_MSG_STOP, false);
+  (void) chThdWait(lat_tp);
+}
+#endif
+
+static THD_FUNCTION(lat_barrier_thread, arg) {
+  msg_t msg;
+
+  (void)arg;
+
+  do {
+    chSysLock();
+    msg = chThdEnqueueTimeoutS(&lat_tq, TIME_INFINITE);
+    chSysUnlock();
+  } while (msg == MSG_OK);
+}
+
+static void lat_vt_jitter_cb(virtual_timer_t *vtp, void *p) {
+
+  (void)vtp;
+  (void)p;
+
+  if (lat_cnt <= LAT_TIMER_SAMPLES) {
+    lat_stamps[lat_cnt] = chSysGetRealtimeCounterX();
+    lat_cnt++;
+    if (lat_cnt > LAT_TIMER_SAMPLES) {
+      chSysLockFromISR();
+      chSemSignalI(&lat_sem);
+      chSysUnlockFromISR();
+    }
+  }
+}
+
+static void lat_isr_cb(virtual_timer_t *vtp, void *p) {
+
+  (void)vtp;
+  (void)p;
+
+  chSysLockFromISR();
+  lat_t0 = chSysGetRealtimeCounterX();
+  chSemSignalI(&lat_sem);
+  chSysUnlockFromISR();
+}
+
+#if (CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_SMP_MODE == TRUE)
+#define LAT_MTX_HOLD        200     /* Mutex hold time in counter cycles.   */
+
+static void lat_hold(void) {
+  rtcnt_t start = chSysGetRealtimeCounterX();
+
+  while (chSysIsCounterWithinX(chSysGetRealtimeCounterX(),
+                               start, start + (rtcnt_t)LAT_MTX_HOLD)) {
+  }
+}
+
+static os_instance_t *lat_remote_instance(void) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)PORT_CORES_NUMBER; i++) {
+    os_instance_t *oip = ch_system.instances[i];
+
+    if ((oip != NULL) && (oip != currcore)) {
+      return oip;
+    }
+  }
+
+  return NULL;
+}
+
+static THD_FUNCTION(lat_contention_thread, arg) {
+  unsigned i;
+
+  (void)arg;
+
+  for (i = 0; i < LAT_SAMPLES; i++) {
+    chMtxLock(&lat_mtx);
+    lat_hold();
+    chMtxUnlock(&lat_mtx);
+  }
+}
+#endif
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page corebmk_test_002_001 [2.1] Thread wakeup latency
+ *
+ * <h2>Description</h2>
+ * A higher priority thread is suspended on a thread reference and
+ * resumed by the test thread, the time from the resume to the execution
+ * of the woken thread is measured.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.1.1] Starting the helper thread, it suspends itself immediately.
+ * - [2.1.2] Resuming the helper thread repeatedly, the helper collects
+ *   the samples.
+ * - [2.1.3] Printing the histogram.
+ * .
+ */
+
+static void corebmk_test_002_001_setup(void) {
+  hist_init(&lat_hist, "wakeup");
+  lat_tr = NULL;
+}
+
+static void corebmk_test_002_001_execute(void) {
+  unsigned i;
+
+  /* [2.1.1] Starting the helper thread, it suspends itself
+     immediately.*/
+  test_set_step(1);
+  {
+    lat_start(lat_wakeup_thread);
+  }
+  test_end_step(1);
+
+  /* [2.1.2] Resuming the helper thread repeatedly, the helper collects
+     the samples.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < LAT_SAMPLES; i++) {
+      chSysLock();
+      lat_t0 = chSysGetRealtimeCounterX();
+      chThdResumeS(&lat_tr, MSG_OK);
+      chSysUnlock();
+    }
+    (void) chThdWait(lat_tp);
+  }
+  test_end_step(2);
+
+  /* [2.1.3] Printing the histogram.*/
+  test_set_step(3);
+  {
+    hist_print(&lat_hist);
+    test_assert(lat_hist.n > 0U, "no samples");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t corebmk_test_002_001 = {
+  "Thread wakeup latency",
+  corebmk_test_002_001_setup,
+  NULL,
+  corebmk_test_002_001_execute
+};
+
+/**
+ * @page corebmk_test_002_002 [2.2] Semaphore handoff latency
+ *
+ * <h2>Description</h2>
+ * A higher priority thread waits on a semaphore signaled by the test
+ * thread, the time from the signal to the execution of the waiting
+ * thread is measured.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.2.1] Starting the helper thread, it waits on the semaphore.
+ * - [2.2.2] Signaling the semaphore repeatedly, the helper collects the
+ *   samples.
+ * - [2.2.3] Printing the histogram.
+ * .
+ */
+
+static void corebmk_test_002_002_setup(void) {
+  hist_init(&lat_hist, "sem_handoff");
+  chSemObjectInit(&lat_sem, 0);
+}
+
+static void corebmk_test_002_002_execute(void) {
+  unsigned i;
+
+  /* [2.2.1] Starting the helper thread, it waits on the semaphore.*/
+  test_set_step(1);
+  {
+    lat_start(lat_sem_thread);
+  }
+  test_end_step(1);
+
+  /* [2.2.2] Signaling the semaphore repeatedly, the helper collects the
+     samples.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < LAT_SAMPLES; i++) {
+      lat_t0 = chSysGetRealtimeCounterX();
+      chSemSignal(&lat_sem);
+    }
+    (void) chThdWait(lat_tp);
+  }
+  test_end_step(2);
+
+  /* [2.2.3] Printing the histogram.*/
+  test_set_step(3);
+  {
+    hist_print(&lat_hist);
+    test_assert(lat_hist.n > 0U, "no samples");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t corebmk_test_002_002 = {
+  "Semaphore handoff latency",
+  corebmk_test_002_002_setup,
+  NULL,
+  corebmk_test_002_002_execute
+};
+
+#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page corebmk_test_002_003 [2.3] Mutex handoff latency
+ *
+ * <h2>Description</h2>
+ * A higher priority thread blocks on a mutex owned by the test thread,
+ * the time from the unlock to the execution of the new owner is
+ * measured.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MUTEXES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [2.3.1] Starting the helper thread, it waits on the semaphore.
+ * - [2.3.2] Locking the mutex and releasing the helper thread, the
+ *   helper blocks on the mutex, then the mutex is unlocked.
+ * - [2.3.3] Printing the histogram.
+ * .
+ */
+
+static void corebmk_test_002_003_setup(void) {
+  hist_init(&lat_hist, "mtx_handoff");
+  chSemObjectInit(&lat_sem, 0);
+  chMtxObjectInit(&lat_mtx);
+}
+
+static void corebmk_test_002_003_execute(void) {
+  unsigned i;
+
+  /* [2.3.1] Starting the helper thread, it waits on the semaphore.*/
+  test_set_step(1);
+  {
+    lat_start(lat_mtx_thread);
+  }
+  test_end_step(1);
+
+  /* [2.3.2] Locking the mutex and releasing the helper thread, the
+     helper blocks on the mutex, then the mutex is unlocked.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < LAT_SAMPLES; i++) {
+      chMtxLock(&lat_mtx);
+      chSemSignal(&lat_sem);
+      lat_t0 = chSysGetRealtimeCounterX();
+      chMtxUnlock(&lat_mtx);
+    }
+    (void) chThdWait(lat_tp);
+  }
+  test_end_step(2);
+
+  /* [2.3.3] Printing the histogram.*/
+  test_set_step(3);
+  {
+    hist_print(&lat_hist);
+    test_assert(lat_hist.n > 0U, "no samples");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t corebmk_test_002_003 = {
+  "Mutex handoff latency",
+  corebmk_test_002_003_setup,
+  NULL,
+  corebmk_test_002_003_execute
+};
+#endif /* CH_CFG_USE_MUTEXES == TRUE */
+
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page corebmk_test_002_004 [2.4] Mailbox round-trip latency
+ *
+ * <h2>Description</h2>
+ * A message is posted to a higher priority thread that sends it back on
+ * a second mailbox, the round-trip time is measured by the test thread.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MAILBOXES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [2.4.1] Starting the helper thread, it waits on the first mailbox.
+ * - [2.4.2] Exchanging messages with the helper thread.
+ * - [2.4.3] Printing the histogram.
+ * .
+ */
+
+static void corebmk_test_002_004_setup(void) {
+  hist_init(&lat_hist, "mb_roundtrip");
+  chMBObjectInit(&lat_mb1, lat_mb1_buf, 1);
+  chMBObjectInit(&lat_mb2, lat_mb2_buf, 1);
+}
+
+static void corebmk_test_002_004_execute(void) {
+  unsigned i;
+  msg_t msg;
+
+  /* [2.4.1] Starting the helper thread, it waits on the first
+     mailbox.*/
+  test_set_step(1);
+  {
+    lat_start(lat_mb_thread);
+  }
+  test_end_step(1);
+
+  /* [2.4.2] Exchanging messages with the helper thread.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < LAT_SAMPLES; i++) {
+      lat_t0 = chSysGetRealtimeCounterX();
+      (void) chMBPostTimeout(&lat_mb1, (msg_t)i, TIME_INFINITE);
+      (void) chMBFetchTimeout(&lat_mb2, &msg, TIME_INFINITE);
+      hist_add(&lat_hist, lat_elapsed());
+    }
+    (void) chThdWait(lat_tp);
+  }
+  test_end_step(2);
+
+  /* [2.4.3] Printing the histogram.*/
+  test_set_step(3);
+  {
+    hist_print(&lat_hist);
+    test_assert(lat_hist.n > 0U, "no samples");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t corebmk_test_002_004 = {
+  "Mailbox round-trip latency",
+  corebmk_test_002_004_setup,
+  NULL,
+  corebmk_test_002_004_execute
+};
+#endif /* CH_CFG_USE_MAILBOXES == TRUE */
+
+/**
+ * @page corebmk_test_002_005 [2.5] Virtual timer jitter
+ *
+ * <h2>Description</h2>
+ * A continuous virtual timer time-stamps its callbacks, the deviation
+ * of each period from the average period is measured.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.5.1] Starting a continuous virtual timer, the test thread waits
+ *   for all the samples to be collected.
+ * - [2.5.2] Computing the deviation of each period from the average
+ *   period.
+ * - [2.5.3] Printing the histogram.
+ * .
+ */
+
+static void corebmk_test_002_005_setup(void) {
+  hist_init(&lat_hist, "vt_jitter");
+  chSemObjectInit(&lat_sem, 0);
+  chVTObjectInit(&lat_vt);
+  lat_cnt = 0;
+}
+
+static void corebmk_test_002_005_execute(void) {
+  unsigned i;
+  uint32_t avg;
+
+  /* [2.5.1] Starting a continuous virtual timer, the test thread waits
+     for all the samples to be collected.*/
+  test_set_step(1);
+  {
+    chSysLock();
+    chVTSetContinuousI(&lat_vt, TIME_MS2I(2), lat_vt_jitter_cb, NULL);
+    (void) chSemWaitS(&lat_sem);
+    chVTResetI(&lat_vt);
+    chSysUnlock();
+  }
+  test_end_step(1);
+
+  /* [2.5.2] Computing the deviation of each period from the average
+     period.*/
+  test_set_step(2);
+  {
+    avg = (uint32_t)((lat_stamps[LAT_TIMER_SAMPLES] - lat_stamps[0]) /
+                     LAT_TIMER_SAMPLES);
+    for (i = 1; i <= LAT_TIMER_SAMPLES; i++) {
+      uint32_t period = (uint32_t)(lat_stamps[i] - lat_stamps[i - 1]);
+      hist_add(&lat_hist, period > avg ? period - avg : avg - period);
+    }
+  }
+  test_end_step(2);
+
+  /* [2.5.3] Printing the histogram.*/
+  test_set_step(3);
+  {
+    hist_print(&lat_hist);
+    test_assert(lat_hist.n > 0U, "no samples");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t corebmk_test_002_005 = {
+  "Virtual timer jitter",
+  corebmk_test_002_005_setup,
+  NULL,
+  corebmk_test_002_005_execute
+};
+
+/**
+ * @page corebmk_test_002_006 [2.6] ISR to thread latency
+ *
+ * <h2>Description</h2>
+ * A virtual timer callback, running in the timer interrupt context,
+ * signals a semaphore the test thread is waiting on, the time from the
+ * signal to the execution of the test thread is measured.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.6.1] Arming a one-shot virtual timer and waiting on the
+ *   semaphore, repeatedly.
+ * - [2.6.2] Printing the histogram.
+ * .
+ */
+
+static void corebmk_test_002_006_setup(void) {
+  hist_init(&lat_hist, "isr_to_thread");
+  chSemObjectInit(&lat_sem, 0);
+  chVTObjectInit(&lat_vt);
+}
+
+static void corebmk_test_002_006_execute(void) {
+  unsigned i;
+
+  /* [2.6.1] Arming a one-shot virtual timer and waiting on the
+     semaphore, repeatedly.*/
+  test_set_step(1);
+  {
+    for (i = 0; i < LAT_TIMER_SAMPLES; i++) {
+      chSysLock();
+      chVTSetI(&lat_vt, TIME_MS2I(1), lat_isr_cb, NULL);
+      (void) chSemWaitS(&lat_sem);
+      hist_add(&lat_hist, lat_elapsed());
+      chSysUnlock();
+    }
+  }
+  test_end_step(1);
+
+  /* [2.6.2] Printing the histogram.*/
+  test_set_step(2);
+  {
+    hist_print(&lat_hist);
+    test_assert(lat_hist.n > 0U, "no samples");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t corebmk_test_002_006 = {
+  "ISR to thread latency",
+  corebmk_test_002_006_setup,
+  NULL,
+  corebmk_test_002_006_execute
+};
+
+#if ((CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_SMP_MODE == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page corebmk_test_002_007 [2.7] Mutex contention across instances
+ *
+ * <h2>Description</h2>
+ * The test thread and a helper thread running on another OS instance
+ * repeatedly lock the same mutex and hold it for a short time, the time
+ * needed by the test thread in order to acquire the mutex is measured.
+ * Results depend on CH_CFG_MUTEXES_SPIN_TIME, builds with and without
+ * spinning should be compared.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_SMP_MODE == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [2.7.1] Finding another OS instance, the test is skipped if the
+ *   other instances are not running.
+ * - [2.7.2] Starting the helper thread on the other instance, then
+ *   locking the mutex concurrently with it and measuring the
+ *   acquisition time.
+ * - [2.7.3] Printing the histogram and the total time.
+ * .
+ */
+
+static void corebmk_test_002_007_setup(void) {
+  hist_init(&lat_hist, "mtx_contention");
+  chMtxObjectInit(&lat_mtx);
+}
+
+static void corebmk_test_002_007_execute(void) {
+  unsigned i;
+  os_instance_t *oip;
+  thread_descriptor_t td;
+  rtcnt_t start;
+
+  /* [2.7.1] Finding another OS instance, the test is skipped if the
+     other instances are not running.*/
+  test_set_step(1);
+  {
+    oip = lat_remote_instance();
+    if (oip == NULL) {
+      test_print("--- Skipped, no other instances");
+      test_println("");
+      return;
+    }
+  }
+  test_end_step(1);
+
+  /* [2.7.2] Starting the helper thread on the other instance, then
+     locking the mutex concurrently with it and measuring the
+     acquisition time.*/
+  test_set_step(2);
+  {
+    td.name     = "contender";
+    td.wbase    = THD_WORKING_AREA_BASE(wa_lat);
+    td.wend     = THD_WORKING_AREA_END(wa_lat);
+    td.prio     = chThdGetPriorityX();
+    td.funcp    = lat_contention_thread;
+    td.arg      = NULL;
+    td.instance = oip;
+    start = chSysGetRealtimeCounterX();
+    lat_tp = chThdCreate(&td);
+    for (i = 0; i < LAT_SAMPLES; i++) {
+      lat_t0 = chSysGetRealtimeCounterX();
+      chMtxLock(&lat_mtx);
+      hist_add(&lat_hist, lat_elapsed());
+      lat_hold();
+      chMtxUnlock(&lat_mtx);
+    }
+    (void) chThdWait(lat_tp);
+  }
+  test_end_step(2);
+
+  /* [2.7.3] Printing the histogram and the total time.*/
+  test_set_step(3);
+  {
+    hist_print(&lat_hist);
+    test_print("--- Total: ");
+    test_printn((uint32_t)(chSysGetRealtimeCounterX() - start));
+    test_println(" cycles");
+    test_assert(lat_hist.n > 0U, "no samples");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t corebmk_test_002_007 = {
+  "Mutex contention across instances",
+  corebmk_test_002_007_setup,
+  NULL,
+  corebmk_test_002_007_execute
+};
+#endif /* (CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_SMP_MODE == TRUE) */
+
+/**
+ * @page corebmk_test_002_008 [2.8] Broadcast release of 64 threads
+ *
+ * <h2>Description</h2>
+ * 64 higher priority threads, all at the same priority, wait on a
+ * threads queue and are released by a single broadcast, the time spent
+ * by the broadcast in making all the threads ready is measured.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.8.1] Starting the helper threads, they enqueue themselves
+ *   immediately.
+ * - [2.8.2] Releasing all the helper threads at once, repeatedly, the
+ *   helper threads enqueue again before the test thread is resumed.
+ * - [2.8.3] Terminating the helper threads.
+ * - [2.8.4] Printing the histogram.
+ * .
+ */
+
+static void corebmk_test_002_008_setup(void) {
+  hist_init(&lat_hist, "broadcast_64");
+  chThdQueueObjectInit(&lat_tq);
+}
+
+static void corebmk_test_002_008_execute(void) {
+  unsigned i;
+
+  /* [2.8.1] Starting the helper threads, they enqueue themselves
+     immediately.*/
+  test_set_step(1);
+  {
+    for (i = 0; i < LAT_BARRIER_THREADS; i++) {
+      lat_bar_tps[i] = chThdCreateStatic(wa_bar[i], sizeof (wa_bar[i]),
+                                         chThdGetPriorityX() + 1,
+                                         lat_barrier_thread, NULL);
+    }
+  }
+  test_end_step(1);
+
+  /* [2.8.2] Releasing all the helper threads at once, repeatedly, the
+     helper threads enqueue again before the test thread is resumed.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < LAT_TIMER_SAMPLES; i++) {
+      chSysLock();
+      lat_t0 = chSysGetRealtimeCounterX();
+      chThdDequeueAllI(&lat_tq, MSG_OK);
+      hist_add(&lat_hist, lat_elapsed());
+      chSchRescheduleS();
+      chSysUnlock();
+    }
+  }
+  test_end_step(2);
+
+  /* [2.8.3] Terminating the helper threads.*/
+  test_set_step(3);
+  {
+    chSysLock();
+    chThdDequeueAllI(&lat_tq, MSG_RESET);
+    chSchRescheduleS();
+    chSysUnlock();
+    for (i = 0; i < LAT_BARRIER_THREADS; i++) {
+      (void) chThdWait(lat_bar_tps[i]);
+    }
+  }
+  test_end_step(3);
+
+  /* [2.8.4] Printing the histogram.*/
+  test_set_step(4);
+  {
+    hist_print(&lat_hist);
+    test_assert(lat_hist.n > 0U, "no samples");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t corebmk_test_002_008 = {
+  "Broadcast release of 64 threads",
+  corebmk_test_002_008_setup,
+  NULL,
+  corebmk_test_002_008_execute
+};
+
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page corebmk_test_002_009 [2.9] Urgent message latency under bulk load
+ *
+ * <h2>Description</h2>
+ * A lower priority thread consumes messages doing some work for each
+ * one, the test thread keeps the mailbox full of bulk messages and
+ * posts an urgent message after each burst. The time from the urgent
+ * post to its fetch is measured using a FIFO mailbox, a mailbox with
+ * post ahead and a priority mailbox.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MAILBOXES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [2.9.1] Posting urgent messages in FIFO order.
+ * - [2.9.2] Posting urgent messages ahead of bulk messages.
+ * - [2.9.3] Posting urgent messages with higher priority on a priority
+ *   mailbox.
+ * .
+ */
+
+static void corebmk_test_002_009_execute(void) {
+
+  /* [2.9.1] Posting urgent messages in FIFO order.*/
+  test_set_step(1);
+  {
+    hist_init(&lat_hist, "mb_urgent_fifo");
+    lat_urgent_run(LAT_URGENT_FIFO);
+    hist_print(&lat_hist);
+    test_assert(lat_hist.n == LAT_TIMER_SAMPLES, "samples lost");
+  }
+  test_end_step(1);
+
+  /* [2.9.2] Posting urgent messages ahead of bulk messages.*/
+  test_set_step(2);
+  {
+    hist_init(&lat_hist, "mb_urgent_ahead");
+    lat_urgent_run(LAT_URGENT_AHEAD);
+    hist_print(&lat_hist);
+    test_assert(lat_hist.n == LAT_TIMER_SAMPLES, "samples lost");
+  }
+  test_end_step(2);
+
+  /* [2.9.3] Posting urgent messages with higher priority on a priority
+     mailbox.*/
+  test_set_step(3);
+  {
+    hist_init(&lat_hist, "pmb_urgent");
+    lat_urgent_run(LAT_URGENT_PRIO);
+    hist_print(&lat_hist);
+    test_assert(lat_hist.n == LAT_TIMER_SAMPLES, "samples lost");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t corebmk_test_002_009 = {
+  "Urgent message latency under bulk load",
+  NULL,
+  NULL,
+  corebmk_test_002_009_execute
+};
+#endif /* CH_CFG_USE_MAILBOXES == TRUE */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const corebmk_test_sequence_002_array[] = {
+  &corebmk_test_002_001,
+  &corebmk_test_002_002,
+#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+  &corebmk_test_002_003,
+#endif
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+  &corebmk_test_002_004,
+#endif
+  &corebmk_test_002_005,
+  &corebmk_test_002_006,
+#if ((CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_SMP_MODE == TRUE)) || defined(__DOXYGEN__)
+  &corebmk_test_002_007,
+#endif
+  &corebmk_test_002_008,
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+  &corebmk_test_002_009,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Kernel latency.
+ */
+const testsequence_t corebmk_test_sequence_002 = {
+  "Kernel latency",
+  corebmk_test_sequence_002_array
+};
+
+#endif /* (PORT_SUPPORTS_RT == TRUE) && (CH_CFG_USE_WAITEXIT == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE) */
@@ -0,0 +1,191 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+/*
+    This module is based on the work of John Walker (April of 1989) and
+    merely adapted to work in ChibiOS. The author has not specified
+    additional license terms so this is released using the most permissive
+    license used in ChibiOS. The license covers the changes only, not the
+    original work.
+ */
+
+#include "hal.h"
+#include "corebmk_test_root.h"
+
+/**
+ * @file    corebmk_test_sequence_003.c
+ * @brief   Test Sequence 003 code.
+ *
+ * @page corebmk_test_sequence_003 [3] Pipes throughput
+ *
+ * File: @ref corebmk_test_sequence_003.c
+ *
+ * <h2>Description</h2>
+ * This sequence compares the throughput of the pipes copy API with the
+ * zero-copy loan API, each transfer writes and then reads a payload.
+ * Results are realtime counter cycles per transfer.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_PIPES == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage corebmk_test_003_001
+ * .
+ */
+
+#if (CH_CFG_USE_PIPES == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#include "ch.h"
+
+#define BMK_PIPE_SIZE       4096    /* Pipe buffer and largest payload.     */
+#define BMK_PIPE_TRANSFERS  256     /* Transfers for each payload size.     */
+
+static uint8_t bmk_pipe_buf[BMK_PIPE_SIZE];
+static uint8_t bmk_payload[BMK_PIPE_SIZE];
+static pipe_t bmk_pipe;
+static bool bmk_pipe_ok;
+
+static void bmk_fill(uint8_t *p, size_t n, uint8_t pattern) {
+
+  memset((void *)p, (int)pattern, n);
+}
+
+static uint32_t bmk_pipe_copy(size_t n) {
+  rtcnt_t start;
+  unsigned i;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0; i < BMK_PIPE_TRANSFERS; i++) {
+    bmk_fill(bmk_payload, n, (uint8_t)i);
+    (void) chPipeWriteTimeout(&bmk_pipe, bmk_payload, n, TIME_INFINITE);
+    (void) chPipeReadTimeout(&bmk_pipe, bmk_payload, n, TIME_INFINITE);
+    if (bmk_payload[n - 1U] != (uint8_t)i) {
+      bmk_pipe_ok = false;
+    }
+  }
+
+  return (uint32_t)(chSysGetRealtimeCounterX() - start) / BMK_PIPE_TRANSFERS;
+}
+
+static uint32_t bmk_pipe_loan(size_t n) {
+  rtcnt_t start;
+  pipe_span_t span;
+  unsigned i;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0; i < BMK_PIPE_TRANSFERS; i++) {
+    (void) chPipeAcquireWriteSpan(&bmk_pipe, &span, n, TIME_INFINITE);
+    if (n <= span.n1) {
+      bmk_fill(span.ptr1, n, (uint8_t)i);
+    }
+    else {
+      bmk_fill(span.ptr1, span.n1, (uint8_t)i);
+      bmk_fill(span.ptr2, n - span.n1, (uint8_t)i);
+    }
+    chPipeCommitWrite(&bmk_pipe, n);
+    (void) chPipeAcquireReadSpan(&bmk_pipe, &span, n, TIME_INFINITE);
+    if (((n <= span.n1) ? span.ptr1[n - 1U]
+                        : span.ptr2[n - span.n1 - 1U]) != (uint8_t)i) {
+      bmk_pipe_ok = false;
+    }
+    chPipeReleaseRead(&bmk_pipe, n);
+  }
+
+  return (uint32_t)(chSysGetRealtimeCounterX() - start) / BMK_PIPE_TRANSFERS;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page corebmk_test_003_001 [3.1] Copy and loan APIs comparison
+ *
+ * <h2>Description</h2>
+ * Payloads from 16 to 4096 bytes are transferred through a pipe using
+ * both APIs, the payload is generated in place and checked after the
+ * transfer.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.1.1] Transferring payloads of increasing size, the pipe read and
+ *   write pointers are misaligned first so that spans also wrap.
+ * .
+ */
+
+static void corebmk_test_003_001_setup(void) {
+  chPipeObjectInit(&bmk_pipe, bmk_pipe_buf, BMK_PIPE_SIZE);
+  bmk_pipe_ok = true;
+}
+
+static void corebmk_test_003_001_execute(void) {
+  size_t n;
+
+  /* [3.1.1] Transferring payloads of increasing size, the pipe read and
+     write pointers are misaligned first so that spans also wrap.*/
+  test_set_step(1);
+  {
+    (void) chPipeWriteTimeout(&bmk_pipe, bmk_payload, 8, TIME_INFINITE);
+    (void) chPipeReadTimeout(&bmk_pipe, bmk_payload, 8, TIME_INFINITE);
+    for (n = 16; n <= BMK_PIPE_SIZE; n *= 4) {
+      test_print("--- Size ");
+      test_printn((uint32_t)n);
+      test_print(" B, copy: ");
+      test_printn(bmk_pipe_copy(n));
+      test_print(", loan: ");
+      test_printn(bmk_pipe_loan(n));
+      test_println(" cycles");
+    }
+    test_assert(bmk_pipe_ok, "content mismatch");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t corebmk_test_003_001 = {
+  "Copy and loan APIs comparison",
+  corebmk_test_003_001_setup,
+  NULL,
+  corebmk_test_003_001_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const corebmk_test_sequence_003_array[] = {
+  &corebmk_test_003_001,
+  NULL
+};
+
+/**
+ * @brief   Pipes throughput.
+ */
+const testsequence_t corebmk_test_sequence_003 = {
+  "Pipes throughput",
+  corebmk_test_sequence_003_array
+};
+
+#endif /* CH_CFG_USE_PIPES == TRUE */
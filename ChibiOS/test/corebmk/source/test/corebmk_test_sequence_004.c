@@ -0,0 +1,265 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+/*
+    This module is based on the work of John Walker (April of 1989) and
+    merely adapted to work in ChibiOS. The author has not specified
+    additional license terms so this is released using the most permissive
+    license used in ChibiOS. The license covers the changes only, not the
+    original work.
+ */
+
+#include "hal.h"
+#include "corebmk_test_root.h"
+
+/**
+ * @file    corebmk_test_sequence_004.c
+ * @brief   Test Sequence 004 code.
+ *
+ * @page corebmk_test_sequence_004 [4] Objects caches trace replay
+ *
+ * File: @ref corebmk_test_sequence_004.c
+ *
+ * <h2>Description</h2>
+ * This sequence replays a synthetic block access trace against an
+ * objects cache placed in front of a RAM-simulated media, the trace
+ * mixes a small working set with long sequential scans. Results are
+ * cache counters and realtime counter cycles per access.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_OBJ_CACHES == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage corebmk_test_004_001
+ * .
+ */
+
+#if (CH_CFG_USE_OBJ_CACHES == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#include "ch.h"
+
+#define BMK_OC_OBJECTS      32      /* Cached objects.                      */
+#define BMK_OC_BLOCKS       1024    /* Blocks on the simulated media.       */
+#define BMK_OC_BLOCK_SIZE   32      /* Size of blocks.                      */
+#define BMK_OC_HOT_BLOCKS   24      /* Size of the working set.             */
+#define BMK_OC_SCAN_LEN     128     /* Length of sequential scans.          */
+#define BMK_OC_TRACE_LEN    4096    /* Accesses in the trace.               */
+#define BMK_OC_WRITE        0x8000U /* Write access flag in the trace.      */
+
+typedef struct {
+  oc_object_t       header;
+  uint8_t           data[BMK_OC_BLOCK_SIZE];
+} bmk_object_t;
+
+static uint8_t bmk_media[BMK_OC_BLOCKS][BMK_OC_BLOCK_SIZE];
+static uint16_t bmk_trace[BMK_OC_TRACE_LEN];
+static oc_hash_header_t bmk_hash[BMK_OC_OBJECTS * 2];
+static bmk_object_t bmk_objects[BMK_OC_OBJECTS];
+static objects_cache_t bmk_cache;
+static uint32_t bmk_sync_reads;
+static bool bmk_oc_ok;
+
+static bool bmk_read(objects_cache_t *ocp,
+                     oc_object_t *objp,
+                     bool async) {
+
+  memcpy(((bmk_object_t *)objp)->data, bmk_media[objp->obj_key],
+         BMK_OC_BLOCK_SIZE);
+  objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+
+  if (async) {
+    chCacheReleaseObject(ocp, objp);
+  }
+  else {
+    bmk_sync_reads++;
+  }
+
+  return false;
+}
+
+static bool bmk_write(objects_cache_t *ocp,
+                      oc_object_t *objp,
+                      bool async) {
+
+  memcpy(bmk_media[objp->obj_key], ((bmk_object_t *)objp)->data,
+         BMK_OC_BLOCK_SIZE);
+
+  if (async) {
+    chCacheReleaseObject(ocp, objp);
+  }
+
+  return false;
+}
+
+static void bmk_trace_init(void) {
+  uint32_t seed = 1U;
+  unsigned i, j;
+
+  for (i = 0; i < BMK_OC_BLOCKS; i++) {
+    memset(bmk_media[i], (int)(uint8_t)i, BMK_OC_BLOCK_SIZE);
+  }
+
+  /* Random accesses to the working set, one in five is a write, with a
+     sequential scan of cold blocks every 512 accesses.*/
+  i = 0;
+  while (i < BMK_OC_TRACE_LEN) {
+    seed = (seed * 1103515245U) + 12345U;
+    if ((i % 512U) == 256U) {
+      uint32_t first = BMK_OC_HOT_BLOCKS +
+                       ((seed >> 16) % (BMK_OC_BLOCKS - BMK_OC_HOT_BLOCKS -
+                                        BMK_OC_SCAN_LEN));
+      for (j = 0; (j < BMK_OC_SCAN_LEN) && (i < BMK_OC_TRACE_LEN); j++) {
+        bmk_trace[i++] = (uint16_t)(first + j);
+      }
+    }
+    else {
+      uint16_t key = (uint16_t)((seed >> 16) % BMK_OC_HOT_BLOCKS);
+      if (((seed >> 8) % 5U) == 0U) {
+        key |= BMK_OC_WRITE;
+      }
+      bmk_trace[i++] = key;
+    }
+  }
+}
+
+static void bmk_oc_replay(ucnt_t ra, bool wb) {
+  rtcnt_t start, elapsed;
+  oc_stats_t stats;
+  unsigned i;
+
+  chCacheObjectInit(&bmk_cache,
+                    BMK_OC_OBJECTS * 2,
+                    bmk_hash,
+                    BMK_OC_OBJECTS,
+                    sizeof (bmk_object_t),
+                    bmk_objects,
+                    bmk_read,
+                    bmk_write);
+  chCacheSetReadAhead(&bmk_cache, ra);
+  bmk_sync_reads = 0U;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0; i < BMK_OC_TRACE_LEN; i++) {
+    uint32_t key = (uint32_t)bmk_trace[i] & ~BMK_OC_WRITE;
+    oc_object_t *objp = chCacheGetObject(&bmk_cache, 0U, key);
+
+    if ((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U) {
+      (void) chCacheReadObject(&bmk_cache, objp, false);
+    }
+    if (((bmk_object_t *)objp)->data[0] != (uint8_t)key) {
+      bmk_oc_ok = false;
+    }
+    if ((bmk_trace[i] & BMK_OC_WRITE) != 0U) {
+      objp->obj_flags |= OC_FLAG_LAZYWRITE;
+    }
+    chCacheReleaseObject(&bmk_cache, objp);
+
+    /* Simulating a background writer.*/
+    if (wb && ((i % 16U) == 15U)) {
+      (void) chCacheWriteBack(&bmk_cache, 4);
+    }
+  }
+  elapsed = chSysGetRealtimeCounterX() - start;
+
+  chCacheGetStatistics(&bmk_cache, &stats);
+  test_print("--- RA ");
+  test_printn((uint32_t)ra);
+  test_print(wb ? ", WB on" : ", WB off");
+  test_print(": hits ");
+  test_printn((uint32_t)stats.hits);
+  test_print(", sync reads ");
+  test_printn(bmk_sync_reads);
+  test_print(", read-ahead ");
+  test_printn((uint32_t)stats.readaheads);
+  test_print(", dirty evictions ");
+  test_printn((uint32_t)stats.dirty_evictions);
+  test_print(", ");
+  test_printn((uint32_t)elapsed / BMK_OC_TRACE_LEN);
+  test_println(" cycles/access");
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page corebmk_test_004_001 [4.1] Trace replay
+ *
+ * <h2>Description</h2>
+ * The same trace is replayed with read-ahead disabled and enabled, each
+ * time with and without write-back of dirty objects. Synchronous reads
+ * are those stalling the accessing thread.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.1.1] Replaying the trace with different cache settings.
+ * .
+ */
+
+static void corebmk_test_004_001_setup(void) {
+  bmk_trace_init();
+  bmk_oc_ok = true;
+}
+
+static void corebmk_test_004_001_execute(void) {
+
+  /* [4.1.1] Replaying the trace with different cache settings.*/
+  test_set_step(1);
+  {
+    bmk_oc_replay(0, false);
+    bmk_oc_replay(0, true);
+    bmk_oc_replay(4, false);
+    bmk_oc_replay(4, true);
+    test_assert(bmk_oc_ok, "content mismatch");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t corebmk_test_004_001 = {
+  "Trace replay",
+  corebmk_test_004_001_setup,
+  NULL,
+  corebmk_test_004_001_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const corebmk_test_sequence_004_array[] = {
+  &corebmk_test_004_001,
+  NULL
+};
+
+/**
+ * @brief   Objects caches trace replay.
+ */
+const testsequence_t corebmk_test_sequence_004 = {
+  "Objects caches trace replay",
+  corebmk_test_sequence_004_array
+};
+
+#endif /* CH_CFG_USE_OBJ_CACHES == TRUE */
@@ -0,0 +1,268 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+/*
+    This module is based on the work of John Walker (April of 1989) and
+    merely adapted to work in ChibiOS. The author has not specified
+    additional license terms so this is released using the most permissive
+    license used in ChibiOS. The license covers the changes only, not the
+    original work.
+ */
+
+#include "hal.h"
+#include "corebmk_test_root.h"
+
+/**
+ * @file    corebmk_test_sequence_005.c
+ * @brief   Test Sequence 005 code.
+ *
+ * @page corebmk_test_sequence_005 [5] Jobs throughput
+ *
+ * File: @ref corebmk_test_sequence_005.c
+ *
+ * <h2>Description</h2>
+ * This sequence compares a jobs queue served by several dispatcher
+ * threads with a work-stealing jobs system using the same number of
+ * workers. Results are realtime counter cycles per job.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_JOBS == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage corebmk_test_005_001
+ * .
+ */
+
+#if (CH_CFG_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include "ch.h"
+
+#define BMK_JOBS_WORKERS    4       /* Maximum number of workers.           */
+#define BMK_JOBS_NUM        32      /* Job objects.                         */
+#define BMK_JOBS_POSTS      2048    /* Jobs posted for each measurement.    */
+#define BMK_JOBS_DEPTH      8       /* Depth of the fork/join tree.         */
+#define BMK_JOBS_STACK_SIZE 512
+
+static THD_WORKING_AREA(wa_bmk_jobs[BMK_JOBS_WORKERS], BMK_JOBS_STACK_SIZE);
+static thread_t *bmk_jobs_tps[BMK_JOBS_WORKERS];
+static job_descriptor_t bmk_jobs[BMK_JOBS_NUM];
+static msg_t bmk_jobs_msgs[BMK_JOBS_NUM];
+static jobs_queue_t bmk_jq;
+static jobs_system_t bmk_js;
+static jobs_worker_t bmk_workers[BMK_JOBS_WORKERS];
+static job_slot_t bmk_slots[BMK_JOBS_WORKERS * BMK_JOBS_NUM];
+static uint32_t bmk_jobs_done;
+
+static void bmk_job(void *arg) {
+
+  (void)arg;
+
+  chSysLock();
+  bmk_jobs_done++;
+  chSysUnlock();
+}
+
+static void bmk_tree(void *arg) {
+  uintptr_t depth = (uintptr_t)arg;
+  jobs_group_t grp;
+
+  bmk_job(NULL);
+  if (depth > 0U) {
+    chJobGroupObjectInit(&grp);
+    chJobSpawn(&bmk_js, &grp, bmk_tree, (void *)(depth - 1U));
+    chJobSpawn(&bmk_js, &grp, bmk_tree, (void *)(depth - 1U));
+    chJobJoin(&bmk_js, &grp);
+  }
+}
+
+static THD_FUNCTION(bmk_dispatcher, arg) {
+
+  (void)arg;
+
+  while (chJobDispatch(&bmk_jq) == MSG_OK) {
+  }
+}
+
+static THD_FUNCTION(bmk_worker, arg) {
+
+  while (chJobWorkerDispatch(&bmk_js, (jobs_worker_t *)arg) == MSG_OK) {
+  }
+}
+
+static void bmk_jobs_start(unsigned n, tfunc_t fn, bool ws) {
+  unsigned i;
+
+  bmk_jobs_done = 0U;
+  for (i = 0; i < n; i++) {
+    bmk_jobs_tps[i] = chThdCreateStatic(wa_bmk_jobs[i],
+                                        sizeof (wa_bmk_jobs[i]),
+                                        chThdGetPriorityX() - 1, fn,
+                                        ws ? (void *)&bmk_workers[i] : NULL);
+  }
+}
+
+static void bmk_jobs_stop(unsigned n, bool ws) {
+  unsigned i;
+
+  for (i = 0; i < n; i++) {
+    job_descriptor_t *jp = ws ? chJobSystemGet(&bmk_js) : chJobGet(&bmk_jq);
+
+    jp->jobfunc = NULL;
+    jp->jobarg  = NULL;
+    if (ws) {
+      chJobSystemPost(&bmk_js, jp);
+    }
+    else {
+      chJobPost(&bmk_jq, jp);
+    }
+  }
+  for (i = 0; i < n; i++) {
+    (void) chThdWait(bmk_jobs_tps[i]);
+  }
+}
+
+static uint32_t bmk_jobs_queue(unsigned n) {
+  rtcnt_t start;
+  unsigned i;
+
+  chJobObjectInit(&bmk_jq, BMK_JOBS_NUM, bmk_jobs, bmk_jobs_msgs);
+  bmk_jobs_start(n, bmk_dispatcher, false);
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0; i < BMK_JOBS_POSTS; i++) {
+    job_descriptor_t *jp = chJobGet(&bmk_jq);
+
+    jp->jobfunc = bmk_job;
+    jp->jobarg  = NULL;
+    chJobPost(&bmk_jq, jp);
+  }
+  bmk_jobs_stop(n, false);
+
+  return (uint32_t)(chSysGetRealtimeCounterX() - start) / BMK_JOBS_POSTS;
+}
+
+static uint32_t bmk_jobs_system(unsigned n) {
+  rtcnt_t start;
+  unsigned i;
+
+  chJobSystemObjectInit(&bmk_js, BMK_JOBS_NUM, bmk_jobs,
+                        n, bmk_workers, bmk_slots);
+  bmk_jobs_start(n, bmk_worker, true);
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0; i < BMK_JOBS_POSTS; i++) {
+    job_descriptor_t *jp = chJobSystemGet(&bmk_js);
+
+    jp->jobfunc = bmk_job;
+    jp->jobarg  = NULL;
+    chJobSystemPost(&bmk_js, jp);
+  }
+  bmk_jobs_stop(n, true);
+
+  return (uint32_t)(chSysGetRealtimeCounterX() - start) / BMK_JOBS_POSTS;
+}
+
+static uint32_t bmk_jobs_tree(unsigned n) {
+  rtcnt_t start;
+  uint32_t jobs;
+
+  chJobSystemObjectInit(&bmk_js, BMK_JOBS_NUM, bmk_jobs,
+                        n, bmk_workers, bmk_slots);
+  bmk_jobs_start(n, bmk_worker, true);
+
+  start = chSysGetRealtimeCounterX();
+  bmk_tree((void *)BMK_JOBS_DEPTH);
+  jobs = bmk_jobs_done;
+  bmk_jobs_stop(n, true);
+
+  return (uint32_t)(chSysGetRealtimeCounterX() - start) / jobs;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page corebmk_test_005_001 [5.1] Workers scaling
+ *
+ * <h2>Description</h2>
+ * Trivial jobs are posted by a single thread to one, two and four
+ * workers using a jobs queue and a jobs system, then a binary tree of
+ * jobs is spawned and joined recursively.
+ *
+ * <h2>Test Steps</h2>
+ * - [5.1.1] Measuring cycles per job for increasing worker counts.
+ * .
+ */
+
+static void corebmk_test_005_001_execute(void) {
+  unsigned n;
+
+  /* [5.1.1] Measuring cycles per job for increasing worker counts.*/
+  test_set_step(1);
+  {
+    for (n = 1; n <= BMK_JOBS_WORKERS; n *= 2) {
+      test_print("--- Workers ");
+      test_printn((uint32_t)n);
+      test_print(", queue: ");
+      test_printn(bmk_jobs_queue(n));
+      test_assert(bmk_jobs_done == BMK_JOBS_POSTS, "jobs lost");
+      test_print(", system: ");
+      test_printn(bmk_jobs_system(n));
+      test_assert(bmk_jobs_done == BMK_JOBS_POSTS, "jobs lost");
+      test_print(", fork/join: ");
+      test_printn(bmk_jobs_tree(n));
+      test_assert(bmk_jobs_done == (2U << BMK_JOBS_DEPTH) - 1U, "jobs lost");
+      test_println(" cycles");
+    }
+  }
+  test_end_step(1);
+}
+
+static const testcase_t corebmk_test_005_001 = {
+  "Workers scaling",
+  NULL,
+  NULL,
+  corebmk_test_005_001_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const corebmk_test_sequence_005_array[] = {
+  &corebmk_test_005_001,
+  NULL
+};
+
+/**
+ * @brief   Jobs throughput.
+ */
+const testsequence_t corebmk_test_sequence_005 = {
+  "Jobs throughput",
+  corebmk_test_sequence_005_array
+};
+
+#endif /* CH_CFG_USE_JOBS == TRUE */
@@ -0,0 +1,191 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+/*
+    This module is based on the work of John Walker (April of 1989) and
+    merely adapted to work in ChibiOS. The author has not specified
+    additional license terms so this is released using the most permissive
+    license used in ChibiOS. The license covers the changes only, not the
+    original work.
+ */
+
+#include "hal.h"
+#include "corebmk_test_root.h"
+
+/**
+ * @file    corebmk_test_sequence_006.c
+ * @brief   Test Sequence 006 code.
+ *
+ * @page corebmk_test_sequence_006 [6] Threads pool spawn latency
+ *
+ * File: @ref corebmk_test_sequence_006.c
+ *
+ * <h2>Description</h2>
+ * This sequence compares threads created from the heap with threads
+ * reused from a threads pool. Results are realtime counter cycles from
+ * the spawn request to the thread execution and for a whole spawn and
+ * reclaim cycle.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_DYNAMIC == TRUE) && (CH_CFG_USE_HEAP == TRUE)
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage corebmk_test_006_001
+ * .
+ */
+
+#if ((CH_CFG_USE_DYNAMIC == TRUE) && (CH_CFG_USE_HEAP == TRUE)) ||          \
+    defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include "ch.h"
+
+#define BMK_POOL_SPAWNS     1024    /* Spawns for each measurement.         */
+#define BMK_POOL_FRAGMENTS  16      /* Small blocks fragmenting the heap.   */
+#define BMK_POOL_STACK_SIZE 512
+#define BMK_POOL_WA_SIZE    THD_WORKING_AREA_SIZE(BMK_POOL_STACK_SIZE)
+
+static CH_HEAP_AREA(bmk_heap_buffer, BMK_POOL_WA_SIZE * 4);
+static memory_heap_t bmk_heap;
+static thread_pool_t bmk_pool;
+static thread_pool_slot_t bmk_pool_slots[1];
+static rtcnt_t bmk_spawn_time;
+static rtcnt_t bmk_latency;
+
+static THD_FUNCTION(bmk_spawned, arg) {
+
+  (void)arg;
+
+  bmk_latency += chSysGetRealtimeCounterX() - bmk_spawn_time;
+}
+
+static void bmk_heap_init(void) {
+  void *blocks[BMK_POOL_FRAGMENTS];
+  unsigned i;
+
+  /* Leaving free fragments in front of the heap, allocations have to
+     walk them.*/
+  chHeapObjectInit(&bmk_heap, bmk_heap_buffer, sizeof (bmk_heap_buffer));
+  for (i = 0; i < BMK_POOL_FRAGMENTS; i++) {
+    blocks[i] = chHeapAlloc(&bmk_heap, 16);
+  }
+  for (i = 0; i < BMK_POOL_FRAGMENTS; i += 2U) {
+    chHeapFree(blocks[i]);
+  }
+}
+
+static void bmk_pool_print(const char *msg, rtcnt_t cycle) {
+
+  test_print(msg);
+  test_printn((uint32_t)bmk_latency / BMK_POOL_SPAWNS);
+  test_print(" cycles latency, ");
+  test_printn((uint32_t)cycle / BMK_POOL_SPAWNS);
+  test_println(" cycles per spawn");
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page corebmk_test_006_001 [6.1] Spawn to run latency
+ *
+ * <h2>Description</h2>
+ * Threads are spawned at a priority higher than the spawning thread
+ * using chThdCreateFromHeap() then chThdPoolStart(), the reclaim of
+ * heap threads is included in the cycle time.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.1.1] Spawning threads from the heap.
+ * - [6.1.2] Spawning threads from a threads pool.
+ * .
+ */
+
+static void corebmk_test_006_001_execute(void) {
+  rtcnt_t start;
+  unsigned i;
+
+  /* [6.1.1] Spawning threads from the heap.*/
+  test_set_step(1);
+  {
+    bmk_heap_init();
+    bmk_latency = (rtcnt_t)0;
+    start = chSysGetRealtimeCounterX();
+    for (i = 0; i < BMK_POOL_SPAWNS; i++) {
+      thread_t *tp;
+
+      bmk_spawn_time = chSysGetRealtimeCounterX();
+      tp = chThdCreateFromHeap(&bmk_heap, BMK_POOL_WA_SIZE, "bmk",
+                               chThdGetPriorityX() + 1, bmk_spawned, NULL);
+      test_assert(tp != NULL, "thread creation failed");
+      (void) chThdWait(tp);
+    }
+    bmk_pool_print("--- Heap: ", chSysGetRealtimeCounterX() - start);
+  }
+  test_end_step(1);
+
+  /* [6.1.2] Spawning threads from a threads pool.*/
+  test_set_step(2);
+  {
+    chThdPoolObjectInit(&bmk_pool, &bmk_heap, BMK_POOL_WA_SIZE, "bmk",
+                        bmk_pool_slots, 1);
+    bmk_latency = (rtcnt_t)0;
+    start = chSysGetRealtimeCounterX();
+    for (i = 0; i < BMK_POOL_SPAWNS; i++) {
+      bmk_spawn_time = chSysGetRealtimeCounterX();
+      test_assert(chThdPoolStart(&bmk_pool, chThdGetPriorityX() + 1,
+                                 bmk_spawned, NULL) != NULL,
+                  "thread start failed");
+    }
+    bmk_pool_print("--- Pool: ", chSysGetRealtimeCounterX() - start);
+    chThdPoolDispose(&bmk_pool);
+  }
+  test_end_step(2);
+}
+
+static const testcase_t corebmk_test_006_001 = {
+  "Spawn to run latency",
+  NULL,
+  NULL,
+  corebmk_test_006_001_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const corebmk_test_sequence_006_array[] = {
+  &corebmk_test_006_001,
+  NULL
+};
+
+/**
+ * @brief   Threads pool spawn latency.
+ */
+const testsequence_t corebmk_test_sequence_006 = {
+  "Threads pool spawn latency",
+  corebmk_test_sequence_006_array
+};
+
+#endif /* (CH_CFG_USE_DYNAMIC == TRUE) && (CH_CFG_USE_HEAP == TRUE) */
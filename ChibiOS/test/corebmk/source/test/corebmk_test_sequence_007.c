@@ -0,0 +1,232 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+/*
+    This module is based on the work of John Walker (April of 1989) and
+    merely adapted to work in ChibiOS. The author has not specified
+    additional license terms so this is released using the most permissive
+    license used in ChibiOS. The license covers the changes only, not the
+    original work.
+ */
+
+#include "hal.h"
+#include "corebmk_test_root.h"
+
+/**
+ * @file    corebmk_test_sequence_007.c
+ * @brief   Test Sequence 007 code.
+ *
+ * @page corebmk_test_sequence_007 [7] Formatted output
+ *
+ * File: @ref corebmk_test_sequence_007.c
+ *
+ * <h2>Description</h2>
+ * This sequence measures chprintf() with a format string and
+ * chprintfv() with a pre-parsed format, on a null stream and on a
+ * memory stream. Results are realtime counter cycles per formatted
+ * message.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage corebmk_test_007_001
+ * - @subpage corebmk_test_007_002
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#include "ch.h"
+#include "chprintf.h"
+#include "memstreams.h"
+#include "nullstreams.h"
+
+#define BMK_PRINTF_CALLS    1024    /* Messages for each measurement.       */
+#define BMK_PRINTF_FMT      "%s: %5d 0x%08X %c %-6s|%u\r\n"
+#define BMK_PRINTF_ARGS     "sensor", -123, 0xABCDEFUL, 'Z', "ok", 77U
+#define BMK_PRINTF_TEXT     "sensor:  -123 0x00ABCDEF Z ok    |77\r\n"
+
+static NullStream bmk_null;
+static MemoryStream bmk_mem;
+static uint8_t bmk_mem_buf[64];
+static chprintf_spec_t bmk_specs[8];
+static chprintf_format_t bmk_format;
+
+static uint32_t bmk_printf(BaseSequentialStream *chp, MemoryStream *msp,
+                           bool parsed) {
+  rtcnt_t start;
+  unsigned i;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0; i < BMK_PRINTF_CALLS; i++) {
+    if (msp != NULL) {
+      msObjectInit(msp, bmk_mem_buf, sizeof (bmk_mem_buf), 0U);
+    }
+    if (parsed) {
+      (void) chprintfv(chp, &bmk_format, BMK_PRINTF_ARGS);
+    }
+    else {
+      (void) chprintf(chp, BMK_PRINTF_FMT, BMK_PRINTF_ARGS);
+    }
+  }
+
+  return (uint32_t)(chSysGetRealtimeCounterX() - start) / BMK_PRINTF_CALLS;
+}
+
+static void bmk_printf_print(uint32_t plain, uint32_t parsed) {
+
+  test_print("--- chprintf(): ");
+  test_printn(plain);
+  test_print(" cycles, chprintfv(): ");
+  test_printn(parsed);
+  test_println(" cycles");
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page corebmk_test_007_001 [7.1] Null stream
+ *
+ * <h2>Description</h2>
+ * Messages are formatted on a null stream, the measurement only
+ * includes the formatting and the stream calls.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.1.1] Parsing the format.
+ * - [7.1.2] Measuring chprintf() and chprintfv().
+ * .
+ */
+
+static void corebmk_test_007_001_setup(void) {
+  nullObjectInit(&bmk_null);
+  (void) chprintfparse(&bmk_format, bmk_specs, 8U, BMK_PRINTF_FMT);
+}
+
+static void corebmk_test_007_001_execute(void) {
+
+  /* [7.1.1] Parsing the format.*/
+  test_set_step(1);
+  {
+    test_assert(chprintfparse(&bmk_format, bmk_specs, 8U, BMK_PRINTF_FMT) ==
+                HAL_SUCCESS, "parse failed");
+    test_assert(chprintfparse(&bmk_format, bmk_specs, 6U, BMK_PRINTF_FMT) ==
+                HAL_FAILED, "overflow not detected");
+    test_assert(chprintfparse(&bmk_format, bmk_specs, 7U, BMK_PRINTF_FMT) ==
+                HAL_SUCCESS, "parse failed");
+  }
+  test_end_step(1);
+
+  /* [7.1.2] Measuring chprintf() and chprintfv().*/
+  test_set_step(2);
+  {
+    uint32_t plain, parsed;
+
+    plain  = bmk_printf((BaseSequentialStream *)&bmk_null, NULL, false);
+    parsed = bmk_printf((BaseSequentialStream *)&bmk_null, NULL, true);
+    bmk_printf_print(plain, parsed);
+  }
+  test_end_step(2);
+}
+
+static const testcase_t corebmk_test_007_001 = {
+  "Null stream",
+  corebmk_test_007_001_setup,
+  NULL,
+  corebmk_test_007_001_execute
+};
+
+/**
+ * @page corebmk_test_007_002 [7.2] Memory stream
+ *
+ * <h2>Description</h2>
+ * Messages are formatted in a memory buffer, the output of chprintf()
+ * and chprintfv() is verified.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.2.1] Checking the formatted output.
+ * - [7.2.2] Measuring chprintf() and chprintfv().
+ * .
+ */
+
+static void corebmk_test_007_002_setup(void) {
+  nullObjectInit(&bmk_null);
+  (void) chprintfparse(&bmk_format, bmk_specs, 8U, BMK_PRINTF_FMT);
+}
+
+static void corebmk_test_007_002_execute(void) {
+
+  /* [7.2.1] Checking the formatted output.*/
+  test_set_step(1);
+  {
+    int n;
+
+    msObjectInit(&bmk_mem, bmk_mem_buf, sizeof (bmk_mem_buf), 0U);
+    n = chprintf((BaseSequentialStream *)&bmk_mem, BMK_PRINTF_FMT,
+                 BMK_PRINTF_ARGS);
+    test_assert(n == (int)strlen(BMK_PRINTF_TEXT), "wrong size");
+    test_assert(memcmp(bmk_mem_buf, BMK_PRINTF_TEXT, (size_t)n) == 0,
+                "wrong output");
+    msObjectInit(&bmk_mem, bmk_mem_buf, sizeof (bmk_mem_buf), 0U);
+    n = chprintfv((BaseSequentialStream *)&bmk_mem, &bmk_format,
+                  BMK_PRINTF_ARGS);
+    test_assert(n == (int)strlen(BMK_PRINTF_TEXT), "wrong size");
+    test_assert(memcmp(bmk_mem_buf, BMK_PRINTF_TEXT, (size_t)n) == 0,
+                "wrong output");
+  }
+  test_end_step(1);
+
+  /* [7.2.2] Measuring chprintf() and chprintfv().*/
+  test_set_step(2);
+  {
+    uint32_t plain, parsed;
+
+    plain  = bmk_printf((BaseSequentialStream *)&bmk_mem, &bmk_mem, false);
+    parsed = bmk_printf((BaseSequentialStream *)&bmk_mem, &bmk_mem, true);
+    bmk_printf_print(plain, parsed);
+  }
+  test_end_step(2);
+}
+
+static const testcase_t corebmk_test_007_002 = {
+  "Memory stream",
+  corebmk_test_007_002_setup,
+  NULL,
+  corebmk_test_007_002_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const corebmk_test_sequence_007_array[] = {
+  &corebmk_test_007_001,
+  &corebmk_test_007_002,
+  NULL
+};
+
+/**
+ * @brief   Formatted output.
+ */
+const testsequence_t corebmk_test_sequence_007 = {
+  "Formatted output",
+  corebmk_test_sequence_007_array
+};
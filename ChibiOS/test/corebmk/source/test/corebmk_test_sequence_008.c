@@ -0,0 +1,273 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+/*
+    This module is based on the work of John Walker (April of 1989) and
+    merely adapted to work in ChibiOS. The author has not specified
+    additional license terms so this is released using the most permissive
+    license used in ChibiOS. The license covers the changes only, not the
+    original work.
+ */
+
+#include "hal.h"
+#include "corebmk_test_root.h"
+
+/**
+ * @file    corebmk_test_sequence_008.c
+ * @brief   Test Sequence 008 code.
+ *
+ * @page corebmk_test_sequence_008 [8] Deferred log
+ *
+ * File: @ref corebmk_test_sequence_008.c
+ *
+ * <h2>Description</h2>
+ * This sequence verifies the records written by the deferred log and
+ * compares the cost of posting a record with the cost of formatting the
+ * same message with chprintf() on a null stream. Results are realtime
+ * counter cycles per message.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage corebmk_test_008_001
+ * - @subpage corebmk_test_008_002
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#include "ch.h"
+#include "chprintf.h"
+#include "memstreams.h"
+#include "nullstreams.h"
+#include "deflog.h"
+
+#define BMK_DLOG_CALLS      1024    /* Messages for each measurement.       */
+#define BMK_DLOG_BATCH      64      /* Messages between drains.             */
+#define BMK_DLOG_FMT        "%s: %5d 0x%08X %c %-6s|%u\r\n"
+
+static const char bmk_dlog_name[] = "sensor";
+static const char bmk_dlog_ok[] = "ok";
+static const char bmk_dlog_msg[] = "started";
+static const char bmk_dlog_fmt2[] = "%d %d";
+static dlog_word_t bmk_dlog_buf[BMK_DLOG_BATCH * 8];
+static dlog_word_t bmk_dlog_out[32];
+static DeferredLog bmk_dlog;
+static MemoryStream bmk_mem;
+static NullStream bmk_null;
+
+static size_t bmk_dlog_drain(void) {
+
+  msObjectInit(&bmk_mem, (uint8_t *)bmk_dlog_out, sizeof (bmk_dlog_out), 0U);
+  return dlogDrain(&bmk_dlog, (BaseSequentialStream *)&bmk_mem);
+}
+
+static bool bmk_dlog_is_header(dlog_word_t w, unsigned n) {
+
+  return (w & 0xFFFFU) == (DLOG_RECORD_MAGIC | (n << 8));
+}
+
+static uint32_t bmk_dlog_post(void) {
+  rtcnt_t start, total = (rtcnt_t)0;
+  unsigned i, j;
+
+  for (i = 0; i < BMK_DLOG_CALLS / BMK_DLOG_BATCH; i++) {
+    start = chSysGetRealtimeCounterX();
+    for (j = 0; j < BMK_DLOG_BATCH; j++) {
+      dlogPrintf(&bmk_dlog, BMK_DLOG_FMT, DLOG_STR(bmk_dlog_name), -123,
+                 0xABCDEFU, 'Z', DLOG_STR(bmk_dlog_ok), 77U);
+    }
+    total += chSysGetRealtimeCounterX() - start;
+    (void) dlogDrain(&bmk_dlog, (BaseSequentialStream *)&bmk_null);
+  }
+
+  return (uint32_t)total / BMK_DLOG_CALLS;
+}
+
+static uint32_t bmk_dlog_chprintf(void) {
+  rtcnt_t start;
+  unsigned i;
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0; i < BMK_DLOG_CALLS; i++) {
+    (void) chprintf((BaseSequentialStream *)&bmk_null, BMK_DLOG_FMT,
+                    bmk_dlog_name, -123, 0xABCDEFUL, 'Z', bmk_dlog_ok, 77U);
+  }
+
+  return (uint32_t)(chSysGetRealtimeCounterX() - start) / BMK_DLOG_CALLS;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page corebmk_test_008_001 [8.1] Records layout
+ *
+ * <h2>Description</h2>
+ * Records are posted in a small buffer and drained on a memory stream,
+ * the drained words are verified including lost records and buffer wrap
+ * around.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.1.1] Posting two records and checking the drained words.
+ * - [8.1.2] Filling the buffer across its end, the third record is
+ *   lost.
+ * - [8.1.3] Posting records after the lost records notification.
+ * - [8.1.4] Waiting for records.
+ * .
+ */
+
+static void corebmk_test_008_001_setup(void) {
+  dlogObjectInit(&bmk_dlog, bmk_dlog_buf, 16U);
+}
+
+static void corebmk_test_008_001_execute(void) {
+
+  /* [8.1.1] Posting two records and checking the drained words.*/
+  test_set_step(1);
+  {
+    test_assert(bmk_dlog_drain() == 0U, "not empty");
+    dlogPuts(&bmk_dlog, bmk_dlog_msg);
+    dlogPrintf(&bmk_dlog, bmk_dlog_fmt2, 1, -2);
+    test_assert(bmk_dlog_drain() == 7U * sizeof (dlog_word_t), "wrong size");
+    test_assert(bmk_dlog_out[0] == DLOG_SYNC_WORD, "missing sync");
+    test_assert(bmk_dlog_is_header(bmk_dlog_out[1], 0U), "wrong header");
+    test_assert(bmk_dlog_out[2] == DLOG_STR(bmk_dlog_msg), "wrong format");
+    test_assert(bmk_dlog_is_header(bmk_dlog_out[3], 2U), "wrong header");
+    test_assert(bmk_dlog_out[4] == DLOG_STR(bmk_dlog_fmt2), "wrong format");
+    test_assert((bmk_dlog_out[5] == 1U) && (bmk_dlog_out[6] == (dlog_word_t)-2),
+                "wrong arguments");
+  }
+  test_end_step(1);
+
+  /* [8.1.2] Filling the buffer across its end, the third record is
+     lost.*/
+  test_set_step(2);
+  {
+    unsigned i;
+
+    for (i = 0; i < 3; i++) {
+      dlogPrintf(&bmk_dlog, bmk_dlog_fmt2, i, 4, 5, 6);
+    }
+    test_assert(bmk_dlog_drain() == 15U * sizeof (dlog_word_t), "wrong size");
+    test_assert(bmk_dlog_out[0] == DLOG_SYNC_WORD, "missing sync");
+    test_assert(bmk_dlog_is_header(bmk_dlog_out[7], 4U) &&
+                (bmk_dlog_out[9] == 1U), "wrong record");
+    test_assert(bmk_dlog_is_header(bmk_dlog_out[13], DLOG_LOST_NARGS),
+                "missing lost notification");
+    test_assert(bmk_dlog_out[14] == 1U, "wrong lost count");
+  }
+  test_end_step(2);
+
+  /* [8.1.3] Posting records after the lost records notification.*/
+  test_set_step(3);
+  {
+    dlogPrintf(&bmk_dlog, bmk_dlog_fmt2, 7, 8, 9, 10);
+    dlogPrintf(&bmk_dlog, bmk_dlog_fmt2, 11, 12, 13, 14);
+    test_assert(bmk_dlog_drain() == 13U * sizeof (dlog_word_t), "wrong size");
+    test_assert(bmk_dlog_is_header(bmk_dlog_out[7], 4U), "wrong header");
+    test_assert(bmk_dlog_out[8] == DLOG_STR(bmk_dlog_fmt2), "wrong format");
+    test_assert((bmk_dlog_out[9] == 11U) && (bmk_dlog_out[12] == 14U),
+                "wrong arguments");
+  }
+  test_end_step(3);
+
+  /* [8.1.4] Waiting for records.*/
+  test_set_step(4);
+  {
+    test_assert(dlogWaitTimeout(&bmk_dlog, TIME_IMMEDIATE) == MSG_TIMEOUT,
+                "not empty");
+    dlogPuts(&bmk_dlog, bmk_dlog_msg);
+    test_assert(dlogWaitTimeout(&bmk_dlog, TIME_IMMEDIATE) == MSG_OK,
+                "empty");
+    (void) bmk_dlog_drain();
+  }
+  test_end_step(4);
+}
+
+static const testcase_t corebmk_test_008_001 = {
+  "Records layout",
+  corebmk_test_008_001_setup,
+  NULL,
+  corebmk_test_008_001_execute
+};
+
+/**
+ * @page corebmk_test_008_002 [8.2] Posting cost
+ *
+ * <h2>Description</h2>
+ * The same message is posted using dlogPrintf() and formatted using
+ * chprintf() on a null stream, the deferred log is drained out of the
+ * measurement.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.2.1] Measuring dlogPrintf() and chprintf().
+ * .
+ */
+
+static void corebmk_test_008_002_setup(void) {
+  nullObjectInit(&bmk_null);
+  dlogObjectInit(&bmk_dlog, bmk_dlog_buf, sizeof (bmk_dlog_buf) /
+                                           sizeof (dlog_word_t));
+}
+
+static void corebmk_test_008_002_execute(void) {
+
+  /* [8.2.1] Measuring dlogPrintf() and chprintf().*/
+  test_set_step(1);
+  {
+    uint32_t posted, formatted;
+
+    posted    = bmk_dlog_post();
+    formatted = bmk_dlog_chprintf();
+    test_print("--- dlogPrintf(): ");
+    test_printn(posted);
+    test_print(" cycles, chprintf(): ");
+    test_printn(formatted);
+    test_println(" cycles");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t corebmk_test_008_002 = {
+  "Posting cost",
+  corebmk_test_008_002_setup,
+  NULL,
+  corebmk_test_008_002_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const corebmk_test_sequence_008_array[] = {
+  &corebmk_test_008_001,
+  &corebmk_test_008_002,
+  NULL
+};
+
+/**
+ * @brief   Deferred log.
+ */
+const testsequence_t corebmk_test_sequence_008 = {
+  "Deferred log",
+  corebmk_test_sequence_008_array
+};
@@ -0,0 +1,116 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "ch_test.h"
+
+#include "histogram_mod.h"
+
+static unsigned hist_bin(uint32_t sample) {
+  unsigned bin = 0U;
+
+  while (sample > 1U) {
+    sample >>= 1;
+    bin++;
+  }
+  return bin;
+}
+
+void hist_init(histogram_t *hp, const char *name) {
+  unsigned i;
+
+  hp->name = name;
+  hp->n    = 0U;
+  hp->min  = (uint32_t)-1;
+  hp->max  = 0U;
+  for (i = 0U; i < HIST_BINS; i++) {
+    hp->bins[i] = 0U;
+  }
+}
+
+void hist_add(histogram_t *hp, uint32_t sample) {
+
+  hp->bins[hist_bin(sample)]++;
+  hp->n++;
+  if (sample < hp->min) {
+    hp->min = sample;
+  }
+  if (sample > hp->max) {
+    hp->max = sample;
+  }
+}
+
+/* Returns the upper bound of the bin containing the requested percentile,
+   the result is capped to the largest sample.*/
+uint32_t hist_percentile(const histogram_t *hp, uint32_t permille) {
+  uint32_t rank, cnt;
+  unsigned i;
+
+  if (hp->n == 0U) {
+    return 0U;
+  }
+
+  rank = (uint32_t)((((uint64_t)hp->n * permille) + 999U) / 1000U);
+  if (rank == 0U) {
+    rank = 1U;
+  }
+
+  cnt = 0U;
+  for (i = 0U; i < HIST_BINS - 1U; i++) {
+    cnt += hp->bins[i];
+    if (cnt >= rank) {
+      uint32_t bound = (2U << i) - 1U;
+      return bound < hp->max ? bound : hp->max;
+    }
+  }
+  return hp->max;
+}
+
+/* Prints the histogram as a single JSON object on a line prefixed by the
+   usual test log marker, trailing empty bins are omitted.*/
+void hist_print(const histogram_t *hp) {
+  unsigned i, last;
+
+  last = 0U;
+  for (i = 0U; i < HIST_BINS; i++) {
+    if (hp->bins[i] > 0U) {
+      last = i;
+    }
+  }
+
+  test_print("--- {\"bench\":\"");
+  test_print(hp->name);
+  test_print("\",\"unit\":\"rtc\",\"n\":");
+  test_printn(hp->n);
+  test_print(",\"min\":");
+  test_printn(hp->n > 0U ? hp->min : 0U);
+  test_print(",\"p50\":");
+  test_printn(hist_percentile(hp, 500U));
+  test_print(",\"p99\":");
+  test_printn(hist_percentile(hp, 990U));
+  test_print(",\"p999\":");
+  test_printn(hist_percentile(hp, 999U));
+  test_print(",\"max\":");
+  test_printn(hp->max);
+  test_print(",\"log2_bins\":[");
+  for (i = 0U; i <= last; i++) {
+    if (i > 0U) {
+      test_print(",");
+    }
+    test_printn(hp->bins[i]);
+  }
+  test_println("]}");
+}
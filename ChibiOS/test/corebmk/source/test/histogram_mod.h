@@ -0,0 +1,46 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef HISTOGRAM_MOD_H
+#define HISTOGRAM_MOD_H
+
+#include <stdint.h>
+
+/* One bin for each power of two of a 32 bits sample, bin zero also
+   holds zero samples.*/
+#define HIST_BINS   32U
+
+/* Latency histogram, samples are realtime counter cycles.*/
+typedef struct {
+  const char    *name;
+  uint32_t      n;
+  uint32_t      min;
+  uint32_t      max;
+  uint32_t      bins[HIST_BINS];
+} histogram_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void hist_init(histogram_t *hp, const char *name);
+  void hist_add(histogram_t *hp, uint32_t sample);
+  uint32_t hist_percentile(const histogram_t *hp, uint32_t permille);
+  void hist_print(const histogram_t *hp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HISTOGRAM_MOD_H */
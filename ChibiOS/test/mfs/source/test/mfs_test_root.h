@@ -27,6 +27,7 @@
 #include "mfs_test_sequence_001.h"
 #include "mfs_test_sequence_002.h"
 #include "mfs_test_sequence_003.h"
+#include "mfs_test_sequence_004.h"
 
 #if !defined(__DOXYGEN__)
 
@@ -61,6 +62,18 @@ extern const uint8_t mfs_pattern32[32];
 extern const uint8_t mfs_pattern10[10];
 extern const uint8_t mfs_pattern512[512];
 
+/*
+ * Bank space not available to records, the header and the index reserve.
+ */
+#if MFS_CFG_USE_INDEX == TRUE
+#define MFS_TEST_INDEX_SIZE                                                 \
+  MFS_ALIGN_NEXT(sizeof (mfs_data_header_t) + sizeof (mfs_index_t))
+#else
+#define MFS_TEST_INDEX_SIZE             0U
+#endif
+#define MFS_TEST_BANK_META_SIZE                                             \
+  (sizeof (mfs_bank_header_t) + MFS_TEST_INDEX_SIZE)
+
 flash_error_t bank_erase(mfs_bank_t bank);
 flash_error_t bank_verify_erased(mfs_bank_t bank);
 void test_print_mfs_info(void);
@@ -411,7 +411,7 @@ static void mfs_test_001_005_execute(void) {
   test_set_step(1);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_TEST_BANK_META_SIZE +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -438,7 +438,7 @@ static void mfs_test_001_005_execute(void) {
   test_set_step(2);
   {
     mfs_error_t err;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_TEST_BANK_META_SIZE +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -455,7 +455,8 @@ static void mfs_test_001_005_execute(void) {
     size_t remaining;
 
     remaining = (size_t)flashGetSectorOffset(mfscfg1.flashp, mfscfg1.bank0_start) +
-                (size_t)mfscfg1.bank_size - (size_t)mfs1.next_offset;
+                (size_t)mfscfg1.bank_size - (size_t)mfs1.next_offset -
+                MFS_TEST_INDEX_SIZE;
     test_assert(remaining >= sizeof (mfs_data_header_t), "not enough space");
 
     if (remaining > sizeof (mfs_data_header_t) * 2) {
@@ -476,7 +477,8 @@ static void mfs_test_001_005_execute(void) {
     }
 
     remaining = (size_t)flashGetSectorOffset(mfscfg1.flashp, mfscfg1.bank0_start) +
-                (size_t)mfscfg1.bank_size - (size_t)mfs1.next_offset;
+                (size_t)mfscfg1.bank_size - (size_t)mfs1.next_offset -
+                MFS_TEST_INDEX_SIZE;
     test_assert(remaining == 0U, "remaining space not zero");
 
     mfsStop(&mfs1);
@@ -534,7 +536,7 @@ static void mfs_test_001_006_execute(void) {
   test_set_step(1);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_TEST_BANK_META_SIZE +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -598,7 +600,7 @@ static void mfs_test_001_006_execute(void) {
   test_set_step(4);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_TEST_BANK_META_SIZE +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -665,7 +667,7 @@ static void mfs_test_001_006_execute(void) {
   test_set_step(7);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_TEST_BANK_META_SIZE +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + sizeof mfs_pattern512);
 
@@ -731,7 +733,7 @@ static void mfs_test_001_007_execute(void) {
   test_set_step(1);
   {
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_TEST_BANK_META_SIZE +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4));
 
@@ -757,7 +759,7 @@ static void mfs_test_001_007_execute(void) {
     mfs_error_t err;
     size_t size;
     mfs_id_t id;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_TEST_BANK_META_SIZE +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4));
     mfs_id_t n = ((mfscfg1.bank_size - sizeof (mfs_bank_header_t)) -
@@ -781,7 +783,7 @@ static void mfs_test_001_007_execute(void) {
   {
     mfs_error_t err;
     size_t size;
-    mfs_id_t id_max = (mfscfg1.bank_size - (sizeof (mfs_bank_header_t) +
+    mfs_id_t id_max = (mfscfg1.bank_size - (MFS_TEST_BANK_META_SIZE +
                                             sizeof (mfs_data_header_t))) /
                       (sizeof (mfs_data_header_t) + (sizeof mfs_pattern512 / 4));
 
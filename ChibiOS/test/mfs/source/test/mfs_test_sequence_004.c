@@ -0,0 +1,393 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "mfs_test_root.h"
+
+/**
+ * @file    mfs_test_sequence_004.c
+ * @brief   Test Sequence 004 code.
+ *
+ * @page mfs_test_sequence_004 [4] Performance tests
+ *
+ * File: @ref mfs_test_sequence_004.c
+ *
+ * <h2>Description</h2>
+ * The time required by operations on the managed storage is measured,
+ * results are in operations per second.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage mfs_test_004_001
+ * - @subpage mfs_test_004_002
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+#include "hal_mfs.h"
+#include "crclib.h"
+
+#define BMK_MFS_WINDOW_MS   1000
+
+static size_t bmk_mfs_record_size(void) {
+  size_t n;
+
+  /* Size of records filling half of a bank.*/
+  n = (((size_t)mfscfg1.bank_size / 2U) / MFS_CFG_MAX_RECORDS) -
+      sizeof (mfs_data_header_t);
+  if (n > sizeof mfs_pattern512) {
+    n = sizeof mfs_pattern512;
+  }
+
+  return n;
+}
+
+static uint32_t bmk_mfs_mount_rate(void) {
+  systime_t start, end;
+  uint32_t n = 0U;
+
+  start = osalOsGetSystemTimeX();
+  end   = osalTimeAddX(start, OSAL_MS2I(BMK_MFS_WINDOW_MS));
+  do {
+    mfsStop(&mfs1);
+    (void) mfsStart(&mfs1, &mfscfg1);
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (osalTimeIsInRangeX(osalOsGetSystemTimeX(), start, end));
+
+  return n;
+}
+
+static void bmk_mfs_print(uint32_t n) {
+
+  test_print("--- Score : ");
+  test_printn(n);
+  test_println(" mounts/S");
+}
+
+
+#if (CRCLIB_CFG_USE_CRC32 == TRUE) && (CRCLIB_CFG_USE_CRC32C == TRUE)
+typedef uint32_t (*bmk_crc_t)(uint32_t crc, const uint8_t *p, size_t n);
+
+static volatile uint32_t bmk_crc_sink;
+
+/* Byte at time CRC16, the loop previously used by MFS.*/
+static uint32_t bmk_crc16_bytewise(uint32_t crc, const uint8_t *p, size_t n) {
+  uint16_t r = (uint16_t)crc;
+
+  while (n > 0U) {
+    r = (uint16_t)(r << 8U) ^ crclib_crc16_table[0][(r >> 8U) ^ (uint16_t)*p];
+    p++;
+    n--;
+  }
+
+  return (uint32_t)r;
+}
+
+static uint32_t bmk_crc16_crclib(uint32_t crc, const uint8_t *p, size_t n) {
+
+  return (uint32_t)crclibCRC16((uint16_t)crc, p, n);
+}
+
+/* Byte at time CRC32, the loop previously used by the software CRC
+   driver.*/
+static uint32_t bmk_crc32_bytewise(uint32_t crc, const uint8_t *p, size_t n) {
+
+  while (n > 0U) {
+    crc = crclib_crc32_table[0][(crc ^ (uint32_t)*p) & 0xFFU] ^ (crc >> 8U);
+    p++;
+    n--;
+  }
+
+  return crc;
+}
+
+static uint32_t bmk_crc32_crclib(uint32_t crc, const uint8_t *p, size_t n) {
+
+  return crclibCRC32(crc, p, n);
+}
+
+static uint32_t bmk_crc32c_crclib(uint32_t crc, const uint8_t *p, size_t n) {
+
+  return crclibCRC32C(crc, p, n);
+}
+
+static uint32_t bmk_crc_rate(bmk_crc_t fn) {
+  systime_t start, end;
+  uint32_t n = 0U, crc = 0U;
+
+  start = osalOsGetSystemTimeX();
+  end   = osalTimeAddX(start, OSAL_MS2I(BMK_MFS_WINDOW_MS));
+  do {
+    crc = fn(crc, mfs_pattern512, sizeof mfs_pattern512);
+    n += (uint32_t)sizeof mfs_pattern512;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (osalTimeIsInRangeX(osalOsGetSystemTimeX(), start, end));
+  bmk_crc_sink = crc;
+
+  return n;
+}
+
+static void bmk_crc_print(uint32_t n) {
+
+  test_print("--- Score : ");
+  test_printn(n);
+  test_println(" bytes/S");
+}
+#endif
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page mfs_test_004_001 [4.1] Mount time
+ *
+ * <h2>Description</h2>
+ * Half of the storage is filled with records, then the storage is
+ * mounted repeatedly for one second, before and after a garbage
+ * collection. If MFS_CFG_USE_INDEX is enabled then the collected bank
+ * is mounted from its index.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.1.1] Filling half of the storage with one instance of each
+ *   record.
+ * - [4.1.2] Measuring the mount rate, all records are scanned.
+ * - [4.1.3] Performing a garbage collection and measuring the mount
+ *   rate again.
+ * - [4.1.4] Reading back all records, data is verified on read.
+ * .
+ */
+
+static void mfs_test_004_001_setup(void) {
+  mfsStart(&mfs1, &mfscfg1);
+  mfsErase(&mfs1);
+}
+
+static void mfs_test_004_001_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_004_001_execute(void) {
+
+  /* [4.1.1] Filling half of the storage with one instance of each
+     record.*/
+  test_set_step(1);
+  {
+    size_t n = bmk_mfs_record_size();
+    mfs_id_t id;
+
+    for (id = 1; id <= MFS_CFG_MAX_RECORDS; id++) {
+      mfs_error_t err;
+
+      err = mfsWriteRecord(&mfs1, id, n, mfs_pattern512);
+      test_assert(err == MFS_NO_ERROR, "error creating the record");
+    }
+  }
+  test_end_step(1);
+
+  /* [4.1.2] Measuring the mount rate, all records are scanned.*/
+  test_set_step(2);
+  {
+    uint32_t n;
+
+    n = bmk_mfs_mount_rate();
+    test_assert(mfs1.state == MFS_READY, "mount failed");
+    bmk_mfs_print(n);
+  }
+  test_end_step(2);
+
+  /* [4.1.3] Performing a garbage collection and measuring the mount
+     rate again.*/
+  test_set_step(3);
+  {
+    mfs_error_t err;
+    uint32_t n;
+
+    err = mfsPerformGarbageCollection(&mfs1);
+    test_assert(err == MFS_NO_ERROR, "garbage collection failed");
+    n = bmk_mfs_mount_rate();
+    test_assert(mfs1.state == MFS_READY, "mount failed");
+    bmk_mfs_print(n);
+  }
+  test_end_step(3);
+
+  /* [4.1.4] Reading back all records, data is verified on read.*/
+  test_set_step(4);
+  {
+    mfs_id_t id;
+
+    for (id = 1; id <= MFS_CFG_MAX_RECORDS; id++) {
+      mfs_error_t err;
+      size_t size = sizeof mfs_buffer;
+
+      err = mfsReadRecord(&mfs1, id, &size, mfs_buffer);
+      test_assert(err == MFS_NO_ERROR, "record not found");
+      test_assert(size == bmk_mfs_record_size(), "unexpected record length");
+      test_assert(memcmp(mfs_pattern512, mfs_buffer, size) == 0,
+                  "wrong record content");
+    }
+  }
+  test_end_step(4);
+}
+
+static const testcase_t mfs_test_004_001 = {
+  "Mount time",
+  mfs_test_004_001_setup,
+  mfs_test_004_001_teardown,
+  mfs_test_004_001_execute
+};
+
+#if ((CRCLIB_CFG_USE_CRC32 == TRUE) && (CRCLIB_CFG_USE_CRC32C == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page mfs_test_004_002 [4.2] CRC throughput
+ *
+ * <h2>Description</h2>
+ * The CRC library is checked against the standard check values and
+ * against the byte at time algorithms, then the throughput of the byte
+ * at time loops is compared with the library implementations over one
+ * second windows.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CRCLIB_CFG_USE_CRC32 == TRUE) && (CRCLIB_CFG_USE_CRC32C == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [4.2.1] Checking the library against the CRC check values.
+ * - [4.2.2] Comparing the library with the byte at time algorithms on
+ *   all alignments and lengths up to 64 bytes.
+ * - [4.2.3] Measuring the byte at time CRC16.
+ * - [4.2.4] Measuring the library CRC16.
+ * - [4.2.5] Measuring the byte at time CRC32.
+ * - [4.2.6] Measuring the library CRC32.
+ * - [4.2.7] Measuring the library CRC32C.
+ * .
+ */
+
+static void mfs_test_004_002_execute(void) {
+
+  /* [4.2.1] Checking the library against the CRC check values.*/
+  test_set_step(1);
+  {
+    static const char check[] = "123456789";
+    crclib_context_t ctx;
+
+    test_assert(crclibCRC16(0xFFFFU, check, 9U) == CRCLIB_CRC16_CHECK,
+                "CRC16 mismatch");
+    crclibInit(&ctx, CRCLIB_CRC32);
+    crclibUpdate(&ctx, check, 4U);
+    crclibUpdate(&ctx, &check[4], 5U);
+    test_assert(crclibFinal(&ctx) == CRCLIB_CRC32_CHECK, "CRC32 mismatch");
+    crclibInit(&ctx, CRCLIB_CRC32C);
+    crclibUpdate(&ctx, check, 9U);
+    test_assert(crclibFinal(&ctx) == CRCLIB_CRC32C_CHECK, "CRC32C mismatch");
+  }
+  test_end_step(1);
+
+  /* [4.2.2] Comparing the library with the byte at time algorithms on
+     all alignments and lengths up to 64 bytes.*/
+  test_set_step(2);
+  {
+    size_t offset, n;
+
+    for (offset = 0U; offset < 8U; offset++) {
+      for (n = 0U; n <= 64U; n++) {
+        const uint8_t *p = &mfs_pattern512[offset];
+
+        test_assert(bmk_crc16_crclib(0xFFFFU, p, n) ==
+                    bmk_crc16_bytewise(0xFFFFU, p, n), "CRC16 mismatch");
+        test_assert(bmk_crc32_crclib(0xFFFFFFFFU, p, n) ==
+                    bmk_crc32_bytewise(0xFFFFFFFFU, p, n), "CRC32 mismatch");
+      }
+    }
+  }
+  test_end_step(2);
+
+  /* [4.2.3] Measuring the byte at time CRC16.*/
+  test_set_step(3);
+  {
+    bmk_crc_print(bmk_crc_rate(bmk_crc16_bytewise));
+  }
+  test_end_step(3);
+
+  /* [4.2.4] Measuring the library CRC16.*/
+  test_set_step(4);
+  {
+    bmk_crc_print(bmk_crc_rate(bmk_crc16_crclib));
+  }
+  test_end_step(4);
+
+  /* [4.2.5] Measuring the byte at time CRC32.*/
+  test_set_step(5);
+  {
+    bmk_crc_print(bmk_crc_rate(bmk_crc32_bytewise));
+  }
+  test_end_step(5);
+
+  /* [4.2.6] Measuring the library CRC32.*/
+  test_set_step(6);
+  {
+    bmk_crc_print(bmk_crc_rate(bmk_crc32_crclib));
+  }
+  test_end_step(6);
+
+  /* [4.2.7] Measuring the library CRC32C.*/
+  test_set_step(7);
+  {
+    bmk_crc_print(bmk_crc_rate(bmk_crc32c_crclib));
+  }
+  test_end_step(7);
+}
+
+static const testcase_t mfs_test_004_002 = {
+  "CRC throughput",
+  NULL,
+  NULL,
+  mfs_test_004_002_execute
+};
+#endif /* (CRCLIB_CFG_USE_CRC32 == TRUE) && (CRCLIB_CFG_USE_CRC32C == TRUE) */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const mfs_test_sequence_004_array[] = {
+  &mfs_test_004_001,
+#if ((CRCLIB_CFG_USE_CRC32 == TRUE) && (CRCLIB_CFG_USE_CRC32C == TRUE)) || defined(__DOXYGEN__)
+  &mfs_test_004_002,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Performance tests.
+ */
+const testsequence_t mfs_test_sequence_004 = {
+  "Performance tests",
+  mfs_test_sequence_004_array
+};
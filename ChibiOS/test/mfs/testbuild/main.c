@@ -0,0 +1,218 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "hal_mfs.h"
+#include "mfs_test_root.h"
+#include "console.h"
+
+/*
+ * Number of power cycles performed by the endurance test.
+ */
+#if !defined(ENDURANCE_CYCLES)
+#define ENDURANCE_CYCLES                    500
+#endif
+
+/*
+ * Maximum size of the records written by the endurance test.
+ */
+#define ENDURANCE_RECORD_MAX                64U
+
+/*
+ * Maximum number of page programs before a simulated power loss.
+ */
+#define ENDURANCE_BUDGET_MAX                128U
+
+/*
+ * Simulated flash configuration, the flash is volatile unless a backing
+ * file is specified on the command line.
+ */
+static EFlashConfig eflcfg1 = {
+  .path             = NULL
+};
+
+const MFSConfig mfscfg1 = {
+  .flashp           = (BaseFlash *)&EFLD1,
+  .erased           = 0xFFFFFFFFU,
+  .bank_size        = 4096U,
+  .bank0_start      = 0U,
+  .bank0_sectors    = 1U,
+  .bank1_start      = 1U,
+  .bank1_sectors    = 1U
+};
+
+/*
+ * Expected state of each record, a zero size means erased.
+ */
+typedef struct {
+  size_t        size;
+  uint8_t       seed;
+} shadow_t;
+
+static shadow_t shadow[MFS_CFG_MAX_RECORDS + 1];
+static uint8_t endurance_buffer[ENDURANCE_RECORD_MAX];
+
+static void fill(uint8_t *p, size_t n, uint8_t seed) {
+
+  while (n > 0U) {
+    *p++ = seed;
+    seed = (uint8_t)(seed * 5U + 1U);
+    n--;
+  }
+}
+
+static bool matches(mfs_id_t id, const shadow_t *sp) {
+  static uint8_t expected[ENDURANCE_RECORD_MAX];
+  size_t size = sizeof endurance_buffer;
+  mfs_error_t err;
+
+  err = mfsReadRecord(&mfs1, id, &size, endurance_buffer);
+  if (sp->size == 0U) {
+    return err == MFS_ERR_NOT_FOUND;
+  }
+  if ((err != MFS_NO_ERROR) || (size != sp->size)) {
+    return false;
+  }
+  fill(expected, size, sp->seed);
+  return memcmp(expected, endurance_buffer, size) == 0;
+}
+
+/*
+ * Writes and erases random records until a power loss is injected, then
+ * power cycles the flash and checks that each record holds either the
+ * last committed state or, for the record being written, the new state.
+ */
+static bool endurance(void) {
+  unsigned cycle;
+  uint32_t ops = 0U;
+  flash_sector_t i;
+
+  mfsObjectInit(&mfs1);
+  if (MFS_IS_ERROR(mfsStart(&mfs1, &mfscfg1)) ||
+      MFS_IS_ERROR(mfsErase(&mfs1))) {
+    printf("Endurance: mount failed\n");
+    return false;
+  }
+  memset(shadow, 0, sizeof shadow);
+  efl_lld_reset_counters(&EFLD1);
+  srand(1);
+
+  for (cycle = 0U; cycle < ENDURANCE_CYCLES; cycle++) {
+    shadow_t next;
+    mfs_id_t id, pending;
+    mfs_error_t err;
+
+    efl_lld_set_power_loss(&EFLD1,
+                           1U + ((uint32_t)rand() % ENDURANCE_BUDGET_MAX));
+
+    /* Random operations until the power is lost.*/
+    do {
+      pending = 1U + (mfs_id_t)((unsigned)rand() % MFS_CFG_MAX_RECORDS);
+      if ((rand() % 4) == 0) {
+        next.size = 0U;
+        next.seed = 0U;
+        err = mfsEraseRecord(&mfs1, pending);
+        if (err == MFS_ERR_NOT_FOUND) {
+          err = MFS_NO_ERROR;
+        }
+      }
+      else {
+        next.size = 1U + ((size_t)rand() % ENDURANCE_RECORD_MAX);
+        next.seed = (uint8_t)rand();
+        fill(endurance_buffer, next.size, next.seed);
+        err = mfsWriteRecord(&mfs1, pending, next.size, endurance_buffer);
+      }
+      if (err == MFS_NO_ERROR) {
+        shadow[pending] = next;
+        ops++;
+      }
+    } while (err == MFS_NO_ERROR);
+
+    /* Power cycle and remount.*/
+    mfsStop(&mfs1);
+    eflStop(&EFLD1);
+    eflStart(&EFLD1, &eflcfg1);
+    if (MFS_IS_ERROR(mfsStart(&mfs1, &mfscfg1))) {
+      printf("Endurance: mount failed at cycle %u\n", cycle);
+      return false;
+    }
+
+    /* Consistency check.*/
+    for (id = 1U; id <= MFS_CFG_MAX_RECORDS; id++) {
+      if (matches(id, &shadow[id])) {
+        continue;
+      }
+      if ((id == pending) && matches(id, &next)) {
+        shadow[id] = next;
+        continue;
+      }
+      printf("Endurance: record %u corrupted at cycle %u\n",
+             (unsigned)id, cycle);
+      return false;
+    }
+  }
+
+  mfsStop(&mfs1);
+
+  printf("Endurance: %u power losses, %u committed operations\n",
+         (unsigned)ENDURANCE_CYCLES, (unsigned)ops);
+  printf("Endurance: %u programmed pages, %llu read bytes\n",
+         (unsigned)EFLD1.programmed_pages,
+         (unsigned long long)EFLD1.read_bytes);
+  printf("Endurance: erase cycles per sector:");
+  for (i = 0U; i < SIM_EFL_SECTORS_COUNT; i++) {
+    printf(" %u", (unsigned)EFLD1.erase_cycles[i]);
+  }
+  printf("\n");
+
+  return true;
+}
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+
+  /* Optional backing file for the simulated flash.*/
+  if (argc > 1) {
+    eflcfg1.path = argv[1];
+  }
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  /* Starting EFL driver.*/
+  eflStart(&EFLD1, &eflcfg1);
+
+  test_execute((BaseSequentialStream *)&CD1, &mfs_test_suite);
+  if (!endurance() || chtest.global_fail)
+    exit(1);
+  else
+    exit(0);
+}
@@ -0,0 +1,39 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef MCUCONF_H
+#define MCUCONF_H
+
+/*
+ * Simulated flash settings, geometry of a small serial NOR device.
+ */
+#if !defined(SIM_EFL_SECTOR_SIZE)
+#define SIM_EFL_SECTOR_SIZE                 4096U
+#endif
+#if !defined(SIM_EFL_SECTORS_COUNT)
+#define SIM_EFL_SECTORS_COUNT               2U
+#endif
+#if !defined(SIM_EFL_PAGE_SIZE)
+#define SIM_EFL_PAGE_SIZE                   256U
+#endif
+#if !defined(SIM_EFL_PROGRAM_TIME_US)
+#define SIM_EFL_PROGRAM_TIME_US             0U
+#endif
+#if !defined(SIM_EFL_ERASE_TIME_MS)
+#define SIM_EFL_ERASE_TIME_MS               0U
+#endif
+
+#endif /* MCUCONF_H */
@@ -41,6 +41,7 @@
  * - @subpage nil_test_008_005
  * - @subpage nil_test_008_006
  * - @subpage nil_test_008_007
+ * - @subpage nil_test_008_008
  * .
  */
 
@@ -49,7 +50,9 @@
  ****************************************************************************/
 
 #if CH_CFG_USE_SEMAPHORES || defined(__DOXYGEN__)
-static semaphore_t sem1;
+static semaphore_t sem1, sem2;
+static THD_WORKING_AREA(wa_bmk[CH_CFG_MAX_THREADS], 128);
+static thread_t *bmk_threads[CH_CFG_MAX_THREADS];
 #endif
 #if CH_CFG_USE_MUTEXES || defined(__DOXYGEN__)
 static mutex_t mtx1;
@@ -104,6 +107,23 @@ static THD_FUNCTION(bmk_thread4, p) {
   chSysUnlock();
 }
 
+#if CH_CFG_USE_SEMAPHORES || defined(__DOXYGEN__)
+static THD_FUNCTION(bmk_thread5, p) {
+
+  (void)p;
+  while (chSemWait(&sem1) == MSG_OK) {
+  }
+}
+
+static THD_FUNCTION(bmk_thread6, p) {
+
+  /* Threads in even slots wait with a timeout in order to have the tick
+     handler processing them.*/
+  (void)chSemWaitTimeout(&sem2, (((uintptr_t)p & 1U) == 0U) ?
+                                TIME_MAX_INTERVAL : TIME_INFINITE);
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -309,6 +329,9 @@ static void nil_test_008_003_execute(void) {
       chSchWakeupS(tp, MSG_OK);
       chSysUnlock();
       n += 4;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
     } while (chVTIsSystemTimeWithinX(start, end));
   }
   test_end_step(2);
@@ -382,6 +405,9 @@ static void nil_test_008_004_execute(void) {
     do {
       chThdWait(chThdCreate(&td));
       n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
     } while (chVTIsSystemTimeWithinX(start, end));
   }
   test_end_step(1);
@@ -446,6 +472,9 @@ static void nil_test_008_005_execute(void) {
     do {
       chThdWait(chThdCreate(&td));
       n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
     } while (chVTIsSystemTimeWithinX(start, end));
   }
   test_end_step(1);
@@ -629,6 +658,138 @@ static const testcase_t nil_test_008_007 = {
   nil_test_008_007_execute
 };
 
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page nil_test_008_008 [8.8] Semaphores wakeup performance
+ *
+ * <h2>Description</h2>
+ * A thread is started at a higher priority than the current one and
+ * waits on a semaphore, all the other free slots of the threads table
+ * are filled with threads waiting on a second semaphore, half of them
+ * with a timeout. The first semaphore is signaled in a one second time
+ * window and the number of wakeups is printed on the output log. The
+ * score depends on CH_CFG_MAX_THREADS and CH_CFG_USE_WAIT_BITMAPS.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_SEMAPHORES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.8.1] The waiter thread is started at a higher priority than the
+ *   current thread.
+ * - [8.8.2] The free slots of the threads table are filled with threads
+ *   waiting on the second semaphore.
+ * - [8.8.3] The number of wakeups is counted in a one second time
+ *   window.
+ * - [8.8.4] Score is printed.
+ * - [8.8.5] The threads are terminated.
+ * .
+ */
+
+static void nil_test_008_008_setup(void) {
+  chSemObjectInit(&sem1, 0);
+  chSemObjectInit(&sem2, 0);
+}
+
+static void nil_test_008_008_execute(void) {
+  uint32_t n;
+  thread_t *tp;
+  tprio_t prio;
+
+  /* [8.8.1] The waiter thread is started at a higher priority than the
+     current thread.*/
+  test_set_step(1);
+  {
+    thread_descriptor_t td = {
+      .name  = "waiter",
+      .wbase = wa_common,
+      .wend  = THD_WORKING_AREA_END(wa_common),
+      .prio  = chThdGetPriorityX() - 1,
+      .funcp = bmk_thread5,
+      .arg   = NULL
+    };
+    tp = chThdCreate(&td);
+  }
+  test_end_step(1);
+
+  /* [8.8.2] The free slots of the threads table are filled with threads
+     waiting on the second semaphore.*/
+  test_set_step(2);
+  {
+    for (prio = 0; prio < CH_CFG_MAX_THREADS; prio++) {
+      bmk_threads[prio] = NULL;
+      if (NIL_THD_IS_WTSTART(&nil.threads[prio]) ||
+          NIL_THD_IS_FINAL(&nil.threads[prio])) {
+        thread_descriptor_t td = {
+          .name  = "sleeper",
+          .wbase = wa_bmk[prio],
+          .wend  = THD_WORKING_AREA_END(wa_bmk[prio]),
+          .prio  = prio,
+          .funcp = bmk_thread6,
+          .arg   = (void *)(uintptr_t)prio
+        };
+        bmk_threads[prio] = chThdCreate(&td);
+      }
+    }
+  }
+  test_end_step(2);
+
+  /* [8.8.3] The number of wakeups is counted in a one second time
+     window.*/
+  test_set_step(3);
+  {
+    systime_t start, end;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chSemSignal(&sem1);
+      chSemSignal(&sem1);
+      chSemSignal(&sem1);
+      chSemSignal(&sem1);
+      n += 4;
+    #if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+    #endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(3);
+
+  /* [8.8.4] Score is printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" wakeups/S");
+  }
+  test_end_step(4);
+
+  /* [8.8.5] The threads are terminated.*/
+  test_set_step(5);
+  {
+    chSemReset(&sem2, 0);
+    chSemReset(&sem1, 0);
+    for (prio = 0; prio < CH_CFG_MAX_THREADS; prio++) {
+      if (bmk_threads[prio] != NULL) {
+        chThdWait(bmk_threads[prio]);
+      }
+    }
+    chThdWait(tp);
+  }
+  test_end_step(5);
+}
+
+static const testcase_t nil_test_008_008 = {
+  "Semaphores wakeup performance",
+  nil_test_008_008_setup,
+  NULL,
+  nil_test_008_008_execute
+};
+#endif /* CH_CFG_USE_SEMAPHORES == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -650,6 +811,9 @@ const testcase_t * const nil_test_sequence_008_array[] = {
   &nil_test_008_006,
 #endif
   &nil_test_008_007,
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
+  &nil_test_008_008,
+#endif
   NULL
 };
 
@@ -58,6 +58,22 @@
 #define CH_CFG_AUTOSTART_THREADS            TRUE
 #endif
 
+/**
+ * @brief   Waiters and timeouts bitmaps.
+ * @details If enabled then each threads queue keeps a bitmap of its waiting
+ *          threads and the kernel keeps a bitmap of the threads having an
+ *          armed timeout, dequeue operations and the system tick processing
+ *          do not need to scan the whole threads array.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Each threads queue and semaphore is enlarged by one bitmap word,
+ *          one byte up to 8 threads.
+ * @note    When enabled @p CH_CFG_MAX_THREADS can be raised up to 32.
+ */
+#if !defined(CH_CFG_USE_WAIT_BITMAPS)
+#define CH_CFG_USE_WAIT_BITMAPS             TRUE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -0,0 +1,69 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdlib.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "nil_test_root.h"
+#include "console.h"
+
+/*
+ * Tester thread, the test suite creates threads at one priority level
+ * above and below this one so it cannot be placed in the first or last
+ * slot of the threads table.
+ */
+static THD_WORKING_AREA(waTester, 8192);
+static THD_FUNCTION(Tester, arg) {
+
+  (void)arg;
+
+  test_execute((BaseSequentialStream *)&CD1, &nil_test_suite);
+  if (chtest.global_fail)
+    exit(1);
+  else
+    exit(0);
+}
+
+/*
+ * Threads creation table, one entry per thread.
+ */
+THD_TABLE_BEGIN
+  THD_TABLE_THREAD(CH_CFG_MAX_THREADS - 2, "tester", waTester, Tester, NULL)
+THD_TABLE_END
+
+/*
+ * Simulator main.
+ */
+int main(void) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  /* This is now the idle thread loop, the simulated interrupts are served
+     while waiting.*/
+  while (true) {
+    port_wait_for_interrupt();
+  }
+}
@@ -180,6 +180,9 @@ static void oslib_test_001_003_execute(void) {
     test_print("--- CH_CFG_USE_PIPES:                   ");
     test_printn(CH_CFG_USE_PIPES);
     test_println("");
+    test_print("--- CH_CFG_USE_RINGS:                   ");
+    test_printn(CH_CFG_USE_RINGS);
+    test_println("");
     test_print("--- CH_CFG_USE_OBJ_CACHES:              ");
     test_printn(CH_CFG_USE_OBJ_CACHES);
     test_println("");
@@ -39,6 +39,7 @@
  * - @subpage oslib_test_002_001
  * - @subpage oslib_test_002_002
  * - @subpage oslib_test_002_003
+ * - @subpage oslib_test_002_004
  * .
  */
 
@@ -53,6 +54,11 @@
 static msg_t mb_buffer[MB_SIZE];
 static MAILBOX_DECL(mb1, mb_buffer, MB_SIZE);
 
+#define PMB_SIZE 8
+
+static pmb_entry_t pmb_buffer[PMB_SIZE];
+static prio_mailbox_t pmb1;
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -410,6 +416,123 @@ static const testcase_t oslib_test_002_003 = {
   oslib_test_002_003_execute
 };
 
+/**
+ * @page oslib_test_002_004 [2.4] Priority mailbox
+ *
+ * <h2>Description</h2>
+ * The priority mailbox is tested with both orderings, messages are
+ * expected to be fetched in key order and in posting order for equal
+ * keys.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.4.1] Filling a priority ordered mailbox, one more post is
+ *   expected to fail.
+ * - [2.4.2] Emptying the mailbox, messages are expected in priority
+ *   order.
+ * - [2.4.3] Posting to a deadline ordered mailbox with deadlines
+ *   crossing the system time wrap-around, messages are expected in
+ *   deadline order.
+ * - [2.4.4] Testing the behavior of API when the mailbox is in reset
+ *   state then return in active state.
+ * .
+ */
+
+static void oslib_test_002_004_execute(void) {
+  msg_t msg1, msg2;
+  unsigned i;
+
+  /* [2.4.1] Filling a priority ordered mailbox, one more post is
+     expected to fail.*/
+  test_set_step(1);
+  {
+    static const systime_t keys[PMB_SIZE] = {1, 3, 2, 3, 1, 0, 2, 3};
+    size_t n;
+
+    chPMBObjectInit(&pmb1, pmb_buffer, PMB_SIZE, PMB_ORDER_PRIORITY);
+    for (i = 0; i < PMB_SIZE; i++) {
+      msg1 = chPMBPostTimeout(&pmb1, (msg_t)('A' + i), keys[i],
+                              TIME_INFINITE);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    }
+    chSysLock();
+    msg1 = chPMBPostI(&pmb1, 'X', 3);
+    n = chPMBGetFreeCountI(&pmb1);
+    chSysUnlock();
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    test_assert(n == 0U, "still empty slots");
+  }
+  test_end_step(1);
+
+  /* [2.4.2] Emptying the mailbox, messages are expected in priority
+     order.*/
+  test_set_step(2);
+  {
+    chSysLock();
+    msg1 = chPMBPeekI(&pmb1);
+    chSysUnlock();
+    test_assert(msg1 == 'B', "wrong peeked message");
+    for (i = 0; i < PMB_SIZE; i++) {
+      msg1 = chPMBFetchTimeout(&pmb1, &msg2, TIME_INFINITE);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+      test_emit_token((char)msg2);
+    }
+    test_assert_sequence("BDHCGAEF", "wrong get sequence");
+    msg1 = chPMBFetchTimeout(&pmb1, &msg2, TIME_IMMEDIATE);
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+  }
+  test_end_step(2);
+
+  /* [2.4.3] Posting to a deadline ordered mailbox with deadlines
+     crossing the system time wrap-around, messages are expected in
+     deadline order.*/
+  test_set_step(3);
+  {
+    systime_t base = (systime_t)-5;
+
+    chPMBObjectInit(&pmb1, pmb_buffer, PMB_SIZE, PMB_ORDER_DEADLINE);
+    chSysLock();
+    (void) chPMBPostI(&pmb1, 'A', base + 10);
+    (void) chPMBPostI(&pmb1, 'B', base + 2);
+    (void) chPMBPostI(&pmb1, 'C', base + 7);
+    (void) chPMBPostI(&pmb1, 'D', base + 2);
+    chSysUnlock();
+    for (i = 0; i < 4; i++) {
+      chSysLock();
+      msg1 = chPMBFetchI(&pmb1, &msg2);
+      chSysUnlock();
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+      test_emit_token((char)msg2);
+    }
+    test_assert_sequence("BDCA", "wrong get sequence");
+  }
+  test_end_step(3);
+
+  /* [2.4.4] Testing the behavior of API when the mailbox is in reset
+     state then return in active state.*/
+  test_set_step(4);
+  {
+    (void) chPMBPostTimeout(&pmb1, 'A', 0, TIME_INFINITE);
+    chPMBReset(&pmb1);
+    msg1 = chPMBPostTimeout(&pmb1, 'A', 0, TIME_INFINITE);
+    test_assert(msg1 == MSG_RESET, "not in reset state");
+    msg1 = chPMBFetchTimeout(&pmb1, &msg2, TIME_INFINITE);
+    test_assert(msg1 == MSG_RESET, "not in reset state");
+    chPMBResumeX(&pmb1);
+    msg1 = chPMBPostTimeout(&pmb1, 'A', 0, TIME_INFINITE);
+    test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    msg1 = chPMBFetchTimeout(&pmb1, &msg2, TIME_INFINITE);
+    test_assert((msg1 == MSG_OK) && (msg2 == 'A'), "wrong message");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_002_004 = {
+  "Priority mailbox",
+  NULL,
+  NULL,
+  oslib_test_002_004_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -421,6 +544,7 @@ const testcase_t * const oslib_test_sequence_002_array[] = {
   &oslib_test_002_001,
   &oslib_test_002_002,
   &oslib_test_002_003,
+  &oslib_test_002_004,
   NULL
 };
 
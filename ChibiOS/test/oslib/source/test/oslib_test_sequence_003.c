@@ -38,6 +38,7 @@
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_003_001
  * - @subpage oslib_test_003_002
+ * - @subpage oslib_test_003_003
  * .
  */
 
@@ -356,6 +357,141 @@ static const testcase_t oslib_test_003_002 = {
   oslib_test_003_002_execute
 };
 
+/**
+ * @page oslib_test_003_003 [3.3] Pipes loan API
+ *
+ * <h2>Description</h2>
+ * The zero-copy API is tested by loaning free space and queued data
+ * spans, spans crossing the buffer boundary are also tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.3.1] Loaning the whole free space of an empty pipe.
+ * - [3.3.2] Loaning queued data and consuming part of it.
+ * - [3.3.3] Loaning free space wrapping buffer boundary.
+ * - [3.3.4] Loaning free space of a full pipe, must fail.
+ * - [3.3.5] Loaning queued data wrapping buffer boundary.
+ * - [3.3.6] Loaning queued data of an empty pipe, must fail.
+ * .
+ */
+
+static void oslib_test_003_003_setup(void) {
+  chPipeObjectInit(&pipe1, buffer, PIPE_SIZE);
+}
+
+static void oslib_test_003_003_execute(void) {
+
+  /* [3.3.1] Loaning the whole free space of an empty pipe.*/
+  test_set_step(1);
+  {
+    size_t n;
+    pipe_span_t span;
+
+    n = chPipeAcquireWriteSpan(&pipe1, &span, 1, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE, "wrong size");
+    test_assert((span.ptr1 == pipe1.buffer) && (span.n1 == PIPE_SIZE) &&
+                (span.n2 == 0),
+                "invalid span");
+    memcpy(span.ptr1, pipe_pattern, 10);
+    chPipeCommitWrite(&pipe1, 10);
+    test_assert((pipe1.rdptr == pipe1.buffer) &&
+                (pipe1.wrptr == pipe1.buffer + 10) &&
+                (pipe1.cnt == 10),
+                "invalid pipe state");
+  }
+  test_end_step(1);
+
+  /* [3.3.2] Loaning queued data and consuming part of it.*/
+  test_set_step(2);
+  {
+    size_t n;
+    pipe_span_t span;
+
+    n = chPipeAcquireReadSpan(&pipe1, &span, 4, TIME_IMMEDIATE);
+    test_assert(n == 10, "wrong size");
+    test_assert((span.ptr1 == pipe1.buffer) && (span.n1 == 10) &&
+                (span.n2 == 0),
+                "invalid span");
+    test_assert(memcmp(pipe_pattern, span.ptr1, 10) == 0, "content mismatch");
+    chPipeReleaseRead(&pipe1, 6);
+    test_assert((pipe1.rdptr == pipe1.buffer + 6) &&
+                (pipe1.wrptr == pipe1.buffer + 10) &&
+                (pipe1.cnt == 4),
+                "invalid pipe state");
+  }
+  test_end_step(2);
+
+  /* [3.3.3] Loaning free space wrapping buffer boundary.*/
+  test_set_step(3);
+  {
+    size_t n;
+    pipe_span_t span;
+
+    n = chPipeAcquireWriteSpan(&pipe1, &span, PIPE_SIZE - 4, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE - 4, "wrong size");
+    test_assert((span.ptr1 == pipe1.buffer + 10) && (span.n1 == 6) &&
+                (span.ptr2 == pipe1.buffer) && (span.n2 == 6),
+                "invalid span");
+    memcpy(span.ptr1, pipe_pattern, 6);
+    memcpy(span.ptr2, pipe_pattern + 6, 6);
+    chPipeCommitWrite(&pipe1, PIPE_SIZE - 4);
+    test_assert((pipe1.rdptr == pipe1.buffer + 6) &&
+                (pipe1.wrptr == pipe1.buffer + 6) &&
+                (pipe1.cnt == PIPE_SIZE),
+                "invalid pipe state");
+  }
+  test_end_step(3);
+
+  /* [3.3.4] Loaning free space of a full pipe, must fail.*/
+  test_set_step(4);
+  {
+    size_t n;
+    pipe_span_t span;
+
+    n = chPipeAcquireWriteSpan(&pipe1, &span, 1, TIME_IMMEDIATE);
+    test_assert(n == 0, "not full");
+  }
+  test_end_step(4);
+
+  /* [3.3.5] Loaning queued data wrapping buffer boundary.*/
+  test_set_step(5);
+  {
+    size_t n;
+    pipe_span_t span;
+
+    n = chPipeAcquireReadSpan(&pipe1, &span, PIPE_SIZE, TIME_IMMEDIATE);
+    test_assert(n == PIPE_SIZE, "wrong size");
+    test_assert((span.ptr1 == pipe1.buffer + 6) && (span.n1 == PIPE_SIZE - 6) &&
+                (span.ptr2 == pipe1.buffer) && (span.n2 == 6),
+                "invalid span");
+    test_assert(memcmp(pipe_pattern + 6, span.ptr1, 4) == 0, "content mismatch");
+    test_assert(memcmp(pipe_pattern, span.ptr1 + 4, 6) == 0, "content mismatch");
+    test_assert(memcmp(pipe_pattern + 6, span.ptr2, 6) == 0, "content mismatch");
+    chPipeReleaseRead(&pipe1, PIPE_SIZE);
+    test_assert((pipe1.rdptr == pipe1.wrptr) &&
+                (pipe1.cnt == 0),
+                "invalid pipe state");
+  }
+  test_end_step(5);
+
+  /* [3.3.6] Loaning queued data of an empty pipe, must fail.*/
+  test_set_step(6);
+  {
+    size_t n;
+    pipe_span_t span;
+
+    n = chPipeAcquireReadSpan(&pipe1, &span, 1, TIME_IMMEDIATE);
+    test_assert(n == 0, "not empty");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t oslib_test_003_003 = {
+  "Pipes loan API",
+  oslib_test_003_003_setup,
+  NULL,
+  oslib_test_003_003_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -366,6 +502,7 @@ static const testcase_t oslib_test_003_002 = {
 const testcase_t * const oslib_test_sequence_003_array[] = {
   &oslib_test_003_001,
   &oslib_test_003_002,
+  &oslib_test_003_003,
   NULL
 };
 
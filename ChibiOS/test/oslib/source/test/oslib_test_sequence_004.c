@@ -37,6 +37,7 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_004_001
+ * - @subpage oslib_test_004_002
  * .
  */
 
@@ -54,7 +55,7 @@ static msg_t msg_queue[JOBS_QUEUE_SIZE];
 
 static void job_slow(void *arg) {
 
-  test_emit_token((int)arg);
+  test_emit_token((char)(uintptr_t)arg);
   chThdSleepMilliseconds(10);
 }
 
@@ -70,6 +71,58 @@ static THD_FUNCTION(Thread1, arg) {
   } while (msg == MSG_OK);
 }
 
+#define JOBS_WORKERS    2
+
+typedef struct {
+  unsigned          lo;
+  unsigned          hi;
+  unsigned          sum;
+} range_sum_t;
+
+static jobs_system_t js;
+static jobs_worker_t workers[JOBS_WORKERS];
+static job_slot_t slots[JOBS_WORKERS * JOBS_QUEUE_SIZE];
+static uint32_t jobs_mask;
+
+static void job_mark(void *arg) {
+
+  chSysLock();
+  jobs_mask |= 1U << (unsigned)(uintptr_t)arg;
+  chSysUnlock();
+}
+
+static void job_sum(void *arg) {
+  range_sum_t *rsp = (range_sum_t *)arg;
+  unsigned mid = (rsp->lo + rsp->hi) / 2U;
+  range_sum_t left = {rsp->lo, mid, 0U};
+  range_sum_t right = {mid, rsp->hi, 0U};
+  jobs_group_t grp;
+
+  if ((rsp->hi - rsp->lo) <= 8U) {
+    unsigned i;
+
+    for (i = rsp->lo; i < rsp->hi; i++) {
+      rsp->sum += i;
+    }
+    return;
+  }
+
+  chJobGroupObjectInit(&grp);
+  chJobSpawn(&js, &grp, job_sum, &left);
+  chJobSpawn(&js, &grp, job_sum, &right);
+  chJobJoin(&js, &grp);
+  rsp->sum = left.sum + right.sum;
+}
+
+static THD_FUNCTION(Thread2, arg) {
+  jobs_worker_t *jwp = (jobs_worker_t *)arg;
+  msg_t msg;
+
+  do {
+    msg = chJobWorkerDispatch(&js, jwp);
+  } while (msg == MSG_OK);
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -132,7 +185,7 @@ static void oslib_test_004_001_execute(void) {
     for (i = 0; i < 8; i++) {
       jdp = chJobGet(&jq);
       jdp->jobfunc = job_slow;
-      jdp->jobarg  = (void *)('a' + i);
+      jdp->jobarg  = (void *)(uintptr_t)('a' + i);
       chJobPost(&jq, jdp);
     }
   }
@@ -165,6 +218,114 @@ static const testcase_t oslib_test_004_001 = {
   oslib_test_004_001_execute
 };
 
+/**
+ * @page oslib_test_004_002 [4.2] Work-stealing system test
+ *
+ * <h2>Description</h2>
+ * The jobs system API is tested for functionality, jobs are posted to
+ * two workers and a sum is computed by splitting it in jobs spawned and
+ * joined recursively.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.2.1] Initializing the Jobs System object.
+ * - [4.2.2] Starting the worker threads.
+ * - [4.2.3] Posting more jobs than available job objects.
+ * - [4.2.4] Computing a sum using spawned and joined jobs.
+ * - [4.2.5] Sending two null jobs to make threads exit.
+ * .
+ */
+
+static void oslib_test_004_002_execute(void) {
+  thread_t *tp1, *tp2;
+
+  /* [4.2.1] Initializing the Jobs System object.*/
+  test_set_step(1);
+  {
+    chJobSystemObjectInit(&js, JOBS_QUEUE_SIZE, jobs,
+                          JOBS_WORKERS, workers, slots);
+    jobs_mask = 0U;
+  }
+  test_end_step(1);
+
+  /* [4.2.2] Starting the worker threads.*/
+  test_set_step(2);
+  {
+    thread_descriptor_t td1 = {
+      .name  = "worker1",
+      .wbase = wa1Thread1,
+      .wend  = THD_WORKING_AREA_END(wa1Thread1),
+      .prio  = chThdGetPriorityX() - 1,
+      .funcp = Thread2,
+      .arg   = (void *)&workers[0]
+    };
+    tp1 = chThdCreate(&td1);
+
+    thread_descriptor_t td2 = {
+      .name  = "worker2",
+      .wbase = wa2Thread1,
+      .wend  = THD_WORKING_AREA_END(wa2Thread1),
+      .prio  = chThdGetPriorityX() - 2,
+      .funcp = Thread2,
+      .arg   = (void *)&workers[1]
+    };
+    tp2 = chThdCreate(&td2);
+  }
+  test_end_step(2);
+
+  /* [4.2.3] Posting more jobs than available job objects.*/
+  test_set_step(3);
+  {
+    unsigned i;
+    job_descriptor_t *jdp;
+
+    for (i = 0; i < 16; i++) {
+      jdp = chJobSystemGet(&js);
+      jdp->jobfunc = job_mark;
+      jdp->jobarg  = (void *)(uintptr_t)i;
+      chJobSystemPost(&js, jdp);
+    }
+  }
+  test_end_step(3);
+
+  /* [4.2.4] Computing a sum using spawned and joined jobs.*/
+  test_set_step(4);
+  {
+    range_sum_t rs = {0U, 64U, 0U};
+
+    job_sum(&rs);
+    test_assert(rs.sum == (64U * 63U) / 2U, "wrong sum");
+  }
+  test_end_step(4);
+
+  /* [4.2.5] Sending two null jobs to make threads exit.*/
+  test_set_step(5);
+  {
+    job_descriptor_t *jdp;
+
+    jdp = chJobSystemGet(&js);
+    jdp->jobfunc = NULL;
+    jdp->jobarg  = NULL;
+    chJobSystemPost(&js, jdp);
+    jdp = chJobSystemGet(&js);
+    jdp->jobfunc = NULL;
+    jdp->jobarg  = NULL;
+    chJobSystemPost(&js, jdp);
+    (void) chThdWait(tp1);
+    (void) chThdWait(tp2);
+    test_assert(jobs_mask == 0xFFFFU, "jobs not executed");
+    test_assert(workers[0].executed + workers[1].executed >= 16U,
+                "wrong executed count");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t oslib_test_004_002 = {
+  "Work-stealing system test",
+  NULL,
+  NULL,
+  oslib_test_004_002_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -174,6 +335,7 @@ static const testcase_t oslib_test_004_001 = {
  */
 const testcase_t * const oslib_test_sequence_004_array[] = {
   &oslib_test_004_001,
+  &oslib_test_004_002,
   NULL
 };
 
@@ -37,6 +37,7 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_006_001
+ * - @subpage oslib_test_006_002
  * .
  */
 
@@ -80,11 +81,13 @@ static bool obj_read(objects_cache_t *ocp,
 static bool obj_write(objects_cache_t *ocp,
                       oc_object_t *objp,
                       bool async) {
-  (void)ocp;
-  (void)async;
 
   test_emit_token('A' + objp->obj_key);
 
+  if (async) {
+    chCacheReleaseObject(ocp, objp);
+  }
+
   return false;
 }
 
@@ -243,6 +246,155 @@ static const testcase_t oslib_test_006_001 = {
   oslib_test_006_001_execute
 };
 
+/**
+ * @page oslib_test_006_002 [6.2] Read-ahead and write-back
+ *
+ * <h2>Description</h2>
+ * Sequential accesses are tested to trigger read-ahead, eviction is
+ * tested to prefer clean objects and dirty objects are written back,
+ * statistics counters are checked.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.2.1] Sequential reads with a read-ahead window of two objects,
+ *   objects following the accessed ones are read in advance.
+ * - [6.2.2] Eviction with a dirty object in cache, clean objects are
+ *   evicted and the dirty object is written back later.
+ * - [6.2.3] Eviction with only dirty objects in cache, the oldest
+ *   object is written and then evicted.
+ * .
+ */
+
+static void oslib_test_006_002_execute(void) {
+
+  /* [6.2.1] Sequential reads with a read-ahead window of two objects,
+     objects following the accessed ones are read in advance.*/
+  test_set_step(1);
+  {
+    uint32_t i;
+    oc_stats_t stats;
+
+    chCacheObjectInit(&cache1,
+                      NUM_HASH_ENTRIES,
+                      hash_headers,
+                      NUM_OBJECTS,
+                      sizeof (cached_object_t),
+                      objects,
+                      obj_read,
+                      obj_write);
+    chCacheSetReadAhead(&cache1, 2);
+
+    for (i = 0; i < (NUM_OBJECTS * 2); i++) {
+      oc_object_t *objp = chCacheGetObject(&cache1, 0U, i);
+
+      if ((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U) {
+        bool error = chCacheReadObject(&cache1, objp, false);
+
+        test_assert(error == false, "returned error");
+      }
+      test_assert((objp->obj_flags & OC_FLAG_NOTSYNC) == 0U, "not in sync");
+
+      chCacheReleaseObject(&cache1, objp);
+    }
+
+    test_assert_sequence("abcdefghij", "unexpected tokens");
+    chCacheGetStatistics(&cache1, &stats);
+    test_assert(stats.hits == 5, "wrong hits");
+    test_assert(stats.misses == 3, "wrong misses");
+    test_assert(stats.readaheads == 7, "wrong read-aheads");
+    test_assert(stats.evictions == 6, "wrong evictions");
+  }
+  test_end_step(1);
+
+  /* [6.2.2] Eviction with a dirty object in cache, clean objects are
+     evicted and the dirty object is written back later.*/
+  test_set_step(2);
+  {
+    uint32_t i;
+    ucnt_t n;
+    oc_object_t *objp;
+    oc_stats_t stats;
+
+    chCacheObjectInit(&cache1,
+                      NUM_HASH_ENTRIES,
+                      hash_headers,
+                      NUM_OBJECTS,
+                      sizeof (cached_object_t),
+                      objects,
+                      obj_read,
+                      obj_write);
+
+    objp = chCacheGetObject(&cache1, 0U, 0U);
+    objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+    objp->obj_flags |= OC_FLAG_LAZYWRITE;
+    chCacheReleaseObject(&cache1, objp);
+
+    for (i = 2; i < (NUM_OBJECTS * 4); i += 2) {
+      objp = chCacheGetObject(&cache1, 0U, i);
+      (void) chCacheReadObject(&cache1, objp, false);
+      chCacheReleaseObject(&cache1, objp);
+    }
+    test_assert_sequence("cegikmo", "unexpected tokens");
+
+    objp = chCacheGetObject(&cache1, 0U, 0U);
+    test_assert((objp->obj_flags & OC_FLAG_NOTSYNC) == 0U, "not in sync");
+    test_assert((objp->obj_flags & OC_FLAG_LAZYWRITE) != 0U, "not dirty");
+    chCacheReleaseObject(&cache1, objp);
+
+    n = chCacheWriteBack(&cache1, NUM_OBJECTS);
+    test_assert(n == 1, "wrong number of written objects");
+    test_assert_sequence("A", "unexpected tokens");
+    n = chCacheWriteBack(&cache1, NUM_OBJECTS);
+    test_assert(n == 0, "dirty objects in cache");
+
+    chCacheGetStatistics(&cache1, &stats);
+    test_assert(stats.dirty_evictions == 0, "dirty object evicted");
+    test_assert(stats.writebacks == 1, "wrong write-backs");
+  }
+  test_end_step(2);
+
+  /* [6.2.3] Eviction with only dirty objects in cache, the oldest
+     object is written and then evicted.*/
+  test_set_step(3);
+  {
+    uint32_t i;
+    oc_object_t *objp;
+    oc_stats_t stats;
+
+    chCacheObjectInit(&cache1,
+                      NUM_HASH_ENTRIES,
+                      hash_headers,
+                      NUM_OBJECTS,
+                      sizeof (cached_object_t),
+                      objects,
+                      obj_read,
+                      obj_write);
+
+    for (i = 0; i < NUM_OBJECTS; i++) {
+      objp = chCacheGetObject(&cache1, 0U, i);
+      objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+      objp->obj_flags |= OC_FLAG_LAZYWRITE;
+      chCacheReleaseObject(&cache1, objp);
+    }
+
+    objp = chCacheGetObject(&cache1, 0U, NUM_OBJECTS);
+    test_assert((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U, "in sync");
+    chCacheReleaseObject(&cache1, objp);
+    test_assert_sequence("A", "unexpected tokens");
+
+    chCacheGetStatistics(&cache1, &stats);
+    test_assert(stats.dirty_evictions == 1, "wrong dirty evictions");
+    test_assert(stats.evictions == 1, "wrong evictions");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_006_002 = {
+  "Read-ahead and write-back",
+  NULL,
+  NULL,
+  oslib_test_006_002_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -252,6 +404,7 @@ static const testcase_t oslib_test_006_001 = {
  */
 const testcase_t * const oslib_test_sequence_006_array[] = {
   &oslib_test_006_001,
+  &oslib_test_006_002,
   NULL
 };
 
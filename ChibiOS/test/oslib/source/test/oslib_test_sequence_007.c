@@ -39,6 +39,10 @@
  * - @subpage oslib_test_007_001
  * - @subpage oslib_test_007_002
  * - @subpage oslib_test_007_003
+ * - @subpage oslib_test_007_004
+ * - @subpage oslib_test_007_005
+ * - @subpage oslib_test_007_006
+ * - @subpage oslib_test_007_007
  * .
  */
 
@@ -50,11 +54,11 @@
 
 #define MEMORY_POOL_SIZE 4
 
-static uint32_t objects[MEMORY_POOL_SIZE];
-static MEMORYPOOL_DECL(mp1, sizeof (uint32_t), PORT_NATURAL_ALIGN, NULL);
+static void *objects[MEMORY_POOL_SIZE];
+static MEMORYPOOL_DECL(mp1, sizeof (void *), PORT_NATURAL_ALIGN, NULL);
 
 #if CH_CFG_USE_SEMAPHORES
-static GUARDEDMEMORYPOOL_DECL(gmp1, sizeof (uint32_t), PORT_NATURAL_ALIGN);
+static GUARDEDMEMORYPOOL_DECL(gmp1, sizeof (void *), PORT_NATURAL_ALIGN);
 #endif
 
 static void *null_provider(size_t size, unsigned align) {
@@ -65,6 +69,45 @@ static void *null_provider(size_t size, unsigned align) {
   return NULL;
 }
 
+#if CH_CFG_USE_POOL_MAGAZINES == TRUE
+#define MAGAZINE_SIZE 3
+
+static pool_magazine_t pm1;
+static void *magazine[MAGAZINE_SIZE];
+
+static systime_t magazine_wait_tick(void) {
+
+  chThdSleep((sysinterval_t)1);
+  return chVTGetSystemTimeX();
+}
+#endif
+
+#if (CH_CFG_USE_POOL_MAGAZINES == TRUE) && (CH_CFG_USE_OBJ_FIFOS == TRUE)
+static objects_fifo_t of1;
+static msg_t of1_msgs[MEMORY_POOL_SIZE];
+static void *of1_objects[MEMORY_POOL_SIZE];
+static void *of1_magazine[MEMORY_POOL_SIZE];
+
+static THD_WORKING_AREA(waConsumer, 256);
+static THD_FUNCTION(Consumer, arg) {
+  pool_magazine_t pm;
+  void *objp;
+  unsigned i;
+
+  (void)arg;
+
+  /* The magazine can hold all the FIFO objects.*/
+  chFifoMagazineObjectInit(&pm, &of1, of1_magazine, MEMORY_POOL_SIZE);
+  for (i = 0; i < MEMORY_POOL_SIZE * 2; i++) {
+    if (chFifoReceiveObjectTimeout(&of1, &objp, TIME_MS2I(1000)) != MSG_OK) {
+      break;
+    }
+    chPoolMagazineFree(&pm, objp);
+  }
+  chPoolMagazineFlush(&pm);
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -89,7 +132,7 @@ static void *null_provider(size_t size, unsigned align) {
  */
 
 static void oslib_test_007_001_setup(void) {
-  chPoolObjectInit(&mp1, sizeof (uint32_t), NULL);
+  chPoolObjectInit(&mp1, sizeof (void *), NULL);
 }
 
 static void oslib_test_007_001_execute(void) {
@@ -144,7 +187,7 @@ static void oslib_test_007_001_execute(void) {
      more memory.*/
   test_set_step(7);
   {
-    chPoolObjectInit(&mp1, sizeof (uint32_t), null_provider);
+    chPoolObjectInit(&mp1, sizeof (void *), null_provider);
     test_assert(chPoolAlloc(&mp1) == NULL, "provider returned memory");
   }
   test_end_step(7);
@@ -183,7 +226,7 @@ static const testcase_t oslib_test_007_001 = {
  */
 
 static void oslib_test_007_002_setup(void) {
-  chGuardedPoolObjectInit(&gmp1, sizeof (uint32_t));
+  chGuardedPoolObjectInit(&gmp1, sizeof (void *));
 }
 
 static void oslib_test_007_002_execute(void) {
@@ -266,7 +309,7 @@ static const testcase_t oslib_test_007_002 = {
  */
 
 static void oslib_test_007_003_setup(void) {
-  chGuardedPoolObjectInit(&gmp1, sizeof (uint32_t));
+  chGuardedPoolObjectInit(&gmp1, sizeof (void *));
 }
 
 static void oslib_test_007_003_execute(void) {
@@ -288,6 +331,388 @@ static const testcase_t oslib_test_007_003 = {
 };
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
+#if (CH_CFG_USE_POOL_MAGAZINES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_007_004 [7.4] Memory Pools magazines
+ *
+ * <h2>Description</h2>
+ * The magazine functionality is tested by allocating and releasing all
+ * the pool objects through a magazine, the hits and misses counters are
+ * checked at each step.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_POOL_MAGAZINES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [7.4.1] Adding the objects to the pool using chPoolLoadArray().
+ * - [7.4.2] Allocating all objects through the magazine, allocations
+ *   must alternate between misses refilling the magazine and hits.
+ * - [7.4.3] Now must be empty, the failed allocation is a miss.
+ * - [7.4.4] Releasing the objects through the magazine, the last
+ *   release finds the magazine full and returns the oldest objects to
+ *   the pool.
+ * - [7.4.5] The most recently released object must be served first.
+ * - [7.4.6] Flushing the magazine, all objects must be back in the
+ *   pool.
+ * .
+ */
+
+static void oslib_test_007_004_setup(void) {
+  chPoolObjectInit(&mp1, sizeof (void *), NULL);
+  chPoolMagazineObjectInit(&pm1, &mp1, magazine, MAGAZINE_SIZE);
+}
+
+static void oslib_test_007_004_execute(void) {
+  unsigned i;
+  void *p[MEMORY_POOL_SIZE];
+
+  /* [7.4.1] Adding the objects to the pool using chPoolLoadArray().*/
+  test_set_step(1);
+  {
+    chPoolLoadArray(&mp1, objects, MEMORY_POOL_SIZE);
+  }
+  test_end_step(1);
+
+  /* [7.4.2] Allocating all objects through the magazine, allocations
+     must alternate between misses refilling the magazine and hits.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < MEMORY_POOL_SIZE; i++) {
+      p[i] = chPoolMagazineAllocTimeout(&pm1, TIME_IMMEDIATE);
+      test_assert(p[i] != NULL, "allocation failed");
+      test_assert(chPoolMagazineGetCountX(&pm1) == (size_t)((i + 1) & 1), "wrong count");
+    }
+    test_assert(chPoolMagazineGetHitsX(&pm1) == 2, "wrong hits");
+    test_assert(chPoolMagazineGetMissesX(&pm1) == 2, "wrong misses");
+  }
+  test_end_step(2);
+
+  /* [7.4.3] Now must be empty, the failed allocation is a miss.*/
+  test_set_step(3);
+  {
+    test_assert(chPoolMagazineAllocTimeout(&pm1, TIME_IMMEDIATE) == NULL, "list not empty");
+    test_assert(chPoolMagazineGetMissesX(&pm1) == 3, "wrong misses");
+  }
+  test_end_step(3);
+
+  /* [7.4.4] Releasing the objects through the magazine, the last
+     release finds the magazine full and returns the oldest objects to
+     the pool.*/
+  test_set_step(4);
+  {
+    for (i = 0; i < MEMORY_POOL_SIZE; i++) {
+      chPoolMagazineFree(&pm1, p[i]);
+    }
+    test_assert(chPoolMagazineGetCountX(&pm1) == 2, "wrong count");
+    test_assert(chPoolMagazineGetHitsX(&pm1) == 5, "wrong hits");
+    test_assert(chPoolMagazineGetMissesX(&pm1) == 4, "wrong misses");
+  }
+  test_end_step(4);
+
+  /* [7.4.5] The most recently released object must be served first.*/
+  test_set_step(5);
+  {
+    test_assert(chPoolMagazineAllocTimeout(&pm1, TIME_IMMEDIATE) == p[MEMORY_POOL_SIZE - 1], "not LIFO");
+    chPoolMagazineFree(&pm1, p[MEMORY_POOL_SIZE - 1]);
+  }
+  test_end_step(5);
+
+  /* [7.4.6] Flushing the magazine, all objects must be back in the
+     pool.*/
+  test_set_step(6);
+  {
+    chPoolMagazineFlush(&pm1);
+    test_assert(chPoolMagazineGetCountX(&pm1) == 0, "not empty");
+    for (i = 0; i < MEMORY_POOL_SIZE; i++) {
+      test_assert(chPoolAlloc(&mp1) != NULL, "list empty");
+    }
+    test_assert(chPoolAlloc(&mp1) == NULL, "list not empty");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t oslib_test_007_004 = {
+  "Memory Pools magazines",
+  oslib_test_007_004_setup,
+  NULL,
+  oslib_test_007_004_execute
+};
+#endif /* CH_CFG_USE_POOL_MAGAZINES == TRUE */
+
+#if ((CH_CFG_USE_POOL_MAGAZINES == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_007_005 [7.5] Guarded Memory Pools magazines
+ *
+ * <h2>Description</h2>
+ * A magazine is placed in front of a guarded memory pool, the pool
+ * semaphore counter is checked while objects are moved between the pool
+ * and the magazine.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_POOL_MAGAZINES == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [7.5.1] Adding the objects to the pool using
+ *   chGuardedPoolLoadArray().
+ * - [7.5.2] Allocating one object, the magazine is refilled and the
+ *   semaphore counter must account for both objects.
+ * - [7.5.3] Allocating the remaining objects, then a further allocation
+ *   must time out.
+ * - [7.5.4] Releasing all objects and flushing the magazine, the
+ *   semaphore counter must be back to its initial value.
+ * .
+ */
+
+static void oslib_test_007_005_setup(void) {
+  chGuardedPoolObjectInit(&gmp1, sizeof (void *));
+  chGuardedPoolMagazineObjectInit(&pm1, &gmp1, magazine, MAGAZINE_SIZE);
+}
+
+static void oslib_test_007_005_execute(void) {
+  unsigned i;
+  cnt_t cnt;
+  void *p[MEMORY_POOL_SIZE];
+
+  /* [7.5.1] Adding the objects to the pool using
+     chGuardedPoolLoadArray().*/
+  test_set_step(1);
+  {
+    chGuardedPoolLoadArray(&gmp1, objects, MEMORY_POOL_SIZE);
+  }
+  test_end_step(1);
+
+  /* [7.5.2] Allocating one object, the magazine is refilled and the
+     semaphore counter must account for both objects.*/
+  test_set_step(2);
+  {
+    p[0] = chPoolMagazineAllocTimeout(&pm1, TIME_IMMEDIATE);
+    test_assert(p[0] != NULL, "allocation failed");
+    chSysLock();
+    cnt = chGuardedPoolGetCounterI(&gmp1);
+    chSysUnlock();
+    test_assert(cnt == (cnt_t)(MEMORY_POOL_SIZE - 2), "wrong counter");
+  }
+  test_end_step(2);
+
+  /* [7.5.3] Allocating the remaining objects, then a further allocation
+     must time out.*/
+  test_set_step(3);
+  {
+    for (i = 1; i < MEMORY_POOL_SIZE; i++) {
+      p[i] = chPoolMagazineAllocTimeout(&pm1, TIME_IMMEDIATE);
+      test_assert(p[i] != NULL, "allocation failed");
+    }
+    test_assert(chPoolMagazineAllocTimeout(&pm1, TIME_MS2I(100)) == NULL, "list not empty");
+  }
+  test_end_step(3);
+
+  /* [7.5.4] Releasing all objects and flushing the magazine, the
+     semaphore counter must be back to its initial value.*/
+  test_set_step(4);
+  {
+    for (i = 0; i < MEMORY_POOL_SIZE; i++) {
+      chPoolMagazineFree(&pm1, p[i]);
+    }
+    chPoolMagazineFlush(&pm1);
+    chSysLock();
+    cnt = chGuardedPoolGetCounterI(&gmp1);
+    chSysUnlock();
+    test_assert(cnt == (cnt_t)MEMORY_POOL_SIZE, "wrong counter");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_007_005 = {
+  "Guarded Memory Pools magazines",
+  oslib_test_007_005_setup,
+  NULL,
+  oslib_test_007_005_execute
+};
+#endif /* (CH_CFG_USE_POOL_MAGAZINES == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE) */
+
+#if (CH_CFG_USE_POOL_MAGAZINES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_007_006 [7.6] Memory Pools magazines performance
+ *
+ * <h2>Description</h2>
+ * The time required by an allocation and release cycle is measured
+ * directly on a memory pool and through a magazine, the number of
+ * cycles per second is printed on the output log.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_POOL_MAGAZINES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [7.6.1] Allocating and releasing objects directly on the pool for
+ *   one second.
+ * - [7.6.2] Allocating and releasing objects through the magazine for
+ *   one second, hits and misses are printed.
+ * .
+ */
+
+static void oslib_test_007_006_setup(void) {
+  chPoolObjectInit(&mp1, sizeof (void *), NULL);
+  chPoolLoadArray(&mp1, objects, MEMORY_POOL_SIZE);
+  chPoolMagazineObjectInit(&pm1, &mp1, magazine, MAGAZINE_SIZE);
+}
+
+static void oslib_test_007_006_execute(void) {
+  systime_t start, end;
+  uint32_t n;
+
+  /* [7.6.1] Allocating and releasing objects directly on the pool for
+     one second.*/
+  test_set_step(1);
+  {
+    n = 0;
+    start = magazine_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      void *p1 = chPoolAlloc(&mp1);
+      void *p2 = chPoolAlloc(&mp1);
+      chPoolFree(&mp1, p2);
+      chPoolFree(&mp1, p1);
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    test_print("--- Pool    : ");
+    test_printn(n * 2U);
+    test_println(" allocs/S");
+  }
+  test_end_step(1);
+
+  /* [7.6.2] Allocating and releasing objects through the magazine for
+     one second, hits and misses are printed.*/
+  test_set_step(2);
+  {
+    n = 0;
+    start = magazine_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      void *p1 = chPoolMagazineAlloc(&pm1);
+      void *p2 = chPoolMagazineAlloc(&pm1);
+      chPoolMagazineFree(&pm1, p2);
+      chPoolMagazineFree(&pm1, p1);
+      n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    chPoolMagazineFlush(&pm1);
+    test_print("--- Magazine: ");
+    test_printn(n * 2U);
+    test_println(" allocs/S");
+    test_print("--- Hits    : ");
+    test_printn((uint32_t)chPoolMagazineGetHitsX(&pm1));
+    test_print(", misses: ");
+    test_printn((uint32_t)chPoolMagazineGetMissesX(&pm1));
+    test_println("");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t oslib_test_007_006 = {
+  "Memory Pools magazines performance",
+  oslib_test_007_006_setup,
+  NULL,
+  oslib_test_007_006_execute
+};
+#endif /* CH_CFG_USE_POOL_MAGAZINES == TRUE */
+
+#if ((CH_CFG_USE_POOL_MAGAZINES == TRUE) && (CH_CFG_USE_OBJ_FIFOS == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_007_007 [7.7] Objects FIFOs with a receiver magazine
+ *
+ * <h2>Description</h2>
+ * A receiver thread returns the objects taken from an objects FIFO
+ * through a magazine able to hold all the FIFO objects, the sender must
+ * never wait for the objects held in the magazine.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_POOL_MAGAZINES == TRUE) && (CH_CFG_USE_OBJ_FIFOS == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [7.7.1] Starting the receiver thread at a higher priority than the
+ *   current thread.
+ * - [7.7.2] Sending twice the number of FIFO objects, taking an object
+ *   must not time out.
+ * - [7.7.3] Waiting for the receiver thread, all the objects must be
+ *   back in the pool.
+ * .
+ */
+
+static void oslib_test_007_007_setup(void) {
+  chFifoObjectInit(&of1, sizeof (void *), MEMORY_POOL_SIZE, of1_objects, of1_msgs);
+}
+
+static void oslib_test_007_007_execute(void) {
+  thread_t *tp;
+  unsigned i;
+  cnt_t cnt;
+
+  /* [7.7.1] Starting the receiver thread at a higher priority than the
+     current thread.*/
+  test_set_step(1);
+  {
+    thread_descriptor_t td = {
+      .name  = "consumer",
+      .wbase = waConsumer,
+      .wend  = THD_WORKING_AREA_END(waConsumer),
+      .prio  = chThdGetPriorityX() + 1,
+      .funcp = Consumer,
+      .arg   = NULL
+    };
+    tp = chThdCreate(&td);
+  }
+  test_end_step(1);
+
+  /* [7.7.2] Sending twice the number of FIFO objects, taking an object
+     must not time out.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < MEMORY_POOL_SIZE * 2; i++) {
+      void *objp = chFifoTakeObjectTimeout(&of1, TIME_MS2I(100));
+      test_assert(objp != NULL, "timeout");
+      chFifoSendObject(&of1, objp);
+    }
+  }
+  test_end_step(2);
+
+  /* [7.7.3] Waiting for the receiver thread, all the objects must be
+     back in the pool.*/
+  test_set_step(3);
+  {
+    chThdWait(tp);
+    chSysLock();
+    cnt = chGuardedPoolGetCounterI(&of1.free);
+    chSysUnlock();
+    test_assert(cnt == (cnt_t)MEMORY_POOL_SIZE, "wrong counter");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_007_007 = {
+  "Objects FIFOs with a receiver magazine",
+  oslib_test_007_007_setup,
+  NULL,
+  oslib_test_007_007_execute
+};
+#endif /* (CH_CFG_USE_POOL_MAGAZINES == TRUE) && (CH_CFG_USE_OBJ_FIFOS == TRUE) */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -302,6 +727,18 @@ const testcase_t * const oslib_test_sequence_007_array[] = {
 #endif
 #if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
   &oslib_test_007_003,
+#endif
+#if (CH_CFG_USE_POOL_MAGAZINES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_007_004,
+#endif
+#if ((CH_CFG_USE_POOL_MAGAZINES == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)) || defined(__DOXYGEN__)
+  &oslib_test_007_005,
+#endif
+#if (CH_CFG_USE_POOL_MAGAZINES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_007_006,
+#endif
+#if ((CH_CFG_USE_POOL_MAGAZINES == TRUE) && (CH_CFG_USE_OBJ_FIFOS == TRUE)) || defined(__DOXYGEN__)
+  &oslib_test_007_007,
 #endif
   NULL
 };
@@ -38,6 +38,7 @@
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_008_001
  * - @subpage oslib_test_008_002
+ * - @subpage oslib_test_008_003
  * .
  */
 
@@ -53,6 +54,32 @@
 static memory_heap_t test_heap;
 static uint8_t test_heap_buffer[HEAP_SIZE];
 
+#define TRACE_HEAP_SIZE 16384
+#define TRACE_SLOTS 256
+#define TRACE_OPERATIONS 50000
+
+static CH_HEAP_AREA(trace_heap_buffer, TRACE_HEAP_SIZE);
+static void *trace_blocks[TRACE_SLOTS];
+static uint32_t trace_seed;
+
+static uint32_t trace_rand(void) {
+
+  trace_seed ^= trace_seed << 13;
+  trace_seed ^= trace_seed >> 17;
+  trace_seed ^= trace_seed << 5;
+  return trace_seed;
+}
+
+static size_t trace_size(void) {
+  uint32_t r = trace_rand();
+
+  /* Mostly small blocks with occasional large ones.*/
+  if ((r & 7U) == 0U) {
+    return (size_t)((r >> 8) % 512U) + 1U;
+  }
+  return (size_t)((r >> 8) % 48U) + 1U;
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -268,6 +295,142 @@ static const testcase_t oslib_test_008_002 = {
   oslib_test_008_002_execute
 };
 
+#if (PORT_SUPPORTS_RT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_008_003 [8.3] Randomized allocation trace
+ *
+ * <h2>Description</h2>
+ * A pseudo-random trace of allocations and releases of mixed sizes is
+ * replayed on a heap, the worst case allocation and release times and
+ * the final fragmentation are measured and printed on the output log.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - PORT_SUPPORTS_RT == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.3.1] Replaying the trace, the duration of each operation is
+ *   measured using the realtime counter.
+ * - [8.3.2] Printing the heap fragmentation at the end of the trace.
+ * - [8.3.3] Releasing all the blocks, the heap must be back to a single
+ *   free block.
+ * .
+ */
+
+static void oslib_test_008_003_setup(void) {
+  unsigned i;
+
+  chHeapObjectInit(&test_heap, trace_heap_buffer, sizeof (trace_heap_buffer));
+  for (i = 0; i < TRACE_SLOTS; i++) {
+    trace_blocks[i] = NULL;
+  }
+  trace_seed = 0x1BADB002U;
+}
+
+static void oslib_test_008_003_execute(void) {
+  size_t n, total_size, largest_size;
+
+  /* [8.3.1] Replaying the trace, the duration of each operation is
+     measured using the realtime counter.*/
+  test_set_step(1);
+  {
+    uint32_t i, allocs = 0, frees = 0, failures = 0;
+    rtcnt_t t, amax = 0, fmax = 0, asum = 0, fsum = 0;
+
+    for (i = 0; i < TRACE_OPERATIONS; i++) {
+      unsigned k = (unsigned)(trace_rand() % TRACE_SLOTS);
+
+      if (trace_blocks[k] == NULL) {
+        size_t size = trace_size();
+
+        t = chSysGetRealtimeCounterX();
+        trace_blocks[k] = chHeapAlloc(&test_heap, size);
+        t = chSysGetRealtimeCounterX() - t;
+        if (trace_blocks[k] == NULL) {
+          failures++;
+        }
+        else {
+          allocs++;
+        }
+        asum += t;
+        if (t > amax) {
+          amax = t;
+        }
+      }
+      else {
+        t = chSysGetRealtimeCounterX();
+        chHeapFree(trace_blocks[k]);
+        t = chSysGetRealtimeCounterX() - t;
+        trace_blocks[k] = NULL;
+        frees++;
+        fsum += t;
+        if (t > fmax) {
+          fmax = t;
+        }
+      }
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    }
+    test_print("--- Allocs: ");
+    test_printn(allocs);
+    test_print(", failures: ");
+    test_printn(failures);
+    test_println("");
+    test_print("--- Average alloc: ");
+    test_printn((uint32_t)(asum / (allocs + failures)));
+    test_print(", average free: ");
+    test_printn((uint32_t)(fsum / frees));
+    test_println(" RT cycles");
+    test_print("--- Worst alloc: ");
+    test_printn((uint32_t)amax);
+    test_print(", worst free: ");
+    test_printn((uint32_t)fmax);
+    test_println(" RT cycles");
+  }
+  test_end_step(1);
+
+  /* [8.3.2] Printing the heap fragmentation at the end of the trace.*/
+  test_set_step(2);
+  {
+    n = chHeapStatus(&test_heap, &total_size, &largest_size);
+    test_print("--- Fragments: ");
+    test_printn((uint32_t)n);
+    test_print(", free: ");
+    test_printn((uint32_t)total_size);
+    test_print(", largest: ");
+    test_printn((uint32_t)largest_size);
+    test_println("");
+  }
+  test_end_step(2);
+
+  /* [8.3.3] Releasing all the blocks, the heap must be back to a single
+     free block.*/
+  test_set_step(3);
+  {
+    unsigned i;
+
+    for (i = 0; i < TRACE_SLOTS; i++) {
+      if (trace_blocks[i] != NULL) {
+        chHeapFree(trace_blocks[i]);
+        trace_blocks[i] = NULL;
+      }
+    }
+    test_assert(chHeapStatus(&test_heap, NULL, NULL) == 1, "heap fragmented");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_008_003 = {
+  "Randomized allocation trace",
+  oslib_test_008_003_setup,
+  NULL,
+  oslib_test_008_003_execute
+};
+#endif /* PORT_SUPPORTS_RT == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -278,6 +441,9 @@ static const testcase_t oslib_test_008_002 = {
 const testcase_t * const oslib_test_sequence_008_array[] = {
   &oslib_test_008_001,
   &oslib_test_008_002,
+#if (PORT_SUPPORTS_RT == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_008_003,
+#endif
   NULL
 };
 
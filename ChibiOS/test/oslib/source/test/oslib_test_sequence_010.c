@@ -0,0 +1,829 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_010.c
+ * @brief   Test Sequence 010 code.
+ *
+ * @page oslib_test_sequence_010 [10] Rings
+ *
+ * File: @ref oslib_test_sequence_010.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiOS library functionalities related to
+ * rings.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RINGS == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_010_001
+ * - @subpage oslib_test_010_002
+ * - @subpage oslib_test_010_003
+ * - @subpage oslib_test_010_004
+ * - @subpage oslib_test_010_005
+ * - @subpage oslib_test_010_006
+ * .
+ */
+
+#if (CH_CFG_USE_RINGS == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#define RING_SIZE 8
+
+static msg_t ring_buffer[RING_SIZE];
+static ring_slot_t ring_slots[RING_SIZE];
+static ring_t ring1;
+static mpring_t mpring1;
+
+#if CH_CFG_USE_MAILBOXES == TRUE
+static msg_t mb_buffer[RING_SIZE];
+static MAILBOX_DECL(mb1, mb_buffer, RING_SIZE);
+#endif
+
+static THD_WORKING_AREA(wa1Thread1, 256);
+static THD_WORKING_AREA(wa2Thread1, 256);
+
+static THD_FUNCTION(ring_reader, arg) {
+  msg_t msg;
+
+  (void)arg;
+
+  while ((chRingFetchTimeout(&ring1, &msg, TIME_INFINITE) == MSG_OK) &&
+         (msg != (msg_t)0)) {
+    test_emit_token((char)msg);
+  }
+}
+
+static THD_FUNCTION(mpring_writer, arg) {
+  msg_t base = (msg_t)(uintptr_t)arg;
+  msg_t i;
+
+  for (i = 0; i < RING_SIZE; i++) {
+    (void) chMPRingPostTimeout(&mpring1, base + i, TIME_INFINITE);
+  }
+}
+
+static thread_t *ring_start(const char *name, stkalign_t *wbase,
+                            stkalign_t *wend, tprio_t prio,
+                            tfunc_t funcp, void *arg) {
+  thread_descriptor_t td = {
+    .name  = name,
+    .wbase = wbase,
+    .wend  = wend,
+    .prio  = prio,
+    .funcp = funcp,
+    .arg   = arg
+  };
+
+  return chThdCreate(&td);
+}
+
+static systime_t ring_wait_tick(void) {
+
+  chThdSleep((sysinterval_t)1);
+  return chVTGetSystemTimeX();
+}
+
+static uint32_t ring_bmk_single(void) {
+  systime_t start, end;
+  uint32_t n = 0;
+  msg_t msg;
+
+  start = ring_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    (void) chRingPostTimeout(&ring1, (msg_t)n, TIME_INFINITE);
+    (void) chRingFetchTimeout(&ring1, &msg, TIME_INFINITE);
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+  return n;
+}
+
+static uint32_t ring_bmk_batch(void) {
+  systime_t start, end;
+  uint32_t n = 0;
+  msg_t msgs[RING_SIZE];
+
+  memset(msgs, 0, sizeof (msgs));
+  start = ring_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    (void) chRingPostManyTimeout(&ring1, msgs, RING_SIZE, TIME_INFINITE);
+    n += (uint32_t)chRingFetchManyTimeout(&ring1, msgs, RING_SIZE,
+                                          TIME_INFINITE);
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+  return n;
+}
+
+static uint32_t mpring_bmk_single(void) {
+  systime_t start, end;
+  uint32_t n = 0;
+  msg_t msg;
+
+  start = ring_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    (void) chMPRingPostTimeout(&mpring1, (msg_t)n, TIME_INFINITE);
+    (void) chMPRingFetchTimeout(&mpring1, &msg, TIME_INFINITE);
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+  return n;
+}
+
+#if CH_CFG_USE_MAILBOXES == TRUE
+static uint32_t mb_bmk_single(void) {
+  systime_t start, end;
+  uint32_t n = 0;
+  msg_t msg;
+
+  start = ring_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    (void) chMBPostTimeout(&mb1, (msg_t)n, TIME_INFINITE);
+    (void) chMBFetchTimeout(&mb1, &msg, TIME_INFINITE);
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+  return n;
+}
+#endif
+
+static void ring_print_score(const char *name, uint32_t n) {
+
+  test_print(name);
+  test_printn(n);
+  test_println(" msgs/S");
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page oslib_test_010_001 [10.1] Single producer ring, non-blocking tests
+ *
+ * <h2>Description</h2>
+ * The ring functionality is tested by loading and emptying it using the
+ * non-blocking APIs, all conditions are tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.1.1] Testing the initial state.
+ * - [10.1.2] Fetching from the empty ring, must fail.
+ * - [10.1.3] Filling the ring, the last post must fail.
+ * - [10.1.4] Emptying the ring, messages must be in FIFO order.
+ * - [10.1.5] Posting and fetching across the buffer boundary using the
+ *   I-class APIs.
+ * .
+ */
+
+static void oslib_test_010_001_setup(void) {
+  chRingObjectInit(&ring1, ring_buffer, RING_SIZE);
+}
+
+static void oslib_test_010_001_execute(void) {
+
+  /* [10.1.1] Testing the initial state.*/
+  test_set_step(1);
+  {
+    test_assert(chRingGetSizeX(&ring1) == RING_SIZE, "wrong size");
+    test_assert(chRingGetUsedCountX(&ring1) == 0, "not empty");
+    test_assert(chRingGetFreeCountX(&ring1) == RING_SIZE, "not empty");
+  }
+  test_end_step(1);
+
+  /* [10.1.2] Fetching from the empty ring, must fail.*/
+  test_set_step(2);
+  {
+    msg_t msg, msg1;
+
+    msg1 = chRingFetchTimeout(&ring1, &msg, TIME_IMMEDIATE);
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    chSysLock();
+    msg1 = chRingFetchI(&ring1, &msg);
+    chSysUnlock();
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+  }
+  test_end_step(2);
+
+  /* [10.1.3] Filling the ring, the last post must fail.*/
+  test_set_step(3);
+  {
+    msg_t msg1;
+    unsigned i;
+
+    for (i = 0; i < RING_SIZE; i++) {
+      msg1 = chRingPostTimeout(&ring1, 'A' + i, TIME_IMMEDIATE);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    }
+    msg1 = chRingPostTimeout(&ring1, 'X', TIME_IMMEDIATE);
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    chSysLock();
+    msg1 = chRingPostI(&ring1, 'X');
+    chSysUnlock();
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    test_assert(chRingGetUsedCountX(&ring1) == RING_SIZE, "not full");
+    test_assert(chRingGetFreeCountX(&ring1) == 0, "not full");
+  }
+  test_end_step(3);
+
+  /* [10.1.4] Emptying the ring, messages must be in FIFO order.*/
+  test_set_step(4);
+  {
+    msg_t msg, msg1;
+    unsigned i;
+
+    for (i = 0; i < RING_SIZE; i++) {
+      msg1 = chRingFetchTimeout(&ring1, &msg, TIME_IMMEDIATE);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+      test_emit_token(msg);
+    }
+    test_assert_sequence("ABCDEFGH", "wrong get sequence");
+    test_assert(chRingGetUsedCountX(&ring1) == 0, "not empty");
+  }
+  test_end_step(4);
+
+  /* [10.1.5] Posting and fetching across the buffer boundary using the
+     I-class APIs.*/
+  test_set_step(5);
+  {
+    msg_t msgs[RING_SIZE];
+    msg_t msg, msg1 = MSG_OK, msg2 = MSG_OK;
+    unsigned i;
+
+    for (i = 0; i < RING_SIZE / 2; i++) {
+      (void) chRingPostTimeout(&ring1, 'X', TIME_IMMEDIATE);
+      (void) chRingFetchTimeout(&ring1, &msg, TIME_IMMEDIATE);
+    }
+    chSysLock();
+    for (i = 0; i < RING_SIZE; i++) {
+      msg1 |= chRingPostI(&ring1, 'A' + i);
+    }
+    for (i = 0; i < RING_SIZE; i++) {
+      msg2 |= chRingFetchI(&ring1, &msgs[i]);
+    }
+    chSysUnlock();
+    test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    test_assert(msg2 == MSG_OK, "wrong wake-up message");
+    for (i = 0; i < RING_SIZE; i++) {
+      test_emit_token(msgs[i]);
+    }
+    test_assert_sequence("ABCDEFGH", "wrong get sequence");
+    test_assert(chRingGetUsedCountX(&ring1) == 0, "not empty");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t oslib_test_010_001 = {
+  "Single producer ring, non-blocking tests",
+  oslib_test_010_001_setup,
+  NULL,
+  oslib_test_010_001_execute
+};
+
+/**
+ * @page oslib_test_010_002 [10.2] Single producer ring, batch tests
+ *
+ * <h2>Description</h2>
+ * The batch APIs are tested by posting and fetching groups of messages
+ * larger and smaller than the ring size.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.2.1] Posting more messages than the ring size, only the free
+ *   slots must be filled.
+ * - [10.2.2] Fetching a partial group, then the remaining messages.
+ * - [10.2.3] Fetching from the empty ring, must fail.
+ * - [10.2.4] Posting and fetching a group across the buffer boundary.
+ * .
+ */
+
+static void oslib_test_010_002_setup(void) {
+  chRingObjectInit(&ring1, ring_buffer, RING_SIZE);
+}
+
+static void oslib_test_010_002_execute(void) {
+
+  /* [10.2.1] Posting more messages than the ring size, only the free
+     slots must be filled.*/
+  test_set_step(1);
+  {
+    msg_t msgs[RING_SIZE + 4];
+    unsigned i;
+    size_t n;
+
+    for (i = 0; i < RING_SIZE + 4; i++) {
+      msgs[i] = 'A' + i;
+    }
+    n = chRingPostManyTimeout(&ring1, msgs, RING_SIZE + 4, TIME_IMMEDIATE);
+    test_assert(n == RING_SIZE, "wrong count");
+    test_assert(chRingGetFreeCountX(&ring1) == 0, "not full");
+  }
+  test_end_step(1);
+
+  /* [10.2.2] Fetching a partial group, then the remaining messages.*/
+  test_set_step(2);
+  {
+    msg_t msgs[RING_SIZE * 2];
+    unsigned i;
+    size_t n;
+
+    n = chRingFetchManyTimeout(&ring1, msgs, 5, TIME_IMMEDIATE);
+    test_assert(n == 5, "wrong count");
+    for (i = 0; i < n; i++) {
+      test_emit_token(msgs[i]);
+    }
+    n = chRingFetchManyTimeout(&ring1, msgs, RING_SIZE * 2, TIME_IMMEDIATE);
+    test_assert(n == RING_SIZE - 5, "wrong count");
+    for (i = 0; i < n; i++) {
+      test_emit_token(msgs[i]);
+    }
+    test_assert_sequence("ABCDEFGH", "wrong get sequence");
+  }
+  test_end_step(2);
+
+  /* [10.2.3] Fetching from the empty ring, must fail.*/
+  test_set_step(3);
+  {
+    msg_t msgs[RING_SIZE];
+    size_t n;
+
+    n = chRingFetchManyTimeout(&ring1, msgs, RING_SIZE, TIME_IMMEDIATE);
+    test_assert(n == 0, "wrong count");
+  }
+  test_end_step(3);
+
+  /* [10.2.4] Posting and fetching a group across the buffer boundary.*/
+  test_set_step(4);
+  {
+    msg_t msgs[RING_SIZE];
+    unsigned i;
+    size_t n;
+
+    for (i = 0; i < RING_SIZE; i++) {
+      msgs[i] = 'a' + i;
+    }
+    n = chRingPostManyTimeout(&ring1, msgs, 6, TIME_IMMEDIATE);
+    test_assert(n == 6, "wrong count");
+    n = chRingFetchManyTimeout(&ring1, msgs, RING_SIZE, TIME_IMMEDIATE);
+    test_assert(n == 6, "wrong count");
+    for (i = 0; i < RING_SIZE; i++) {
+      msgs[i] = 'A' + i;
+    }
+    n = chRingPostManyTimeout(&ring1, msgs, RING_SIZE, TIME_IMMEDIATE);
+    test_assert(n == RING_SIZE, "wrong count");
+    n = chRingFetchManyTimeout(&ring1, msgs, RING_SIZE, TIME_IMMEDIATE);
+    test_assert(n == RING_SIZE, "wrong count");
+    for (i = 0; i < n; i++) {
+      test_emit_token(msgs[i]);
+    }
+    test_assert_sequence("ABCDEFGH", "wrong get sequence");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_010_002 = {
+  "Single producer ring, batch tests",
+  oslib_test_010_002_setup,
+  NULL,
+  oslib_test_010_002_execute
+};
+
+/**
+ * @page oslib_test_010_003 [10.3] Multiple producers ring, non-blocking tests
+ *
+ * <h2>Description</h2>
+ * The multiple producers ring functionality is tested by loading and
+ * emptying it using the non-blocking and batch APIs, all conditions are
+ * tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.3.1] Testing the initial state and fetching from the empty
+ *   ring, must fail.
+ * - [10.3.2] Filling the ring using both the normal and the I-class
+ *   APIs, the last post must fail.
+ * - [10.3.3] Emptying the ring, messages must be in FIFO order.
+ * - [10.3.4] Posting and fetching groups across the buffer boundary.
+ * .
+ */
+
+static void oslib_test_010_003_setup(void) {
+  chMPRingObjectInit(&mpring1, ring_slots, RING_SIZE);
+}
+
+static void oslib_test_010_003_execute(void) {
+
+  /* [10.3.1] Testing the initial state and fetching from the empty
+     ring, must fail.*/
+  test_set_step(1);
+  {
+    msg_t msg, msg1;
+    size_t n;
+
+    test_assert(chMPRingGetSizeX(&mpring1) == RING_SIZE, "wrong size");
+    test_assert(chMPRingGetFreeCountX(&mpring1) == RING_SIZE, "not empty");
+    msg1 = chMPRingFetchTimeout(&mpring1, &msg, TIME_IMMEDIATE);
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    chSysLock();
+    msg1 = chMPRingFetchI(&mpring1, &msg);
+    chSysUnlock();
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    n = chMPRingFetchManyTimeout(&mpring1, &msg, 1, TIME_IMMEDIATE);
+    test_assert(n == 0, "wrong count");
+  }
+  test_end_step(1);
+
+  /* [10.3.2] Filling the ring using both the normal and the I-class
+     APIs, the last post must fail.*/
+  test_set_step(2);
+  {
+    msg_t msg1, msg2 = MSG_OK;
+    unsigned i;
+
+    for (i = 0; i < RING_SIZE / 2; i++) {
+      msg1 = chMPRingPostTimeout(&mpring1, 'A' + i, TIME_IMMEDIATE);
+      test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    }
+    chSysLock();
+    for (i = RING_SIZE / 2; i < RING_SIZE; i++) {
+      msg2 |= chMPRingPostI(&mpring1, 'A' + i);
+    }
+    msg1 = chMPRingPostI(&mpring1, 'X');
+    chSysUnlock();
+    test_assert(msg2 == MSG_OK, "wrong wake-up message");
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    msg1 = chMPRingPostTimeout(&mpring1, 'X', TIME_IMMEDIATE);
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    test_assert(chMPRingGetUsedCountX(&mpring1) == RING_SIZE, "not full");
+  }
+  test_end_step(2);
+
+  /* [10.3.3] Emptying the ring, messages must be in FIFO order.*/
+  test_set_step(3);
+  {
+    msg_t msgs[RING_SIZE];
+    msg_t msg1 = MSG_OK;
+    unsigned i;
+
+    for (i = 0; i < RING_SIZE / 2; i++) {
+      msg1 |= chMPRingFetchTimeout(&mpring1, &msgs[i], TIME_IMMEDIATE);
+    }
+    chSysLock();
+    for (i = RING_SIZE / 2; i < RING_SIZE; i++) {
+      msg1 |= chMPRingFetchI(&mpring1, &msgs[i]);
+    }
+    chSysUnlock();
+    test_assert(msg1 == MSG_OK, "wrong wake-up message");
+    for (i = 0; i < RING_SIZE; i++) {
+      test_emit_token(msgs[i]);
+    }
+    test_assert_sequence("ABCDEFGH", "wrong get sequence");
+    test_assert(chMPRingGetUsedCountX(&mpring1) == 0, "not empty");
+  }
+  test_end_step(3);
+
+  /* [10.3.4] Posting and fetching groups across the buffer boundary.*/
+  test_set_step(4);
+  {
+    msg_t msgs[RING_SIZE + 4];
+    unsigned i;
+    size_t n;
+
+    for (i = 0; i < RING_SIZE + 4; i++) {
+      msgs[i] = 'A' + i;
+    }
+    n = chMPRingPostManyTimeout(&mpring1, msgs, 3, TIME_IMMEDIATE);
+    test_assert(n == 3, "wrong count");
+    n = chMPRingFetchManyTimeout(&mpring1, msgs, RING_SIZE, TIME_IMMEDIATE);
+    test_assert(n == 3, "wrong count");
+    for (i = 0; i < RING_SIZE + 4; i++) {
+      msgs[i] = 'A' + i;
+    }
+    n = chMPRingPostManyTimeout(&mpring1, msgs, RING_SIZE + 4, TIME_IMMEDIATE);
+    test_assert(n == RING_SIZE, "wrong count");
+    n = chMPRingFetchManyTimeout(&mpring1, msgs, RING_SIZE + 4, TIME_IMMEDIATE);
+    test_assert(n == RING_SIZE, "wrong count");
+    for (i = 0; i < n; i++) {
+      test_emit_token(msgs[i]);
+    }
+    test_assert_sequence("ABCDEFGH", "wrong get sequence");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_010_003 = {
+  "Multiple producers ring, non-blocking tests",
+  oslib_test_010_003_setup,
+  NULL,
+  oslib_test_010_003_execute
+};
+
+/**
+ * @page oslib_test_010_004 [10.4] Single producer ring, blocking tests
+ *
+ * <h2>Description</h2>
+ * A reader thread fetches messages from the ring while the current
+ * thread posts more messages than the ring size, the reader is started
+ * at lower and higher priority in order to test both the writer and the
+ * reader waiting paths. Timeouts are also tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.4.1] Starting a reader thread at lower priority, posting
+ *   messages, the writer must wait for free slots.
+ * - [10.4.2] Starting a reader thread at higher priority, posting
+ *   messages in groups, the reader must wait for messages.
+ * - [10.4.3] Testing timeouts on the empty and full ring.
+ * .
+ */
+
+static void oslib_test_010_004_setup(void) {
+  chRingObjectInit(&ring1, ring_buffer, RING_SIZE);
+}
+
+static void oslib_test_010_004_execute(void) {
+  thread_t *tp;
+
+  /* [10.4.1] Starting a reader thread at lower priority, posting
+     messages, the writer must wait for free slots.*/
+  test_set_step(1);
+  {
+    unsigned i;
+
+    tp = ring_start("reader", wa1Thread1, THD_WORKING_AREA_END(wa1Thread1),
+                    chThdGetPriorityX() - 1, ring_reader, NULL);
+    for (i = 0; i < RING_SIZE * 2; i++) {
+      (void) chRingPostTimeout(&ring1, 'a' + i, TIME_INFINITE);
+    }
+    (void) chRingPostTimeout(&ring1, 0, TIME_INFINITE);
+    (void) chThdWait(tp);
+    test_assert_sequence("abcdefghijklmnop", "wrong get sequence");
+  }
+  test_end_step(1);
+
+  /* [10.4.2] Starting a reader thread at higher priority, posting
+     messages in groups, the reader must wait for messages.*/
+  test_set_step(2);
+  {
+    msg_t msgs[3] = {'A', 'B', 'C'};
+    unsigned i;
+
+    tp = ring_start("reader", wa1Thread1, THD_WORKING_AREA_END(wa1Thread1),
+                    chThdGetPriorityX() + 1, ring_reader, NULL);
+    for (i = 0; i < 3; i++) {
+      (void) chRingPostManyTimeout(&ring1, msgs, 3, TIME_INFINITE);
+    }
+    (void) chRingPostTimeout(&ring1, 0, TIME_INFINITE);
+    (void) chThdWait(tp);
+    test_assert_sequence("ABCABCABC", "wrong get sequence");
+  }
+  test_end_step(2);
+
+  /* [10.4.3] Testing timeouts on the empty and full ring.*/
+  test_set_step(3);
+  {
+    msg_t msgs[RING_SIZE + 1];
+    msg_t msg1;
+    size_t n;
+
+    msg1 = chRingFetchTimeout(&ring1, msgs, TIME_MS2I(10));
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    n = chRingPostManyTimeout(&ring1, msgs, RING_SIZE + 1, TIME_MS2I(10));
+    test_assert(n == RING_SIZE, "wrong count");
+    msg1 = chRingPostTimeout(&ring1, 0, TIME_MS2I(10));
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_010_004 = {
+  "Single producer ring, blocking tests",
+  oslib_test_010_004_setup,
+  NULL,
+  oslib_test_010_004_execute
+};
+
+/**
+ * @page oslib_test_010_005 [10.5] Multiple producers ring, blocking tests
+ *
+ * <h2>Description</h2>
+ * Two writer threads post messages on the ring concurrently, the
+ * current thread fetches them. The messages of each writer must be
+ * received in order. Writers are started at higher priority so that
+ * they have to wait for free slots. Timeouts are also tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.5.1] Starting two writer threads at higher priority, the second
+ *   writer must wait for free slots.
+ * - [10.5.2] Fetching all the messages, the order of each writer must
+ *   be preserved.
+ * - [10.5.3] Testing timeouts on the empty and full ring.
+ * .
+ */
+
+static void oslib_test_010_005_setup(void) {
+  chMPRingObjectInit(&mpring1, ring_slots, RING_SIZE);
+}
+
+static void oslib_test_010_005_execute(void) {
+  thread_t *tp1, *tp2;
+
+  /* [10.5.1] Starting two writer threads at higher priority, the second
+     writer must wait for free slots.*/
+  test_set_step(1);
+  {
+    tp1 = ring_start("writer1", wa1Thread1, THD_WORKING_AREA_END(wa1Thread1),
+                     chThdGetPriorityX() + 1, mpring_writer, (void *)'A');
+    tp2 = ring_start("writer2", wa2Thread1, THD_WORKING_AREA_END(wa2Thread1),
+                     chThdGetPriorityX() + 1, mpring_writer, (void *)'a');
+    test_assert(mpring1.wcnt == 1, "writer not waiting");
+  }
+  test_end_step(1);
+
+  /* [10.5.2] Fetching all the messages, the order of each writer must
+     be preserved.*/
+  test_set_step(2);
+  {
+    msg_t msgs[RING_SIZE];
+    msg_t next1 = 'A', next2 = 'a';
+    unsigned total = 0, i;
+    size_t n;
+
+    while (total < RING_SIZE * 2) {
+      n = chMPRingFetchManyTimeout(&mpring1, msgs, 3, TIME_INFINITE);
+      test_assert(n > 0, "wrong count");
+      for (i = 0; i < n; i++) {
+        if (msgs[i] == next1) {
+          next1++;
+        }
+        else if (msgs[i] == next2) {
+          next2++;
+        }
+        else {
+          test_assert(false, "wrong sequence");
+        }
+      }
+      total += n;
+    }
+    (void) chThdWait(tp1);
+    (void) chThdWait(tp2);
+    test_assert((next1 == 'A' + RING_SIZE) && (next2 == 'a' + RING_SIZE),
+                "missing messages");
+    test_assert(chMPRingGetUsedCountX(&mpring1) == 0, "not empty");
+  }
+  test_end_step(2);
+
+  /* [10.5.3] Testing timeouts on the empty and full ring.*/
+  test_set_step(3);
+  {
+    msg_t msgs[RING_SIZE + 1];
+    msg_t msg1;
+    size_t n;
+
+    msg1 = chMPRingFetchTimeout(&mpring1, msgs, TIME_MS2I(10));
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    n = chMPRingPostManyTimeout(&mpring1, msgs, RING_SIZE + 1, TIME_MS2I(10));
+    test_assert(n == RING_SIZE, "wrong count");
+    msg1 = chMPRingPostTimeout(&mpring1, 0, TIME_MS2I(10));
+    test_assert(msg1 == MSG_TIMEOUT, "wrong wake-up message");
+    test_assert(mpring1.wcnt == 0, "writer still waiting");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_010_005 = {
+  "Multiple producers ring, blocking tests",
+  oslib_test_010_005_setup,
+  NULL,
+  oslib_test_010_005_execute
+};
+
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_006 [10.6] Rings and mailboxes performance
+ *
+ * <h2>Description</h2>
+ * Messages are posted and fetched by the current thread using rings and
+ * a mailbox of the same size, the number of messages transferred in a
+ * one second time window is measured and printed on the output log.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MAILBOXES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.6.1] Single producer ring, one message at time.
+ * - [10.6.2] Single producer ring, groups of messages.
+ * - [10.6.3] Multiple producers ring, one message at time.
+ * - [10.6.4] Mailbox, one message at time.
+ * .
+ */
+
+static void oslib_test_010_006_setup(void) {
+  chRingObjectInit(&ring1, ring_buffer, RING_SIZE);
+  chMPRingObjectInit(&mpring1, ring_slots, RING_SIZE);
+  chMBObjectInit(&mb1, mb_buffer, RING_SIZE);
+}
+
+static void oslib_test_010_006_execute(void) {
+
+  /* [10.6.1] Single producer ring, one message at time.*/
+  test_set_step(1);
+  {
+    ring_print_score("--- Ring    : ", ring_bmk_single());
+  }
+  test_end_step(1);
+
+  /* [10.6.2] Single producer ring, groups of messages.*/
+  test_set_step(2);
+  {
+    ring_print_score("--- Ring x8 : ", ring_bmk_batch());
+  }
+  test_end_step(2);
+
+  /* [10.6.3] Multiple producers ring, one message at time.*/
+  test_set_step(3);
+  {
+    ring_print_score("--- MP ring : ", mpring_bmk_single());
+  }
+  test_end_step(3);
+
+  /* [10.6.4] Mailbox, one message at time.*/
+  test_set_step(4);
+  {
+    ring_print_score("--- Mailbox : ", mb_bmk_single());
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_010_006 = {
+  "Rings and mailboxes performance",
+  oslib_test_010_006_setup,
+  NULL,
+  oslib_test_010_006_execute
+};
+#endif /* CH_CFG_USE_MAILBOXES == TRUE */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_010_array[] = {
+  &oslib_test_010_001,
+  &oslib_test_010_002,
+  &oslib_test_010_003,
+  &oslib_test_010_004,
+  &oslib_test_010_005,
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_006,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Rings.
+ */
+const testsequence_t oslib_test_sequence_010 = {
+  "Rings",
+  oslib_test_sequence_010_array
+};
+
+#endif /* CH_CFG_USE_RINGS == TRUE */
@@ -32,6 +32,8 @@
  * <h2>Test Cases</h2>
  * - @subpage rt_test_003_001
  * - @subpage rt_test_003_002
+ * - @subpage rt_test_003_003
+ * - @subpage rt_test_003_004
  * .
  */
 
@@ -41,6 +43,25 @@
 
 #include "ch.h"
 
+#define VT_TEST_TIMERS 8
+
+static const sysinterval_t vt_delays[VT_TEST_TIMERS] = {
+  1, 2, 31, 32, 33, 100, 1023, 1025
+};
+static virtual_timer_t vt_timers[VT_TEST_TIMERS];
+static systime_t vt_fired[VT_TEST_TIMERS];
+static unsigned vt_mask;
+
+static void vt_cb(virtual_timer_t *vtp, void *p) {
+  unsigned i = (unsigned)(uintptr_t)p;
+
+  (void)vtp;
+  chSysLockFromISR();
+  vt_fired[i] = chVTGetSystemTimeX();
+  vt_mask |= 1U << i;
+  chSysUnlockFromISR();
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -153,6 +174,156 @@ static const testcase_t rt_test_003_002 = {
   rt_test_003_002_execute
 };
 
+/**
+ * @page rt_test_003_003 [3.3] Virtual timers deadlines
+ *
+ * <h2>Description</h2>
+ * A set of virtual timers is armed with delays chosen in order to cross
+ * slots and levels boundaries of the timers wheel, half of the timers
+ * are reset before expiring. The remaining timers must be triggered on
+ * their deadlines.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.3.1] Timers are armed with delays crossing slots boundaries, the
+ *   remaining intervals are checked.
+ * - [3.3.2] Timers with odd index are reset.
+ * - [3.3.3] Waiting for the remaining timers to expire, each timer must
+ *   be triggered not before its deadline, exactly on its deadline in
+ *   tick mode.
+ * .
+ */
+
+static void rt_test_003_003_execute(void) {
+  systime_t start;
+
+  /* [3.3.1] Timers are armed with delays crossing slots boundaries, the
+     remaining intervals are checked.*/
+  test_set_step(1);
+  {
+    bool ok = true;
+    unsigned i;
+
+    vt_mask = 0U;
+    chSysLock();
+    start = chVTGetSystemTimeX();
+    for (i = 0; i < VT_TEST_TIMERS; i++) {
+      chVTDoSetI(&vt_timers[i], vt_delays[i], vt_cb, (void *)(uintptr_t)i);
+    }
+    for (i = 0; i < VT_TEST_TIMERS; i++) {
+      if (chVTGetRemainingIntervalI(&vt_timers[i]) > vt_delays[i]) {
+        ok = false;
+      }
+    }
+    chSysUnlock();
+    test_assert(ok, "invalid remaining interval");
+  }
+  test_end_step(1);
+
+  /* [3.3.2] Timers with odd index are reset.*/
+  test_set_step(2);
+  {
+    unsigned i;
+
+    for (i = 1; i < VT_TEST_TIMERS; i += 2) {
+      chVTReset(&vt_timers[i]);
+      test_assert(!chVTIsArmed(&vt_timers[i]), "still armed");
+    }
+  }
+  test_end_step(2);
+
+  /* [3.3.3] Waiting for the remaining timers to expire, each timer must
+     be triggered not before its deadline, exactly on its deadline in
+     tick mode.*/
+  test_set_step(3);
+  {
+    unsigned i;
+
+    chThdSleepUntil(chTimeAddX(start, vt_delays[VT_TEST_TIMERS - 1] + 10));
+    test_assert(vt_mask == 0x55U, "wrong timers triggered");
+    for (i = 0; i < VT_TEST_TIMERS; i += 2) {
+      sysinterval_t elapsed = chTimeDiffX(start, vt_fired[i]);
+
+      test_assert(elapsed >= vt_delays[i], "triggered early");
+#if CH_CFG_ST_TIMEDELTA == 0
+      test_assert(elapsed == vt_delays[i], "not on deadline");
+#endif
+    }
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_003_003 = {
+  "Virtual timers deadlines",
+  NULL,
+  NULL,
+  rt_test_003_003_execute
+};
+
+/**
+ * @page rt_test_003_004 [3.4] Virtual timers slack
+ *
+ * <h2>Description</h2>
+ * Virtual timers are armed with and without a slack, the timer with a
+ * slack must be triggered within its slack window. With the timers list
+ * the timer is moved on the deadline of the timer already armed within
+ * its window.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.4.1] Three timers are armed, the second one with a slack window
+ *   containing the deadline of the first one.
+ * - [3.4.2] Waiting for the timers to expire, the timer with slack must
+ *   be triggered within its window, in tick mode it must be triggered
+ *   together with the first timer if the timers list is used.
+ * .
+ */
+
+static void rt_test_003_004_execute(void) {
+  systime_t start;
+
+  /* [3.4.1] Three timers are armed, the second one with a slack window
+     containing the deadline of the first one.*/
+  test_set_step(1);
+  {
+    vt_mask = 0U;
+    chSysLock();
+    start = chVTGetSystemTimeX();
+    chVTDoSetI(&vt_timers[0], 20, vt_cb, (void *)0);
+    chVTDoSetWithSlackI(&vt_timers[1], 10, 20, vt_cb, (void *)1);
+    chVTDoSetI(&vt_timers[2], 25, vt_cb, (void *)2);
+    chSysUnlock();
+  }
+  test_end_step(1);
+
+  /* [3.4.2] Waiting for the timers to expire, the timer with slack must
+     be triggered within its window, in tick mode it must be triggered
+     together with the first timer if the timers list is used.*/
+  test_set_step(2);
+  {
+    sysinterval_t elapsed;
+
+    chThdSleepUntil(chTimeAddX(start, 40));
+    test_assert(vt_mask == 7U, "not all timers triggered");
+    test_assert(chTimeDiffX(start, vt_fired[0]) >= 20, "triggered early");
+    test_assert(chTimeDiffX(start, vt_fired[2]) >= 25, "triggered early");
+    elapsed = chTimeDiffX(start, vt_fired[1]);
+    test_assert(elapsed >= 10, "triggered early");
+#if CH_CFG_ST_TIMEDELTA == 0
+    test_assert(elapsed <= 30, "triggered late");
+#if CH_CFG_USE_TIMERS_WHEEL == FALSE
+    test_assert(vt_fired[1] == vt_fired[0], "not coalesced");
+#endif
+#endif
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_003_004 = {
+  "Virtual timers slack",
+  NULL,
+  NULL,
+  rt_test_003_004_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -163,6 +334,8 @@ static const testcase_t rt_test_003_002 = {
 const testcase_t * const rt_test_sequence_003_array[] = {
   &rt_test_003_001,
   &rt_test_003_002,
+  &rt_test_003_003,
+  &rt_test_003_004,
   NULL
 };
 
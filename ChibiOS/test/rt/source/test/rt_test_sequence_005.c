@@ -34,6 +34,7 @@
  * - @subpage rt_test_005_002
  * - @subpage rt_test_005_003
  * - @subpage rt_test_005_004
+ * - @subpage rt_test_005_005
  * .
  */
 
@@ -46,6 +47,33 @@ static THD_FUNCTION(thread, p) {
   test_emit_token(*(char *)p);
 }
 
+#if (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
+#define WM_FRAME_SIZE 32U
+
+static THD_FUNCTION(wm_shallow_thread, p) {
+
+  (void)p;
+  chThdSleep(1);
+}
+
+static void wm_deep_sleep(void) {
+  volatile uint8_t frame[WM_FRAME_SIZE];
+  unsigned i;
+
+  for (i = 0U; i < WM_FRAME_SIZE; i++) {
+    frame[i] = (uint8_t)i;
+  }
+  chThdSleep(1);
+  (void)frame[0];
+}
+
+static THD_FUNCTION(wm_deep_thread, p) {
+
+  (void)p;
+  wm_deep_sleep();
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -339,6 +367,69 @@ static const testcase_t rt_test_005_004 = {
 };
 #endif /* CH_CFG_USE_MUTEXES == TRUE */
 
+#if (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_005_005 [5.5] Stack watermark
+ *
+ * <h2>Description</h2>
+ * The stack high-water-mark sampled at context switch is tested, a
+ * thread going to sleep from a deeper call frame must leave less unused
+ * stack than a thread sleeping from its main function.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_DBG_STACK_WATERMARK == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [5.5.1] Creating a thread sleeping from its main function, the
+ *   unused stack must be within the working area.
+ * - [5.5.2] Creating a thread sleeping from a deeper call frame, the
+ *   unused stack must be lower by at least the size of the frame.
+ * .
+ */
+
+static void rt_test_005_005_execute(void) {
+  size_t unused;
+
+  /* [5.5.1] Creating a thread sleeping from its main function, the
+     unused stack must be within the working area.*/
+  test_set_step(1);
+  {
+    thread_t *tp;
+
+    tp = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() - 1,
+                           wm_shallow_thread, NULL);
+    chThdWait(tp);
+    unused = chRegGetThreadStackUnusedX(tp);
+    test_assert((unused > 0U) && (unused < WA_SIZE), "out of range");
+  }
+  test_end_step(1);
+
+  /* [5.5.2] Creating a thread sleeping from a deeper call frame, the
+     unused stack must be lower by at least the size of the frame.*/
+  test_set_step(2);
+  {
+    thread_t *tp;
+
+    tp = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() - 1,
+                           wm_deep_thread, NULL);
+    chThdWait(tp);
+    test_assert(chRegGetThreadStackUnusedX(tp) + WM_FRAME_SIZE <= unused,
+                "watermark not lowered");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_005_005 = {
+  "Stack watermark",
+  NULL,
+  NULL,
+  rt_test_005_005_execute
+};
+#endif /* CH_DBG_STACK_WATERMARK == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -352,6 +443,9 @@ const testcase_t * const rt_test_sequence_005_array[] = {
   &rt_test_005_003,
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   &rt_test_005_004,
+#endif
+#if (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
+  &rt_test_005_005,
 #endif
   NULL
 };
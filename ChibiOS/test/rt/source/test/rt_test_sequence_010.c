@@ -42,6 +42,8 @@
  * - @subpage rt_test_010_005
  * - @subpage rt_test_010_006
  * - @subpage rt_test_010_007
+ * - @subpage rt_test_010_008
+ * - @subpage rt_test_010_009
  * .
  */
 
@@ -573,6 +575,214 @@ static const testcase_t rt_test_010_007 = {
   rt_test_010_007_execute
 };
 
+#if (CH_CFG_USE_EVENTS_INDEXED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_010_008 [10.8] Indexed Event Sources
+ *
+ * <h2>Description</h2>
+ * Three Event Listeners are registered on an Indexed Event Source with
+ * filters on single flags groups and on multiple groups, broadcasts are
+ * performed with different flags and the signaled events and the
+ * listeners flags are checked.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_EVENTS_INDEXED == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.8.1] An Indexed Event Source is initialized and three Event
+ *   Listeners are registered, the first on flag 0, the second on flag
+ *   8, the third on flags 0 and 4.
+ * - [10.8.2] Flag 0 is broadcasted, the first and third listeners must
+ *   be signaled.
+ * - [10.8.3] Flags 4 and 8 are broadcasted, the second and third
+ *   listeners must be signaled.
+ * - [10.8.4] A flag no listener is interested in is broadcasted, no
+ *   events must be signaled.
+ * - [10.8.5] An empty flags set is broadcasted, all listeners must be
+ *   signaled.
+ * - [10.8.6] The listeners are unregistered, the Event Source must not
+ *   have listeners.
+ * .
+ */
+
+static void rt_test_010_008_setup(void) {
+  chEvtGetAndClearEvents(ALL_EVENTS);
+}
+
+static void rt_test_010_008_execute(void) {
+  indexed_event_source_t ies;
+  event_listener_t el1, el2, el3;
+  eventmask_t m;
+
+  /* [10.8.1] An Indexed Event Source is initialized and three Event
+     Listeners are registered, the first on flag 0, the second on flag
+     8, the third on flags 0 and 4.*/
+  test_set_step(1);
+  {
+    chEvtIndexedObjectInit(&ies);
+    test_assert_lock(!chEvtIndexedIsListeningI(&ies), "listening");
+    chEvtIndexedRegisterMaskWithFlags(&ies, &el1, EVENT_MASK(0), (eventflags_t)0x001);
+    chEvtIndexedRegisterMaskWithFlags(&ies, &el2, EVENT_MASK(1), (eventflags_t)0x100);
+    chEvtIndexedRegisterMaskWithFlags(&ies, &el3, EVENT_MASK(2), (eventflags_t)0x011);
+    test_assert_lock(chEvtIndexedIsListeningI(&ies), "not listening");
+  }
+  test_end_step(1);
+
+  /* [10.8.2] Flag 0 is broadcasted, the first and third listeners must
+     be signaled.*/
+  test_set_step(2);
+  {
+    chEvtIndexedBroadcastFlags(&ies, (eventflags_t)0x001);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == (EVENT_MASK(0) | EVENT_MASK(2)), "wrong events");
+    test_assert(chEvtGetAndClearFlags(&el1) == (eventflags_t)0x001, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el2) == (eventflags_t)0, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el3) == (eventflags_t)0x001, "wrong flags");
+  }
+  test_end_step(2);
+
+  /* [10.8.3] Flags 4 and 8 are broadcasted, the second and third
+     listeners must be signaled.*/
+  test_set_step(3);
+  {
+    chEvtIndexedBroadcastFlags(&ies, (eventflags_t)0x110);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == (EVENT_MASK(1) | EVENT_MASK(2)), "wrong events");
+    test_assert(chEvtGetAndClearFlags(&el1) == (eventflags_t)0, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el2) == (eventflags_t)0x100, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el3) == (eventflags_t)0x010, "wrong flags");
+  }
+  test_end_step(3);
+
+  /* [10.8.4] A flag no listener is interested in is broadcasted, no
+     events must be signaled.*/
+  test_set_step(4);
+  {
+    chEvtIndexedBroadcastFlags(&ies, (eventflags_t)0x002);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == (eventmask_t)0, "unexpected events");
+  }
+  test_end_step(4);
+
+  /* [10.8.5] An empty flags set is broadcasted, all listeners must be
+     signaled.*/
+  test_set_step(5);
+  {
+    chEvtIndexedBroadcastFlags(&ies, (eventflags_t)0);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == (EVENT_MASK(0) | EVENT_MASK(1) | EVENT_MASK(2)), "wrong events");
+  }
+  test_end_step(5);
+
+  /* [10.8.6] The listeners are unregistered, the Event Source must not
+     have listeners.*/
+  test_set_step(6);
+  {
+    chEvtIndexedUnregister(&ies, &el2);
+    chEvtIndexedUnregister(&ies, &el1);
+    test_assert_lock(chEvtIndexedIsListeningI(&ies), "not listening");
+    chEvtIndexedUnregister(&ies, &el3);
+    test_assert_lock(!chEvtIndexedIsListeningI(&ies), "stuck listener");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t rt_test_010_008 = {
+  "Indexed Event Sources",
+  rt_test_010_008_setup,
+  NULL,
+  rt_test_010_008_execute
+};
+#endif /* CH_CFG_USE_EVENTS_INDEXED == TRUE */
+
+/**
+ * @page rt_test_010_009 [10.9] Broadcasting using chEvtBroadcastFlagsMany()
+ *
+ * <h2>Description</h2>
+ * Two Event Sources are broadcasted with different flags sets in a
+ * single call, the listeners are checked to receive the flags of their
+ * own source only.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.9.1] An Event Listener is registered on each Event Source, the
+ *   first is interested in flag 0, the second in flag 1.
+ * - [10.9.2] Flag 0 is broadcasted on the first source and flag 1 on
+ *   the second, both listeners must be signaled.
+ * - [10.9.3] Flag 0 is broadcasted on both sources, only the first
+ *   listener must be signaled.
+ * - [10.9.4] The listeners are unregistered.
+ * .
+ */
+
+static void rt_test_010_009_setup(void) {
+  chEvtGetAndClearEvents(ALL_EVENTS);
+}
+
+static void rt_test_010_009_execute(void) {
+  event_source_t *const esps[2] = {&es1, &es2};
+  event_listener_t el1, el2;
+  eventmask_t m;
+
+  /* [10.9.1] An Event Listener is registered on each Event Source, the
+     first is interested in flag 0, the second in flag 1.*/
+  test_set_step(1);
+  {
+    chEvtObjectInit(&es1);
+    chEvtObjectInit(&es2);
+    chEvtRegisterMaskWithFlags(&es1, &el1, EVENT_MASK(0), (eventflags_t)1);
+    chEvtRegisterMaskWithFlags(&es2, &el2, EVENT_MASK(1), (eventflags_t)2);
+  }
+  test_end_step(1);
+
+  /* [10.9.2] Flag 0 is broadcasted on the first source and flag 1 on
+     the second, both listeners must be signaled.*/
+  test_set_step(2);
+  {
+    static const eventflags_t flags[2] = {1, 2};
+
+    chEvtBroadcastFlagsMany(esps, flags, 2);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == (EVENT_MASK(0) | EVENT_MASK(1)), "wrong events");
+    test_assert(chEvtGetAndClearFlags(&el1) == (eventflags_t)1, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el2) == (eventflags_t)2, "wrong flags");
+  }
+  test_end_step(2);
+
+  /* [10.9.3] Flag 0 is broadcasted on both sources, only the first
+     listener must be signaled.*/
+  test_set_step(3);
+  {
+    static const eventflags_t flags[2] = {1, 1};
+
+    chEvtBroadcastFlagsMany(esps, flags, 2);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == EVENT_MASK(0), "wrong events");
+    test_assert(chEvtGetAndClearFlags(&el1) == (eventflags_t)1, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el2) == (eventflags_t)0, "wrong flags");
+  }
+  test_end_step(3);
+
+  /* [10.9.4] The listeners are unregistered.*/
+  test_set_step(4);
+  {
+    chEvtUnregister(&es1, &el1);
+    chEvtUnregister(&es2, &el2);
+    test_assert_lock(!chEvtIsListeningI(&es1), "stuck listener");
+    test_assert_lock(!chEvtIsListeningI(&es2), "stuck listener");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_010_009 = {
+  "Broadcasting using chEvtBroadcastFlagsMany()",
+  rt_test_010_009_setup,
+  NULL,
+  rt_test_010_009_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -590,6 +800,10 @@ const testcase_t * const rt_test_sequence_010_array[] = {
   &rt_test_010_006,
 #endif
   &rt_test_010_007,
+#if (CH_CFG_USE_EVENTS_INDEXED == TRUE) || defined(__DOXYGEN__)
+  &rt_test_010_008,
+#endif
+  &rt_test_010_009,
   NULL
 };
 
@@ -38,6 +38,7 @@
  * <h2>Test Cases</h2>
  * - @subpage rt_test_011_001
  * - @subpage rt_test_011_002
+ * - @subpage rt_test_011_003
  * .
  */
 
@@ -276,6 +277,122 @@ static const testcase_t rt_test_011_002 = {
 };
 #endif /* CH_CFG_USE_MEMPOOLS == TRUE */
 
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_003 [11.3] Threads pool
+ *
+ * <h2>Description</h2>
+ * A threads pool with two slots is exercised, threads are expected to
+ * be created on demand, parked when their function returns and re-armed
+ * without allocating memory.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_HEAP == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.3.1] Initializing the pool and getting heap info before the
+ *   test.
+ * - [11.3.2] Starting a function at higher priority, a thread is
+ *   expected to be created and to execute immediately.
+ * - [11.3.3] Starting another function, the parked thread is expected
+ *   to be reused without allocating memory.
+ * - [11.3.4] Starting three functions at lower priority, the third is
+ *   expected to fail because all slots are busy.
+ * - [11.3.5] Disposing the pool then getting heap info again for
+ *   verification.
+ * .
+ */
+
+static void rt_test_011_003_setup(void) {
+  chHeapObjectInit(&heap1, test_buffer, sizeof test_buffer);
+}
+
+static void rt_test_011_003_execute(void) {
+  thread_pool_t pool;
+  thread_pool_slot_t slots[2];
+  size_t n1, total1, largest1;
+  size_t n2, total2, largest2;
+  tprio_t prio;
+  thread_t *tp;
+
+  /* [11.3.1] Initializing the pool and getting heap info before the
+     test.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    chThdPoolObjectInit(&pool, &heap1,
+                        THD_WORKING_AREA_SIZE(THREADS_STACK_SIZE),
+                        "pool", slots, 2);
+    n1 = chHeapStatus(&heap1, &total1, &largest1);
+    test_assert(n1 == 1, "heap fragmented");
+  }
+  test_end_step(1);
+
+  /* [11.3.2] Starting a function at higher priority, a thread is
+     expected to be created and to execute immediately.*/
+  test_set_step(2);
+  {
+    tp = chThdPoolStart(&pool, prio + 1, dyn_thread1, "A");
+    test_assert(tp != NULL, "thread creation failed");
+    test_assert_sequence("A", "invalid sequence");
+    n2 = chHeapStatus(&heap1, &total2, &largest2);
+    test_assert(total2 < total1, "no allocation");
+  }
+  test_end_step(2);
+
+  /* [11.3.3] Starting another function, the parked thread is expected
+     to be reused without allocating memory.*/
+  test_set_step(3);
+  {
+    size_t n3, total3, largest3;
+
+    test_assert(chThdPoolStart(&pool, prio + 1, dyn_thread1, "B") == tp,
+                "thread not reused");
+    test_assert_sequence("B", "invalid sequence");
+    n3 = chHeapStatus(&heap1, &total3, &largest3);
+    test_assert((n2 == n3) && (total2 == total3), "heap changed");
+  }
+  test_end_step(3);
+
+  /* [11.3.4] Starting three functions at lower priority, the third is
+     expected to fail because all slots are busy.*/
+  test_set_step(4);
+  {
+    test_assert(chThdPoolStart(&pool, prio - 1, dyn_thread1, "C") == tp,
+                "thread not reused");
+    test_assert(chThdPoolStart(&pool, prio - 1, dyn_thread1, "D") != NULL,
+                "thread creation failed");
+    test_assert(chThdPoolStart(&pool, prio - 1, dyn_thread1, "E") == NULL,
+                "thread creation not failed");
+    chThdSleepMilliseconds(10);
+    test_assert_sequence("CD", "invalid sequence");
+  }
+  test_end_step(4);
+
+  /* [11.3.5] Disposing the pool then getting heap info again for
+     verification.*/
+  test_set_step(5);
+  {
+    chThdPoolDispose(&pool);
+    n2 = chHeapStatus(&heap1, &total2, &largest2);
+    test_assert(n1 == n2, "fragmentation changed");
+    test_assert(total1 == total2, "total free space changed");
+    test_assert(largest1 == largest2, "largest fragment size changed");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t rt_test_011_003 = {
+  "Threads pool",
+  rt_test_011_003_setup,
+  NULL,
+  rt_test_011_003_execute
+};
+#endif /* CH_CFG_USE_HEAP == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -289,6 +406,9 @@ const testcase_t * const rt_test_sequence_011_array[] = {
 #endif
 #if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
   &rt_test_011_002,
+#endif
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+  &rt_test_011_003,
 #endif
   NULL
 };
@@ -46,6 +46,10 @@
  * - @subpage rt_test_012_010
  * - @subpage rt_test_012_011
  * - @subpage rt_test_012_012
+ * - @subpage rt_test_012_013
+ * - @subpage rt_test_012_014
+ * - @subpage rt_test_012_015
+ * - @subpage rt_test_012_016
  * .
  */
 
@@ -138,6 +142,230 @@ static THD_FUNCTION(bmk_thread8, p) {
   } while(!chThdShouldTerminateX());
 }
 
+#if !defined(RT_TEST_RDY_MAX_THREADS) || defined(__DOXYGEN__)
+#if defined(SIMULATOR)
+#define RT_TEST_RDY_MAX_THREADS 128
+#else
+#define RT_TEST_RDY_MAX_THREADS 8
+#endif
+#endif
+
+static thread_t *rdy_threads[RT_TEST_RDY_MAX_THREADS];
+static THD_WORKING_AREA(rdy_wa[RT_TEST_RDY_MAX_THREADS], THREADS_STACK_SIZE);
+
+static THD_FUNCTION(bmk_thread9, p) {
+
+  (void)p;
+  chSysLock();
+  while (!chThdShouldTerminateX())
+    chSchGoSleepS(CH_STATE_SUSPENDED);
+  chSysUnlock();
+}
+
+static void rdy_wakeup_all(unsigned nthd) {
+  unsigned i;
+
+  /* Waking up starting from the highest priority, each thread is
+     inserted behind all the threads already in the ready list.*/
+  chSysLock();
+  for (i = nthd; i > 0U; i--)
+    (void) chSchReadyI(rdy_threads[i - 1U]);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+NOINLINE static uint32_t rdy_loop_test(unsigned nthd) {
+  systime_t start, end;
+  tprio_t prio = chThdGetPriorityX();
+  uint32_t n = 0;
+  unsigned i;
+
+  for (i = 0; i < nthd; i++)
+    rdy_threads[i] = chThdCreateStatic(rdy_wa[i], sizeof (rdy_wa[i]),
+                                       prio + (tprio_t)(i + 1U),
+                                       bmk_thread9, NULL);
+
+  start = test_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    rdy_wakeup_all(nthd);
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+
+  for (i = 0; i < nthd; i++)
+    chThdTerminate(rdy_threads[i]);
+  rdy_wakeup_all(nthd);
+  for (i = 0; i < nthd; i++)
+    chThdWait(rdy_threads[i]);
+
+  return n * (uint32_t)nthd;
+}
+
+#if !defined(RT_TEST_VT_MAX_TIMERS) || defined(__DOXYGEN__)
+#if defined(SIMULATOR)
+#define RT_TEST_VT_MAX_TIMERS 10000
+#else
+#define RT_TEST_VT_MAX_TIMERS 100
+#endif
+#endif
+
+static virtual_timer_t vt_timers[RT_TEST_VT_MAX_TIMERS];
+
+NOINLINE static uint32_t vt_loop_test(unsigned ntimers) {
+  systime_t start, end;
+  uint32_t n = 0, seed = 1;
+  unsigned i;
+
+  start = test_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    /* Timers are armed with pseudo-random delays then reset in arming
+       order, the deadlines are far enough to never expire.*/
+    for (i = 0; i < ntimers; i++) {
+      seed = (seed * 1664525U) + 1013904223U;
+      chSysLock();
+      chVTDoSetI(&vt_timers[i],
+                 TIME_MS2I(2000) + ((sysinterval_t)(seed >> 8) %
+                                    TIME_MS2I(2000)),
+                 tmo, NULL);
+      chSysUnlock();
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    }
+    for (i = 0; i < ntimers; i++) {
+      chSysLock();
+      chVTResetI(&vt_timers[i]);
+      chSysUnlock();
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    }
+    n += (uint32_t)ntimers;
+  } while (chVTIsSystemTimeWithinX(start, end));
+
+  /* Large sets can exceed the time window, the score is scaled to the
+     actual elapsed time.*/
+  return (uint32_t)(((uint64_t)n * (uint64_t)TIME_MS2I(1000)) /
+                    (uint64_t)chVTTimeElapsedSinceX(start));
+}
+
+#if (CH_DBG_STATISTICS == TRUE) || defined(__DOXYGEN__)
+#define RT_TEST_VT_SLACK_TIMERS 100
+
+NOINLINE static void vt_slack_test(sysinterval_t slack) {
+  kernel_stats_t *ksp = &currcore->kernel_stats;
+  ucnt_t alarms, ticks, fired;
+  uint32_t seed = 1;
+  unsigned i;
+
+  (void) test_wait_tick();
+
+  /* Timers are armed with pseudo-random delays, the counters are sampled
+     before and after all timers expired.*/
+  chSysLock();
+  alarms = ksp->n_vtalarm;
+  ticks  = ksp->n_vttick;
+  fired  = ksp->n_vtfire;
+  for (i = 0; i < RT_TEST_VT_SLACK_TIMERS; i++) {
+    seed = (seed * 1664525U) + 1013904223U;
+    chVTDoSetWithSlackI(&vt_timers[i],
+                        TIME_MS2I(10) + ((sysinterval_t)(seed >> 8) %
+                                         TIME_MS2I(100)),
+                        slack, tmo, NULL);
+  }
+  chSysUnlock();
+  chThdSleepMilliseconds(200);
+  chSysLock();
+  alarms = ksp->n_vtalarm - alarms;
+  ticks  = ksp->n_vttick - ticks;
+  fired  = ksp->n_vtfire - fired;
+  chSysUnlock();
+
+  test_print("--- Alarms: ");
+  test_printn((uint32_t)alarms);
+  test_print(", events: ");
+  test_printn((uint32_t)ticks);
+  test_print(", timers: ");
+  test_printn((uint32_t)fired);
+  test_println("");
+}
+#endif
+
+#if (CH_CFG_USE_EVENTS_INDEXED == TRUE) || defined(__DOXYGEN__)
+#define RT_TEST_EVT_MAX_LISTENERS 64
+
+static event_source_t evt_es;
+static indexed_event_source_t evt_ies;
+static event_listener_t evt_listeners[RT_TEST_EVT_MAX_LISTENERS];
+
+NOINLINE static uint32_t evt_loop_test(unsigned nlisteners, bool indexed) {
+  systime_t start, end;
+  uint32_t n = 0;
+  unsigned i;
+
+  /* Each listener is interested in a single flag, flags are assigned
+     in rotation.*/
+  chEvtObjectInit(&evt_es);
+  chEvtIndexedObjectInit(&evt_ies);
+  for (i = 0; i < nlisteners; i++) {
+    eventflags_t wflags = (eventflags_t)1 <<
+                          (i % (sizeof (eventflags_t) * 8U));
+
+    if (indexed) {
+      chEvtIndexedRegisterMaskWithFlags(&evt_ies, &evt_listeners[i],
+                                        EVENT_MASK(0), wflags);
+    }
+    else {
+      chEvtRegisterMaskWithFlags(&evt_es, &evt_listeners[i],
+                                 EVENT_MASK(0), wflags);
+    }
+  }
+
+  start = test_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    chSysLock();
+    if (indexed) {
+      chEvtIndexedBroadcastFlagsI(&evt_ies, (eventflags_t)1);
+    }
+    else {
+      chEvtBroadcastFlagsI(&evt_es, (eventflags_t)1);
+    }
+    chSysUnlock();
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+
+  for (i = 0; i < nlisteners; i++) {
+    if (indexed) {
+      chEvtIndexedUnregister(&evt_ies, &evt_listeners[i]);
+    }
+    else {
+      chEvtUnregister(&evt_es, &evt_listeners[i]);
+    }
+  }
+  (void) chEvtGetAndClearEvents(ALL_EVENTS);
+
+  return n;
+}
+
+static void evt_print_score(uint32_t n, unsigned nlisteners, const char *mode) {
+
+  test_print("--- Score : ");
+  test_printn(n);
+  test_print(" broadcasts/S, ");
+  test_printn((uint32_t)nlisteners);
+  test_print(" listeners, ");
+  test_println(mode);
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -1038,6 +1266,307 @@ static const testcase_t rt_test_012_012 = {
   rt_test_012_012_execute
 };
 
+/**
+ * @page rt_test_012_013 [12.13] Ready list insertion performance
+ *
+ * <h2>Description</h2>
+ * Sets of threads at distinct priorities are made ready at once
+ * starting from the highest priority, each insertion goes behind all
+ * the threads already in the ready list. The operation is performed
+ * into a continuous loop for sets of 8, 32 and 128 threads, the sets
+ * exceeding RT_TEST_RDY_MAX_THREADS are skipped.<br> The performance
+ * is calculated by measuring the number of wakeups after a second of
+ * continuous operations.
+ *
+ * <h2>Test Steps</h2>
+ * - [12.13.1] The test thread priority is lowered in order to make
+ *   room for the benchmark threads.
+ * - [12.13.2] Eight threads are awakened continuously in a one-second
+ *   time window, the score is printed.
+ * - [12.13.3] Thirty-two threads are awakened continuously in a
+ *   one-second time window, the score is printed.
+ * - [12.13.4] One hundred and twenty-eight threads are awakened
+ *   continuously in a one-second time window, the score is printed.
+ * - [12.13.5] The test thread priority is restored.
+ * .
+ */
+
+static void rt_test_012_013_execute(void) {
+  uint32_t n;
+  tprio_t prio;
+
+  /* [12.13.1] The test thread priority is lowered in order to make
+     room for the benchmark threads.*/
+  test_set_step(1);
+  {
+    prio = chThdSetPriority(LOWPRIO);
+  }
+  test_end_step(1);
+
+  /* [12.13.2] Eight threads are awakened continuously in a one-second
+     time window, the score is printed.*/
+  test_set_step(2);
+  {
+    n = rdy_loop_test(8);
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" wakeups/S, 8 threads");
+  }
+  test_end_step(2);
+
+  /* [12.13.3] Thirty-two threads are awakened continuously in a
+     one-second time window, the score is printed.*/
+  test_set_step(3);
+  {
+#if RT_TEST_RDY_MAX_THREADS >= 32
+    n = rdy_loop_test(32);
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" wakeups/S, 32 threads");
+#endif
+  }
+  test_end_step(3);
+
+  /* [12.13.4] One hundred and twenty-eight threads are awakened
+     continuously in a one-second time window, the score is printed.*/
+  test_set_step(4);
+  {
+#if RT_TEST_RDY_MAX_THREADS >= 128
+    n = rdy_loop_test(128);
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" wakeups/S, 128 threads");
+#endif
+  }
+  test_end_step(4);
+
+  /* [12.13.5] The test thread priority is restored.*/
+  test_set_step(5);
+  {
+    chThdSetPriority(prio);
+  }
+  test_end_step(5);
+}
+
+static const testcase_t rt_test_012_013 = {
+  "Ready list insertion performance",
+  NULL,
+  NULL,
+  rt_test_012_013_execute
+};
+
+/**
+ * @page rt_test_012_014 [12.14] Virtual Timers scalability
+ *
+ * <h2>Description</h2>
+ * Sets of virtual timers are armed with pseudo-random delays then
+ * reset, the operation is performed into a continuous loop for sets of
+ * 10, 100, 1000 and 10000 timers, the sets exceeding
+ * RT_TEST_VT_MAX_TIMERS are skipped.<br> The performance is calculated
+ * by measuring the number of timers armed and reset after a second of
+ * continuous operations.
+ *
+ * <h2>Test Steps</h2>
+ * - [12.14.1] Ten timers are armed and reset continuously in a
+ *   one-second time window, the score is printed.
+ * - [12.14.2] One hundred timers are armed and reset continuously in a
+ *   one-second time window, the score is printed.
+ * - [12.14.3] One thousand timers are armed and reset continuously in a
+ *   one-second time window, the score is printed.
+ * - [12.14.4] Ten thousand timers are armed and reset continuously in a
+ *   one-second time window, the score is printed.
+ * .
+ */
+
+static void rt_test_012_014_execute(void) {
+  uint32_t n;
+
+  /* [12.14.1] Ten timers are armed and reset continuously in a
+     one-second time window, the score is printed.*/
+  test_set_step(1);
+  {
+    n = vt_loop_test(10);
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" timers/S, 10 timers");
+  }
+  test_end_step(1);
+
+  /* [12.14.2] One hundred timers are armed and reset continuously in a
+     one-second time window, the score is printed.*/
+  test_set_step(2);
+  {
+    n = vt_loop_test(100);
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" timers/S, 100 timers");
+  }
+  test_end_step(2);
+
+  /* [12.14.3] One thousand timers are armed and reset continuously in a
+     one-second time window, the score is printed.*/
+  test_set_step(3);
+  {
+#if RT_TEST_VT_MAX_TIMERS >= 1000
+    n = vt_loop_test(1000);
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" timers/S, 1000 timers");
+#endif
+  }
+  test_end_step(3);
+
+  /* [12.14.4] Ten thousand timers are armed and reset continuously in a
+     one-second time window, the score is printed.*/
+  test_set_step(4);
+  {
+#if RT_TEST_VT_MAX_TIMERS >= 10000
+    n = vt_loop_test(10000);
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" timers/S, 10000 timers");
+#endif
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_012_014 = {
+  "Virtual Timers scalability",
+  NULL,
+  NULL,
+  rt_test_012_014_execute
+};
+
+#if (CH_DBG_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_015 [12.15] Virtual Timers coalescing
+ *
+ * <h2>Description</h2>
+ * One hundred virtual timers are armed with pseudo-random delays within
+ * a 100mS window, the operation is repeated with increasing slack
+ * values. The number of alarm settings, of timer events and of
+ * triggered timers is printed for each slack value.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_DBG_STATISTICS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.15.1] Timers are armed without slack, the counters are printed.
+ * - [12.15.2] Timers are armed with a 1mS slack, the counters are
+ *   printed.
+ * - [12.15.3] Timers are armed with a 10mS slack, the counters are
+ *   printed.
+ * .
+ */
+
+static void rt_test_012_015_execute(void) {
+
+  /* [12.15.1] Timers are armed without slack, the counters are
+     printed.*/
+  test_set_step(1);
+  {
+    vt_slack_test((sysinterval_t)0);
+  }
+  test_end_step(1);
+
+  /* [12.15.2] Timers are armed with a 1mS slack, the counters are
+     printed.*/
+  test_set_step(2);
+  {
+    vt_slack_test(TIME_MS2I(1));
+  }
+  test_end_step(2);
+
+  /* [12.15.3] Timers are armed with a 10mS slack, the counters are
+     printed.*/
+  test_set_step(3);
+  {
+    vt_slack_test(TIME_MS2I(10));
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_012_015 = {
+  "Virtual Timers coalescing",
+  NULL,
+  NULL,
+  rt_test_012_015_execute
+};
+#endif /* CH_DBG_STATISTICS == TRUE */
+
+#if (CH_CFG_USE_EVENTS_INDEXED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_016 [12.16] Event Sources scalability
+ *
+ * <h2>Description</h2>
+ * Sets of listeners interested in a single flag each are registered on
+ * a plain Event Source and on an Indexed Event Source, a single flag is
+ * broadcasted continuously for one second. The number of broadcasts is
+ * printed for 4, 16 and 64 listeners.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_EVENTS_INDEXED == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.16.1] Four listeners are registered on a plain and on an
+ *   indexed Event Source, broadcasts are performed continuously in a
+ *   one-second time window, the scores are printed.
+ * - [12.16.2] Sixteen listeners are registered on a plain and on an
+ *   indexed Event Source, broadcasts are performed continuously in a
+ *   one-second time window, the scores are printed.
+ * - [12.16.3] Sixty-four listeners are registered on a plain and on an
+ *   indexed Event Source, broadcasts are performed continuously in a
+ *   one-second time window, the scores are printed.
+ * .
+ */
+
+static void rt_test_012_016_execute(void) {
+
+  /* [12.16.1] Four listeners are registered on a plain and on an
+     indexed Event Source, broadcasts are performed continuously in a
+     one-second time window, the scores are printed.*/
+  test_set_step(1);
+  {
+    evt_print_score(evt_loop_test(4, false), 4, "linear");
+    evt_print_score(evt_loop_test(4, true), 4, "indexed");
+  }
+  test_end_step(1);
+
+  /* [12.16.2] Sixteen listeners are registered on a plain and on an
+     indexed Event Source, broadcasts are performed continuously in a
+     one-second time window, the scores are printed.*/
+  test_set_step(2);
+  {
+    evt_print_score(evt_loop_test(16, false), 16, "linear");
+    evt_print_score(evt_loop_test(16, true), 16, "indexed");
+  }
+  test_end_step(2);
+
+  /* [12.16.3] Sixty-four listeners are registered on a plain and on an
+     indexed Event Source, broadcasts are performed continuously in a
+     one-second time window, the scores are printed.*/
+  test_set_step(3);
+  {
+    evt_print_score(evt_loop_test(64, false), 64, "linear");
+    evt_print_score(evt_loop_test(64, true), 64, "indexed");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_012_016 = {
+  "Event Sources scalability",
+  NULL,
+  NULL,
+  rt_test_012_016_execute
+};
+#endif /* CH_CFG_USE_EVENTS_INDEXED == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -1070,6 +1599,14 @@ const testcase_t * const rt_test_sequence_012_array[] = {
   &rt_test_012_011,
 #endif
   &rt_test_012_012,
+  &rt_test_012_013,
+  &rt_test_012_014,
+#if (CH_DBG_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_012_015,
+#endif
+#if (CH_CFG_USE_EVENTS_INDEXED == TRUE) || defined(__DOXYGEN__)
+  &rt_test_012_016,
+#endif
   NULL
 };
 
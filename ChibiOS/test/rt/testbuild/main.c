@@ -22,6 +22,7 @@
 #include "hal.h"
 #include "rt_test_root.h"
 #include "oslib_test_root.h"
+#include "corebmk_test_root.h"
 #include "console.h"
 
 /*
@@ -45,6 +46,7 @@ int main(int argc, char *argv[]) {
 
   test_execute((BaseSequentialStream *)&CD1, &rt_test_suite);
   test_execute((BaseSequentialStream *)&CD1, &oslib_test_suite);
+  test_execute((BaseSequentialStream *)&CD1, &corebmk_test_suite);
   if (chtest.global_fail)
     exit(1);
   else
@@ -0,0 +1,219 @@
+#!/usr/bin/env python3
+
+"""Expands a ChibiOS deferred binary log into text.
+
+The log is the byte stream produced by dlogDrain(), format strings are
+read from the ELF file of the firmware that produced the log.
+
+Each drained block starts with the "DLOG" synchronization word, records
+are formed by an header word, a format identifier and the argument words.
+Format identifiers and DLOG_STR() arguments are offsets from the
+dlog_anchor symbol.
+
+Usage: dlog2txt.py [-f FREQ] ELF LOG
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SYNC = b"DLOG"
+RECORD_MAGIC = 0xA5
+LOST_NARGS = 0xFF
+ANCHOR = "dlog_anchor"
+
+SHT_PROGBITS = 1
+SHT_SYMTAB = 2
+SHF_ALLOC = 2
+
+# Same syntax accepted by chprintf(): %[-][+][0][width|*][.precision|*][l|L]p
+SPEC = re.compile(r"%(-?)(\+?)(0?)(\*|\d*)(?:\.(\*|\d*))?([lL]?)(.)",
+                  re.DOTALL)
+
+
+class Elf:
+    """Minimal ELF reader, sections and symbols only."""
+
+    def __init__(self, data):
+        if data[:4] != b"\x7fELF":
+            raise ValueError("not an ELF file")
+        self.data = data
+        self.is64 = data[4] == 2
+        self.end = "<" if data[5] == 1 else ">"
+        if self.is64:
+            shoff, = self.unpack("Q", 0x28)
+            shentsize, shnum, shstrndx = self.unpack("HHH", 0x3A)
+        else:
+            shoff, = self.unpack("I", 0x20)
+            shentsize, shnum, shstrndx = self.unpack("HHH", 0x2E)
+        self.sections = [self.section(shoff + i * shentsize)
+                         for i in range(shnum)]
+        self.symbols = {}
+        for sec in self.sections:
+            if sec["type"] == SHT_SYMTAB:
+                self.load_symbols(sec, self.sections[sec["link"]])
+
+    def unpack(self, fmt, offset):
+        return struct.unpack_from(self.end + fmt, self.data, offset)
+
+    def section(self, offset):
+        if self.is64:
+            (_, stype, flags, addr, off, size, link, _, _,
+             entsize) = self.unpack("IIQQQQIIQQ", offset)
+        else:
+            (_, stype, flags, addr, off, size, link, _, _,
+             entsize) = self.unpack("IIIIIIIIII", offset)
+        return {"type": stype, "flags": flags, "addr": addr, "offset": off,
+                "size": size, "link": link, "entsize": entsize}
+
+    def load_symbols(self, sec, strtab):
+        for off in range(sec["offset"], sec["offset"] + sec["size"],
+                         sec["entsize"]):
+            if self.is64:
+                name, _, _, _, value, _ = self.unpack("IBBHQQ", off)
+            else:
+                name, value, _, _, _, _ = self.unpack("IIIBBH", off)
+            start = strtab["offset"] + name
+            end = self.data.index(b"\0", start)
+            self.symbols[self.data[start:end].decode("ascii", "replace")] = \
+                value
+
+    def string(self, addr):
+        for sec in self.sections:
+            if (sec["type"] == SHT_PROGBITS and sec["flags"] & SHF_ALLOC and
+                    sec["addr"] <= addr < sec["addr"] + sec["size"]):
+                start = sec["offset"] + addr - sec["addr"]
+                end = self.data.index(b"\0", start)
+                return self.data[start:end].decode("utf-8", "replace")
+        return None
+
+
+class Decoder:
+    """Stateful decoder of the log stream."""
+
+    def __init__(self, elf, freq):
+        if ANCHOR not in elf.symbols:
+            raise ValueError("symbol %s not found" % ANCHOR)
+        self.elf = elf
+        self.anchor = elf.symbols[ANCHOR]
+        self.freq = freq
+        self.end = None
+        self.time = None
+        self.stamp = 0
+        self.lost = 0
+        self.skipped = 0
+
+    def string(self, offset):
+        if offset & 0x80000000:
+            offset -= 1 << 32
+        s = self.elf.string((self.anchor + offset) & 0xFFFFFFFFFFFFFFFF)
+        return s if s is not None else "<0x%x>" % offset
+
+    def format(self, fmt, args):
+        args = list(args)
+
+        def arg():
+            return args.pop(0) if args else 0
+
+        def expand(m):
+            left, sign, zero, width, prec, _, conv = m.groups()
+            if width == "*":
+                width = str(arg())
+            if prec == "*":
+                prec = str(arg())
+            flags = left + sign + (zero if conv not in "cs" else "")
+            spec = "%" + flags + width
+            if conv == "s":
+                return (spec + "s") % self.string(arg())[:int(prec)
+                                                         if prec else None]
+            if conv == "c":
+                return (spec + "c") % chr(arg() & 0xFF)
+            if conv in "dDiI":
+                v = arg()
+                return (spec + "d") % (v - (1 << 32) if v & 0x80000000 else v)
+            if conv in "uU":
+                return (spec + "d") % arg()
+            if conv in "xXpP":
+                return (spec + "X") % arg()
+            if conv in "oO":
+                return (spec + "o") % arg()
+            return conv
+
+        return SPEC.sub(expand, fmt)
+
+    def stamp_text(self, stamp):
+        if self.time is None:
+            self.time = stamp
+        else:
+            self.time += (stamp - self.stamp) & 0xFFFF
+        self.stamp = stamp
+        if self.freq:
+            return "[%12.6f]" % (self.time / self.freq)
+        return "[%10d]" % self.time
+
+    def decode(self, data, out):
+        pos = 0
+        while pos + 4 <= len(data):
+            word = data[pos:pos + 4]
+            if word in (SYNC, SYNC[::-1]):
+                self.end = "<" if word == SYNC else ">"
+                pos += 4
+                continue
+            if self.end is None:
+                self.skipped += 1
+                pos += 1
+                continue
+            hdr, = struct.unpack(self.end + "I", word)
+            n = (hdr >> 8) & 0xFF
+            if (hdr & 0xFF) != RECORD_MAGIC or (n != LOST_NARGS and n > 8):
+                # Not a record, resynchronizing on the next sync word.
+                self.end = None
+                continue
+            if n == LOST_NARGS:
+                n = 0
+                lost = True
+            else:
+                lost = False
+            if pos + 8 + n * 4 > len(data):
+                break
+            words = struct.unpack_from(self.end + "%dI" % (n + 1), data,
+                                       pos + 4)
+            pos += 8 + n * 4
+            text = self.stamp_text(hdr >> 16)
+            if lost:
+                self.lost += words[0]
+                out.write("%s *** %d records lost\n" % (text, words[0]))
+                continue
+            out.write("%s %s\n" % (text, self.format(self.string(words[0]),
+                                                     words[1:]).rstrip("\r\n")))
+        return pos
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="ELF file of the firmware")
+    parser.add_argument("log", help="binary log dump, - for stdin")
+    parser.add_argument("-f", "--freq", type=float, default=0,
+                        help="system tick frequency in Hz, timestamps are "
+                             "shown in seconds if specified")
+    args = parser.parse_args()
+
+    with open(args.elf, "rb") as f:
+        elf = Elf(f.read())
+    if args.log == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.log, "rb") as f:
+            data = f.read()
+
+    dec = Decoder(elf, args.freq)
+    used = dec.decode(data, sys.stdout)
+    if dec.skipped or dec.lost or used != len(data):
+        sys.stderr.write("skipped %d bytes before sync, %d records lost, "
+                         "%d trailing bytes\n"
+                         % (dec.skipped, dec.lost, len(data) - used))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,250 @@
+#!/usr/bin/env python3
+
+"""Converts a ChibiOS/RT binary trace dump into Chrome trace JSON.
+
+The dump is the raw byte stream produced by chTraceRead() or trsDrain(),
+the output can be loaded in chrome://tracing or https://ui.perfetto.dev.
+
+Records are formed by a type byte, a length byte and the payload, all
+integers are LEB128 variable length, signed values and pointers are
+zig-zag encoded, pointers are deltas from the previous pointer modulo
+the target pointer size, the size is carried by the SYNC records.
+
+Usage: chtrace2json.py [-f FREQ] [-o OUT] DUMP
+"""
+
+import argparse
+import json
+import sys
+
+TYPE_READY = 1
+TYPE_SWITCH = 2
+TYPE_ISR_ENTER = 3
+TYPE_ISR_LEAVE = 4
+TYPE_HALT = 5
+TYPE_USER = 6
+TYPE_OBJECT = 7
+TYPE_SYNC = 8
+TYPE_LOST = 9
+TYPE_NAME = 10
+
+OBJ_OPS = ["sem_wait", "sem_signal", "mtx_lock", "mtx_unlock",
+           "mb_post", "mb_fetch", "vt_set", "vt_reset", "vt_fire"]
+
+# Thread states, same order as CH_STATE_NAMES in chthreads.h.
+STATES = ["READY", "CURRENT", "WTSTART", "SUSPENDED", "QUEUED", "WTSEM",
+          "WTMTX", "WTCOND", "SLEEPING", "WTEXIT", "WTOREVT", "WTANDEVT",
+          "SNDMSGQ", "SNDMSG", "WTMSG", "FINAL"]
+
+ISR_TID = 1
+
+
+class Reader:
+    """Decoder of a single record payload."""
+
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def u8(self):
+        v = self.data[self.pos]
+        self.pos += 1
+        return v
+
+    def uvar(self):
+        v, shift = 0, 0
+        while True:
+            b = self.data[self.pos]
+            self.pos += 1
+            v |= (b & 0x7F) << shift
+            shift += 7
+            if b < 0x80:
+                return v
+
+    def svar(self):
+        v = self.uvar()
+        return (v >> 1) ^ -(v & 1)
+
+    def rest(self):
+        s = self.data[self.pos:].decode("utf-8", "replace")
+        self.pos = len(self.data)
+        return s
+
+
+class Decoder:
+    """Stateful decoder producing Chrome trace events."""
+
+    def __init__(self, freq):
+        self.freq = float(freq)
+        self.events = []
+        self.names = {}
+        self.synced = False
+        self.skipped = 0
+        self.lost = 0
+        self.time = 0
+        self.stamp = 0
+        self.lastptr = 0
+        self.ptrmask = 0xFFFFFFFF
+        self.current = None
+        self.started = None
+
+    def us(self):
+        return round(self.time * 1e6 / self.freq, 3)
+
+    def ptr(self, r):
+        # Deltas are computed by the target in its pointer size, the sum
+        # wraps around exactly as the target arithmetic does.
+        self.lastptr = (self.lastptr + r.svar()) & self.ptrmask
+        return self.lastptr
+
+    def name(self, p):
+        return self.names.get(p, "0x%x" % p)
+
+    def instant(self, tid, name, args=None, scope="t"):
+        ev = {"name": name, "ph": "i", "s": scope, "pid": 0, "tid": tid,
+              "ts": self.us()}
+        if args:
+            ev["args"] = args
+        self.events.append(ev)
+
+    def close_running(self):
+        if self.current is not None and self.started is not None:
+            self.events.append({"name": "running", "ph": "X", "pid": 0,
+                                "tid": self.current, "ts": self.started,
+                                "dur": round(self.us() - self.started, 3)})
+
+    def record(self, rtype, payload):
+        r = Reader(payload)
+        if rtype == TYPE_SYNC:
+            stamp = r.uvar()
+            r.uvar()  # System time, not used.
+            self.ptrmask = (1 << (8 * r.u8())) - 1
+            self.lastptr = 0
+            current = self.ptr(r)
+            if self.synced:
+                self.time += (stamp - self.stamp) & 0xFFFFFFFF
+            else:
+                self.time = stamp
+            self.stamp = stamp
+            if self.current != current:
+                self.close_running()
+                self.current = current
+                self.started = self.us()
+            self.synced = True
+            return
+        if not self.synced:
+            self.skipped += 1
+            return
+        if rtype == TYPE_LOST:
+            count = r.uvar()
+            self.lost += count
+            self.instant(0, "lost %d records" % count, scope="g")
+            return
+
+        dt = r.uvar()
+        self.time += dt
+        self.stamp = (self.stamp + dt) & 0xFFFFFFFF
+
+        if rtype == TYPE_READY:
+            r.u8()
+            tp = self.ptr(r)
+            msg = r.svar()
+            self.instant(tp, "ready", {"msg": msg})
+        elif rtype == TYPE_SWITCH:
+            state = r.u8()
+            ntp = self.ptr(r)
+            wtobjp = self.ptr(r)
+            self.close_running()
+            if self.current is not None:
+                args = {"state": STATES[state] if state < len(STATES)
+                        else state}
+                if state >= 4:
+                    args["object"] = wtobjp
+                self.instant(self.current, "switch out", args)
+            self.current = ntp
+            self.started = self.us()
+        elif rtype in (TYPE_ISR_ENTER, TYPE_ISR_LEAVE):
+            isr = self.ptr(r)
+            self.events.append({"name": isr,
+                                "ph": "B" if rtype == TYPE_ISR_ENTER else "E",
+                                "pid": 0, "tid": ISR_TID, "ts": self.us()})
+        elif rtype == TYPE_HALT:
+            self.instant(0, "halt: " + r.rest(), scope="g")
+        elif rtype == TYPE_USER:
+            up1 = self.ptr(r)
+            up2 = self.ptr(r)
+            self.instant(self.current or 0, "user",
+                         {"up1": "0x%x" % up1, "up2": "0x%x" % up2})
+        elif rtype == TYPE_OBJECT:
+            op = r.u8()
+            objp = self.ptr(r)
+            arg = r.svar()
+            self.instant(self.current or 0,
+                         OBJ_OPS[op] if op < len(OBJ_OPS) else "op%d" % op,
+                         {"object": objp, "arg": arg})
+        elif rtype == TYPE_NAME:
+            p = self.ptr(r)
+            self.names[p] = r.rest()
+
+    def decode(self, data):
+        pos = 0
+        while pos + 2 <= len(data):
+            rtype, n = data[pos], data[pos + 1]
+            if pos + 2 + n > len(data):
+                break
+            self.record(rtype, data[pos + 2:pos + 2 + n])
+            pos += 2 + n
+        self.close_running()
+        return pos
+
+    def trace(self):
+        meta = [{"name": "process_name", "ph": "M", "pid": 0,
+                 "args": {"name": "ChibiOS/RT"}},
+                {"name": "thread_name", "ph": "M", "pid": 0, "tid": ISR_TID,
+                 "args": {"name": "ISRs"}}]
+        tids = {ev["tid"] for ev in self.events if ev["tid"] > ISR_TID}
+        for tid in sorted(tids):
+            meta.append({"name": "thread_name", "ph": "M", "pid": 0,
+                         "tid": tid, "args": {"name": self.name(tid)}})
+        # Names are resolved last, name records can follow the events.
+        for ev in self.events:
+            if isinstance(ev["name"], int):
+                ev["name"] = self.name(ev["name"])
+            if "object" in ev.get("args", {}):
+                ev["args"]["object"] = self.name(ev["args"]["object"])
+        return {"traceEvents": meta + self.events,
+                "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", help="binary trace dump, - for stdin")
+    parser.add_argument("-f", "--freq", type=float, default=1e6,
+                        help="realtime counter frequency in Hz "
+                             "(default 1000000)")
+    parser.add_argument("-o", "--output", default="-",
+                        help="output JSON file (default stdout)")
+    args = parser.parse_args()
+
+    if args.dump == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.dump, "rb") as f:
+            data = f.read()
+
+    dec = Decoder(args.freq)
+    used = dec.decode(data)
+    if dec.skipped or dec.lost or used != len(data):
+        sys.stderr.write("skipped %d records before sync, %d records lost, "
+                         "%d trailing bytes\n"
+                         % (dec.skipped, dec.lost, len(data) - used))
+
+    out = sys.stdout if args.output == "-" else open(args.output, "w")
+    json.dump(dec.trace(), out)
+    out.write("\n")
+    if out is not sys.stdout:
+        out.close()
+
+
+if __name__ == "__main__":
+    main()